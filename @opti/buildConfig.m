@@ -40,7 +40,7 @@ opts.objbias = prob.objbias;
 %nonlinear
 if(isempty(prob.fun)) %linear / quadratic /sdp
     prob = fixLin('row',prob,warn,'SCIP'); %Check & Fix Linear Constraints
-    prob = fixSparsity(prob,warn,'SCIP'); %Check & Fix Sparsity
+    %(scip accepts dense and sparse A, H and Q directly - no fixSparsity)
     nlprob = [];
 else %nonlinear
     nlprob = prob;
@@ -373,7 +373,6 @@ if(cqc)
         end
         prob.l = l;    
     end
-    prob.l = chkdouble(prob.l,'prob.l',warn > 1);
     if(iscell(prob.qrl))
         if(size(prob.qrl,1) > 1 && size(prob.qrl,2) > 1)
             error('Quadratic constraint qrl must be a column cell array');
@@ -404,8 +403,6 @@ if(cqc)
         end
         prob.qru = qru;         
     end
-    prob.qrl = chkdouble(prob.qrl,'prob.qrl',warn > 1);
-    prob.qru = chkdouble(prob.qru,'prob.qru',warn > 1);
     if(iscell(prob.Q))
         if(size(prob.Q,2) > 1)
             prob.Q = prob.Q';
@@ -597,9 +594,6 @@ if(cqc)
             opts.solver = 'scip';
         end
     end
-    if(issparse(prob.l))
-       prob.l = full(prob.l); %ensure dense
-    end
     if(iscell(prob.Q))
        if(iscell(prob.l) || iscell(prob.qrl) || iscell(prob.qru))
            error('Only Quadratic Constraints Q may be a cell!');
@@ -612,8 +606,7 @@ if(cqc)
            error('Quadratic Constraints Q + l + qrl + qru are not the same length!');
        end
        for i = 1:r0
-           %Check Data Type
-           prob.Q{i} = chkdouble(prob.Q{i},['prob.Q{',i,'}'],warn > 1);
+           %(Q and l may be sparse or dense, double, single, integer or logical - converted in the MEX)
            Q = prob.Q{i};
            l = prob.l(:,i);
            rl = prob.qrl(i);
@@ -622,8 +615,6 @@ if(cqc)
            QCisconvex = QCisconvex & chkQC(Q,l,rl,ru,i,siz.ndec,opts.solver,settings.QUAD_EIG_MAX_SIZE);
        end
     else 
-        %Check Data Type
-        prob.Q = chkdouble(prob.Q,'prob.Q',warn > 1);
         %Check constraint
         QCisconvex = QCisconvex & chkQC(prob.Q,prob.l,prob.qrl,prob.qru,1,siz.ndec,opts.solver,settings.QUAD_EIG_MAX_SIZE);
     end
@@ -673,18 +664,7 @@ if(csos)
     if(any(types < 1 | types > 2))
         error('Only SOS types 1 and 2 are allowed!');
     end   
-    %Check Datatypes
-    if(nsos > 1)
-        %Check vectors
-        for i = 1:nsos
-            %Check Data Types
-            prob.sos.index{i} = chkdouble(prob.sos.index{i},['prob.sos.index{',i,'}'],warn > 1);
-            prob.sos.weight{i} = chkdouble(prob.sos.weight{i},['prob.sos.weight{',i,'}'],warn > 1);
-        end  
-    else
-        prob.sos.index = chkdouble(prob.sos.index,'prob.sos.index',warn > 1);
-        prob.sos.weight = chkdouble(prob.sos.weight,'prob.sos.weight',warn > 1);
-    end    
+    %(indices and weights may be double, single or integer, indices also a logical mask - converted in the MEX)
 end
 
 %Check bounds direction
@@ -0,0 +1,783 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * Model-construction benchmark: generates synthetic problems of a given number of nonzeros, builds them through
+ * mexFunction (without solving, opts.testmode = 1) and reports the time of each build phase (opts.buildtime = 1),
+ * the throughput in nonzeros per second and the peak resident set size. Results are printed as a table and can be
+ * written as CSV for regression tracking.
+ *
+ * Usage:
+ *   bench_build [--class lp,milp,qpsparse,qpdense,qcqp,nlp] [--nnz 1e3,1e4,1e5,1e6] [--reps 3] [--seed 1]
+ *               [--csv file]
+ *
+ * When compiled with BENCH_SDP (target bench_build_sdp), the only class is "sdp" and the problems are built through
+ * scipsdpmex with a time limit of 0, so the total time also contains the start of the solving process.
+ */
+
+#include "mexshim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+/** instructions of nonlinear instruction lists (see scipnlmex.cpp) */
+enum
+{
+   NUM   = 0,
+   VAR   = 1,
+   ADD   = 5,
+   SIN   = 12
+};
+
+/** names of build phases as returned in stats.BuildTime */
+#ifdef BENCH_SDP
+static const char* phasenames[] = {"validation", "variables", "linear", "sdp"};
+#else
+static const char* phasenames[] = {"validation", "variables", "linear", "quadratic", "sos", "nonlinear"};
+#endif
+static const int nphases = (int) (sizeof(phasenames) / sizeof(phasenames[0]));
+
+/** generated problem (the input arguments of mexFunction) */
+struct Problem
+{
+   std::vector<mxArray*> args;               /**< input arguments */
+   size_t                nvars;              /**< number of variables */
+   size_t                ncons;              /**< number of constraints (of all types) */
+   size_t                nnz;                /**< number of nonzeros (of all constraints and the objective) */
+};
+
+/** result of one build */
+struct Result
+{
+   double                phases[8];          /**< times of build phases [s] */
+   double                build;              /**< sum of build phases [s] */
+   double                total;              /**< time of mexFunction call [s] */
+   long                  peakrss;            /**< peak resident set size [kB] */
+};
+
+/*
+ * random numbers
+ */
+
+static uint64_t rngstate = 1;
+
+/** xorshift random number generator */
+static
+uint64_t rngNext(void)
+{
+   rngstate ^= rngstate << 13;
+   rngstate ^= rngstate >> 7;
+   rngstate ^= rngstate << 17;
+   return rngstate;
+}
+
+/** random integer in [0, n) */
+static
+size_t rngInt(
+   size_t                n                   /**< upper bound */
+   )
+{
+   return (size_t) (rngNext() % n);
+}
+
+/** random double in [lb, ub) */
+static
+double rngDouble(
+   double                lb,                 /**< lower bound */
+   double                ub                  /**< upper bound */
+   )
+{
+   return lb + (ub - lb) * (double) (rngNext() >> 11) / 9007199254740992.0;
+}
+
+/*
+ * array helpers
+ */
+
+/** dense vector with constant value */
+static
+mxArray* constVector(
+   size_t                n,                  /**< length */
+   double                val                 /**< value */
+   )
+{
+   mxArray* arr = mxCreateDoubleMatrix(n, 1, mxREAL);
+   std::fill(mxGetPr(arr), mxGetPr(arr) + n, val);
+   return arr;
+}
+
+/** dense vector with random values */
+static
+mxArray* randVector(
+   size_t                n,                  /**< length */
+   double                lb,                 /**< lower bound of values */
+   double                ub                  /**< upper bound of values */
+   )
+{
+   mxArray* arr = mxCreateDoubleMatrix(n, 1, mxREAL);
+   for (size_t i = 0; i < n; ++i)
+      mxGetPr(arr)[i] = rngDouble(lb, ub);
+   return arr;
+}
+
+/** sparse matrix from columns of (row, value) entries */
+static
+mxArray* sparseMatrix(
+   size_t                m,                  /**< number of rows */
+   const std::vector<std::vector<std::pair<size_t, double> > >& cols, /**< entries of each column */
+   size_t*               nnz                 /**< number of nonzeros (increased) */
+   )
+{
+   size_t n = cols.size();
+   size_t nz = 0;
+   mxArray* arr;
+   mwIndex* ir;
+   mwIndex* jc;
+   double* pr;
+
+   for (size_t j = 0; j < n; ++j)
+      nz += cols[j].size();
+
+   arr = mxCreateSparse(m, n, nz, mxREAL);
+   ir = mxGetIr(arr);
+   jc = mxGetJc(arr);
+   pr = mxGetPr(arr);
+
+   nz = 0;
+   for (size_t j = 0; j < n; ++j)
+   {
+      std::vector<std::pair<size_t, double> > col = cols[j];
+
+      /* sorted, unique row indices */
+      std::sort(col.begin(), col.end());
+      jc[j] = nz;
+      for (size_t k = 0; k < col.size(); ++k)
+      {
+         if ( k > 0 && col[k].first == col[k-1].first )
+            continue;
+         ir[nz] = col[k].first;
+         pr[nz++] = col[k].second;
+      }
+   }
+   jc[n] = nz;
+   *nnz += nz;
+
+   return arr;
+}
+
+/** random sparse matrix with about nzpercol nonzeros in each column */
+static
+mxArray* randSparse(
+   size_t                m,                  /**< number of rows */
+   size_t                n,                  /**< number of columns */
+   size_t                nzpercol,           /**< nonzeros per column */
+   size_t*               nnz                 /**< number of nonzeros (increased) */
+   )
+{
+   std::vector<std::vector<std::pair<size_t, double> > > cols(n);
+
+   for (size_t j = 0; j < n; ++j)
+   {
+      for (size_t k = 0; k < nzpercol; ++k)
+         cols[j].push_back(std::make_pair(rngInt(m), rngDouble(1.0, 10.0)));
+   }
+
+   return sparseMatrix(m, cols, nnz);
+}
+
+#ifndef BENCH_SDP
+/** symmetric sparse matrix with diagonal and bandwidth-one off-diagonal entries on the variables [first, last) */
+static
+mxArray* bandedSymmetric(
+   size_t                n,                  /**< dimension */
+   size_t                first,              /**< first variable */
+   size_t                last,               /**< last variable (exclusive) */
+   size_t*               nnz                 /**< number of nonzeros (increased) */
+   )
+{
+   std::vector<std::vector<std::pair<size_t, double> > > cols(n);
+
+   for (size_t j = first; j < last; ++j)
+   {
+      cols[j].push_back(std::make_pair(j, rngDouble(2.0, 4.0)));
+      if ( j + 1 < last )
+      {
+         double v = rngDouble(-0.5, 0.5);
+         cols[j].push_back(std::make_pair(j + 1, v));
+         cols[j+1].push_back(std::make_pair(j, v));
+      }
+   }
+
+   return sparseMatrix(n, cols, nnz);
+}
+#endif
+
+/** options structure */
+static
+mxArray* createOptions(void)
+{
+#ifdef BENCH_SDP
+   const char* fnames[3] = {"display", "buildtime", "maxtime"};
+   mxArray* opts = mxCreateStructMatrix(1, 1, 3, fnames);
+
+   mxSetField(opts, 0, "display", mxCreateString("off"));
+   mxSetField(opts, 0, "buildtime", mxCreateDoubleScalar(1.0));
+   mxSetField(opts, 0, "maxtime", mxCreateDoubleScalar(0.0));
+#else
+   const char* fnames[3] = {"display", "buildtime", "testmode"};
+   mxArray* opts = mxCreateStructMatrix(1, 1, 3, fnames);
+
+   mxSetField(opts, 0, "display", mxCreateDoubleScalar(0.0));
+   mxSetField(opts, 0, "buildtime", mxCreateDoubleScalar(1.0));
+   mxSetField(opts, 0, "testmode", mxCreateDoubleScalar(1.0));
+#endif
+
+   return opts;
+}
+
+/*
+ * problem generators
+ */
+
+#ifdef BENCH_SDP
+
+/** SDP: one cone of dimension about sqrt(n), each variable with a diagonal and an off-diagonal pair */
+static
+void generateSDP(
+   size_t                nnz,                /**< target number of nonzeros */
+   Problem&              prob                /**< generated problem */
+   )
+{
+   size_t n = std::max((size_t) 1, nnz / 3);
+   size_t dim = std::max((size_t) 2, std::min((size_t) 500, (size_t) std::sqrt((double) n)));
+   std::vector<std::vector<std::pair<size_t, double> > > cols(n + 1);
+
+   /* C = identity, A_i = diagonal entry and a symmetric off-diagonal pair */
+   for (size_t d = 0; d < dim; ++d)
+      cols[0].push_back(std::make_pair(d * dim + d, 1.0));
+   for (size_t i = 0; i < n; ++i)
+   {
+      size_t r = rngInt(dim);
+      size_t c = rngInt(dim);
+      double v = rngDouble(-1.0, 1.0);
+
+      cols[i+1].push_back(std::make_pair(r * dim + r, rngDouble(0.5, 1.0)));
+      if ( r != c )
+      {
+         cols[i+1].push_back(std::make_pair(c * dim + r, v));
+         cols[i+1].push_back(std::make_pair(r * dim + c, v));
+      }
+   }
+
+   prob.nvars = n;
+   prob.ncons = 2;
+   prob.args.resize(10, (mxArray*) NULL);
+   prob.args[0] = randVector(n, -1.0, 1.0);
+   prob.args[1] = randSparse(1, n, 1, &prob.nnz);
+   prob.args[2] = constVector(1, -mxGetInf());
+   prob.args[3] = constVector(1, (double) n);
+   prob.args[4] = constVector(n, -10.0);
+   prob.args[5] = constVector(n, 10.0);
+   prob.args[6] = sparseMatrix(dim * dim, cols, &prob.nnz);
+   prob.args[7] = mxCreateDoubleMatrix(0, 0, mxREAL);
+   prob.args[8] = mxCreateDoubleMatrix(0, 0, mxREAL);
+   prob.args[9] = createOptions();
+}
+
+#else
+
+/** arguments (H, f, A, lhs, rhs, lb, ub, xtype, sos, qc, nl, x0, opts) with empty H, xtype, sos, qc, nl and x0 */
+static
+void initArgs(
+   Problem&              prob,               /**< problem */
+   size_t                n,                  /**< number of variables */
+   mxArray*              A                   /**< linear constraint matrix */
+   )
+{
+   size_t m = mxGetM(A);
+
+   prob.nvars = n;
+   prob.ncons = m;
+   prob.args.resize(13, (mxArray*) NULL);
+   for (size_t i = 0; i < 13; ++i)
+      prob.args[i] = mxCreateDoubleMatrix(0, 0, mxREAL);
+
+   mxDestroyArray(prob.args[1]);
+   prob.args[1] = randVector(n, -1.0, 1.0);
+   mxDestroyArray(prob.args[2]);
+   prob.args[2] = A;
+   mxDestroyArray(prob.args[3]);
+   prob.args[3] = constVector(m, -mxGetInf());
+   mxDestroyArray(prob.args[4]);
+   prob.args[4] = randVector(m, 10.0, 100.0);
+   mxDestroyArray(prob.args[5]);
+   prob.args[5] = constVector(n, 0.0);
+   mxDestroyArray(prob.args[6]);
+   prob.args[6] = constVector(n, 10.0);
+   mxDestroyArray(prob.args[12]);
+   prob.args[12] = createOptions();
+}
+
+/** replace argument */
+static
+void setArg(
+   Problem&              prob,               /**< problem */
+   size_t                k,                  /**< argument index */
+   mxArray*              arr                 /**< new argument */
+   )
+{
+   mxDestroyArray(prob.args[k]);
+   prob.args[k] = arr;
+}
+
+/** LP: 5 nonzeros per column, n/2 rows */
+static
+void generateLP(
+   size_t                nnz,                /**< target number of nonzeros */
+   Problem&              prob                /**< generated problem */
+   )
+{
+   size_t n = std::max((size_t) 2, nnz / 5);
+
+   initArgs(prob, n, randSparse(n / 2, n, 5, &prob.nnz));
+}
+
+/** MILP with SOS1 constraints on 20% of the variables (sets of 10 variables), half of the variables integer */
+static
+void generateMILP(
+   size_t                nnz,                /**< target number of nonzeros */
+   Problem&              prob                /**< generated problem */
+   )
+{
+   const char* sosfields[3] = {"type", "index", "weight"};
+   size_t n = std::max((size_t) 20, nnz * 10 / 52);
+   size_t nsos = std::max((size_t) 1, n / 50);
+   std::string xtype(n, 'C');
+   std::string types(nsos, '1');
+   mxArray* sos;
+   mxArray* index;
+   mxArray* weight;
+
+   initArgs(prob, n, randSparse(n / 2, n, 5, &prob.nnz));
+
+   for (size_t i = 0; i < n; i += 2)
+      xtype[i] = 'I';
+   setArg(prob, 7, mxCreateString(xtype.c_str()));
+
+   sos = mxCreateStructMatrix(1, 1, 3, sosfields);
+   index = mxCreateCellMatrix(nsos, 1);
+   weight = mxCreateCellMatrix(nsos, 1);
+   for (size_t s = 0; s < nsos; ++s)
+   {
+      mxArray* ind = mxCreateDoubleMatrix(10, 1, mxREAL);
+      mxArray* wt = mxCreateDoubleMatrix(10, 1, mxREAL);
+
+      for (size_t k = 0; k < 10; ++k)
+      {
+         mxGetPr(ind)[k] = (double) ((s * 10 + k) % n + 1); /* 1-based */
+         mxGetPr(wt)[k] = (double) (k + 1);
+      }
+      mxSetCell(index, s, ind);
+      mxSetCell(weight, s, wt);
+   }
+   mxSetField(sos, 0, "type", mxCreateString(types.c_str()));
+   mxSetField(sos, 0, "index", index);
+   mxSetField(sos, 0, "weight", weight);
+   setArg(prob, 8, sos);
+
+   prob.ncons += nsos;
+   prob.nnz += 10 * nsos;
+}
+
+/** QP with sparse banded H (about 3 nonzeros per column) and one nonzero per column in A */
+static
+void generateQPSparse(
+   size_t                nnz,                /**< target number of nonzeros */
+   Problem&              prob                /**< generated problem */
+   )
+{
+   size_t n = std::max((size_t) 10, nnz / 4);
+
+   initArgs(prob, n, randSparse(n / 10, n, 1, &prob.nnz));
+   setArg(prob, 0, bandedSymmetric(n, 0, n, &prob.nnz));
+}
+
+/** QP with dense H (stored as sparse matrix) */
+static
+void generateQPDense(
+   size_t                nnz,                /**< target number of nonzeros */
+   Problem&              prob                /**< generated problem */
+   )
+{
+   size_t n = std::max((size_t) 2, (size_t) std::sqrt((double) nnz));
+   std::vector<std::vector<std::pair<size_t, double> > > cols(n);
+   std::vector<double> lower(n * n);
+
+   initArgs(prob, n, randSparse(1, n, 1, &prob.nnz));
+
+   /* diagonally dominant symmetric matrix */
+   for (size_t j = 0; j < n; ++j)
+   {
+      for (size_t i = j; i < n; ++i)
+         lower[i + j * n] = i == j ? (double) n : rngDouble(-0.5, 0.5);
+   }
+   for (size_t j = 0; j < n; ++j)
+   {
+      for (size_t i = 0; i < n; ++i)
+         cols[j].push_back(std::make_pair(i, i >= j ? lower[i + j * n] : lower[j + i * n]));
+   }
+   setArg(prob, 0, sparseMatrix(n, cols, &prob.nnz));
+}
+
+/** QCQP: 2 nonzeros per column in A and up to 10 banded quadratic constraints on disjoint blocks of variables */
+static
+void generateQCQP(
+   size_t                nnz,                /**< target number of nonzeros */
+   Problem&              prob                /**< generated problem */
+   )
+{
+   const char* qcfields[4] = {"Q", "l", "qrl", "qru"};
+   size_t n = std::max((size_t) 10, nnz / 5);
+   size_t nqc = std::min((size_t) 10, n / 10);
+   size_t blocksize = n / nqc;
+   mxArray* qc;
+   mxArray* Q;
+   mxArray* l;
+
+   initArgs(prob, n, randSparse(n / 4, n, 2, &prob.nnz));
+
+   qc = mxCreateStructMatrix(1, 1, 4, qcfields);
+   Q = mxCreateCellMatrix(nqc, 1);
+   l = mxCreateDoubleMatrix(n, nqc, mxREAL);
+   for (size_t k = 0; k < nqc; ++k)
+   {
+      mxSetCell(Q, k, bandedSymmetric(n, k * blocksize, (k + 1) * blocksize, &prob.nnz));
+      mxGetPr(l)[k * n + k * blocksize] = 1.0;
+   }
+   mxSetField(qc, 0, "Q", Q);
+   mxSetField(qc, 0, "l", l);
+   mxSetField(qc, 0, "qrl", constVector(nqc, -mxGetInf()));
+   mxSetField(qc, 0, "qru", constVector(nqc, (double) blocksize));
+   setArg(prob, 9, qc);
+
+   prob.ncons += nqc;
+}
+
+/** nonlinear instruction lists: constraints sum_{k=1}^{10} sin(x_j(k)) <= 5 */
+static
+void generateNLP(
+   size_t                nnz,                /**< target number of nonzeros */
+   Problem&              prob                /**< generated problem */
+   )
+{
+   const char* nlfields[3] = {"instr", "cl", "cu"};
+   const size_t nterms = 10;
+   size_t m = std::max((size_t) 1, nnz / nterms);
+   size_t n = std::max((size_t) nterms, nnz / 10);
+   mxArray* nl;
+   mxArray* instr;
+   size_t dummy = 0;
+
+   /* single linear row with one nonzero to keep A non-empty */
+   initArgs(prob, n, randSparse(1, n, 1, &dummy));
+
+   nl = mxCreateStructMatrix(1, 1, 3, nlfields);
+   instr = mxCreateCellMatrix(m, 1);
+   for (size_t c = 0; c < m; ++c)
+   {
+      mxArray* list = mxCreateDoubleMatrix(1, 6 * nterms - 2, mxREAL);
+      double* ins = mxGetPr(list);
+      size_t pos = 0;
+
+      for (size_t k = 0; k < nterms; ++k)
+      {
+         ins[pos++] = VAR;
+         ins[pos++] = (double) rngInt(n);
+         ins[pos++] = SIN;
+         ins[pos++] = mxGetNaN();
+         if ( k > 0 )
+         {
+            ins[pos++] = ADD;
+            ins[pos++] = mxGetNaN();
+         }
+      }
+      mxSetCell(instr, c, list);
+   }
+   mxSetField(nl, 0, "instr", instr);
+   mxSetField(nl, 0, "cl", constVector(m, -mxGetInf()));
+   mxSetField(nl, 0, "cu", constVector(m, 5.0));
+   setArg(prob, 10, nl);
+
+   prob.ncons += m;
+   prob.nnz += m * nterms;
+}
+
+#endif
+
+/** generate problem of given class */
+static
+bool generate(
+   const std::string&    cls,                /**< problem class */
+   size_t                nnz,                /**< target number of nonzeros */
+   Problem&              prob                /**< generated problem */
+   )
+{
+   prob.nnz = 0;
+#ifdef BENCH_SDP
+   if ( cls == "sdp" )
+      generateSDP(nnz, prob);
+#else
+   if ( cls == "lp" )
+      generateLP(nnz, prob);
+   else if ( cls == "milp" )
+      generateMILP(nnz, prob);
+   else if ( cls == "qpsparse" )
+      generateQPSparse(nnz, prob);
+   else if ( cls == "qpdense" )
+      generateQPDense(nnz, prob);
+   else if ( cls == "qcqp" )
+      generateQCQP(nnz, prob);
+   else if ( cls == "nlp" )
+      generateNLP(nnz, prob);
+#endif
+   else
+      return false;
+
+   return true;
+}
+
+/*
+ * measurement
+ */
+
+/** reset the peak resident set size of this process (Linux >= 4.0), returns whether this is supported */
+static
+bool resetPeakRSS(void)
+{
+   FILE* file = fopen("/proc/self/clear_refs", "w");
+
+   if ( file == NULL )
+      return false;
+   fputs("5", file);
+   return fclose(file) == 0;
+}
+
+/** peak resident set size [kB] since the last reset (or since the start of the process) */
+static
+long peakRSS(void)
+{
+   FILE* file = fopen("/proc/self/status", "r");
+   char line[256];
+   long kb = -1;
+
+   if ( file != NULL )
+   {
+      while ( fgets(line, sizeof(line), file) != NULL )
+      {
+         if ( strncmp(line, "VmHWM:", 6) == 0 )
+         {
+            kb = atol(line + 6);
+            break;
+         }
+      }
+      fclose(file);
+   }
+
+   if ( kb < 0 )
+   {
+      struct rusage usage;
+
+      getrusage(RUSAGE_SELF, &usage);
+      kb = usage.ru_maxrss;
+   }
+
+   return kb;
+}
+
+/** build problem once and measure */
+static
+void run(
+   const Problem&        prob,               /**< problem */
+   Result&               res                 /**< result */
+   )
+{
+   mxArray* plhs[4];
+   const mxArray* bt;
+   std::chrono::steady_clock::time_point start;
+
+   (void) resetPeakRSS();
+   start = std::chrono::steady_clock::now();
+   mexshim::call(mexFunction, 4, plhs, (int) prob.args.size(), (const mxArray**) prob.args.data());
+   res.total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   res.peakrss = peakRSS();
+
+   bt = mxGetField(plhs[3], 0, "BuildTime");
+   res.build = 0.0;
+   for (int p = 0; p < nphases; ++p)
+   {
+      const mxArray* phase = bt != NULL ? mxGetField(bt, 0, phasenames[p]) : NULL;
+
+      res.phases[p] = phase != NULL ? mxGetScalar(phase) : 0.0;
+      res.build += res.phases[p];
+   }
+
+   for (int i = 0; i < 4; ++i)
+      mxDestroyArray(plhs[i]);
+}
+
+/** split comma separated list */
+static
+std::vector<std::string> splitList(
+   const char*           str                 /**< list */
+   )
+{
+   std::vector<std::string> items;
+   std::string s(str);
+   size_t pos = 0;
+
+   while ( pos <= s.size() )
+   {
+      size_t next = s.find(',', pos);
+      if ( next == std::string::npos )
+         next = s.size();
+      if ( next > pos )
+         items.push_back(s.substr(pos, next - pos));
+      pos = next + 1;
+   }
+
+   return items;
+}
+
+/** print usage */
+static
+void usage(
+   const char*           prog                /**< program name */
+   )
+{
+#ifdef BENCH_SDP
+   printf("usage: %s [--class sdp] [--nnz 1e3,1e4,...] [--reps n] [--seed s] [--csv file]\n", prog);
+#else
+   printf("usage: %s [--class lp,milp,qpsparse,qpdense,qcqp,nlp] [--nnz 1e3,1e4,...] [--reps n] [--seed s] [--csv file]\n", prog);
+#endif
+}
+
+int main(
+   int                   argc,               /**< number of arguments */
+   char**                argv                /**< arguments */
+   )
+{
+#ifdef BENCH_SDP
+   std::vector<std::string> classes = splitList("sdp");
+#else
+   std::vector<std::string> classes = splitList("lp,milp,qpsparse,qpdense,qcqp,nlp");
+#endif
+   std::vector<std::string> sizes = splitList("1e3,1e4,1e5,1e6");
+   const char* csvfile = NULL;
+   FILE* csv = NULL;
+   int reps = 3;
+
+   for (int i = 1; i < argc; ++i)
+   {
+      if ( strcmp(argv[i], "--class") == 0 && i + 1 < argc )
+         classes = splitList(argv[++i]);
+      else if ( strcmp(argv[i], "--nnz") == 0 && i + 1 < argc )
+         sizes = splitList(argv[++i]);
+      else if ( strcmp(argv[i], "--reps") == 0 && i + 1 < argc )
+         reps = std::max(1, atoi(argv[++i]));
+      else if ( strcmp(argv[i], "--seed") == 0 && i + 1 < argc )
+         rngstate = std::max(1ULL, strtoull(argv[++i], NULL, 10));
+      else if ( strcmp(argv[i], "--csv") == 0 && i + 1 < argc )
+         csvfile = argv[++i];
+      else
+      {
+         usage(argv[0]);
+         return 1;
+      }
+   }
+
+   if ( csvfile != NULL )
+   {
+      csv = fopen(csvfile, "w");
+      if ( csv == NULL )
+      {
+         printf("Cannot open <%s>.\n", csvfile);
+         return 1;
+      }
+      fprintf(csv, "class,target_nnz,nnz,nvars,ncons,rep");
+      for (int p = 0; p < nphases; ++p)
+         fprintf(csv, ",%s_s", phasenames[p]);
+      fprintf(csv, ",build_s,total_s,nnz_per_s,peak_rss_kb\n");
+   }
+
+   mexshim::setOutput(NULL);
+
+   printf("%-9s %10s %10s %10s", "class", "nnz", "nvars", "ncons");
+   for (int p = 0; p < nphases; ++p)
+      printf(" %10.10s", phasenames[p]);
+   printf(" %10s %10s %12s %10s\n", "build", "total", "nnz/s", "rss [MB]");
+
+   for (size_t c = 0; c < classes.size(); ++c)
+   {
+      for (size_t s = 0; s < sizes.size(); ++s)
+      {
+         size_t target = (size_t) atof(sizes[s].c_str());
+         Problem prob;
+         Result best;
+
+         if ( ! generate(classes[c], target, prob) )
+         {
+            printf("Unknown problem class <%s>.\n", classes[c].c_str());
+            usage(argv[0]);
+            return 1;
+         }
+
+         for (int r = 0; r < reps; ++r)
+         {
+            Result res;
+
+            try
+            {
+               run(prob, res);
+            }
+            catch (const mexshim::MexError& e)
+            {
+               printf("Error building %s with %zu nonzeros: %s\n", classes[c].c_str(), prob.nnz, e.what());
+               return 1;
+            }
+
+            if ( csv != NULL )
+            {
+               fprintf(csv, "%s,%zu,%zu,%zu,%zu,%d", classes[c].c_str(), target, prob.nnz, prob.nvars, prob.ncons, r);
+               for (int p = 0; p < nphases; ++p)
+                  fprintf(csv, ",%.6g", res.phases[p]);
+               fprintf(csv, ",%.6g,%.6g,%.6g,%ld\n", res.build, res.total, res.build > 0.0 ? prob.nnz / res.build : 0.0, res.peakrss);
+            }
+
+            if ( r == 0 || res.build < best.build )
+               best = res;
+         }
+
+         /* table shows the fastest repetition */
+         printf("%-9s %10zu %10zu %10zu", classes[c].c_str(), prob.nnz, prob.nvars, prob.ncons);
+         for (int p = 0; p < nphases; ++p)
+            printf(" %10.4f", best.phases[p]);
+         printf(" %10.4f %10.4f %12.4g %10.1f\n", best.build, best.total, best.build > 0.0 ? prob.nnz / best.build : 0.0, best.peakrss / 1024.0);
+         fflush(stdout);
+
+         for (size_t i = 0; i < prob.args.size(); ++i)
+            mxDestroyArray(prob.args[i]);
+      }
+   }
+
+   if ( csv != NULL )
+      fclose(csv);
+
+   return 0;
+}
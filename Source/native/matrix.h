@@ -0,0 +1,151 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * Native implementation of the subset of the MATLAB matrix API (matrix.h) that is used by the MEX sources. This
+ * allows to build and run the interface without MATLAB, e.g., for tests, benchmarks, profilers and sanitizers.
+ */
+
+#ifndef MEXSHIM_MATRIX_H
+#define MEXSHIM_MATRIX_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef size_t mwSize;
+typedef size_t mwIndex;
+typedef ptrdiff_t mwSignedIndex;
+typedef unsigned short mxChar;
+typedef bool mxLogical;
+
+/** opaque array type */
+typedef struct mxArray_tag mxArray;
+
+/** class of an array */
+typedef enum
+{
+   mxUNKNOWN_CLASS = 0,
+   mxCELL_CLASS,
+   mxSTRUCT_CLASS,
+   mxLOGICAL_CLASS,
+   mxCHAR_CLASS,
+   mxVOID_CLASS,
+   mxDOUBLE_CLASS,
+   mxSINGLE_CLASS,
+   mxINT8_CLASS,
+   mxUINT8_CLASS,
+   mxINT16_CLASS,
+   mxUINT16_CLASS,
+   mxINT32_CLASS,
+   mxUINT32_CLASS,
+   mxINT64_CLASS,
+   mxUINT64_CLASS,
+   mxFUNCTION_CLASS
+} mxClassID;
+
+/** complexity of numeric arrays (only real arrays are supported) */
+typedef enum
+{
+   mxREAL = 0,
+   mxCOMPLEX
+} mxComplexity;
+
+/* creation and destruction */
+mxArray* mxCreateDoubleMatrix(mwSize m, mwSize n, mxComplexity complexity);
+mxArray* mxCreateDoubleScalar(double value);
+mxArray* mxCreateNumericMatrix(mwSize m, mwSize n, mxClassID classid, mxComplexity complexity);
+mxArray* mxCreateNumericArray(mwSize ndim, const mwSize* dims, mxClassID classid, mxComplexity complexity);
+mxArray* mxCreateLogicalMatrix(mwSize m, mwSize n);
+mxArray* mxCreateLogicalScalar(mxLogical value);
+mxArray* mxCreateSparse(mwSize m, mwSize n, mwSize nzmax, mxComplexity complexity);
+mxArray* mxCreateSparseLogicalMatrix(mwSize m, mwSize n, mwSize nzmax);
+mxArray* mxCreateString(const char* str);
+mxArray* mxCreateCellMatrix(mwSize m, mwSize n);
+mxArray* mxCreateStructMatrix(mwSize m, mwSize n, int nfields, const char** fieldnames);
+mxArray* mxDuplicateArray(const mxArray* arr);
+void mxDestroyArray(mxArray* arr);
+
+/* memory */
+void* mxCalloc(mwSize n, mwSize size);
+void* mxMalloc(mwSize n);
+void* mxRealloc(void* ptr, mwSize size);
+void mxFree(void* ptr);
+
+/* size and type */
+mwSize mxGetM(const mxArray* arr);
+mwSize mxGetN(const mxArray* arr);
+void mxSetM(mxArray* arr, mwSize m);
+void mxSetN(mxArray* arr, mwSize n);
+mwSize mxGetNumberOfDimensions(const mxArray* arr);
+const mwSize* mxGetDimensions(const mxArray* arr);
+size_t mxGetNumberOfElements(const mxArray* arr);
+size_t mxGetElementSize(const mxArray* arr);
+mxClassID mxGetClassID(const mxArray* arr);
+const char* mxGetClassName(const mxArray* arr);
+bool mxIsClass(const mxArray* arr, const char* name);
+bool mxIsEmpty(const mxArray* arr);
+bool mxIsDouble(const mxArray* arr);
+bool mxIsSingle(const mxArray* arr);
+bool mxIsNumeric(const mxArray* arr);
+bool mxIsLogical(const mxArray* arr);
+bool mxIsChar(const mxArray* arr);
+bool mxIsCell(const mxArray* arr);
+bool mxIsStruct(const mxArray* arr);
+bool mxIsSparse(const mxArray* arr);
+bool mxIsComplex(const mxArray* arr);
+bool mxIsInt8(const mxArray* arr);
+bool mxIsUint8(const mxArray* arr);
+bool mxIsInt16(const mxArray* arr);
+bool mxIsUint16(const mxArray* arr);
+bool mxIsInt32(const mxArray* arr);
+bool mxIsUint32(const mxArray* arr);
+bool mxIsInt64(const mxArray* arr);
+bool mxIsUint64(const mxArray* arr);
+
+/* data access */
+double* mxGetPr(const mxArray* arr);
+void* mxGetData(const mxArray* arr);
+mxLogical* mxGetLogicals(const mxArray* arr);
+mxChar* mxGetChars(const mxArray* arr);
+double mxGetScalar(const mxArray* arr);
+mwIndex* mxGetIr(const mxArray* arr);
+mwIndex* mxGetJc(const mxArray* arr);
+mwSize mxGetNzmax(const mxArray* arr);
+
+/* strings */
+int mxGetString(const mxArray* arr, char* buf, mwSize buflen);
+char* mxArrayToString(const mxArray* arr);
+
+/* cells */
+mxArray* mxGetCell(const mxArray* arr, mwIndex i);
+void mxSetCell(mxArray* arr, mwIndex i, mxArray* value);
+
+/* structs */
+int mxGetNumberOfFields(const mxArray* arr);
+const char* mxGetFieldNameByNumber(const mxArray* arr, int fieldnumber);
+int mxGetFieldNumber(const mxArray* arr, const char* fieldname);
+mxArray* mxGetField(const mxArray* arr, mwIndex i, const char* fieldname);
+mxArray* mxGetFieldByNumber(const mxArray* arr, mwIndex i, int fieldnumber);
+void mxSetField(mxArray* arr, mwIndex i, const char* fieldname, mxArray* value);
+void mxSetFieldByNumber(mxArray* arr, mwIndex i, int fieldnumber, mxArray* value);
+int mxAddField(mxArray* arr, const char* fieldname);
+
+/* objects: only the MException returned by mexCallMATLABWithTrap(), represented as struct */
+mxArray* mxGetProperty(const mxArray* arr, mwIndex i, const char* propname);
+
+/* special values */
+double mxGetInf(void);
+double mxGetNaN(void);
+double mxGetEps(void);
+bool mxIsInf(double value);
+bool mxIsNaN(double value);
+bool mxIsFinite(double value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,37 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * Native implementation of the subset of the MATLAB MEX API (mex.h) that is used by the MEX sources. Errors raised
+ * by mexErrMsgTxt() are thrown as C++ exceptions, see mexshim.h.
+ */
+
+#ifndef MEXSHIM_MEX_H
+#define MEXSHIM_MEX_H
+
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** entry point of a MEX file */
+void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[]);
+
+int mexPrintf(const char* fmt, ...);
+void mexErrMsgTxt(const char* msg);
+void mexErrMsgIdAndTxt(const char* id, const char* fmt, ...);
+void mexWarnMsgTxt(const char* msg);
+void mexWarnMsgIdAndTxt(const char* id, const char* fmt, ...);
+int mexEvalString(const char* command);
+int mexCallMATLAB(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[], const char* name);
+mxArray* mexCallMATLABWithTrap(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[], const char* name);
+
+/* Ctrl-C detection (private MATLAB functions used by scipeventmex.cpp) */
+bool utIsInterruptPending(void);
+void utSetInterruptPending(bool pending);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
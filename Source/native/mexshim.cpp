@@ -0,0 +1,987 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * Native implementation of the MEX/matrix API subset declared in mex.h and matrix.h.
+ *
+ * Arrays and memory created while a MEX function runs (see mexshim::call()) are registered as temporaries and freed
+ * after the call unless they are returned in plhs or have been stored in a cell or struct, as in MATLAB. Arrays
+ * created outside of a call (e.g., the inputs built by a test driver) are owned by the caller.
+ */
+
+#include "mexshim.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/** internal array representation */
+struct mxArray_tag
+{
+   mxClassID             classid;            /**< class of array */
+   bool                  sparse;             /**< is the array sparse? */
+   std::vector<mwSize>   dims;               /**< dimensions (at least two) */
+   std::vector<char>     data;               /**< numeric/char/logical data (for sparse arrays: nzmax values) */
+   std::vector<mwIndex>  ir;                 /**< row indices of sparse arrays */
+   std::vector<mwIndex>  jc;                 /**< column starts of sparse arrays */
+   std::vector<std::string> fieldnames;      /**< field names of structs */
+   std::vector<mxArray*> elements;           /**< cell elements or struct fields (element-major) */
+};
+
+/* global state of the shim */
+static int calldepth = 0;                                  /* > 0 while a MEX function is running */
+static std::set<mxArray*> temparrays;                      /* arrays created during the current call */
+static std::set<void*> tempmemory;                         /* memory allocated during the current call */
+static std::map<std::string, mexshim::MexFunction> functions; /* functions for mexCallMATLAB() */
+static FILE* output = stdout;                              /* stream for output */
+static bool interruptpending = false;                      /* Ctrl-C flag */
+static size_t narrays = 0;                                 /* number of allocated arrays */
+
+/** error thrown for invalid use of the API */
+static
+void shimError(
+   const char*           fmt,                /**< format string */
+   ...
+   )
+{
+   char buf[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(buf, sizeof(buf), fmt, ap);
+   va_end(ap);
+
+   throw mexshim::MexError(buf);
+}
+
+/** size in bytes of one element of a class */
+static
+size_t classElementSize(
+   mxClassID             classid             /**< class of array */
+   )
+{
+   switch ( classid )
+   {
+   case mxLOGICAL_CLASS:
+      return sizeof(mxLogical);
+   case mxCHAR_CLASS:
+      return sizeof(mxChar);
+   case mxDOUBLE_CLASS:
+      return sizeof(double);
+   case mxSINGLE_CLASS:
+      return sizeof(float);
+   case mxINT8_CLASS:
+   case mxUINT8_CLASS:
+      return 1;
+   case mxINT16_CLASS:
+   case mxUINT16_CLASS:
+      return 2;
+   case mxINT32_CLASS:
+   case mxUINT32_CLASS:
+      return 4;
+   case mxINT64_CLASS:
+   case mxUINT64_CLASS:
+      return 8;
+   case mxCELL_CLASS:
+   case mxSTRUCT_CLASS:
+      return sizeof(mxArray*);
+   default:
+      return 0;
+   }
+}
+
+/** create a new array and register it */
+static
+mxArray* newArray(
+   mxClassID             classid,            /**< class of array */
+   mwSize                ndim,               /**< number of dimensions */
+   const mwSize*         dims                /**< dimensions */
+   )
+{
+   mxArray* arr = new mxArray;
+
+   arr->classid = classid;
+   arr->sparse = false;
+   arr->dims.assign(dims, dims + ndim);
+   while ( arr->dims.size() < 2 )
+      arr->dims.push_back(arr->dims.empty() ? 0 : 1);
+
+   /* remove trailing singleton dimensions */
+   while ( arr->dims.size() > 2 && arr->dims.back() == 1 )
+      arr->dims.pop_back();
+
+   if ( classid != mxCELL_CLASS && classid != mxSTRUCT_CLASS )
+      arr->data.assign(mxGetNumberOfElements(arr) * classElementSize(classid), 0);
+
+   ++narrays;
+   if ( calldepth > 0 )
+      temparrays.insert(arr);
+
+   return arr;
+}
+
+/** create a new matrix */
+static
+mxArray* newMatrix(
+   mxClassID             classid,            /**< class of array */
+   mwSize                m,                  /**< number of rows */
+   mwSize                n                   /**< number of columns */
+   )
+{
+   mwSize dims[2] = {m, n};
+   return newArray(classid, 2, dims);
+}
+
+/** a cell or struct takes over ownership of an array */
+static
+void takeOwnership(
+   mxArray*              arr                 /**< array that becomes a child */
+   )
+{
+   if ( arr != NULL )
+      temparrays.erase(arr);
+}
+
+/** check element index */
+static
+void checkIndex(
+   const mxArray*        arr,                /**< array */
+   mwIndex               i,                  /**< index */
+   const char*           func                /**< calling function */
+   )
+{
+   if ( i >= mxGetNumberOfElements(arr) )
+      shimError("%s: index %zu out of range (number of elements %zu).", func, (size_t) i, mxGetNumberOfElements(arr));
+}
+
+/*
+ * creation and destruction
+ */
+
+mxArray* mxCreateDoubleMatrix(mwSize m, mwSize n, mxComplexity complexity)
+{
+   if ( complexity != mxREAL )
+      shimError("mxCreateDoubleMatrix: complex arrays are not supported.");
+   return newMatrix(mxDOUBLE_CLASS, m, n);
+}
+
+mxArray* mxCreateDoubleScalar(double value)
+{
+   mxArray* arr = newMatrix(mxDOUBLE_CLASS, 1, 1);
+   *mxGetPr(arr) = value;
+   return arr;
+}
+
+mxArray* mxCreateNumericMatrix(mwSize m, mwSize n, mxClassID classid, mxComplexity complexity)
+{
+   mwSize dims[2] = {m, n};
+   return mxCreateNumericArray(2, dims, classid, complexity);
+}
+
+mxArray* mxCreateNumericArray(mwSize ndim, const mwSize* dims, mxClassID classid, mxComplexity complexity)
+{
+   if ( complexity != mxREAL )
+      shimError("mxCreateNumericArray: complex arrays are not supported.");
+   if ( classid < mxDOUBLE_CLASS || classid > mxUINT64_CLASS )
+      shimError("mxCreateNumericArray: class %d is not numeric.", (int) classid);
+   return newArray(classid, ndim, dims);
+}
+
+mxArray* mxCreateLogicalMatrix(mwSize m, mwSize n)
+{
+   return newMatrix(mxLOGICAL_CLASS, m, n);
+}
+
+mxArray* mxCreateLogicalScalar(mxLogical value)
+{
+   mxArray* arr = newMatrix(mxLOGICAL_CLASS, 1, 1);
+   *mxGetLogicals(arr) = value;
+   return arr;
+}
+
+/** create sparse array of given class */
+static
+mxArray* newSparse(
+   mxClassID             classid,            /**< class of array */
+   mwSize                m,                  /**< number of rows */
+   mwSize                n,                  /**< number of columns */
+   mwSize                nzmax               /**< number of nonzeros to allocate */
+   )
+{
+   mwSize dims[2] = {0, 0};
+   mxArray* arr = newArray(classid, 2, dims);
+
+   /* set dimensions afterwards, so that no dense storage is allocated */
+   arr->dims[0] = m;
+   arr->dims[1] = n;
+   if ( nzmax == 0 )
+      nzmax = 1;
+   arr->sparse = true;
+   arr->data.assign(nzmax * classElementSize(classid), 0);
+   arr->ir.assign(nzmax, 0);
+   arr->jc.assign(n + 1, 0);
+
+   return arr;
+}
+
+mxArray* mxCreateSparse(mwSize m, mwSize n, mwSize nzmax, mxComplexity complexity)
+{
+   if ( complexity != mxREAL )
+      shimError("mxCreateSparse: complex arrays are not supported.");
+   return newSparse(mxDOUBLE_CLASS, m, n, nzmax);
+}
+
+mxArray* mxCreateSparseLogicalMatrix(mwSize m, mwSize n, mwSize nzmax)
+{
+   return newSparse(mxLOGICAL_CLASS, m, n, nzmax);
+}
+
+mxArray* mxCreateString(const char* str)
+{
+   size_t len = str != NULL ? strlen(str) : 0;
+   mxArray* arr = newMatrix(mxCHAR_CLASS, len > 0 ? 1 : 0, len);
+   mxChar* chars = mxGetChars(arr);
+
+   for (size_t i = 0; i < len; ++i)
+      chars[i] = (mxChar) (unsigned char) str[i];
+
+   return arr;
+}
+
+mxArray* mxCreateCellMatrix(mwSize m, mwSize n)
+{
+   mxArray* arr = newMatrix(mxCELL_CLASS, m, n);
+   arr->elements.assign(m * n, (mxArray*) NULL);
+   return arr;
+}
+
+mxArray* mxCreateStructMatrix(mwSize m, mwSize n, int nfields, const char** fieldnames)
+{
+   mxArray* arr = newMatrix(mxSTRUCT_CLASS, m, n);
+
+   for (int f = 0; f < nfields; ++f)
+   {
+      if ( mxGetFieldNumber(arr, fieldnames[f]) >= 0 )
+         shimError("mxCreateStructMatrix: duplicate field name '%s'.", fieldnames[f]);
+      arr->fieldnames.push_back(fieldnames[f]);
+   }
+   arr->elements.assign(m * n * (size_t) nfields, (mxArray*) NULL);
+
+   return arr;
+}
+
+mxArray* mxDuplicateArray(const mxArray* arr)
+{
+   mxArray* dup;
+
+   if ( arr == NULL )
+      return NULL;
+
+   dup = newArray(arr->classid, arr->dims.size(), arr->dims.data());
+   dup->sparse = arr->sparse;
+   dup->data = arr->data;
+   dup->ir = arr->ir;
+   dup->jc = arr->jc;
+   dup->fieldnames = arr->fieldnames;
+   dup->elements.resize(arr->elements.size(), (mxArray*) NULL);
+   for (size_t i = 0; i < arr->elements.size(); ++i)
+   {
+      dup->elements[i] = mxDuplicateArray(arr->elements[i]);
+      takeOwnership(dup->elements[i]);
+   }
+
+   return dup;
+}
+
+void mxDestroyArray(mxArray* arr)
+{
+   if ( arr == NULL )
+      return;
+
+   for (size_t i = 0; i < arr->elements.size(); ++i)
+      mxDestroyArray(arr->elements[i]);
+
+   temparrays.erase(arr);
+   --narrays;
+   delete arr;
+}
+
+/*
+ * memory
+ */
+
+void* mxCalloc(mwSize n, mwSize size)
+{
+   void* ptr = calloc(n > 0 ? n : 1, size > 0 ? size : 1);
+
+   if ( ptr == NULL )
+      shimError("mxCalloc: out of memory.");
+   if ( calldepth > 0 )
+      tempmemory.insert(ptr);
+
+   return ptr;
+}
+
+void* mxMalloc(mwSize n)
+{
+   void* ptr = malloc(n > 0 ? n : 1);
+
+   if ( ptr == NULL )
+      shimError("mxMalloc: out of memory.");
+   if ( calldepth > 0 )
+      tempmemory.insert(ptr);
+
+   return ptr;
+}
+
+void* mxRealloc(void* ptr, mwSize size)
+{
+   bool istemp = tempmemory.erase(ptr) > 0;
+   void* newptr = realloc(ptr, size > 0 ? size : 1);
+
+   if ( newptr == NULL )
+      shimError("mxRealloc: out of memory.");
+   if ( istemp || (ptr == NULL && calldepth > 0) )
+      tempmemory.insert(newptr);
+
+   return newptr;
+}
+
+void mxFree(void* ptr)
+{
+   if ( ptr == NULL )
+      return;
+   tempmemory.erase(ptr);
+   free(ptr);
+}
+
+/*
+ * size and type
+ */
+
+mwSize mxGetM(const mxArray* arr)
+{
+   return arr->dims[0];
+}
+
+mwSize mxGetN(const mxArray* arr)
+{
+   mwSize n = 1;
+
+   /* as in MATLAB, all trailing dimensions are collapsed into the number of columns */
+   for (size_t d = 1; d < arr->dims.size(); ++d)
+      n *= arr->dims[d];
+
+   return n;
+}
+
+void mxSetM(mxArray* arr, mwSize m)
+{
+   arr->dims[0] = m;
+}
+
+void mxSetN(mxArray* arr, mwSize n)
+{
+   arr->dims.resize(2);
+   arr->dims[1] = n;
+   if ( arr->sparse )
+      arr->jc.resize(n + 1, arr->jc.empty() ? 0 : arr->jc.back());
+}
+
+mwSize mxGetNumberOfDimensions(const mxArray* arr)
+{
+   return arr->dims.size();
+}
+
+const mwSize* mxGetDimensions(const mxArray* arr)
+{
+   return arr->dims.data();
+}
+
+size_t mxGetNumberOfElements(const mxArray* arr)
+{
+   size_t nelem = 1;
+
+   for (size_t d = 0; d < arr->dims.size(); ++d)
+      nelem *= arr->dims[d];
+
+   return nelem;
+}
+
+size_t mxGetElementSize(const mxArray* arr)
+{
+   return classElementSize(arr->classid);
+}
+
+mxClassID mxGetClassID(const mxArray* arr)
+{
+   return arr->classid;
+}
+
+const char* mxGetClassName(const mxArray* arr)
+{
+   switch ( arr->classid )
+   {
+   case mxCELL_CLASS: return "cell";
+   case mxSTRUCT_CLASS: return "struct";
+   case mxLOGICAL_CLASS: return "logical";
+   case mxCHAR_CLASS: return "char";
+   case mxDOUBLE_CLASS: return "double";
+   case mxSINGLE_CLASS: return "single";
+   case mxINT8_CLASS: return "int8";
+   case mxUINT8_CLASS: return "uint8";
+   case mxINT16_CLASS: return "int16";
+   case mxUINT16_CLASS: return "uint16";
+   case mxINT32_CLASS: return "int32";
+   case mxUINT32_CLASS: return "uint32";
+   case mxINT64_CLASS: return "int64";
+   case mxUINT64_CLASS: return "uint64";
+   case mxFUNCTION_CLASS: return "function_handle";
+   default: return "unknown";
+   }
+}
+
+bool mxIsClass(const mxArray* arr, const char* name)
+{
+   return strcmp(mxGetClassName(arr), name) == 0;
+}
+
+bool mxIsEmpty(const mxArray* arr)
+{
+   return mxGetNumberOfElements(arr) == 0;
+}
+
+bool mxIsDouble(const mxArray* arr)
+{
+   return arr->classid == mxDOUBLE_CLASS;
+}
+
+bool mxIsSingle(const mxArray* arr)
+{
+   return arr->classid == mxSINGLE_CLASS;
+}
+
+bool mxIsNumeric(const mxArray* arr)
+{
+   return arr->classid >= mxDOUBLE_CLASS && arr->classid <= mxUINT64_CLASS;
+}
+
+bool mxIsLogical(const mxArray* arr)
+{
+   return arr->classid == mxLOGICAL_CLASS;
+}
+
+bool mxIsChar(const mxArray* arr)
+{
+   return arr->classid == mxCHAR_CLASS;
+}
+
+bool mxIsCell(const mxArray* arr)
+{
+   return arr->classid == mxCELL_CLASS;
+}
+
+bool mxIsStruct(const mxArray* arr)
+{
+   return arr->classid == mxSTRUCT_CLASS;
+}
+
+bool mxIsSparse(const mxArray* arr)
+{
+   return arr->sparse;
+}
+
+bool mxIsComplex(const mxArray* arr)
+{
+   (void) arr;
+   return false;
+}
+
+bool mxIsInt8(const mxArray* arr) { return arr->classid == mxINT8_CLASS; }
+bool mxIsUint8(const mxArray* arr) { return arr->classid == mxUINT8_CLASS; }
+bool mxIsInt16(const mxArray* arr) { return arr->classid == mxINT16_CLASS; }
+bool mxIsUint16(const mxArray* arr) { return arr->classid == mxUINT16_CLASS; }
+bool mxIsInt32(const mxArray* arr) { return arr->classid == mxINT32_CLASS; }
+bool mxIsUint32(const mxArray* arr) { return arr->classid == mxUINT32_CLASS; }
+bool mxIsInt64(const mxArray* arr) { return arr->classid == mxINT64_CLASS; }
+bool mxIsUint64(const mxArray* arr) { return arr->classid == mxUINT64_CLASS; }
+
+/*
+ * data access
+ */
+
+double* mxGetPr(const mxArray* arr)
+{
+   if ( arr->classid != mxDOUBLE_CLASS )
+      shimError("mxGetPr: array of class %s is not double.", mxGetClassName(arr));
+   return arr->data.empty() ? NULL : (double*) arr->data.data();
+}
+
+void* mxGetData(const mxArray* arr)
+{
+   if ( arr->classid == mxCELL_CLASS || arr->classid == mxSTRUCT_CLASS )
+      return arr->elements.empty() ? NULL : (void*) arr->elements.data();
+   return arr->data.empty() ? NULL : (void*) arr->data.data();
+}
+
+mxLogical* mxGetLogicals(const mxArray* arr)
+{
+   if ( arr->classid != mxLOGICAL_CLASS )
+      return NULL;
+   return (mxLogical*) mxGetData(arr);
+}
+
+mxChar* mxGetChars(const mxArray* arr)
+{
+   if ( arr->classid != mxCHAR_CLASS )
+      return NULL;
+   return (mxChar*) mxGetData(arr);
+}
+
+double mxGetScalar(const mxArray* arr)
+{
+   const void* data = mxGetData(arr);
+
+   if ( data == NULL || arr->classid == mxCELL_CLASS || arr->classid == mxSTRUCT_CLASS )
+      return 0.0;
+
+   switch ( arr->classid )
+   {
+   case mxLOGICAL_CLASS: return *(const mxLogical*) data ? 1.0 : 0.0;
+   case mxCHAR_CLASS: return (double) *(const mxChar*) data;
+   case mxDOUBLE_CLASS: return *(const double*) data;
+   case mxSINGLE_CLASS: return (double) *(const float*) data;
+   case mxINT8_CLASS: return (double) *(const signed char*) data;
+   case mxUINT8_CLASS: return (double) *(const unsigned char*) data;
+   case mxINT16_CLASS: return (double) *(const short*) data;
+   case mxUINT16_CLASS: return (double) *(const unsigned short*) data;
+   case mxINT32_CLASS: return (double) *(const int*) data;
+   case mxUINT32_CLASS: return (double) *(const unsigned int*) data;
+   case mxINT64_CLASS: return (double) *(const long long*) data;
+   case mxUINT64_CLASS: return (double) *(const unsigned long long*) data;
+   default: return 0.0;
+   }
+}
+
+mwIndex* mxGetIr(const mxArray* arr)
+{
+   return arr->sparse ? const_cast<mwIndex*>(arr->ir.data()) : NULL;
+}
+
+mwIndex* mxGetJc(const mxArray* arr)
+{
+   return arr->sparse ? const_cast<mwIndex*>(arr->jc.data()) : NULL;
+}
+
+mwSize mxGetNzmax(const mxArray* arr)
+{
+   return arr->sparse ? arr->ir.size() : mxGetNumberOfElements(arr);
+}
+
+/*
+ * strings
+ */
+
+int mxGetString(const mxArray* arr, char* buf, mwSize buflen)
+{
+   size_t len;
+   const mxChar* chars;
+
+   if ( buflen == 0 )
+      return 1;
+   buf[0] = '\0';
+   if ( arr == NULL || arr->classid != mxCHAR_CLASS )
+      return 1;
+
+   len = mxGetNumberOfElements(arr);
+   chars = mxGetChars(arr);
+   for (size_t i = 0; i < len && i < buflen - 1; ++i)
+      buf[i] = (char) chars[i];
+   buf[len < buflen - 1 ? len : buflen - 1] = '\0';
+
+   return len < buflen ? 0 : 1;
+}
+
+char* mxArrayToString(const mxArray* arr)
+{
+   size_t len;
+   char* str;
+
+   if ( arr == NULL || arr->classid != mxCHAR_CLASS )
+      return NULL;
+
+   len = mxGetNumberOfElements(arr);
+   str = (char*) mxCalloc(len + 1, sizeof(char));
+   (void) mxGetString(arr, str, len + 1);
+
+   return str;
+}
+
+/*
+ * cells
+ */
+
+mxArray* mxGetCell(const mxArray* arr, mwIndex i)
+{
+   if ( arr->classid != mxCELL_CLASS )
+      shimError("mxGetCell: array is not a cell.");
+   checkIndex(arr, i, "mxGetCell");
+   return arr->elements[i];
+}
+
+void mxSetCell(mxArray* arr, mwIndex i, mxArray* value)
+{
+   if ( arr->classid != mxCELL_CLASS )
+      shimError("mxSetCell: array is not a cell.");
+   checkIndex(arr, i, "mxSetCell");
+
+   /* as in MATLAB, the previous value is not freed */
+   arr->elements[i] = value;
+   takeOwnership(value);
+}
+
+/*
+ * structs
+ */
+
+int mxGetNumberOfFields(const mxArray* arr)
+{
+   return arr->classid == mxSTRUCT_CLASS ? (int) arr->fieldnames.size() : 0;
+}
+
+const char* mxGetFieldNameByNumber(const mxArray* arr, int fieldnumber)
+{
+   if ( fieldnumber < 0 || fieldnumber >= mxGetNumberOfFields(arr) )
+      return NULL;
+   return arr->fieldnames[fieldnumber].c_str();
+}
+
+int mxGetFieldNumber(const mxArray* arr, const char* fieldname)
+{
+   for (size_t f = 0; f < arr->fieldnames.size(); ++f)
+   {
+      if ( arr->fieldnames[f] == fieldname )
+         return (int) f;
+   }
+   return -1;
+}
+
+mxArray* mxGetFieldByNumber(const mxArray* arr, mwIndex i, int fieldnumber)
+{
+   if ( arr->classid != mxSTRUCT_CLASS || fieldnumber < 0 || fieldnumber >= mxGetNumberOfFields(arr) )
+      return NULL;
+   if ( i >= mxGetNumberOfElements(arr) )
+      return NULL;
+   return arr->elements[i * arr->fieldnames.size() + fieldnumber];
+}
+
+mxArray* mxGetField(const mxArray* arr, mwIndex i, const char* fieldname)
+{
+   if ( arr == NULL || arr->classid != mxSTRUCT_CLASS )
+      return NULL;
+   return mxGetFieldByNumber(arr, i, mxGetFieldNumber(arr, fieldname));
+}
+
+mxArray* mxGetProperty(const mxArray* arr, mwIndex i, const char* propname)
+{
+   mxArray* value = mxGetField(arr, i, propname);
+
+   /* as in MATLAB, a copy is returned */
+   return value != NULL ? mxDuplicateArray(value) : NULL;
+}
+
+void mxSetFieldByNumber(mxArray* arr, mwIndex i, int fieldnumber, mxArray* value)
+{
+   if ( arr->classid != mxSTRUCT_CLASS )
+      shimError("mxSetFieldByNumber: array is not a struct.");
+   if ( fieldnumber < 0 || fieldnumber >= mxGetNumberOfFields(arr) )
+      shimError("mxSetFieldByNumber: invalid field number %d.", fieldnumber);
+   checkIndex(arr, i, "mxSetFieldByNumber");
+
+   /* as in MATLAB, the previous value is not freed */
+   arr->elements[i * arr->fieldnames.size() + fieldnumber] = value;
+   takeOwnership(value);
+}
+
+void mxSetField(mxArray* arr, mwIndex i, const char* fieldname, mxArray* value)
+{
+   int fieldnumber = mxGetFieldNumber(arr, fieldname);
+
+   if ( fieldnumber < 0 )
+      shimError("mxSetField: struct has no field '%s'.", fieldname);
+   mxSetFieldByNumber(arr, i, fieldnumber, value);
+}
+
+int mxAddField(mxArray* arr, const char* fieldname)
+{
+   size_t nfields;
+   size_t nelem;
+   std::vector<mxArray*> elements;
+   int fieldnumber;
+
+   if ( arr->classid != mxSTRUCT_CLASS )
+      return -1;
+
+   fieldnumber = mxGetFieldNumber(arr, fieldname);
+   if ( fieldnumber >= 0 )
+      return fieldnumber;
+
+   /* re-layout elements with one more field */
+   nfields = arr->fieldnames.size();
+   nelem = mxGetNumberOfElements(arr);
+   elements.assign(nelem * (nfields + 1), (mxArray*) NULL);
+   for (size_t i = 0; i < nelem; ++i)
+   {
+      for (size_t f = 0; f < nfields; ++f)
+         elements[i * (nfields + 1) + f] = arr->elements[i * nfields + f];
+   }
+   arr->elements.swap(elements);
+   arr->fieldnames.push_back(fieldname);
+
+   return (int) nfields;
+}
+
+/*
+ * special values
+ */
+
+double mxGetInf(void)
+{
+   return std::numeric_limits<double>::infinity();
+}
+
+double mxGetNaN(void)
+{
+   return std::numeric_limits<double>::quiet_NaN();
+}
+
+double mxGetEps(void)
+{
+   return std::numeric_limits<double>::epsilon();
+}
+
+bool mxIsInf(double value)
+{
+   return std::isinf(value);
+}
+
+bool mxIsNaN(double value)
+{
+   return std::isnan(value);
+}
+
+bool mxIsFinite(double value)
+{
+   return std::isfinite(value);
+}
+
+/*
+ * MEX functions
+ */
+
+int mexPrintf(const char* fmt, ...)
+{
+   va_list ap;
+   int n;
+
+   if ( output == NULL )
+      return 0;
+
+   va_start(ap, fmt);
+   n = vfprintf(output, fmt, ap);
+   va_end(ap);
+
+   return n;
+}
+
+void mexErrMsgTxt(const char* msg)
+{
+   throw mexshim::MexError(msg != NULL ? msg : "");
+}
+
+void mexErrMsgIdAndTxt(const char* id, const char* fmt, ...)
+{
+   char buf[2048];
+   va_list ap;
+
+   (void) id;
+   va_start(ap, fmt);
+   vsnprintf(buf, sizeof(buf), fmt, ap);
+   va_end(ap);
+
+   throw mexshim::MexError(buf);
+}
+
+void mexWarnMsgTxt(const char* msg)
+{
+   if ( output != NULL )
+      fprintf(output, "Warning: %s\n", msg);
+}
+
+void mexWarnMsgIdAndTxt(const char* id, const char* fmt, ...)
+{
+   va_list ap;
+
+   (void) id;
+   if ( output == NULL )
+      return;
+
+   fprintf(output, "Warning: ");
+   va_start(ap, fmt);
+   vfprintf(output, fmt, ap);
+   va_end(ap);
+   fprintf(output, "\n");
+}
+
+int mexEvalString(const char* command)
+{
+   /* only used for flushing the display */
+   (void) command;
+   if ( output != NULL )
+      fflush(output);
+   return 0;
+}
+
+int mexCallMATLAB(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[], const char* name)
+{
+   std::map<std::string, mexshim::MexFunction>::const_iterator it;
+   std::string fname(name);
+
+   /* feval with a function name as first argument */
+   if ( fname == "feval" )
+   {
+      char* str;
+
+      if ( nrhs < 1 || ! mxIsChar(prhs[0]) )
+         shimError("mexCallMATLAB: feval needs a registered function name as first argument.");
+      str = mxArrayToString(prhs[0]);
+      fname = str;
+      mxFree(str);
+      ++prhs;
+      --nrhs;
+   }
+
+   it = functions.find(fname);
+   if ( it == functions.end() )
+      shimError("mexCallMATLAB: undefined function '%s'.", fname.c_str());
+
+   it->second(nlhs, plhs, nrhs, (const mxArray**) prhs);
+
+   return 0;
+}
+
+mxArray* mexCallMATLABWithTrap(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[], const char* name)
+{
+   const char* fnames[2] = {"identifier", "message"};
+   mxArray* exception;
+
+   try
+   {
+      mexCallMATLAB(nlhs, plhs, nrhs, prhs, name);
+   }
+   catch (const mexshim::MexError& e)
+   {
+      /* outputs are not assigned on errors */
+      for (int i = 0; i < nlhs; ++i)
+         plhs[i] = NULL;
+      exception = mxCreateStructMatrix(1, 1, 2, fnames);
+      mxSetField(exception, 0, "identifier", mxCreateString(""));
+      mxSetField(exception, 0, "message", mxCreateString(e.what()));
+      return exception;
+   }
+
+   return NULL;
+}
+
+bool utIsInterruptPending(void)
+{
+   return interruptpending;
+}
+
+void utSetInterruptPending(bool pending)
+{
+   interruptpending = pending;
+}
+
+/*
+ * driver interface
+ */
+
+/** free all temporaries of the current call */
+static
+void releaseTemporaries(void)
+{
+   std::set<mxArray*> arrays;
+   std::set<void*> memory;
+
+   arrays.swap(temparrays);
+   memory.swap(tempmemory);
+
+   for (std::set<mxArray*>::iterator it = arrays.begin(); it != arrays.end(); ++it)
+      mxDestroyArray(*it);
+   for (std::set<void*>::iterator it = memory.begin(); it != memory.end(); ++it)
+      free(*it);
+}
+
+void mexshim::call(
+   MexFunction           fn,
+   int                   nlhs,
+   mxArray*              plhs[],
+   int                   nrhs,
+   const mxArray*        prhs[]
+   )
+{
+   /* as in MATLAB, plhs[0] may be assigned even if no output is requested */
+   int nout = nlhs > 0 ? nlhs : 1;
+
+   if ( calldepth > 0 )
+      shimError("mexshim::call: nested calls are not supported.");
+
+   for (int i = 0; i < nout; ++i)
+      plhs[i] = NULL;
+
+   ++calldepth;
+   try
+   {
+      fn(nlhs, plhs, nrhs, prhs);
+   }
+   catch (...)
+   {
+      --calldepth;
+      for (int i = 0; i < nout; ++i)
+         plhs[i] = NULL;
+      releaseTemporaries();
+      throw;
+   }
+   --calldepth;
+
+   /* returned arrays belong to the caller */
+   for (int i = 0; i < nout; ++i)
+      temparrays.erase(plhs[i]);
+   releaseTemporaries();
+}
+
+void mexshim::registerFunction(
+   const std::string&    name,
+   MexFunction           fn
+   )
+{
+   functions[name] = fn;
+}
+
+void mexshim::setOutput(
+   FILE*                 stream
+   )
+{
+   output = stream;
+}
+
+size_t mexshim::nAllocatedArrays()
+{
+   return narrays;
+}
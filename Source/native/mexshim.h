@@ -0,0 +1,63 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * Driver interface of the native MEX shim: calls a mexFunction() with MATLAB semantics, i.e., errors are reported as
+ * exceptions and memory allocated with mxCalloc() or arrays that are not returned are freed after the call.
+ */
+
+#ifndef MEXSHIM_H
+#define MEXSHIM_H
+
+#include <stdio.h>
+#include <stdexcept>
+#include <string>
+#include "mex.h"
+
+namespace mexshim
+{
+
+/** error raised by mexErrMsgTxt() */
+class MexError : public std::runtime_error
+{
+public:
+   explicit MexError(
+      const std::string&    msg                 /**< error message */
+      )
+      : std::runtime_error(msg)
+   {}
+};
+
+/** signature of mexFunction() */
+typedef void (*MexFunction)(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[]);
+
+/** call a MEX function
+ *
+ *  As in MATLAB, plhs needs space for at least one output even if nlhs is 0. Arrays returned in plhs are owned by
+ *  the caller and have to be freed with mxDestroyArray(). All other arrays and memory created during the call are
+ *  freed, also if an error is thrown.
+ */
+void call(
+   MexFunction           fn,                 /**< MEX function */
+   int                   nlhs,               /**< number of outputs */
+   mxArray*              plhs[],             /**< array of pointers to output arguments */
+   int                   nrhs,               /**< number of inputs */
+   const mxArray*        prhs[]              /**< array of pointers to input arguments */
+   );
+
+/** register a function that can be called via mexCallMATLAB() or feval */
+void registerFunction(
+   const std::string&    name,               /**< name of function */
+   MexFunction           fn                  /**< implementation */
+   );
+
+/** set stream for mexPrintf() and warnings (NULL suppresses all output) */
+void setOutput(
+   FILE*                 stream              /**< output stream */
+   );
+
+/** get number of arrays currently allocated (for leak checks) */
+size_t nAllocatedArrays();
+
+}
+
+#endif
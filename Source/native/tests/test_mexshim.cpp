@@ -0,0 +1,255 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * Tests of the native mex/matrix API shim.
+ */
+
+#include "mexshim.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <cmath>
+
+static int nfailed = 0;
+
+#define CHECK(cond) do { if ( ! (cond) ) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); ++nfailed; } } while ( 0 )
+
+/** MEX function creating temporaries and returning a struct */
+static
+void mexCreate(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   const char* fnames[2] = {"x", "name"};
+   double* tmp;
+   char* str;
+
+   (void) nlhs;
+   (void) nrhs;
+
+   /* temporaries that are not freed explicitly */
+   (void) mxCreateDoubleMatrix(10, 10, mxREAL);
+   tmp = (double*) mxCalloc(100, sizeof(double));
+   tmp[99] = 1.0;
+
+   str = mxArrayToString(prhs[0]);
+   plhs[0] = mxCreateStructMatrix(1, 1, 2, fnames);
+   mxSetField(plhs[0], 0, "x", mxCreateDoubleScalar(mxGetScalar(prhs[1])));
+   mxSetField(plhs[0], 0, "name", mxCreateString(str));
+   mxFree(str);
+}
+
+/** MEX function raising an error after creating temporaries */
+static
+void mexFail(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   (void) nlhs;
+   (void) nrhs;
+   (void) prhs;
+
+   plhs[0] = mxCreateCellMatrix(2, 1);
+   mxSetCell(plhs[0], 0, mxCreateDoubleScalar(1.0));
+   (void) mxCalloc(10, sizeof(int));
+   mexErrMsgTxt("Expected failure.");
+}
+
+/** function called through mexCallMATLAB */
+static
+void mexTimesTwo(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   (void) nlhs;
+   (void) nrhs;
+   plhs[0] = mxCreateDoubleScalar(2.0 * mxGetScalar(prhs[0]));
+}
+
+/** MEX function using mexCallMATLAB */
+static
+void mexCallback(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   mxArray* args[2];
+   mxArray* res[1];
+
+   (void) nlhs;
+   (void) nrhs;
+
+   args[0] = mxCreateString("timestwo");
+   args[1] = mxDuplicateArray(prhs[0]);
+   mexCallMATLAB(1, res, 2, args, "feval");
+   plhs[0] = res[0];
+}
+
+/** MEX function trapping the error of a function called through mexCallMATLABWithTrap, returns its message */
+static
+void mexTrapCallback(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   mxArray* args[1];
+   mxArray* res[1] = {NULL};
+   mxArray* exception;
+
+   (void) nlhs;
+   (void) nrhs;
+   (void) prhs;
+
+   args[0] = mxCreateString("fail");
+   exception = mexCallMATLABWithTrap(1, res, 1, args, "feval");
+   CHECK( exception != NULL && res[0] == NULL );
+   plhs[0] = mxGetProperty(exception, 0, "message");
+   mxDestroyArray(exception);
+   mxDestroyArray(args[0]);
+}
+
+/** dense, sparse and char arrays */
+static
+void testArrays(void)
+{
+   mxArray* A;
+   mxArray* S;
+   mxArray* s;
+   mxArray* I;
+   mxArray* E;
+   char buf[4];
+
+   A = mxCreateDoubleMatrix(2, 3, mxREAL);
+   CHECK( mxGetM(A) == 2 && mxGetN(A) == 3 && mxGetNumberOfElements(A) == 6 );
+   CHECK( mxIsDouble(A) && mxIsNumeric(A) && ! mxIsSparse(A) && ! mxIsEmpty(A) );
+   mxGetPr(A)[5] = 4.0;
+   CHECK( mxGetPr(A)[5] == 4.0 && mxGetPr(A)[0] == 0.0 );
+   CHECK( mxGetIr(A) == NULL );
+
+   S = mxCreateSparse(3, 2, 4, mxREAL);
+   CHECK( mxIsSparse(S) && mxGetNzmax(S) == 4 && mxGetJc(S)[2] == 0 );
+   mxGetJc(S)[1] = 1;
+   mxGetJc(S)[2] = 1;
+   mxGetIr(S)[0] = 2;
+   mxGetPr(S)[0] = 3.0;
+
+   s = mxCreateString("abcdef");
+   CHECK( mxIsChar(s) && mxGetN(s) == 6 );
+   CHECK( mxGetString(s, buf, sizeof(buf)) == 1 && strcmp(buf, "abc") == 0 );
+
+   I = mxCreateNumericMatrix(1, 2, mxINT32_CLASS, mxREAL);
+   ((int*) mxGetData(I))[0] = -7;
+   CHECK( mxIsInt32(I) && mxGetElementSize(I) == 4 && mxGetScalar(I) == -7.0 );
+   CHECK( strcmp(mxGetClassName(I), "int32") == 0 );
+
+   CHECK( mxIsInf(mxGetInf()) && mxIsNaN(mxGetNaN()) );
+   E = mxCreateDoubleMatrix(0, 0, mxREAL);
+   CHECK( mxIsEmpty(E) );
+
+   mxDestroyArray(A);
+   mxDestroyArray(S);
+   mxDestroyArray(s);
+   mxDestroyArray(I);
+   mxDestroyArray(E);
+}
+
+/** structs and cells */
+static
+void testStructs(void)
+{
+   const char* fnames[1] = {"a"};
+   mxArray* st;
+   mxArray* c;
+
+   st = mxCreateStructMatrix(1, 2, 1, fnames);
+   mxSetField(st, 1, "a", mxCreateDoubleScalar(5.0));
+   CHECK( mxGetField(st, 0, "a") == NULL );
+   CHECK( mxGetScalar(mxGetField(st, 1, "a")) == 5.0 );
+   CHECK( mxGetField(st, 0, "b") == NULL );
+   CHECK( mxAddField(st, "b") == 1 );
+   CHECK( mxGetNumberOfFields(st) == 2 && strcmp(mxGetFieldNameByNumber(st, 1), "b") == 0 );
+   CHECK( mxGetScalar(mxGetFieldByNumber(st, 1, 0)) == 5.0 );
+
+   c = mxCreateCellMatrix(1, 2);
+   mxSetCell(c, 1, mxDuplicateArray(st));
+   CHECK( mxGetCell(c, 0) == NULL && mxIsStruct(mxGetCell(c, 1)) );
+   CHECK( mxGetScalar(mxGetField(mxGetCell(c, 1), 1, "a")) == 5.0 );
+
+   mxDestroyArray(st);
+   mxDestroyArray(c);
+}
+
+/** calling MEX functions */
+static
+void testCall(void)
+{
+   size_t narrays = mexshim::nAllocatedArrays();
+   mxArray* in[2];
+   mxArray* out[1];
+   char msg[32];
+   bool failed = false;
+
+   in[0] = mxCreateString("test");
+   in[1] = mxCreateDoubleScalar(3.0);
+   mexshim::call(mexCreate, 1, out, 2, (const mxArray**) in);
+   CHECK( mxIsStruct(out[0]) );
+   CHECK( mxGetScalar(mxGetField(out[0], 0, "x")) == 3.0 );
+   CHECK( mxIsChar(mxGetField(out[0], 0, "name")) );
+   mxDestroyArray(out[0]);
+
+   /* errors become exceptions, temporaries are freed */
+   try
+   {
+      mexshim::call(mexFail, 1, out, 0, NULL);
+   }
+   catch (const mexshim::MexError& e)
+   {
+      failed = strcmp(e.what(), "Expected failure.") == 0;
+   }
+   CHECK( failed );
+   CHECK( out[0] == NULL );
+
+   mexshim::registerFunction("timestwo", mexTimesTwo);
+   mexshim::call(mexCallback, 1, out, 1, (const mxArray**) &in[1]);
+   CHECK( mxGetScalar(out[0]) == 6.0 );
+   mxDestroyArray(out[0]);
+
+   /* trapped errors are returned as exception */
+   mexshim::registerFunction("fail", mexFail);
+   mexshim::call(mexTrapCallback, 1, out, 0, NULL);
+   CHECK( mxIsChar(out[0]) && mxGetString(out[0], msg, sizeof(msg)) == 0 && strcmp(msg, "Expected failure.") == 0 );
+   mxDestroyArray(out[0]);
+
+   mxDestroyArray(in[0]);
+   mxDestroyArray(in[1]);
+   CHECK( mexshim::nAllocatedArrays() == narrays );
+}
+
+int main(void)
+{
+   testArrays();
+   testStructs();
+   testCall();
+
+   if ( nfailed > 0 )
+   {
+      printf("%d checks failed.\n", nfailed);
+      return 1;
+   }
+   printf("All checks passed.\n");
+
+   return 0;
+}
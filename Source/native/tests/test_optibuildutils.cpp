@@ -0,0 +1,94 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * Tests of the size checks in opti_build_utils.h on arrays that are larger than SCIP can index.
+ */
+
+#include "mexshim.h"
+#include "opti_build_utils.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+static int nfailed = 0;
+
+#define CHECK(cond) do { if ( ! (cond) ) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); ++nfailed; } } while ( 0 )
+
+/** MEX function checking the number of elements of its input like the builders do */
+static
+void mexCheckSize(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   (void) nlhs;
+   (void) nrhs;
+
+   CheckIntSize(mxGetM(prhs[0]), "rows");
+   CheckIntSize(mxGetN(prhs[0]), "columns");
+   plhs[0] = mxCreateDoubleScalar((double) mxGetNumberOfElements(prhs[0]));
+}
+
+/** returns the error message of calling mexCheckSize() on an empty array of the given size (or "" if accepted) */
+static
+std::string checkSize(
+   mwSize                m,                  /**< number of rows */
+   mwSize                n                   /**< number of columns */
+   )
+{
+   mxArray* arr = mxCreateDoubleMatrix(0, 0, mxREAL);
+   mxArray* plhs[1];
+   std::string msg;
+
+   /* only the dimensions are set, the data is never read */
+   mxSetM(arr, m);
+   mxSetN(arr, n);
+
+   try
+   {
+      mexshim::call(mexCheckSize, 1, plhs, 1, (const mxArray**) &arr);
+      mxDestroyArray(plhs[0]);
+   }
+   catch (const mexshim::MexError& e)
+   {
+      msg = e.what();
+   }
+   mxDestroyArray(arr);
+
+   return msg;
+}
+
+int main(void)
+{
+   const mwSize big = (mwSize) INT_MAX + 1;
+   std::string msg;
+
+   mexshim::setOutput(NULL);
+
+   /* sizes up to INT_MAX are accepted */
+   CHECK( checkSize(0, 0).empty() );
+   CHECK( checkSize((mwSize) INT_MAX, 1).empty() );
+   CHECK( checkSize(1, (mwSize) INT_MAX).empty() );
+
+   /* larger sizes are rejected with the offending size in the message */
+   msg = checkSize(big, 1);
+   CHECK( msg.find("number of rows (2147483648) exceeds the maximum of 2147483647") != std::string::npos );
+   msg = checkSize(1, big + 4);
+   CHECK( msg.find("number of columns (2147483652)") != std::string::npos );
+   msg = checkSize((mwSize) 1 << 40, (mwSize) 1 << 40);
+   CHECK( msg.find("number of rows (1099511627776)") != std::string::npos );
+
+   CHECK( mexshim::nAllocatedArrays() == 0 );
+
+   if ( nfailed > 0 )
+   {
+      printf("%d checks failed.\n", nfailed);
+      return 1;
+   }
+   printf("All checks passed.\n");
+
+   return 0;
+}
@@ -0,0 +1,161 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * Tests of the scipvar expression graph (scipexprmex) through the native mex shim.
+ */
+
+#include "mexshim.h"
+
+#include <stdio.h>
+#include <cmath>
+#include <vector>
+
+static int nfailed = 0;
+
+#define CHECK(cond) do { if ( ! (cond) ) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); ++nfailed; } } while ( 0 )
+
+/** dense double matrix */
+static
+mxArray* matrix(
+   size_t                m,                  /**< number of rows */
+   size_t                n,                  /**< number of columns */
+   const std::vector<double>& vals           /**< values in column-major order */
+   )
+{
+   mxArray* arr = mxCreateDoubleMatrix(m, n, mxREAL);
+   for (size_t i = 0; i < vals.size() && i < m * n; ++i)
+      mxGetPr(arr)[i] = vals[i];
+   return arr;
+}
+
+/** call scipexprmex(cmd, args...), frees the arguments and returns the first output */
+static
+mxArray* expr(
+   const char*           cmd,                /**< command */
+   std::vector<mxArray*> args                /**< arguments (freed) */
+   )
+{
+   mxArray* out[1];
+
+   args.insert(args.begin(), mxCreateString(cmd));
+   try
+   {
+      mexshim::call(mexFunction, 1, out, (int) args.size(), (const mxArray**) args.data());
+   }
+   catch (...)
+   {
+      for (size_t i = 0; i < args.size(); ++i)
+         mxDestroyArray(args[i]);
+      throw;
+   }
+   for (size_t i = 0; i < args.size(); ++i)
+      mxDestroyArray(args[i]);
+
+   return out[0];
+}
+
+/** emit instructions of a single node */
+static
+std::vector<double> emit(
+   const mxArray*        ids                 /**< node id */
+   )
+{
+   mxArray* ins = expr("emit", std::vector<mxArray*>(1, mxDuplicateArray(ids)));
+   const mxArray* list = mxGetCell(ins, 0);
+   std::vector<double> res(mxGetPr(list), mxGetPr(list) + mxGetNumberOfElements(list));
+
+   mxDestroyArray(ins);
+   return res;
+}
+
+/** compare instruction list, where NaN arguments match NaN */
+static
+bool sameInstr(
+   const std::vector<double>& a,             /**< first list */
+   const std::vector<double>& b              /**< second list */
+   )
+{
+   if ( a.size() != b.size() )
+      return false;
+   for (size_t i = 0; i < a.size(); ++i)
+   {
+      if ( a[i] != b[i] && ! (std::isnan(a[i]) && std::isnan(b[i])) )
+         return false;
+   }
+   return true;
+}
+
+int main(void)
+{
+   const double NaN = mxGetNaN();
+   mxArray* x;
+   mxArray* y;
+   mxArray* two;
+   mxArray* aff;
+   bool failed = false;
+
+   mexshim::setOutput(NULL);
+   mxDestroyArray(expr("reset", std::vector<mxArray*>()));
+
+   /* variables x0, x1, x2 */
+   x = expr("var", std::vector<mxArray*>(1, matrix(3, 1, {0, 1, 2})));
+   CHECK( mxGetNumberOfElements(x) == 3 );
+   y = matrix(1, 1, {mxGetPr(x)[1]});
+   CHECK( sameInstr(emit(y), {1, 1}) );
+   mxDestroyArray(y);
+
+   /* x0 + 2*x2 via a linear map */
+   y = expr("linmap", {matrix(1, 3, {1, 0, 2}), mxDuplicateArray(x)});
+   {
+      mxArray* out[4];
+      mxArray* in[3] = {mxCreateString("affine"), y, mxCreateDoubleScalar(3.0)};
+
+      mexshim::call(mexFunction, 4, out, 3, (const mxArray**) in);
+      CHECK( mxIsSparse(out[0]) && mxGetM(out[0]) == 3 && mxGetN(out[0]) == 1 );
+      CHECK( mxGetJc(out[0])[1] == 2 && mxGetPr(out[0])[0] == 1.0 && mxGetPr(out[0])[1] == 2.0 );
+      CHECK( mxGetScalar(out[1]) == 0.0 );
+      CHECK( mxGetScalar(out[3]) == -1.0 );
+      for (int i = 0; i < 4; ++i)
+         mxDestroyArray(out[i]);
+      mxDestroyArray(in[0]);
+      mxDestroyArray(in[2]);
+   }
+
+   /* 2 - (x0 + 2*x2) */
+   two = expr("num", std::vector<mxArray*>(1, matrix(1, 1, {2})));
+   aff = expr("binary", {matrix(1, 1, {6}), mxDuplicateArray(two), y});
+   CHECK( sameInstr(emit(aff), {1, 0, 0, 2, 1, 2, 3, NaN, 5, NaN, 0, 2, 6, 1}) );
+   mxDestroyArray(aff);
+
+   /* exp(x0) */
+   y = matrix(1, 1, {mxGetPr(x)[0]});
+   aff = expr("unary", {matrix(1, 1, {10}), y});
+   CHECK( sameInstr(emit(aff), {1, 0, 10, NaN}) );
+   mxDestroyArray(aff);
+
+   /* size mismatch is an error */
+   try
+   {
+      mxDestroyArray(expr("binary", {matrix(1, 1, {5}), mxDuplicateArray(x), matrix(2, 1, {0, 1})}));
+   }
+   catch (const mexshim::MexError&)
+   {
+      failed = true;
+   }
+   CHECK( failed );
+
+   mxDestroyArray(two);
+   mxDestroyArray(x);
+   mxDestroyArray(expr("reset", std::vector<mxArray*>()));
+
+   CHECK( mexshim::nAllocatedArrays() == 0 );
+
+   if ( nfailed > 0 )
+   {
+      printf("%d checks failed.\n", nfailed);
+      return 1;
+   }
+   printf("All checks passed.\n");
+
+   return 0;
+}
@@ -0,0 +1,1228 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * Solves small problems through the scip MEX function via the native mex shim.
+ */
+
+#include "mexshim.h"
+#include "scipnlmex.h"
+#include <scip/scipdefplugins.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <cmath>
+#include <string>
+#include <vector>
+
+static int nfailed = 0;
+
+#define CHECK(cond) do { if ( ! (cond) ) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); ++nfailed; } } while ( 0 )
+
+/** column vector */
+static
+mxArray* vector(
+   size_t                n,                  /**< length */
+   const double*         vals                /**< values */
+   )
+{
+   mxArray* arr = mxCreateDoubleMatrix(n, 1, mxREAL);
+   memcpy(mxGetPr(arr), vals, n * sizeof(double));
+   return arr;
+}
+
+/** sparse matrix from dense values in column-major order */
+static
+mxArray* sparse(
+   size_t                m,                  /**< number of rows */
+   size_t                n,                  /**< number of columns */
+   const double*         vals                /**< values */
+   )
+{
+   mxArray* arr = mxCreateSparse(m, n, m * n, mxREAL);
+   size_t nnz = 0;
+
+   for (size_t j = 0; j < n; ++j)
+   {
+      for (size_t i = 0; i < m; ++i)
+      {
+         if ( vals[j * m + i] != 0.0 )
+         {
+            mxGetIr(arr)[nnz] = i;
+            mxGetPr(arr)[nnz++] = vals[j * m + i];
+         }
+      }
+      mxGetJc(arr)[j + 1] = nnz;
+   }
+   return arr;
+}
+
+/** replaces input k of scip */
+static
+void setInput(
+   mxArray*              prhs[],             /**< inputs */
+   int                   k,                  /**< index of input */
+   mxArray*              value               /**< new value */
+   )
+{
+   mxDestroyArray(prhs[k]);
+   prhs[k] = value;
+}
+
+/** adds a field to the options structure prhs[12] */
+static
+void addOption(
+   mxArray*              prhs[],             /**< inputs */
+   const char*           name,               /**< option name (not yet in the options) */
+   mxArray*              value               /**< option value */
+   )
+{
+   mxAddField(prhs[12], name);
+   mxSetField(prhs[12], 0, name, value);
+}
+
+/** creates the 13 inputs of scip for min f'x s.t. Ax <= rhs with variable types xtype and options display = 0 */
+static
+void createProblem(
+   mxArray*              prhs[],             /**< array of 13 inputs to create */
+   size_t                n,                  /**< number of variables */
+   const double*         f,                  /**< objective */
+   size_t                m,                  /**< number of rows */
+   const double*         A,                  /**< dense constraint matrix (column-major) */
+   const double*         rhs,                /**< right hand sides */
+   const char*           xtype               /**< variable types */
+   )
+{
+   const char* fnames[1] = {"display"};
+
+   for (int i = 0; i < 13; ++i)
+      prhs[i] = mxCreateDoubleMatrix(0, 0, mxREAL);
+   setInput(prhs, 1, vector(n, f));
+   setInput(prhs, 2, sparse(m, n, A));
+   setInput(prhs, 4, vector(m, rhs));
+   setInput(prhs, 7, mxCreateString(xtype));
+   setInput(prhs, 12, mxCreateStructMatrix(1, 1, 1, fnames));
+   mxSetField(prhs[12], 0, "display", mxCreateDoubleScalar(0.0));
+}
+
+/** creates the inputs of scip for min -x1 - 2 x2 s.t. x1 + x2 <= 1 over binaries (optimal value -2) */
+static
+void createPairProblem(
+   mxArray*              prhs[]              /**< array of 13 inputs to create */
+   )
+{
+   const double f[2] = {-1.0, -2.0};
+   const double A[2] = {1.0, 1.0};
+   const double rhs[1] = {1.0};
+
+   createProblem(prhs, 2, f, 1, A, rhs, "BB");
+}
+
+/** calls scip and destroys the inputs, returns the error message (or "" and the outputs, to be destroyed by the caller) */
+static
+std::string callScip(
+   int                   nlhs,               /**< number of outputs */
+   mxArray*              plhs[],             /**< outputs */
+   int                   nrhs,               /**< number of inputs */
+   mxArray*              prhs[]              /**< inputs (destroyed) */
+   )
+{
+   std::string msg;
+
+   try
+   {
+      mexshim::call(mexFunction, nlhs, plhs, nrhs, (const mxArray**) prhs);
+   }
+   catch (const mexshim::MexError& e)
+   {
+      msg = e.what();
+   }
+
+   for (int i = 0; i < nrhs; ++i)
+      mxDestroyArray(prhs[i]);
+
+   return msg;
+}
+
+/** destroys the outputs of scip */
+static
+void destroyOutputs(
+   int                   nlhs,               /**< number of outputs */
+   mxArray*              plhs[]              /**< outputs */
+   )
+{
+   for (int i = 0; i < nlhs; ++i)
+      mxDestroyArray(plhs[i]);
+}
+
+/** solve min f'x s.t. Ax <= rhs, 0 <= x, with A = [1 2; 3 1] */
+static
+void solve(
+   const char*           xtype,              /**< variable types */
+   bool                  typed,              /**< pass dense int32 A, single f and int32 rhs and lb instead of doubles */
+   double*               fval,               /**< objective value */
+   double*               exitflag            /**< SCIP status */
+   )
+{
+   const double f[2] = {-1.0, -1.0};
+   const double A[4] = {1.0, 3.0, 2.0, 1.0};
+   const double lhs[2] = {-mxGetInf(), -mxGetInf()};
+   const double rhs[2] = {4.0, 6.0};
+   const double lb[2] = {0.0, 0.0};
+   const double ub[2] = {mxGetInf(), mxGetInf()};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+
+   createProblem(prhs, 2, f, 2, A, rhs, xtype);
+   setInput(prhs, 3, vector(2, lhs));
+   setInput(prhs, 5, vector(2, lb));
+   setInput(prhs, 6, vector(2, ub));
+
+   if ( typed )
+   {
+      /* dense int32 A in column-major order */
+      int32_t vals[4] = {1, 3, 2, 1};
+      setInput(prhs, 2, mxCreateNumericMatrix(2, 2, mxINT32_CLASS, mxREAL));
+      memcpy(mxGetData(prhs[2]), vals, sizeof(vals));
+
+      setInput(prhs, 1, mxCreateNumericMatrix(2, 1, mxSINGLE_CLASS, mxREAL));
+      ((float*) mxGetData(prhs[1]))[0] = (float) f[0];
+      ((float*) mxGetData(prhs[1]))[1] = (float) f[1];
+      setInput(prhs, 4, mxCreateNumericMatrix(2, 1, mxINT32_CLASS, mxREAL));
+      ((int32_t*) mxGetData(prhs[4]))[0] = (int32_t) rhs[0];
+      ((int32_t*) mxGetData(prhs[4]))[1] = (int32_t) rhs[1];
+      setInput(prhs, 5, mxCreateNumericMatrix(2, 1, mxINT32_CLASS, mxREAL));
+   }
+
+   CHECK( callScip(4, plhs, 13, prhs).empty() );
+
+   CHECK( mxGetNumberOfElements(plhs[0]) == 2 );
+   CHECK( mxIsStruct(plhs[3]) && mxGetField(plhs[3], 0, "BBnodes") != NULL );
+   *fval = mxGetScalar(plhs[1]);
+   *exitflag = mxGetScalar(plhs[2]);
+   destroyOutputs(4, plhs);
+}
+
+/** solve the LP of solve() through the LP fast path, possibly warm started, returns the final basis */
+static
+mxArray* solveLP(
+   const mxArray*        basis,              /**< basis to start from (or NULL) */
+   double*               fval,               /**< objective value */
+   double*               lambda,             /**< duals of the two rows */
+   double*               niter               /**< number of LP iterations */
+   )
+{
+   const double f[2] = {-1.0, -1.0};
+   const double A[4] = {1.0, 3.0, 2.0, 1.0};
+   const double rhs[2] = {4.0, 6.0};
+   const double lb[2] = {0.0, 0.0};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   mxArray* finalbasis;
+
+   createProblem(prhs, 2, f, 2, A, rhs, "CC");
+   setInput(prhs, 5, vector(2, lb));
+   if ( basis != NULL )
+      addOption(prhs, "basis", mxDuplicateArray(basis));
+
+   CHECK( callScip(4, plhs, 13, prhs).empty() );
+
+   *fval = mxGetScalar(plhs[1]);
+   *niter = mxGetScalar(mxGetField(plhs[3], 0, "LPiter"));
+   CHECK( mxGetNumberOfElements(mxGetField(plhs[3], 0, "Lambda")) == 2 );
+   CHECK( mxGetNumberOfElements(mxGetField(plhs[3], 0, "RedCost")) == 2 );
+   memcpy(lambda, mxGetPr(mxGetField(plhs[3], 0, "Lambda")), 2 * sizeof(double));
+   finalbasis = mxDuplicateArray(mxGetField(plhs[3], 0, "Basis"));
+   destroyOutputs(4, plhs);
+
+   return finalbasis;
+}
+
+/** solve the LP of solveLP() with an invalid basis, returns the error message */
+static
+std::string solveInvalidBasis(void)
+{
+   const double f[2] = {-1.0, -1.0};
+   const double A[4] = {1.0, 3.0, 2.0, 1.0};
+   const double rhs[2] = {4.0, 6.0};
+   const double lb[2] = {0.0, 0.0};
+   const double cstat[2] = {1.0, 5.0};
+   const char* bnames[2] = {"cstat", "rstat"};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   mxArray* basis;
+
+   createProblem(prhs, 2, f, 2, A, rhs, "CC");
+   setInput(prhs, 5, vector(2, lb));
+   basis = mxCreateStructMatrix(1, 1, 2, bnames);
+   mxSetField(basis, 0, "cstat", vector(2, cstat));
+   mxSetField(basis, 0, "rstat", vector(2, cstat));
+   addOption(prhs, "basis", basis);
+
+   return callScip(4, plhs, 13, prhs);
+}
+
+/** lazy constraint callback [A, lhs, rhs] = lazyPair(X) returning x1 + x2 <= 1 for candidates that violate it */
+static
+void lazyPair(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   const double* X = mxGetPr(prhs[0]);
+   bool violated = false;
+
+   (void) nlhs;
+   (void) nrhs;
+
+   for (size_t k = 0; k < mxGetN(prhs[0]); ++k)
+      violated = violated || X[2 * k] + X[2 * k + 1] > 1.5;
+
+   plhs[1] = mxCreateDoubleMatrix(0, 0, mxREAL);
+   if ( violated )
+   {
+      mwIndex jc[3] = {0, 1, 2};
+      mwIndex ir[2] = {0, 0};
+      double pr[2] = {1.0, 1.0};
+
+      plhs[0] = mxCreateSparse(1, 2, 2, mxREAL);
+      memcpy(mxGetJc(plhs[0]), jc, sizeof(jc));
+      memcpy(mxGetIr(plhs[0]), ir, sizeof(ir));
+      memcpy(mxGetPr(plhs[0]), pr, sizeof(pr));
+      plhs[2] = mxCreateDoubleScalar(1.0);
+   }
+   else
+   {
+      plhs[0] = mxCreateSparse(0, 2, 0, mxREAL);
+      plhs[2] = mxCreateDoubleMatrix(0, 0, mxREAL);
+   }
+}
+
+/** lazy constraint callback raising a MATLAB error */
+static
+void lazyFail(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   (void) nlhs;
+   (void) plhs;
+   (void) nrhs;
+   (void) prhs;
+
+   mexErrMsgTxt("Undefined variable in lazyFail.");
+}
+
+/** solve min -x1 - 2 x2 over binaries, with x1 + x2 <= 1 only given by the lazy constraint callback, returns the
+ *  error message (or "") */
+static
+std::string solveLazy(
+   const char*           callback,           /**< name of callback */
+   double*               fval,               /**< objective value */
+   double*               ncalls,             /**< number of callback calls */
+   double*               nrows               /**< number of lazy rows added */
+   )
+{
+   const double f[2] = {-1.0, -2.0};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   std::string msg;
+
+   createProblem(prhs, 2, f, 0, NULL, NULL, "BB");
+   addOption(prhs, "lazycb", mxCreateString(callback));
+
+   msg = callScip(4, plhs, 13, prhs);
+   if ( msg.empty() )
+   {
+      *fval = mxGetScalar(plhs[1]);
+      CHECK( mxGetField(plhs[3], 0, "LazyCalls") != NULL && mxGetField(plhs[3], 0, "LazyTime") != NULL );
+      *ncalls = mxGetScalar(mxGetField(plhs[3], 0, "LazyCalls"));
+      *nrows = mxGetScalar(mxGetField(plhs[3], 0, "LazyRows"));
+      destroyOutputs(4, plhs);
+   }
+
+   return msg;
+}
+
+/** cut callback [A, lhs, rhs] = cutPair(x) always returning x1 + x2 <= 1 and x1 <= 1 */
+static
+void cutPair(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   mwIndex jc[3] = {0, 2, 3};
+   mwIndex ir[3] = {0, 1, 0};
+   double pr[3] = {1.0, 1.0, 1.0};
+   const double rhs[2] = {1.0, 1.0};
+
+   (void) nlhs;
+   (void) nrhs;
+   (void) prhs;
+
+   plhs[0] = mxCreateSparse(2, 2, 3, mxREAL);
+   memcpy(mxGetJc(plhs[0]), jc, sizeof(jc));
+   memcpy(mxGetIr(plhs[0]), ir, sizeof(ir));
+   memcpy(mxGetPr(plhs[0]), pr, sizeof(pr));
+   plhs[1] = mxCreateDoubleMatrix(0, 0, mxREAL);
+   plhs[2] = vector(2, rhs);
+}
+
+/** solve min -x1 - x2 s.t. 2 x1 + 2 x2 <= 3 over binaries without presolving, with cuts from cutPair */
+static
+void solveCuts(
+   double*               fval,               /**< objective value */
+   double*               ncalls,             /**< number of callback calls */
+   double*               nfound,             /**< number of rows returned by the callback */
+   double*               nadded              /**< number of cuts passed to SCIP */
+   )
+{
+   const double f[2] = {-1.0, -1.0};
+   const double A[2] = {2.0, 2.0};
+   const double rhs[1] = {3.0};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   mxArray* solveropts;
+
+   createProblem(prhs, 2, f, 1, A, rhs, "BB");
+   addOption(prhs, "cutcb", mxCreateString("cutPair"));
+   solveropts = mxCreateCellMatrix(1, 2);
+   mxSetCell(solveropts, 0, mxCreateString("presolving/maxrounds"));
+   mxSetCell(solveropts, 1, mxCreateDoubleScalar(0.0));
+   addOption(prhs, "solverOpts", solveropts);
+
+   CHECK( callScip(4, plhs, 13, prhs).empty() );
+
+   *fval = mxGetScalar(plhs[1]);
+   CHECK( mxGetField(plhs[3], 0, "CutCalls") != NULL && mxGetField(plhs[3], 0, "CutTime") != NULL );
+   *ncalls = mxGetScalar(mxGetField(plhs[3], 0, "CutCalls"));
+   *nfound = mxGetScalar(mxGetField(plhs[3], 0, "CutRows"));
+   *nadded = mxGetScalar(mxGetField(plhs[3], 0, "CutsAdded"));
+   destroyOutputs(4, plhs);
+}
+
+/** pricing callback [f, A, ub] = priceHalf(y, farkas) always returning a column with cost 0.5 covering the row */
+static
+void priceHalf(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   mwIndex jc[2] = {0, 1};
+   mwIndex ir[1] = {0};
+   double pr[1] = {1.0};
+
+   (void) nlhs;
+   (void) nrhs;
+
+   CHECK( mxGetNumberOfElements(prhs[0]) == 1 && mxIsLogical(prhs[1]) && mxGetNumberOfElements(prhs[1]) == 1 );
+
+   plhs[0] = mxCreateDoubleScalar(0.5);
+   plhs[1] = mxCreateSparse(1, 1, 1, mxREAL);
+   memcpy(mxGetJc(plhs[1]), jc, sizeof(jc));
+   memcpy(mxGetIr(plhs[1]), ir, sizeof(ir));
+   memcpy(mxGetPr(plhs[1]), pr, sizeof(pr));
+   plhs[2] = mxCreateDoubleMatrix(0, 0, mxREAL);
+}
+
+/** solve min x1 s.t. x1 >= 1, 0 <= x1 <= 10, with a cheaper column from priceHalf */
+static
+void solvePricing(
+   double*               fval,               /**< objective value */
+   double*               ncols,              /**< number of priced columns */
+   double*               pricedx             /**< value of the first priced column */
+   )
+{
+   const double f[1] = {1.0};
+   const double A[1] = {1.0};
+   const double lhs[1] = {1.0};
+   const double lb[1] = {0.0};
+   const double ub[1] = {10.0};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+
+   createProblem(prhs, 1, f, 1, A, lhs, "C");
+   setInput(prhs, 3, vector(1, lhs));
+   setInput(prhs, 4, mxCreateDoubleMatrix(0, 0, mxREAL));
+   setInput(prhs, 5, vector(1, lb));
+   setInput(prhs, 6, vector(1, ub));
+   addOption(prhs, "pricecb", mxCreateString("priceHalf"));
+
+   CHECK( callScip(4, plhs, 13, prhs).empty() );
+
+   *fval = mxGetScalar(plhs[1]);
+   CHECK( mxGetField(plhs[3], 0, "PriceCalls") != NULL && mxGetField(plhs[3], 0, "PriceTime") != NULL );
+   *ncols = mxGetScalar(mxGetField(plhs[3], 0, "PriceColumns"));
+   CHECK( mxGetNumberOfElements(mxGetField(plhs[3], 0, "PricedX")) == (size_t) *ncols );
+   *pricedx = *ncols > 0 ? mxGetPr(mxGetField(plhs[3], 0, "PricedX"))[0] : 0.0;
+   destroyOutputs(4, plhs);
+}
+
+/** solve min -x1 - x2 s.t. x1 <= 1, x2 <= 1 over integers with each row and variable labeled as its own block */
+static
+void solveDecomp(
+   double*               fval,               /**< objective value */
+   double*               nblocks,            /**< number of blocks of the decomposition */
+   double*               nlinkvars           /**< number of linking variables of the decomposition */
+   )
+{
+   const double f[2] = {-1.0, -1.0};
+   const double A[4] = {1.0, 0.0, 0.0, 1.0};
+   const double rhs[2] = {1.0, 1.0};
+   const double lb[2] = {0.0, 0.0};
+   const double labels[2] = {0.0, 1.0};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   mxArray* dstats;
+
+   createProblem(prhs, 2, f, 2, A, rhs, "II");
+   setInput(prhs, 5, vector(2, lb));
+   setInput(prhs, 6, vector(2, rhs));
+   addOption(prhs, "rowlabels", vector(2, labels));
+   addOption(prhs, "varlabels", vector(2, labels));
+
+   CHECK( callScip(4, plhs, 13, prhs).empty() );
+
+   *fval = mxGetScalar(plhs[1]);
+   dstats = mxGetField(plhs[3], 0, "Decomp");
+   CHECK( dstats != NULL && mxGetField(dstats, 0, "AreaScore") != NULL );
+   *nblocks = dstats != NULL ? mxGetScalar(mxGetField(dstats, 0, "NBlocks")) : 0.0;
+   *nlinkvars = dstats != NULL ? mxGetScalar(mxGetField(dstats, 0, "NLinkVars")) : -1.0;
+   destroyOutputs(4, plhs);
+}
+
+/** solve the pair problem with branching hints, returns the error message (or "") */
+static
+std::string solveBranching(
+   const double*         dir,                /**< branching directions */
+   double*               fval                /**< objective value */
+   )
+{
+   const double prio[2] = {1.0, 0.0};
+   const double factor[2] = {1.0, 2.0};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   std::string msg;
+
+   createPairProblem(prhs);
+   addOption(prhs, "branchpriority", vector(2, prio));
+   addOption(prhs, "branchdir", vector(2, dir));
+   addOption(prhs, "branchfactor", vector(2, factor));
+
+   msg = callScip(4, plhs, 13, prhs);
+   if ( msg.empty() )
+   {
+      *fval = mxGetScalar(plhs[1]);
+      destroyOutputs(4, plhs);
+   }
+
+   return msg;
+}
+
+/** solve the pair problem with starting points x0, returns the error message (or "") */
+static
+std::string solveStarts(
+   size_t                m,                  /**< number of rows of x0 */
+   size_t                n,                  /**< number of columns of x0 */
+   const double*         x0,                 /**< starting points (column-major) */
+   double*               fval                /**< objective value */
+   )
+{
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   std::string msg;
+
+   createPairProblem(prhs);
+   setInput(prhs, 11, mxCreateDoubleMatrix(m, n, mxREAL));
+   memcpy(mxGetPr(prhs[11]), x0, m * n * sizeof(double));
+
+   msg = callScip(4, plhs, 13, prhs);
+   if ( msg.empty() )
+   {
+      *fval = mxGetScalar(plhs[1]);
+      destroyOutputs(4, plhs);
+   }
+
+   return msg;
+}
+
+/** solve the pair problem with one limit option (or none), returns stats.StopReason */
+static
+std::string solveLimit(
+   const char*           option,             /**< name of the option (or NULL) */
+   double                value,              /**< value of the option */
+   double*               fval                /**< objective value */
+   )
+{
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   char reason[32] = "";
+
+   createPairProblem(prhs);
+   if ( option != NULL )
+      addOption(prhs, option, mxCreateDoubleScalar(value));
+
+   CHECK( callScip(4, plhs, 13, prhs).empty() );
+
+   *fval = mxGetScalar(plhs[1]);
+   CHECK( mxGetField(plhs[3], 0, "StopReason") != NULL );
+   CHECK( mxGetString(mxGetField(plhs[3], 0, "StopReason"), reason, sizeof(reason)) == 0 );
+   destroyOutputs(4, plhs);
+
+   return reason;
+}
+
+/** presolve min -x1 - 2 x2 - x3 s.t. x1 + x2 <= 1, x3 <= 0 over binaries, returns the presolve statistics */
+static
+mxArray* presolveOnly(
+   bool                  matrices            /**< also return the presolved matrices */
+   )
+{
+   const double f[3] = {-1.0, -2.0, -1.0};
+   const double A[6] = {1.0, 0.0, 1.0, 0.0, 0.0, 1.0};
+   const double rhs[2] = {1.0, 0.0};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   mxArray* pstats;
+
+   createProblem(prhs, 3, f, 2, A, rhs, "BBB");
+   addOption(prhs, "presolveonly", mxCreateDoubleScalar(1.0));
+   addOption(prhs, "presolvematrices", mxCreateDoubleScalar(matrices ? 1.0 : 0.0));
+
+   CHECK( callScip(4, plhs, 13, prhs).empty() );
+
+   CHECK( std::isnan(mxGetScalar(plhs[1])) );
+   CHECK( mxGetField(plhs[3], 0, "StopReason") == NULL );
+   pstats = mxDuplicateArray(mxGetField(plhs[3], 0, "Presolve"));
+   destroyOutputs(4, plhs);
+
+   return pstats;
+}
+
+/** solve the pair problem (or min -x1 s.t. x1 <= 1 over continuous x1) with a presolve cache and no presolving
+ *  rounds, so that the presolved problem keeps its variables, returns stats.PresolveCache */
+static
+std::string solveCached(
+   const char*           cachedir,           /**< directory of the presolve cache */
+   bool                  pair,               /**< solve the pair problem instead of the one variable problem */
+   double                tolrfun,            /**< value of opts.tolrfun (or 0 to leave it unset) */
+   double*               fval                /**< objective value */
+   )
+{
+   const double f[1] = {-1.0};
+   const double A[1] = {1.0};
+   const double rhs[1] = {1.0};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   mxArray* solveropts;
+   char result[8] = "";
+
+   if ( pair )
+      createPairProblem(prhs);
+   else
+      createProblem(prhs, 1, f, 1, A, rhs, "C");
+   addOption(prhs, "presolvecache", mxCreateString(cachedir));
+   solveropts = mxCreateCellMatrix(1, 2);
+   mxSetCell(solveropts, 0, mxCreateString("presolving/maxrounds"));
+   mxSetCell(solveropts, 1, mxCreateDoubleScalar(0.0));
+   addOption(prhs, "solverOpts", solveropts);
+   if ( tolrfun > 0.0 )
+      addOption(prhs, "tolrfun", mxCreateDoubleScalar(tolrfun));
+
+   CHECK( callScip(4, plhs, 13, prhs).empty() );
+
+   *fval = mxGetScalar(plhs[1]);
+   CHECK( mxGetField(plhs[3], 0, "PresolveCache") != NULL && mxGetField(plhs[3], 0, "PresolveTimeSaved") != NULL );
+   CHECK( mxGetString(mxGetField(plhs[3], 0, "PresolveCache"), result, sizeof(result)) == 0 );
+   destroyOutputs(4, plhs);
+
+   return result;
+}
+
+/** returns the names of the cache files (*.cip) in a directory */
+static
+std::vector<std::string> cacheFiles(
+   const char*           dirname             /**< directory */
+   )
+{
+   std::vector<std::string> files;
+   DIR* dir = opendir(dirname);
+   struct dirent* entry;
+
+   while ( dir != NULL && (entry = readdir(dir)) != NULL )
+   {
+      std::string name = entry->d_name;
+
+      if ( name.size() > 4 && name.compare(name.size() - 4, 4, ".cip") == 0 )
+         files.push_back(std::string(dirname) + "/" + name);
+   }
+   if ( dir != NULL )
+      closedir(dir);
+
+   return files;
+}
+
+/** removes a presolve cache directory with its files */
+static
+void removeCacheDir(
+   const char*           dirname             /**< directory */
+   )
+{
+   DIR* dir = opendir(dirname);
+   struct dirent* entry;
+
+   while ( dir != NULL && (entry = readdir(dir)) != NULL )
+   {
+      if ( strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0 )
+         remove((std::string(dirname) + "/" + entry->d_name).c_str());
+   }
+   if ( dir != NULL )
+      closedir(dir);
+   rmdir(dirname);
+}
+
+/** define a parameter profile with one parameter, returns the number of stored parameters or -1 on error */
+static
+int defineProfile(
+   const char*           name,               /**< profile name */
+   const char*           param,              /**< parameter name */
+   mxArray*              value               /**< parameter value (destroyed) */
+   )
+{
+   mxArray* prhs[3];
+   mxArray* plhs[1];
+   int nparams = -1;
+
+   prhs[0] = mxCreateString("defineProfile");
+   prhs[1] = mxCreateString(name);
+   prhs[2] = mxCreateCellMatrix(1, 2);
+   mxSetCell(prhs[2], 0, mxCreateString(param));
+   mxSetCell(prhs[2], 1, value);
+
+   try
+   {
+      mexshim::call(mexFunction, 1, plhs, 3, (const mxArray**) prhs);
+      nparams = (int) mxGetScalar(plhs[0]);
+      mxDestroyArray(plhs[0]);
+   }
+   catch (const mexshim::MexError&)
+   {
+   }
+
+   for (int i = 0; i < 3; ++i)
+      mxDestroyArray(prhs[i]);
+
+   return nparams;
+}
+
+/** solve the pair problem with a parameter profile, returns the error message (or "") */
+static
+std::string solveProfile(
+   const char*           profile,            /**< profile name */
+   double*               fval                /**< objective value */
+   )
+{
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   std::string msg;
+
+   createPairProblem(prhs);
+   addOption(prhs, "profile", mxCreateString(profile));
+
+   msg = callScip(4, plhs, 13, prhs);
+   if ( msg.empty() )
+   {
+      *fval = mxGetScalar(plhs[1]);
+      destroyOutputs(4, plhs);
+   }
+
+   return msg;
+}
+
+/** tune over the grid {'lp/pricing', 'ls'; param, [0 5]} on the pair problem (as structure) with two seeds, returns
+ *  the error message (or "") */
+static
+std::string solveTune(
+   const char*           param,              /**< name of second parameter */
+   double*               nconfigs,           /**< number of configurations */
+   double*               nruns,              /**< number of runs */
+   double*               nsolved,            /**< number of runs solved to optimality */
+   double*               nbest               /**< number of parameters in the best configuration */
+   )
+{
+   const double rounds[2] = {0.0, 5.0};
+   const char* pnames[4] = {"f", "A", "ru", "xtype"};
+   const char* fnames[4] = {"maxtime", "seeds", "threads", "score"};
+   mxArray* pair[13];
+   mxArray* prhs[4];
+   mxArray* plhs[2];
+   mxArray* prob;
+   std::string msg;
+
+   /* the problem structure takes the data of the pair problem */
+   createPairProblem(pair);
+   prob = mxCreateStructMatrix(1, 1, 4, pnames);
+   mxSetField(prob, 0, "f", mxDuplicateArray(pair[1]));
+   mxSetField(prob, 0, "A", mxDuplicateArray(pair[2]));
+   mxSetField(prob, 0, "ru", mxDuplicateArray(pair[4]));
+   mxSetField(prob, 0, "xtype", mxDuplicateArray(pair[7]));
+   for (int i = 0; i < 13; ++i)
+      mxDestroyArray(pair[i]);
+
+   prhs[0] = mxCreateString("tune");
+   prhs[1] = mxCreateCellMatrix(1, 1);
+   mxSetCell(prhs[1], 0, prob);
+   prhs[2] = mxCreateCellMatrix(2, 2);
+   mxSetCell(prhs[2], 0, mxCreateString("lp/pricing"));
+   mxSetCell(prhs[2], 1, mxCreateString(param));
+   mxSetCell(prhs[2], 2, mxCreateString("ls"));
+   mxSetCell(prhs[2], 3, vector(2, rounds));
+   prhs[3] = mxCreateStructMatrix(1, 1, 4, fnames);
+   mxSetField(prhs[3], 0, "maxtime", mxCreateDoubleScalar(10.0));
+   mxSetField(prhs[3], 0, "seeds", mxCreateDoubleScalar(2.0));
+   mxSetField(prhs[3], 0, "threads", mxCreateDoubleScalar(3.0));
+   mxSetField(prhs[3], 0, "score", mxCreateString("integral"));
+
+   msg = callScip(2, plhs, 4, prhs);
+   if ( msg.empty() )
+   {
+      *nbest = (double) mxGetM(plhs[0]);
+      *nconfigs = (double) mxGetNumberOfElements(mxGetField(plhs[1], 0, "Configs"));
+      *nruns = (double) mxGetNumberOfElements(mxGetField(mxGetField(plhs[1], 0, "Runs"), 0, "Time"));
+      *nsolved = 0.0;
+      for (size_t c = 0; c < (size_t) *nconfigs; ++c)
+         *nsolved += mxGetPr(mxGetField(plhs[1], 0, "Solved"))[c];
+      destroyOutputs(2, plhs);
+   }
+
+   return msg;
+}
+
+/** solve min y + 2 z s.t. y + z >= 3, 0 <= y <= 10, z >= 0 with y in the master and z in a Benders subproblem,
+ *  returns the error message (or "") */
+static
+std::string solveBenders(
+   const char*           subxtype,           /**< variable types of the subproblem (or NULL) */
+   const char*           option,             /**< name of an option (or NULL) */
+   double                value,              /**< value of the option */
+   double*               fval,               /**< objective value */
+   double*               y,                  /**< value of the master variable */
+   double*               nsubs               /**< number of subproblems */
+   )
+{
+   const char* fnames[3] = {"f", "lb", "ub"};
+   const char* subnames[6] = {"f", "A", "rl", "lb", "ub", "link"};
+   const double one[1] = {1.0};
+   const double zero[1] = {0.0};
+   const double ten[1] = {10.0};
+   const double subf[2] = {0.0, 2.0};
+   const double sublb[2] = {0.0, 0.0};
+   const double subub[2] = {10.0, mxGetInf()};
+   const double sublink[2] = {1.0, 0.0};
+   const double rl[1] = {3.0};
+   mwIndex jc[3] = {0, 1, 2};
+   mwIndex ir[2] = {0, 0};
+   double pr[2] = {1.0, 1.0};
+   mxArray* prhs[4];
+   mxArray* plhs[4];
+   mxArray* sub;
+   mxArray* A;
+   std::string msg;
+
+   prhs[0] = mxCreateString("benders");
+   prhs[1] = mxCreateStructMatrix(1, 1, 3, fnames);
+   mxSetField(prhs[1], 0, "f", vector(1, one));
+   mxSetField(prhs[1], 0, "lb", vector(1, zero));
+   mxSetField(prhs[1], 0, "ub", vector(1, ten));
+
+   /* subproblem variables: copy of y and z */
+   A = mxCreateSparse(1, 2, 2, mxREAL);
+   memcpy(mxGetJc(A), jc, sizeof(jc));
+   memcpy(mxGetIr(A), ir, sizeof(ir));
+   memcpy(mxGetPr(A), pr, sizeof(pr));
+   sub = mxCreateStructMatrix(1, 1, 6, subnames);
+   mxSetField(sub, 0, "f", vector(2, subf));
+   mxSetField(sub, 0, "A", A);
+   mxSetField(sub, 0, "rl", vector(1, rl));
+   mxSetField(sub, 0, "lb", vector(2, sublb));
+   mxSetField(sub, 0, "ub", vector(2, subub));
+   mxSetField(sub, 0, "link", vector(2, sublink));
+   if ( subxtype != NULL )
+   {
+      mxAddField(sub, "xtype");
+      mxSetField(sub, 0, "xtype", mxCreateString(subxtype));
+   }
+   prhs[2] = mxCreateCellMatrix(1, 1);
+   mxSetCell(prhs[2], 0, sub);
+   prhs[3] = mxCreateStructMatrix(1, 1, 0, NULL);
+   if ( option != NULL )
+   {
+      mxAddField(prhs[3], option);
+      mxSetField(prhs[3], 0, option, mxCreateDoubleScalar(value));
+   }
+
+   msg = callScip(4, plhs, 4, prhs);
+   if ( msg.empty() )
+   {
+      *fval = mxGetScalar(plhs[1]);
+      *y = mxGetScalar(plhs[0]);
+      CHECK( mxGetField(plhs[3], 0, "BendersCuts") != NULL );
+      *nsubs = mxGetScalar(mxGetField(plhs[3], 0, "BendersSubproblems"));
+      destroyOutputs(4, plhs);
+   }
+
+   return msg;
+}
+
+/** returns whether scip rejects an argument with more rows or columns than SCIP can index with int
+ *
+ *  Only the dimensions are enlarged, so this also checks that the sizes are checked before any data is read.
+ */
+static
+bool rejectsLargeSize(
+   int                   arg,                /**< argument to enlarge (1 = f, 2 = A) */
+   bool                  rows                /**< enlarge the number of rows instead of columns */
+   )
+{
+   const double f[1] = {0.0};
+   mxArray* prhs[13];
+   mxArray* plhs[4];
+   std::string msg;
+
+   /* one variable and no rows */
+   createProblem(prhs, 1, f, 0, f, f, "C");
+
+   if ( rows )
+      mxSetM(prhs[arg], (mwSize) INT_MAX + 5);
+   else
+      mxSetN(prhs[arg], (mwSize) INT_MAX + 5);
+
+   msg = callScip(4, plhs, 13, prhs);
+   if ( msg.empty() )
+      destroyOutputs(4, plhs);
+
+   return msg.find("exceeds the maximum") != std::string::npos;
+}
+
+#if SCIP_VERSION >= 800
+/** adds lhs <= g(x) <= rhs (or g as objective) for an instruction list g in x0, x1 to a new problem, with or without
+ *  detecting affine and quadratic lists, returns g(1.5, -2) */
+static
+double addInstr(
+   const std::vector<double>& instr,         /**< instruction list */
+   bool                  isobj,              /**< add g as objective */
+   bool                  detect,             /**< detect affine and quadratic lists */
+   SCIP**                scip                /**< pointer to store the SCIP instance (to be freed by the caller) */
+   )
+{
+   std::vector<double> copy(instr);          /* the expression builder may change the list */
+   double xval[2] = {1.5, -2.0};
+   SCIP_VAR* vars[2];
+   double val;
+
+   CHECK( SCIPcreate(scip) == SCIP_OKAY );
+   CHECK( SCIPincludeDefaultPlugins(*scip) == SCIP_OKAY );
+   CHECK( SCIPcreateProbBasic(*scip, "instr") == SCIP_OKAY );
+   for (int j = 0; j < 2; ++j)
+   {
+      char name[8];
+
+      snprintf(name, sizeof(name), "x%d", j);
+      CHECK( SCIPcreateVarBasic(*scip, &vars[j], name, -10.0, 10.0, 0.0, SCIP_VARTYPE_CONTINUOUS) == SCIP_OKAY );
+      CHECK( SCIPaddVar(*scip, vars[j]) == SCIP_OKAY );
+   }
+
+   setQuadraticDetection(detect);
+   val = addNonlinearCon(*scip, vars, copy.data(), copy.size(), -SCIPinfinity(*scip), 5.0, xval, 0, isobj);
+   setQuadraticDetection(true);
+
+   for (int j = 0; j < 2; ++j)
+      CHECK( SCIPreleaseVar(*scip, &vars[j]) == SCIP_OKAY );
+
+   return val;
+}
+
+/** returns rhs - g(1.5, -2) of the single constraint of a problem built by addInstr() */
+static
+double rowSlack(
+   SCIP*                 scip                /**< SCIP instance */
+   )
+{
+   SCIP_CONS* cons = SCIPgetConss(scip)[0];
+   SCIP_VAR** vars = SCIPgetVars(scip);
+   SCIP_SOL* sol;
+   double slack;
+
+   CHECK( SCIPcreateSol(scip, &sol, NULL) == SCIP_OKAY );
+   CHECK( SCIPsetSolVal(scip, sol, vars[0], 1.5) == SCIP_OKAY );
+   CHECK( SCIPsetSolVal(scip, sol, vars[1], -2.0) == SCIP_OKAY );
+   if ( strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(cons)), "linear") == 0 )
+      slack = SCIPgetRhsLinear(scip, cons) - SCIPgetActivityLinear(scip, cons, sol);
+   else
+   {
+      double activity = SCIP_INVALID;
+
+      CHECK( SCIPgetActivityNonlinear(scip, cons, sol, &activity) == SCIP_OKAY );
+      slack = SCIPgetRhsNonlinear(cons) - activity;
+   }
+   CHECK( SCIPfreeSol(scip, &sol) == SCIP_OKAY );
+
+   return slack;
+}
+
+/** adds an instruction list as row with and without detection, checks that the value at (1.5, -2) and the slack of
+ *  the row agree with the expression builder, returns the name of the detected row */
+static
+std::string classifyRow(
+   const std::vector<double>& instr,         /**< instruction list */
+   double                expected            /**< expected value at (1.5, -2) */
+   )
+{
+   SCIP* detected;
+   SCIP* built;
+   std::string name;
+
+   CHECK( std::fabs(addInstr(instr, false, true, &detected) - expected) < 1e-9 );
+   CHECK( std::fabs(addInstr(instr, false, false, &built) - expected) < 1e-9 );
+   CHECK( SCIPgetNConss(detected) == 1 && SCIPgetNConss(built) == 1 );
+   CHECK( strcmp(SCIPconsGetName(SCIPgetConss(built)[0]), "NonlinearExp0") == 0 );
+   CHECK( std::fabs(rowSlack(detected) - (5.0 - expected)) < 1e-9 );
+   CHECK( std::fabs(rowSlack(built) - (5.0 - expected)) < 1e-9 );
+   name = SCIPconsGetName(SCIPgetConss(detected)[0]);
+
+   CHECK( SCIPfree(&detected) == SCIP_OKAY );
+   CHECK( SCIPfree(&built) == SCIP_OKAY );
+
+   return name;
+}
+
+#endif
+
+int main(void)
+{
+   double fval;
+   double exitflag;
+   bool failed = false;
+
+   mexshim::setOutput(NULL);
+
+   /* LP: optimum at (1.6, 1.2) */
+   solve("CC", false, &fval, &exitflag);
+   CHECK( std::fabs(fval + 2.8) < 1e-6 );
+
+   /* MILP: optimal value -2 */
+   solve("II", false, &fval, &exitflag);
+   CHECK( std::fabs(fval + 2.0) < 1e-6 );
+
+   /* same LP and MILP with dense and non-double data */
+   solve("CC", true, &fval, &exitflag);
+   CHECK( std::fabs(fval + 2.8) < 1e-6 );
+   solve("II", true, &fval, &exitflag);
+   CHECK( std::fabs(fval + 2.0) < 1e-6 );
+
+   /* LP fast path: both rows are tight, duals solve A'y = f; the final basis needs no iterations */
+   double lambda[2];
+   double niter;
+   mxArray* basis = solveLP(NULL, &fval, lambda, &niter);
+   CHECK( std::fabs(fval + 2.8) < 1e-6 );
+   CHECK( std::fabs(lambda[0] + 0.4) < 1e-6 && std::fabs(lambda[1] + 0.2) < 1e-6 );
+   CHECK( mxIsStruct(basis) && mxGetNumberOfElements(mxGetField(basis, 0, "rstat")) == 2 );
+   mxDestroyArray(solveLP(basis, &fval, lambda, &niter));
+   CHECK( std::fabs(fval + 2.8) < 1e-6 );
+   CHECK( niter == 0 );
+   mxDestroyArray(basis);
+   CHECK( solveInvalidBasis() == "Invalid basis status 5 in opts.basis.cstat (must be 0, 1, 2 or 3)." );
+
+   /* lazy constraints: without x1 + x2 <= 1 the optimum would be -3 */
+   double ncalls;
+   double nrows;
+   mexshim::registerFunction("lazyPair", lazyPair);
+   CHECK( solveLazy("lazyPair", &fval, &ncalls, &nrows).empty() );
+   CHECK( std::fabs(fval + 2.0) < 1e-6 );
+   CHECK( ncalls >= 1 );
+   CHECK( nrows >= 1 );
+
+   /* errors in callbacks stop the solve and are raised after SCIP is freed */
+   mexshim::registerFunction("lazyFail", lazyFail);
+   CHECK( solveLazy("lazyFail", &fval, &ncalls, &nrows) == "Error in the lazy constraint callback: Undefined variable in lazyFail." );
+
+   /* cuts: x1 <= 1 is never violated and filtered out, so at most one cut is added per call */
+   double nfound;
+   double nadded;
+   mexshim::registerFunction("cutPair", cutPair);
+   solveCuts(&fval, &ncalls, &nfound, &nadded);
+   CHECK( std::fabs(fval + 1.0) < 1e-6 );
+   CHECK( nfound == 2 * ncalls );
+   CHECK( nadded <= ncalls );
+
+   /* pricing: the priced column replaces x1, then its reduced cost is 0 and it is not added again */
+   double ncols;
+   double pricedx;
+   mexshim::registerFunction("priceHalf", priceHalf);
+   solvePricing(&fval, &ncols, &pricedx);
+   CHECK( std::fabs(fval - 0.5) < 1e-6 );
+   CHECK( ncols == 1 );
+   CHECK( std::fabs(pricedx - 1.0) < 1e-6 );
+
+   /* Benders: z costs more than y, so y = 3 */
+   double y;
+   double nsubs;
+   CHECK( solveBenders(NULL, NULL, 0.0, &fval, &y, &nsubs).empty() );
+   CHECK( std::fabs(fval - 3.0) < 1e-6 );
+   CHECK( std::fabs(y - 3.0) < 1e-6 );
+   CHECK( nsubs == 1 );
+
+   /* invalid variable types and branching hints are rejected before any SCIP instance is created */
+   CHECK( solveBenders("CX", NULL, 0.0, &fval, &y, &nsubs) == "Unknown variable type 'X' in xtype of the subproblem 1." );
+   CHECK( solveBenders(NULL, "branchdir", 2.0, &fval, &y, &nsubs) == "Invalid branching direction 2 (must be -1, 0 or 1)." );
+
+   /* decomposition: two independent blocks */
+   double nblocks;
+   double nlinkvars;
+   solveDecomp(&fval, &nblocks, &nlinkvars);
+   CHECK( std::fabs(fval + 2.0) < 1e-6 );
+   CHECK( nblocks == 2 );
+   CHECK( nlinkvars == 0 );
+
+   /* branching hints do not change the optimum, invalid directions are rejected */
+   const double dirok[2] = {1.0, -1.0};
+   const double dirbad[2] = {2.0, 0.0};
+   CHECK( solveBranching(dirok, &fval).empty() );
+   CHECK( std::fabs(fval + 2.0) < 1e-6 );
+   CHECK( solveBranching(dirbad, &fval).find("Invalid branching direction 2") != std::string::npos );
+
+   /* starting points: a partial one (x1 free) and a full one as columns, or a row vector */
+   const double starts[4] = {mxGetNaN(), 1.0, 1.0, 0.0};
+   CHECK( solveStarts(2, 2, starts, &fval).empty() );
+   CHECK( std::fabs(fval + 2.0) < 1e-6 );
+   CHECK( solveStarts(1, 2, starts + 2, &fval).empty() );
+   CHECK( solveStarts(3, 1, starts, &fval).find("x0 has incompatible dimensions") != std::string::npos );
+
+   /* early termination: no solution is better than the objective limit, a deadline in the past stops at once */
+   CHECK( solveLimit(NULL, 0.0, &fval) == "optimal" );
+   CHECK( solveLimit("objlimit", -3.0, &fval) == "infeasible_or_objlimit" );
+   CHECK( std::isnan(fval) );
+   CHECK( solveLimit("deadline", 1.0, &fval) == "deadline" );
+
+   /* presolve only: x3 is fixed to 0, the matrices are those of the remaining variables */
+   mxArray* pstats = presolveOnly(false);
+   CHECK( mxIsStruct(pstats) && mxGetScalar(mxGetField(pstats, 0, "OrigVars")) == 3 );
+   CHECK( mxGetScalar(mxGetField(pstats, 0, "Vars")) < 3 );
+   CHECK( mxGetField(pstats, 0, "A") == NULL );
+   mxDestroyArray(pstats);
+   pstats = presolveOnly(true);
+   CHECK( mxGetN(mxGetField(pstats, 0, "A")) == mxGetScalar(mxGetField(pstats, 0, "Vars")) );
+   CHECK( mxGetNumberOfElements(mxGetField(pstats, 0, "VarNames")) == mxGetScalar(mxGetField(pstats, 0, "Vars")) );
+   mxDestroyArray(pstats);
+
+   /* presolve cache: a miss writes the cache file, the same solve hits it, another tolrfun misses */
+   char cachedir[] = "/tmp/scipmex_cacheXXXXXX";
+   char otherdir[] = "/tmp/scipmex_otherXXXXXX";
+   CHECK( mkdtemp(cachedir) != NULL && mkdtemp(otherdir) != NULL );
+   CHECK( solveCached(cachedir, true, 0.0, &fval) == "miss" );
+   CHECK( cacheFiles(cachedir).size() == 1 );
+   CHECK( solveCached(cachedir, true, 0.0, &fval) == "hit" );
+   CHECK( std::fabs(fval + 2.0) < 1e-6 );
+   CHECK( solveCached(cachedir, true, 1e-7, &fval) == "miss" );
+   CHECK( cacheFiles(cachedir).size() == 2 );
+   CHECK( solveCached(cachedir, true, 1e-7, &fval) == "hit" );
+   removeCacheDir(cachedir);
+
+   /* a cache file of another problem is removed and rebuilt */
+   strcpy(cachedir, "/tmp/scipmex_cacheXXXXXX");
+   CHECK( mkdtemp(cachedir) != NULL );
+   CHECK( solveCached(cachedir, true, 0.0, &fval) == "miss" );
+   CHECK( solveCached(otherdir, false, 0.0, &fval) == "miss" );
+   CHECK( cacheFiles(cachedir).size() == 1 && cacheFiles(otherdir).size() == 1 );
+   if ( cacheFiles(cachedir).size() == 1 && cacheFiles(otherdir).size() == 1 )
+      CHECK( rename(cacheFiles(otherdir)[0].c_str(), cacheFiles(cachedir)[0].c_str()) == 0 );
+   CHECK( solveCached(cachedir, true, 0.0, &fval) == "miss" );
+   CHECK( std::fabs(fval + 2.0) < 1e-6 );
+   CHECK( solveCached(cachedir, true, 0.0, &fval) == "hit" );
+   removeCacheDir(cachedir);
+   removeCacheDir(otherdir);
+
+   /* parameter profiles: checked when defined, applied by name */
+   CHECK( defineProfile("binfirst", "branching/preferbinary", mxCreateLogicalScalar(true)) == 1 );
+   CHECK( defineProfile("bad", "no/such/param", mxCreateDoubleScalar(1.0)) == -1 );
+   CHECK( solveProfile("binfirst", &fval).empty() );
+   CHECK( std::fabs(fval + 2.0) < 1e-6 );
+   CHECK( solveProfile("bad", &fval).find("Unknown parameter profile") != std::string::npos );
+
+   /* tuning: 2 x 2 configurations, each solved with two seeds in three worker threads */
+   double nconfigs;
+   double nruns;
+   double nsolved;
+   double nbest;
+   CHECK( solveTune("separating/maxrounds", &nconfigs, &nruns, &nsolved, &nbest).empty() );
+   CHECK( nconfigs == 4 && nruns == 8 && nsolved == 8 && nbest == 2 );
+   CHECK( solveTune("no/such/param", &nconfigs, &nruns, &nsolved, &nbest).find("not recognized") != std::string::npos );
+
+   /* more variables or constraints than SCIP can index are reported as error */
+   CHECK( rejectsLargeSize(1, false) );
+   CHECK( rejectsLargeSize(2, true) );
+
+   /* unknown commands are reported as error */
+   mxArray* cmd = mxCreateString("nosuchcommand");
+   try
+   {
+      mxArray* plhs[1];
+      mexshim::call(mexFunction, 1, plhs, 1, (const mxArray**) &cmd);
+   }
+   catch (const mexshim::MexError&)
+   {
+      failed = true;
+   }
+   CHECK( failed );
+   mxDestroyArray(cmd);
+
+#if SCIP_VERSION >= 800
+   /* affine and quadratic instruction lists become linear or quadratic rows that agree with the expression builder */
+   const double NaN = mxGetNaN();
+   CHECK( classifyRow({1, 0, 1, 1, 3, NaN, 0, 2, 6, 1}, 5.0) == "QuadraticExp0" );            /* 2 - x0*x1 */
+   CHECK( classifyRow({1, 0, 0, 0, 9, NaN}, 1.0) == "LinearExp0" );                            /* x0^0 */
+   CHECK( classifyRow({1, 0, 0, 1, 9, NaN}, 1.5) == "LinearExp0" );                            /* x0^1 */
+   CHECK( classifyRow({1, 0, 0, 2, 9, NaN}, 2.25) == "QuadraticExp0" );                        /* x0^2 */
+   CHECK( classifyRow({1, 0, 1, 1, 5, NaN, 0, 4, 4, NaN}, -0.125) == "LinearExp0" );           /* (x0 + x1) / 4 */
+   CHECK( classifyRow({1, 0, 1, 0, 3, NaN, 1, 1, 3, NaN}, -4.5) == "NonlinearExp0" );          /* x0*x0*x1 */
+
+   /* objective x0*x1 + 2*x0 + 3: the affine part goes into the objective, only x0*x1 into a row */
+   {
+      const std::vector<double> objinstr = {1, 0, 1, 1, 3, NaN, 0, 2, 1, 0, 3, NaN, 5, NaN, 0, 3, 5, 1};
+      SCIP* detected;
+      SCIP* built;
+
+      CHECK( std::fabs(addInstr(objinstr, true, true, &detected) - 3.0) < 1e-9 );
+      CHECK( std::fabs(addInstr(objinstr, true, false, &built) - 3.0) < 1e-9 );
+      CHECK( SCIPgetOrigObjoffset(detected) == 3.0 && SCIPgetOrigObjoffset(built) == 0.0 );
+      CHECK( SCIPvarGetObj(SCIPgetVars(detected)[0]) == 2.0 && SCIPvarGetObj(SCIPgetVars(detected)[1]) == 0.0 );
+      CHECK( SCIPfindCons(detected, "QuadraticObj0") != NULL && SCIPfindCons(built, "NonlinearObj0") != NULL );
+      CHECK( SCIPfindVar(detected, "nlobj") != NULL && SCIPvarGetObj(SCIPfindVar(detected, "nlobj")) == 1.0 );
+      CHECK( SCIPfree(&detected) == SCIP_OKAY );
+      CHECK( SCIPfree(&built) == SCIP_OKAY );
+   }
+#endif
+
+   CHECK( mexshim::nAllocatedArrays() == 0 );
+
+   if ( nfailed > 0 )
+   {
+      printf("%d checks failed.\n", nfailed);
+      return 1;
+   }
+   printf("All checks passed.\n");
+
+   return 0;
+}
@@ -21,6 +21,11 @@ function [x,fval,exitflag,info] = opti_scip(H,f,A,rl,ru,lb,ub,xint,sos,qc,x0,opt
 %   x = opti_scip(H,...,sos,qc,x0) qc is structure with fields Q, l, and qrl
 %   and qru for quadratic constraints.
 %
+%   The matrices H, A, Q and l may be sparse or dense, and all arguments
+%   (apart from xint) may be double, single, integer or logical. The SOS
+%   indices may also be a logical mask. The data is converted to double
+%   only when it is added to SCIP, so no converted copies are made.
+%
 %   x = opti_scip(H,f,...,qc,x0,opts) uses opts to pass optiset options to the
 %   solver.
 %
@@ -44,42 +49,12 @@ if nargin < 7, ub = []; end
 if nargin < 6, lb = []; end
 if nargin < 5, error('You must supply at least 5 arguments to opti_scip.'); end
 
-warn = strcmpi(opts.warnings,'all');
-
-% check sparsity
-if(~issparse(A))
-    if(warn)
-        optiwarn('opti:sparse','The A matrix should be sparse, correcting: [sparse(A)].');
-    end
-    A = sparse(A);
-end
-if(~isempty(H) && ~issparse(H))
-    if(warn)
-        optiwarn('opti:sparse','The H matrix should be sparse, correcting: [sparse(A)].');
-    end
-    H = sparse(H);
-end
+% A, H, Q and l may be sparse or dense, and double, single, integer or
+% logical: the MEX converts them when adding them to SCIP (no copies here)
 if(~isempty(qc))
     if(~isfield(qc,'Q') || ~isfield(qc,'l') || ~isfield(qc,'qrl') || ~isfield(qc,'qru'))
         error('The qc structure must contain fields Q, l, qrl and qru.');
     end
-    if(~isempty(qc.Q))
-        err = 0;
-        if(iscell(qc.Q))
-            for i=1:length(qc.Q)
-                if(~issparse(qc.Q{i}))
-                    err = 1;
-                    qc.Q{i} = sparse(qc.Q{i});
-                end
-            end
-        elseif(~issparse(qc.Q))
-            err = 1;
-            qc.Q = sparse(qc.Q);
-        end
-        if(err && warn)
-            optiwarn('opti:sparse','The Q matrix should be sparse, correcting: [sparse(Q)].');
-        end
-    end
 end
 
 % remove H if all nz
@@ -93,6 +68,9 @@ info.BBNodes = stats.BBnodes;
 info.BBGap = stats.BBgap;
 info.PrimalBound = stats.PrimalBound;
 info.DualBound = stats.DualBound;
+if(isfield(stats,'BuildTime'))
+    info.BuildTime = stats.BuildTime;
+end
 info.Time = toc(t);
 info.Algorithm = 'SCIP: Spatial Branch and Bound';
 
@@ -110,7 +110,13 @@ if(any(isnan(xval)))
 end
 
 % encode nonlinear constraints into SCIP MEX interface instruction lists
+% (the expressions are built in the native expression graph of scipexprmex,
+% affine constraints and affine objective terms are passed as linear data)
+scipvar.reset();
 x = scipvar(size(xval));
+nl = [];
+fobj = zeros(ndec,1);
+objconst = 0;
 if(~isempty(nlcon))
     try
         n = nlcon(x);
@@ -118,34 +124,43 @@ if(~isempty(nlcon))
         ex = processEqErr(ME,'a constraint');
         throwAsCaller(ex);
     end
-    if(numel(n) > 1) % multiple constraints
-        nl.instr = cell(numel(n),1);
-        for i = 1:numel(n)
-            if(isnumeric(n(i))) % read as number
-                nl.instr{i} = [0 n(i)];
-            elseif(isempty(n(i).ins)) % assume just a variable
-                nl.instr{i} = [1; n(i).indx];
-            else
-                nl.instr{i} = n(i).ins;
-            end
-        end
+    nlcon_val = nlcon(xval);
+    cl = cl(:);
+    cu = cu(:);
+    % check for Inf or NaN
+    if(any(isnan(nlcon_val)) || any(isinf(nlcon_val)))
+        error('One or more constraints resulted in Inf or NaN at the initial guess (xval). Please provide a better initial guess vector.');
+    end
+    if(isnumeric(n)) % read as number(s)
+        nlrows = true(numel(n),1);
+        ins = num2cell([zeros(numel(n),1) n(:)],2);
     else
-        if(isnumeric(n)) % read as number
-            nl.instr = [0 n];
-        elseif(isempty(n.ins)) % assume just a variable
-            nl.instr = [1; n.indx];
-        else
-            nl.instr = n.ins;
+        % move affine constraints to the linear constraints
+        [Alin,clin,isaff] = scipvar.linearParts(n(:),ndec);
+        if(any(isaff))
+            if(~isempty(A))
+                if(isempty(rl)), rl = -Inf(size(A,1),1); end
+                if(isempty(ru)), ru = Inf(size(A,1),1); end
+            end
+            A = [sparse(A); Alin(isaff,:)];
+            rl = [rl(:); cl(isaff) - clin(isaff)];
+            ru = [ru(:); cu(isaff) - clin(isaff)];
         end
+        nlrows = ~isaff;
+        ins = cell(numel(n),1);
+        ins(nlrows) = scipvar.instructions(n(nlrows));
     end
-    nl.cl = cl;
-    nl.cu = cu;
-    % verification fields
-    nl.nlcon_val = nlcon(xval);
-    nl.xval = xval;
-    % check for Inf or NaN
-    if(any(isnan(nl.nlcon_val)) || any(isinf(nl.nlcon_val)))
-        error('One or more constraints resulted in Inf or NaN at the initial guess (xval). Please provide a better initial guess vector.');
+    if(sum(nlrows) > 1) % multiple constraints
+        nl.instr = ins(nlrows);
+    elseif(any(nlrows))
+        nl.instr = ins{nlrows};
+    end
+    if(any(nlrows))
+        nl.cl = cl(nlrows);
+        nl.cu = cu(nlrows);
+        % verification fields
+        nl.nlcon_val = nlcon_val(nlrows);
+        nl.xval = xval;
     end
 end
 
@@ -157,22 +172,29 @@ if(~isempty(fun))
         ex = processEqErr(ME,'the objective');
         throwAsCaller(ex);
     end
-    if(isnumeric(f)) %read as number
-        nl.obj_instr = [0 f];
-    elseif(isempty(f.ins)) %assume just a variable
-        nl.obj_instr = [1; f.indx];
-    else
-        nl.obj_instr = f.ins;
-    end
-    % verification field
-    nl.obj_val = fun(xval);
-    nl.xval = xval;
+    obj_val = fun(xval);
     % check for Inf or NaN
-    if(any(isnan(nl.obj_val)) || any(isinf(nl.obj_val)))
+    if(any(isnan(obj_val)) || any(isinf(obj_val)))
         error('The objective resulted in Inf or NaN at the initial guess (xval). Please provide a better initial guess vector.');
     end
+    if(isnumeric(f)) %read as number
+        objconst = f;
+    else
+        % affine terms go to the linear objective, only the rest is nonlinear
+        [flin,objconst,isaff,ins] = scipvar.linearParts(f,ndec);
+        fobj = full(flin.');
+        if(~isaff)
+            nl.obj_instr = ins{1};
+            % verification field
+            nl.obj_val = obj_val - fobj.'*xval(:) - objconst;
+            nl.xval = xval;
+        end
+    end
 end
 
+% free expression graph
+scipvar.reset();
+
 % check sparsity
 if(~isempty(A) && ~issparse(A))
     if(warn)
@@ -202,7 +224,10 @@ if(isfield(opts,'tolrfun') && ~isempty(opts.tolrfun))
     sopts.tolrfun = opts.tolrfun;
 end
 if(isfield(opts,'objbias') && ~isempty(opts.objbias))
-    sopts.objbias = opts.objbias;
+    objconst = objconst + opts.objbias;
+end
+if(objconst ~= 0)
+    sopts.objbias = objconst;
 end
 if(isfield(opts,'display') && ~isempty(opts.display))
     sopts.display = dispLevel(opts.display);
@@ -210,7 +235,7 @@ end
 sopts.optiver = optiver;
 
 % run SCIP
-[x,fval,exitflag,stats] = scip([],zeros(ndec,1),A,rl,ru,lb,ub,xint,[],[],nl,x0,sopts);
+[x,fval,exitflag,stats] = scip([],fobj,A,rl,ru,lb,ub,xint,[],[],nl,x0,sopts);
 
 % reshape output
 x = reshape(x,size(xval));
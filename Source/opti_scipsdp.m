@@ -16,6 +16,22 @@ function [x,fval,exitflag,info] = opti_scipsdp(f,A,lhs,rhs,lb,ub,sdp,xtype,x0,op
 %   solution x, the objective value fval, a solver exitflag, and an
 %   information structure.
 %
+%   Besides the optiset fields, the following fields of opts are passed
+%   to the MEX interface (set them directly on the options structure):
+%       sdpwarmstart - warm start each SDP relaxation from the primal/dual
+%                      solution of its parent relaxation [0/1]. Combine
+%                      with x0 (e.g., the solution of a previous, slightly
+%                      perturbed problem) when re-solving a sequence of
+%                      problems.
+%       sdpchordal   - split each SDP cone along the maximal cliques of a
+%                      chordal extension of its aggregate sparsity
+%                      pattern, linking the smaller cones by coupling
+%                      variables [0/1]. The clique sizes of each cone are
+%                      returned in info.SDPcliques.
+%       buildtime    - return the wall clock time of the model building
+%                      phases (validation, variables, linear, sdp) in
+%                      info.BuildTime [0/1].
+%
 %   This is a wrapper for SCIP-SDP using the mex interface.
 %
 %   Copyright (C) 2020- Marc Pfetsch (TU Darmstadt)
@@ -51,6 +67,12 @@ info.BBNodes = stats.BBnodes;
 info.BBGap = stats.BBgap;
 info.PrimalBound = stats.PrimalBound;
 info.DualBound = stats.DualBound;
+if(isfield(stats,'SDPcliques'))
+    info.SDPcliques = stats.SDPcliques;
+end
+if(isfield(stats,'BuildTime'))
+    info.BuildTime = stats.BuildTime;
+end
 info.Time = toc(t);
 info.Algorithm = 'SCIP-SDP: SDP-based Branch and Bound';
 
@@ -6,9 +6,9 @@
 %   [x,fval,exitflag,stats] = scip(H, f, A, rl, ru, lb, ub, xtype, sos, qc, nl, x0, opts)
 %
 %   Input arguments*:
-%       H - quadratic objective matrix (sparse, optional [NOT TRIL / TRIU])
+%       H - quadratic objective matrix (sparse or dense, optional [NOT TRIL / TRIU])
 %       f - linear objective vector
-%       A - linear constraint matrix (sparse)
+%       A - linear constraint matrix (sparse or dense)
 %       rl - linear constraint lhs
 %       ru - linear constraint rhs
 %       lb - decision variable lower bounds
@@ -17,15 +17,74 @@
 %       sos - SOS structure with fields type, index and weight (see below)
 %       qc - Quadratic Constraints structure with fields Q, l, qrl and qru (see below)
 %       nl - Nonlinear Objective and Constraints structure (see below)
-%       x0 - primal solution
+%       x0 - starting point(s), one per column (see below)
 %       opts - solver options (see below)
 %
+%   *All numeric arguments may be double, single, integer or logical; they
+%   are converted to double only when added to SCIP (dense matrices are
+%   scanned column by column for nonzeros).
+%
 %   Return arguments:
 %       x - solution vector
 %       fval - objective value at the solution
 %       exitflag - exit status (see below)
 %       stats - statistics structure
 %
+%   [x,fval,exitflag,stats] = scip('readsolve', filename, opts)
+%
+%   Reads the problem directly from a file in any format supported by the
+%   SCIP readers (e.g., .mps, .lp, .cip, also compressed as .gz) and solves
+%   it, without building the model in MATLAB. x is returned in the order of
+%   the variables in the file. Only the common options below and
+%   solverOpts are used.
+%
+%   [x,fval,exitflag,stats] = scip('benders', master, subprobs, opts)
+%
+%   Solves a two-stage MILP with SCIP's default Benders' decomposition.
+%   master is a structure with fields f, A, rl, ru, lb, ub and xtype (all
+%   but f optional) and subprobs is a cell array of such structures, each
+%   with an additional field link: link(j) is the index of the master
+%   variable that subproblem variable j is a copy of, or 0 for a variable
+%   of the subproblem only. Every subproblem is built in its own SCIP
+%   instance; copies of master variables are continuous and have no
+%   objective there. x contains the master variables only. The common
+%   options and solverOpts (for the master) are used, and bendersthreads
+%   solves the subproblems in parallel if SCIP supports it. stats also
+%   contains BendersSubproblems, BendersCalls and BendersCuts.
+%
+%   n = scip('defineProfile', name, solverOpts)
+%
+%   Defines the parameter profile name from solverOpts, a cell array
+%   {'name1', val1; ...} or the name of a parameter file (.set). The
+%   parameters are checked once and stored until the MEX file is cleared;
+%   solves with opts.profile = name set them without parsing solverOpts
+%   again. n is the number of parameters; an empty solverOpts removes the
+%   profile. Parameters are applied in the order paramfile, profile,
+%   solverOpts, so later ones override earlier ones.
+%
+%   [best,results] = scip('tune', problems, space, opts)
+%
+%   Tunes SCIP parameters over a set of problems. problems is a cell
+%   array of problem file names and structures as for 'benders' (fields
+%   f, A, rl, ru, lb, ub, xtype), space a cell array {'name1', values1;
+%   ...} of parameters and their candidate values (a vector, a char array
+%   of single characters or a cell array); all combinations are tried.
+%   Each configuration is solved on each problem with opts.seeds random
+%   seed shifts (default 1) and a time limit of opts.maxtime (default
+%   60s), in opts.threads worker threads (default: number of cores).
+%   paramfile, profile and solverOpts of opts apply to all runs.
+%   Configurations are scored by the shifted geometric mean (shift
+%   opts.shift, default 10) of the solving time (opts.score = 'time') or
+%   the primal-dual integral ('integral'); failed runs give score Inf.
+%   best is the solverOpts cell array of the configuration with the
+%   smallest score. results contains Configs, Score and Solved (number of
+%   runs solved to optimality or infeasibility, which with objlimit
+%   includes runs without a solution better than objlimit) per
+%   configuration, and Runs with one entry per run (Config, Problem,
+%   Seed, Status, Time, Nodes, Gap, PrimalBound, DualBound, Integral),
+%   e.g., for struct2table(results.Runs). Ctrl-C stops the tuning after
+%   interrupting the running solves; display > 0 prints each run.
+%
 %   Option Fields (all optional - also see scipset):
 %       tolrfun - LP primal convergence tolerance
 %       maxiter - maximum LP solver iterations
@@ -33,6 +92,188 @@
 %       maxtime - maximum execution time [s]
 %       display - solver display level [0-5]
 %       objbias - constant objective bias term
+%       paramfile - SCIP parameter file (.set) read before solverOpts
+%       profile - name of a parameter profile defined with 'defineProfile'
+%       presolvecache - directory of the presolve cache (see below)
+%       presolveonly - only presolve and return the presolved sizes (see below) [0/1]
+%       presolvematrices - with presolveonly, also return the presolved matrices [0/1]
+%       presolvethreads - threads of the parallel presolver PaPILO (if SCIP has it)
+%       reoptobj - matrix of objectives, one column per solve (see below)
+%       buildtime - return the time of each model building phase [0/1]
+%       lazycb - function handle for lazy constraints (see below)
+%       cutcb - function handle for cutting planes (see below)
+%       cutfreq - call cutcb at every cutfreq-th depth (0: root only) [1]
+%       cutmaxdepth - maximal node depth for calling cutcb (-1: any) [-1]
+%       cutminefficacy - minimal efficacy of cuts passed to SCIP [1e-4]
+%       cutmaxround - maximal number of cuts per call (-1: all) [-1]
+%       cutpool - add cuts to the global cut pool instead of the LP [0/1]
+%       pricecb - function handle for column generation (see below)
+%       rowlabels - block of each linear constraint (see below)
+%       varlabels - block of each variable (see below)
+%       branchpriority - branching priority of each variable (higher first)
+%       branchdir - preferred branching direction (-1 down, 0 auto, 1 up)
+%       branchfactor - factor of the branching score of each variable [1]
+%       bendersthreads - threads for Benders' subproblems ('benders' only)
+%       objlimit - objective cutoff, only solutions better than it are sought
+%       relgap - stop at this relative gap between primal and dual bound
+%       absgap - stop at this absolute gap between primal and dual bound
+%       stallnodes - stop after nodes without improvement of the best solution
+%       stalltime - stop after time [s] without improvement of the best solution
+%       maxsols - stop after this number of solutions was found
+%       deadline - stop at this absolute POSIX time [s], e.g., posixtime(datetime)+60
+%       testmode - only build (and validate) the problem, do not solve [0/1]
+%       lpfastpath - solve pure LPs directly with the LP solver (see below) [0/1]
+%       basis - starting basis for the LP fast path (stats.Basis of a previous solve)
+%
+%   Presolve Cache:
+%       If presolvecache is set, a hash of the problem data (all inputs
+%       except x0), of objbias and objlimit, of all SCIP parameters changed
+%       by the options except limits and display settings (e.g., by
+%       tolrfun, solverOpts, paramfile and profile) and of the SCIP version
+%       selects a file in this directory. On a miss, the
+%       presolved problem is stored there; on a hit, building and
+%       presolving the problem is skipped and the cached presolved problem
+%       is solved instead, without presolving rounds and restarts. A cache
+%       file that does not contain all variables of the problem is
+%       rebuilt. stats.PresolveCache is 'hit' or 'miss' and
+%       stats.PresolveTimeSaved is the presolving time recorded with the
+%       cache file minus the presolving time of the hit [s]. x0 is not
+%       used on a hit.
+%
+%   Presolve Only:
+%       If presolveonly is 1 (also with 'readsolve'), the problem is only
+%       presolved, x is 0, fval NaN, and stats.Presolve contains the sizes of
+%       the original (OrigVars, OrigConss) and presolved problem (Vars,
+%       BinVars, IntVars, ImplVars, ContVars, Conss, NNonzeros), the
+%       reductions (FixedVars, AggrVars, ChgVarTypes, ChgBds, DelConss,
+%       AddConss, UpgrConss, ChgCoefs, ChgSides), Rounds, Time [s] and the
+%       Threads of PaPILO (0 if SCIP was built without it). presolvethreads
+%       sets the threads of PaPILO (presolver milp), which presolves in
+%       parallel if SCIP and PaPILO were built with TBB; it is also used
+%       when solving. With presolvematrices = 1, stats.Presolve also
+%       contains the presolved problem in the format of the inputs, f,
+%       ObjOffset, A, rl, ru, lb, ub, xtype, and VarNames, the names of its
+%       variables (e.g., 't_xvar0' for the first continuous variable). A
+%       contains the constraints of linear type; the number of other
+%       constraints is NOtherConss.
+%
+%   Reoptimization:
+%       If reoptobj (ndec x k) is given, SCIP's reoptimization is enabled
+%       and the problem is solved k times within one call, once for each
+%       column of reoptobj as linear objective (f is not used), reusing the
+%       search information of the previous solves. x is then ndec x k and
+%       fval, exitflag and the fields of stats are 1 x k. This is intended
+%       for sequences of MILPs that differ only in the objective.
+%
+%   Build Times:
+%       If buildtime is 1, stats.BuildTime contains the wall clock time [s]
+%       spent in each phase of building the SCIP problem before solving:
+%       validation (input checks, options, SCIP setup), variables, linear,
+%       quadratic (H and qc), sos, nonlinear, and their total.
+%
+%   Lazy Constraints:
+%       If lazycb is given, [A, lhs, rhs] = lazycb(X) is called whenever
+%       SCIP checks or enforces a candidate solution that satisfies all
+%       other constraints. The columns of X are candidate solutions (ndec x
+%       k) and the function returns violated rows lhs <= A*x <= rhs, where
+%       A is sparse with ndec columns, and lhs or rhs may be [] (-inf/inf);
+%       return an empty A if no row is violated. Violated rows are added
+%       as linear constraints; rows returned while SCIP checks a heuristic
+%       solution are kept and tried on later candidates before lazycb is
+%       called again. Dual reductions, symmetry handling and the components
+%       presolver are disabled, since they need all constraints. stats
+%       contains LazyCalls, LazyRows (rows added) and LazyTime, the wall
+%       clock time [s] spent in lazycb including the data conversion.
+%
+%   Cutting Planes:
+%       If cutcb is given, [A, lhs, rhs] = cutcb(x) is called with the
+%       current LP solution x (ndec x 1) at the nodes selected by cutfreq
+%       and cutmaxdepth, after SCIP's own separators. It returns globally
+%       valid rows lhs <= A*x <= rhs in the same format as lazycb. Rows
+%       whose efficacy (violation by x divided by the Euclidean norm of the
+%       row) is below cutminefficacy are dropped; of the others, at most
+%       cutmaxround are passed to SCIP, the most efficacious first, either
+%       to the LP or, with cutpool = 1, to the global cut pool. Cuts must
+%       not remove feasible solutions; use lazycb for constraints. stats
+%       contains CutCalls, CutRows (rows returned), CutsAdded (rows passed
+%       to SCIP) and CutTime, the wall clock time [s] spent in cutcb.
+%
+%   Column Generation:
+%       If pricecb is given, [f, A, ub] = pricecb(y, farkas) is called
+%       whenever the LP relaxation of a node is solved, with the duals y of
+%       the rows of A (ncon x 1). If the LP is infeasible, farkas is true
+%       and y are the Farkas multipliers instead. The function returns new
+%       columns with objective coefficients f (k x 1), sparse coefficients
+%       A (ncon x k) in the linear constraints and upper bounds ub (k x 1,
+%       or [] for inf). They are added as continuous variables with lower
+%       bound 0, in reduced cost pricing only those with f - A'*y < 0;
+%       return an empty A if there are none. Branching is only done on the
+%       original variables, dual reductions and restarts are disabled.
+%       stats contains PriceCalls, PriceColumns (columns added), PriceTime,
+%       the wall clock time [s] spent in pricecb, and PricedX, the values
+%       of the added columns in the solution, in the order they were added.
+%       pricecb cannot be used with reoptobj.
+%
+%   Starting Points:
+%       x0 may be a vector or a matrix with ndec rows, where each column is
+%       passed to SCIP as a starting solution. NaN entries leave a variable
+%       open: such a column is added as partial solution, which SCIP's
+%       completesol heuristic tries to complete, e.g., the continuous
+%       variables for given values of the integers.
+%
+%   Branching Hints:
+%       branchpriority, branchdir and branchfactor are vectors with one
+%       entry per variable; each may be omitted. SCIP branches on the
+%       fractional variables of highest priority first (default 0), prefers
+%       the given child first and weighs branching scores with the factor.
+%       They also apply to all solves of reoptobj, to the variables in file
+%       order with 'readsolve' and to the master variables with 'benders'.
+%
+%   Decomposition:
+%       rowlabels (ncon x 1) and varlabels (ndec x 1) assign the linear
+%       constraints and variables to blocks 0, 1, ..., or -1 for linking
+%       (border) rows and variables; either may be omitted. They are passed
+%       to SCIP as decomposition, which is used by decomposition-aware
+%       heuristics (e.g., GINS and PADM). Missing labels are computed by
+%       SCIP from the given ones: rows get the block of their variables,
+%       variables the block of their rows. stats.Decomp contains NBlocks,
+%       NLinkVars, NLinkConss, AreaScore, Modularity, NBlockGraphEdges and
+%       NBlockGraphComponents of the decomposition.
+%
+%   LP Fast Path:
+%       If all variables are continuous, H, sos, qc and nl are empty and no
+%       option needs the SCIP problem (solverOpts, paramfile, profile,
+%       probfile, presolvedfile, presolvecache, reoptobj, lazycb, cutcb, pricecb, rowlabels,
+%       varlabels, buildtime, objlimit, stalltime, deadline, presolveonly
+%       or testmode),
+%       the LP is solved by the dual simplex of SCIP's LP solver without
+%       presolving or branch-and-bound (maxtime, maxiter, tolrfun, display
+%       and objbias are used, x0 is not). stats then also contains Lambda,
+%       the duals of the rows of A (f - A'*Lambda = RedCost), RedCost, the
+%       reduced costs of the variables, and Basis with fields cstat (ndec x
+%       1) and rstat (ncon x 1), the status of each column and row (0 at
+%       lower bound, 1 basic, 2 at upper bound, 3 free at zero). Passing
+%       Basis as opts.basis warm starts the next solve, e.g., in a pricing
+%       loop with changed objective or bounds. If an iteration limit is
+%       reached, exitflag is 0 and stats.StopReason is 'iterlimit'.
+%       With display > 0, only the LP solver and a summary of the result
+%       are printed, since the log of the LP solver is not shown in MATLAB.
+%       Ctrl-C is not checked while the LP is solved; use maxtime or
+%       maxiter to bound it. Set lpfastpath to 0 to solve LPs with SCIP.
+%
+%   Early Termination:
+%       objlimit, relgap, absgap, stallnodes, stalltime, maxsols and
+%       deadline stop the solve early (deadline reduces maxtime to the time
+%       left when the solve starts, also for each solve of reoptobj).
+%       stats.StopReason names the reason why SCIP stopped: 'optimal',
+%       'infeasible', 'infeasible_or_objlimit' (with objlimit, SCIP cannot
+%       tell an infeasible problem from one without a solution better than
+%       objlimit; exitflag is that of an infeasible problem), 'unbounded',
+%       'inforunbd', 'timelimit', 'deadline', 'gaplimit', 'absgaplimit',
+%       'sollimit', 'bestsollimit', 'stallnodes', 'stalltime',
+%       'userinterrupt', 'nodelimit', 'totalnodelimit', 'memlimit',
+%       'restartlimit' or 'unknown'. With reoptobj, it is a cell array with
+%       one entry per solve.
 %
 %   Return Status:
 %       0 - Unknown
@@ -53,14 +294,15 @@
 %
 %   Special Ordered Sets (SOS):
 %       type    - A string containing '1' or '2' for each SOS1 or SOS2 constraint.
-%       index   - A double array of the indices of the variables in the SOS,
-%                 group multiple SOS index arrays in a cell array.
+%       index   - A double array of the indices of the variables in the SOS
+%                 (or a logical mask of the variables), group multiple SOS
+%                 index arrays in a cell array.
 %       weight  - A double array of the weights of each of the variable
 %                 above, indicating variables next to each other. Group 
 %                 multiple SOS via cell arrays as above.
 %
 %   Quadratic Constraints (QC) [qrl <= x'Qx + l'x <= qru]:
-%       Q       - A sparse double matrix of the quadratic terms for the
+%       Q       - A sparse or dense matrix of the quadratic terms for the
 %                 constraint, group multiple quadratic constraints via a
 %                 cell array of matrices. [NOT TRIL / TRIU]
 %       l       - A column vector of the linear terms for the constraint,
@@ -16,6 +16,8 @@
 
 #include "mex.h"
 #include <string.h>
+#include <stdio.h>
+#include <limits.h>
 
 /** OPTI Version Checker Function */
 inline void CheckOptiVersion(const mxArray* opts)
@@ -42,4 +44,16 @@ inline void CheckOptiVersion(const mxArray* opts)
    }
 }
 
+/** Size Checker Function: SCIP counts variables, constraints, and the terms of a constraint with int, so larger
+ *  sizes have to be rejected before they are silently truncated. */
+inline void CheckIntSize(size_t n, const char* what)
+{
+   if ( n > (size_t) INT_MAX )
+   {
+      char buf[1024];
+      snprintf(buf, 1024, "The number of %s (%zu) exceeds the maximum of %d supported by SCIP.", what, n, INT_MAX);
+      mexErrMsgTxt(buf);
+   }
+}
+
 #endif // OPTI_BUILD_UTILS
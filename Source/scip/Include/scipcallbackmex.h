@@ -0,0 +1,107 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * SCIP plugins that call back into MATLAB.
+ */
+
+#ifndef SCIPCALLBACKMEXINC
+#define SCIPCALLBACKMEXINC
+
+#include "mex.h"
+#include <scip/scip.h>
+
+/** add constraint handler for lazy constraints given by a MATLAB function
+ *
+ *  The function is called as [A, lhs, rhs] = callback(X), where the columns of X are candidate solutions in terms of
+ *  the original variables, and has to return (some of) the rows lhs <= A*x <= rhs that these candidates violate.
+ */
+SCIP_EXPORT
+SCIP_RETCODE SCIPincludeConshdlrMatlabLazy(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        callback,           /**< function handle or name (has to exist until SCIP is freed) */
+   SCIP_VAR**            vars,               /**< original variables */
+   int                   nvars               /**< number of original variables */
+   );
+
+/** get statistics of the lazy constraint callback */
+SCIP_EXPORT
+void SCIPgetConshdlrMatlabLazyStats(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_Longint*         ncalls,             /**< number of calls of the MATLAB function */
+   SCIP_Longint*         nrows,              /**< number of rows added as constraints */
+   SCIP_Real*            time                /**< wall clock time spent in MATLAB, including marshalling [s] */
+   );
+
+/** add separator for cutting planes given by a MATLAB function
+ *
+ *  The function is called as [A, lhs, rhs] = callback(x), where x is the current LP solution in terms of the original
+ *  variables, and has to return globally valid rows lhs <= A*x <= rhs. Only rows whose Euclidean efficacy is at least
+ *  minefficacy are passed to SCIP, at most maxcuts of them and the most efficacious first.
+ */
+SCIP_EXPORT
+SCIP_RETCODE SCIPincludeSepaMatlabCuts(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        callback,           /**< function handle or name (has to exist until SCIP is freed) */
+   SCIP_VAR**            vars,               /**< original variables */
+   int                   nvars,              /**< number of original variables */
+   int                   freq,               /**< frequency of calls in the tree (0: only root, -1: never) */
+   int                   maxdepth,           /**< maximal depth at which the function is called (-1: no limit) */
+   SCIP_Real             minefficacy,        /**< minimal efficacy of a cut to be passed to SCIP */
+   int                   maxcuts,            /**< maximal number of cuts passed to SCIP per call (-1: no limit) */
+   SCIP_Bool             usepool             /**< add cuts to the global cut pool instead of the LP? */
+   );
+
+/** get statistics of the cut callback */
+SCIP_EXPORT
+void SCIPgetSepaMatlabCutsStats(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_Longint*         ncalls,             /**< number of calls of the MATLAB function */
+   SCIP_Longint*         nfound,             /**< number of rows returned by the MATLAB function */
+   SCIP_Longint*         ncuts,              /**< number of cuts passed to SCIP after filtering */
+   SCIP_Real*            time                /**< wall clock time spent in MATLAB, including marshalling [s] */
+   );
+
+/** add and activate pricer for columns given by a MATLAB function
+ *
+ *  The function is called as [f, A, ub] = callback(y, farkas), where y are the dual values (or, if farkas is true, the
+ *  Farkas multipliers) of the given linear constraints, and returns new columns with objective coefficients f, sparse
+ *  coefficients A in the constraints and upper bounds ub (or []). The columns are added as continuous variables with
+ *  lower bound 0; in reduced cost pricing only columns with negative reduced cost are added. The constraints are made
+ *  modifiable.
+ */
+SCIP_EXPORT
+SCIP_RETCODE SCIPincludePricerMatlabColumns(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        callback,           /**< function handle or name (has to exist until SCIP is freed) */
+   SCIP_CONS**           conss,              /**< original linear constraints the columns have coefficients in */
+   int                   nconss              /**< number of linear constraints */
+   );
+
+/** get statistics of the pricing callback */
+SCIP_EXPORT
+void SCIPgetPricerMatlabColumnsStats(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_Longint*         ncalls,             /**< number of calls of the MATLAB function */
+   int*                  ncols,              /**< number of columns added */
+   SCIP_Real*            time                /**< wall clock time spent in MATLAB, including marshalling [s] */
+   );
+
+/** get the values of the columns added by the pricer in a solution, in the order they were added */
+SCIP_EXPORT
+SCIP_RETCODE SCIPgetPricerMatlabColumnsVals(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_SOL*             sol,                /**< solution */
+   SCIP_Real*            vals                /**< array to store the values (length: ncols of the statistics) */
+   );
+
+/** copies the MATLAB error raised in the last failed callback to msg and clears it, returns FALSE if there was none
+ *
+ *  Errors in the MATLAB functions stop the solve with an error code; the MATLAB error is raised after SCIP is freed.
+ */
+SCIP_EXPORT
+SCIP_Bool SCIPgetMatlabCallbackError(
+   char*                 msg,                /**< buffer to store the message */
+   size_t                msgsize             /**< size of buffer */
+   );
+
+#endif
@@ -19,4 +19,23 @@ SCIP_RETCODE SCIPincludeCtrlCEventHdlr(
    SCIP*                 scip                /**< SCIP instance */
    );
 
+/** add event handler that interrupts the solve if the best solution did not improve for stalltime seconds */
+SCIP_EXPORT
+SCIP_RETCODE SCIPincludeStallTimeEventHdlr(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_Real             stalltime           /**< maximal solving time without improvement [s] */
+   );
+
+/** returns whether the last solve was interrupted by the stall time event handler */
+SCIP_EXPORT
+SCIP_Bool SCIPisStallTimeReached(
+   SCIP*                 scip                /**< SCIP instance */
+   );
+
+/** returns whether Ctrl-C was pressed in MATLAB and resets it, for waiting loops outside of a SCIP solve */
+SCIP_EXPORT
+SCIP_Bool SCIPisCtrlCPending(
+   void
+   );
+
 #endif
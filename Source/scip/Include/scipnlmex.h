@@ -28,4 +28,10 @@ double addNonlinearCon(
    bool                  isObj               /**< is this the objective function */
    );
 
+/** enable or disable adding affine and quadratic instruction lists as linear or quadratic constraints (default: on) */
+SCIP_EXPORT
+void setQuadraticDetection(
+   bool                  enable              /**< whether to detect affine and quadratic instruction lists */
+   );
+
 #endif
@@ -0,0 +1,944 @@
+/* SCIPMEX - A MATLAB MEX Interface to SCIP
+ * Released Under the BSD 3-Clause License.
+ *
+ * SCIP plugins that call back into MATLAB.
+ */
+
+#include "mex.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <scip/scip.h>
+#include <scip/cons_linear.h>
+#include "scipcallbackmex.h"
+
+using std::vector;
+
+#define CONSHDLR_NAME          "matlablazy"
+#define CONSHDLR_DESC          "lazy constraints given by a MATLAB function"
+#define CONSHDLR_ENFOPRIORITY  -5000000 /**< enforce after integrality, i.e., only for integral candidates */
+#define CONSHDLR_CHECKPRIORITY -5000000 /**< check after all constraints known to SCIP */
+#define CONSHDLR_EAGERFREQ     -1
+#define CONSHDLR_NEEDSCONS     FALSE
+
+#define SEPA_NAME              "matlabcuts"
+#define SEPA_DESC              "cutting planes given by a MATLAB function"
+#define SEPA_PRIORITY          -100000  /**< separate after SCIP's own separators */
+#define SEPA_MAXBOUNDDIST      1.0
+#define SEPA_USESSUBSCIP       FALSE
+#define SEPA_DELAY             FALSE
+
+#define PRICER_NAME            "matlabcolumns"
+#define PRICER_DESC            "columns given by a MATLAB function"
+#define PRICER_PRIORITY        0
+#define PRICER_DELAY           TRUE     /**< only price if no other pricer found a column */
+
+/** row lhs <= a^T x <= rhs returned by a MATLAB function */
+struct CallbackRow
+{
+   vector<int>           ind;                /**< indices of the original variables */
+   vector<SCIP_Real>     val;                /**< coefficients */
+   SCIP_Real             lhs;                /**< left hand side */
+   SCIP_Real             rhs;                /**< right hand side */
+};
+
+/** constraint handler data */
+struct SCIP_ConshdlrData
+{
+   const mxArray*        callback;           /**< function handle or name */
+   vector<SCIP_VAR*>     vars;               /**< original variables */
+   vector<SCIP_VAR*>     transvars;          /**< transformed variables (set when locking) */
+   int                   nvars;              /**< number of original variables */
+   vector<CallbackRow>   pending;            /**< rows returned while checking, which are added when enforcing */
+   SCIP_Longint          ncalls;             /**< number of calls of the MATLAB function */
+   SCIP_Longint          nrows;              /**< number of rows added as constraints */
+   SCIP_Real             time;               /**< time spent in MATLAB [s] */
+};
+
+/** pricer data */
+struct SCIP_PricerData
+{
+   const mxArray*        callback;           /**< function handle or name */
+   vector<SCIP_CONS*>    conss;              /**< original linear constraints */
+   vector<SCIP_CONS*>    transconss;         /**< transformed linear constraints (set when initializing) */
+   int                   nconss;             /**< number of linear constraints */
+   vector<SCIP_VAR*>     pricedvars;         /**< variables added by the pricer, in order of creation */
+   SCIP_Longint          ncalls;             /**< number of calls of the MATLAB function */
+   SCIP_Real             time;               /**< time spent in MATLAB [s] */
+};
+
+/** separator data */
+struct SCIP_SepaData
+{
+   const mxArray*        callback;           /**< function handle or name */
+   vector<SCIP_VAR*>     vars;               /**< original variables */
+   int                   nvars;              /**< number of original variables */
+   int                   maxdepth;           /**< maximal depth at which the function is called (-1: no limit) */
+   SCIP_Real             minefficacy;        /**< minimal efficacy of a cut to be passed to SCIP */
+   int                   maxcuts;            /**< maximal number of cuts passed to SCIP per call (-1: no limit) */
+   SCIP_Bool             usepool;            /**< add cuts to the global cut pool instead of the LP? */
+   SCIP_Longint          ncalls;             /**< number of calls of the MATLAB function */
+   SCIP_Longint          nfound;             /**< number of rows returned by the MATLAB function */
+   SCIP_Longint          ncuts;              /**< number of cuts passed to SCIP */
+   SCIP_Real             time;               /**< time spent in MATLAB [s] */
+};
+
+/** message of the last MATLAB error in a callback, raised after SCIP has been freed */
+static std::string callbackerror;
+
+
+/** calls a MATLAB function via feval, trapping errors so that the solve can be left with an error code
+ *
+ *  The outputs are not assigned on errors.
+ */
+static
+SCIP_RETCODE callMatlabFunction(
+   int                   nlhs,               /**< number of outputs */
+   mxArray*              plhs[],             /**< outputs */
+   int                   nrhs,               /**< number of inputs (function handle or name first) */
+   mxArray*              prhs[],             /**< inputs */
+   const char*           what                /**< name of the callback for error messages */
+   )
+{
+   mxArray* exception = mexCallMATLABWithTrap(nlhs, plhs, nrhs, prhs, "feval");
+   mxArray* message;
+   char* str;
+
+   if ( exception == NULL )
+      return SCIP_OKAY;
+
+   message = mxGetProperty(exception, 0, "message");
+   str = message != NULL ? mxArrayToString(message) : NULL;
+   callbackerror = std::string("Error in the ") + what + " callback: " + ( str != NULL ? str : "unknown error" );
+   if ( str != NULL )
+      mxFree(str);
+   if ( message != NULL )
+      mxDestroyArray(message);
+   mxDestroyArray(exception);
+
+   return SCIP_ERROR;
+}
+
+/** returns whether a row is violated by a solution */
+static
+SCIP_Bool isRowViolated(
+   SCIP*                 scip,               /**< SCIP instance */
+   const CallbackRow&    row,                /**< row */
+   const SCIP_Real*      x                   /**< values of the original variables */
+   )
+{
+   SCIP_Real activity = 0.0;
+
+   for (size_t k = 0; k < row.ind.size(); ++k)
+      activity += row.val[k] * x[row.ind[k]];
+
+   return SCIPisFeasLT(scip, activity, row.lhs) || SCIPisFeasGT(scip, activity, row.rhs);
+}
+
+/** calls a MATLAB function [A, lhs, rhs] = callback(X) and collects the returned rows */
+static
+SCIP_RETCODE callRowCallback(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        callback,           /**< function handle or name */
+   mxArray*              X,                  /**< point(s) passed to the function (nvars x k) */
+   int                   nvars,              /**< number of original variables */
+   const char*           what,               /**< name of the callback for error messages */
+   vector<CallbackRow>&  rows,               /**< rows returned by the function (appended) */
+   SCIP_Longint*         ncalls,             /**< counter of calls to increase */
+   SCIP_Real*            time                /**< time spent in MATLAB to increase [s] */
+   )
+{
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   mxArray* cbrhs[2];
+   mxArray* cblhs[3] = {NULL, NULL, NULL};
+   const mxArray* A;
+   SCIP_RETCODE retcode = SCIP_OKAY;
+   size_t m;
+   size_t nrows = rows.size();
+
+   cbrhs[0] = (mxArray*) callback;
+   cbrhs[1] = X;
+   retcode = callMatlabFunction(3, cblhs, 2, cbrhs, what);
+   ++(*ncalls);
+
+   /* no rows */
+   A = cblhs[0];
+   m = ( A == NULL || mxIsEmpty(A) ) ? 0 : mxGetM(A);
+
+   if ( retcode != SCIP_OKAY )
+   {
+      /* the MATLAB error is raised after SCIP has been freed */
+   }
+   else if ( m > 0 && ( ! mxIsSparse(A) || ! mxIsDouble(A) || mxIsComplex(A) || mxGetN(A) != (size_t) nvars ) )
+   {
+      SCIPerrorMessage("The %s callback has to return a real sparse matrix A with %d columns.\n", what, nvars);
+      retcode = SCIP_INVALIDDATA;
+   }
+   else if ( ( ! mxIsEmpty(cblhs[1]) && ( ! mxIsDouble(cblhs[1]) || mxIsSparse(cblhs[1]) || mxGetNumberOfElements(cblhs[1]) != m ) )
+      || ( ! mxIsEmpty(cblhs[2]) && ( ! mxIsDouble(cblhs[2]) || mxIsSparse(cblhs[2]) || mxGetNumberOfElements(cblhs[2]) != m ) ) )
+   {
+      SCIPerrorMessage("The %s callback has to return dense vectors lhs and rhs with one entry per row of A (or []).\n", what);
+      retcode = SCIP_INVALIDDATA;
+   }
+   else if ( m > 0 )
+   {
+      const mwIndex* jc = mxGetJc(A);
+      const mwIndex* ir = mxGetIr(A);
+      const double* pr = mxGetPr(A);
+      const double* lhs = mxIsEmpty(cblhs[1]) ? NULL : mxGetPr(cblhs[1]);
+      const double* rhs = mxIsEmpty(cblhs[2]) ? NULL : mxGetPr(cblhs[2]);
+
+      rows.resize(nrows + m);
+      for (size_t i = 0; i < m; ++i)
+      {
+         rows[nrows + i].lhs = ( lhs == NULL || mxIsInf(lhs[i]) ) ? -SCIPinfinity(scip) : lhs[i];
+         rows[nrows + i].rhs = ( rhs == NULL || mxIsInf(rhs[i]) ) ? SCIPinfinity(scip) : rhs[i];
+      }
+
+      /* A is stored column-wise */
+      for (int j = 0; j < nvars; ++j)
+      {
+         for (mwIndex k = jc[j]; k < jc[j+1]; ++k)
+         {
+            rows[nrows + ir[k]].ind.push_back(j);
+            rows[nrows + ir[k]].val.push_back(pr[k]);
+         }
+      }
+   }
+
+   for (int i = 0; i < 3; ++i)
+   {
+      if ( cblhs[i] != NULL )
+         mxDestroyArray(cblhs[i]);
+   }
+
+   *time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+   return retcode;
+}
+
+/** calls the lazy constraint function for the candidates given as columns of X and collects the returned rows */
+static
+SCIP_RETCODE callLazyCallback(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_CONSHDLRDATA*    conshdlrdata,       /**< constraint handler data */
+   mxArray*              X,                  /**< candidate solutions (nvars x k) */
+   vector<CallbackRow>&  rows                /**< rows returned by the function (appended) */
+   )
+{
+   SCIP_CALL( callRowCallback(scip, conshdlrdata->callback, X, conshdlrdata->nvars, "lazy constraint", rows,
+         &conshdlrdata->ncalls, &conshdlrdata->time) );
+
+   return SCIP_OKAY;
+}
+
+/** adds a row as (global) linear constraint */
+static
+SCIP_RETCODE addLazyRow(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_CONSHDLRDATA*    conshdlrdata,       /**< constraint handler data */
+   const CallbackRow&    row                 /**< row */
+   )
+{
+   char name[SCIP_MAXSTRLEN];
+   SCIP_CONS* cons;
+   vector<SCIP_VAR*> vars(row.ind.size());
+
+   for (size_t k = 0; k < row.ind.size(); ++k)
+      vars[k] = conshdlrdata->transvars[row.ind[k]];
+
+   (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "lazycon%" SCIP_LONGINT_FORMAT, conshdlrdata->nrows);
+   SCIP_CALL( SCIPcreateConsLinear(scip, &cons, name, (int) vars.size(), vars.empty() ? NULL : &vars[0],
+         row.val.empty() ? NULL : (SCIP_Real*) &row.val[0], row.lhs, row.rhs,
+         TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE) );
+   SCIP_CALL( SCIPaddCons(scip, cons) );
+   SCIP_CALL( SCIPreleaseCons(scip, &cons) );
+   ++conshdlrdata->nrows;
+
+   return SCIP_OKAY;
+}
+
+/** enforces the lazy constraints for the current LP or pseudo solution */
+static
+SCIP_RETCODE enforceLazy(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_CONSHDLR*        conshdlr,           /**< constraint handler */
+   SCIP_RESULT*          result              /**< result */
+   )
+{
+   SCIP_CONSHDLRDATA* conshdlrdata = SCIPconshdlrGetData(conshdlr);
+   vector<CallbackRow> rows;
+   vector<CallbackRow> keep;
+   mxArray* X;
+   double* x;
+
+   *result = SCIP_FEASIBLE;
+
+   X = mxCreateDoubleMatrix(conshdlrdata->nvars, 1, mxREAL);
+   x = mxGetPr(X);
+   SCIP_CALL( SCIPgetSolVals(scip, NULL, conshdlrdata->nvars, &conshdlrdata->vars[0], x) );
+
+   /* rows found while checking earlier candidates may already cut off this one, without calling MATLAB */
+   rows.swap(conshdlrdata->pending);
+   for (size_t i = 0; i < rows.size(); ++i)
+   {
+      if ( isRowViolated(scip, rows[i], x) )
+         *result = SCIP_CONSADDED;
+   }
+
+   if ( *result == SCIP_FEASIBLE )
+   {
+      SCIP_CALL( callLazyCallback(scip, conshdlrdata, X, rows) );
+   }
+
+   /* add violated rows, keep the others for later candidates */
+   for (size_t i = 0; i < rows.size(); ++i)
+   {
+      if ( isRowViolated(scip, rows[i], x) )
+      {
+         SCIP_CALL( addLazyRow(scip, conshdlrdata, rows[i]) );
+         *result = SCIP_CONSADDED;
+      }
+      else
+         keep.push_back(rows[i]);
+   }
+   conshdlrdata->pending.swap(keep);
+
+   mxDestroyArray(X);
+
+   return SCIP_OKAY;
+}
+
+
+/** destructor of constraint handler to free constraint handler data */
+static
+SCIP_DECL_CONSFREE(consFreeMatlabLazy)
+{
+   delete SCIPconshdlrGetData(conshdlr);
+   SCIPconshdlrSetData(conshdlr, NULL);
+
+   return SCIP_OKAY;
+}
+
+/** constraint enforcing method of constraint handler for LP solutions */
+static
+SCIP_DECL_CONSENFOLP(consEnfolpMatlabLazy)
+{
+   SCIP_CALL( enforceLazy(scip, conshdlr, result) );
+
+   return SCIP_OKAY;
+}
+
+/** constraint enforcing method of constraint handler for pseudo solutions */
+static
+SCIP_DECL_CONSENFOPS(consEnfopsMatlabLazy)
+{
+   SCIP_CALL( enforceLazy(scip, conshdlr, result) );
+
+   return SCIP_OKAY;
+}
+
+/** feasibility check method of constraint handler for integral solutions */
+static
+SCIP_DECL_CONSCHECK(consCheckMatlabLazy)
+{
+   SCIP_CONSHDLRDATA* conshdlrdata = SCIPconshdlrGetData(conshdlr);
+   mxArray* X;
+   double* x;
+   size_t i;
+
+   *result = SCIP_FEASIBLE;
+
+   X = mxCreateDoubleMatrix(conshdlrdata->nvars, 1, mxREAL);
+   x = mxGetPr(X);
+   SCIP_CALL( SCIPgetSolVals(scip, sol, conshdlrdata->nvars, &conshdlrdata->vars[0], x) );
+
+   /* first try the rows that are not added yet */
+   for (i = 0; i < conshdlrdata->pending.size(); ++i)
+   {
+      if ( isRowViolated(scip, conshdlrdata->pending[i], x) )
+      {
+         *result = SCIP_INFEASIBLE;
+         break;
+      }
+   }
+
+   /* rows cannot be added while checking, so they are kept until the next enforcement */
+   if ( *result == SCIP_FEASIBLE )
+   {
+      size_t npending = conshdlrdata->pending.size();
+
+      SCIP_CALL( callLazyCallback(scip, conshdlrdata, X, conshdlrdata->pending) );
+
+      for (i = npending; i < conshdlrdata->pending.size(); ++i)
+      {
+         if ( isRowViolated(scip, conshdlrdata->pending[i], x) )
+         {
+            *result = SCIP_INFEASIBLE;
+            if ( printreason )
+               SCIPinfoMessage(scip, NULL, "solution violates lazy constraint returned by MATLAB callback\n");
+            break;
+         }
+      }
+   }
+
+   mxDestroyArray(X);
+
+   return SCIP_OKAY;
+}
+
+/** variable rounding lock method of constraint handler */
+static
+SCIP_DECL_CONSLOCK(consLockMatlabLazy)
+{
+   SCIP_CONSHDLRDATA* conshdlrdata = SCIPconshdlrGetData(conshdlr);
+
+   /* the variables are locked when the problem is transformed (and unlocked when it is freed) */
+   if ( nlockspos + nlocksneg > 0 )
+   {
+      conshdlrdata->transvars.resize(conshdlrdata->nvars);
+      SCIP_CALL( SCIPgetTransformedVars(scip, conshdlrdata->nvars, &conshdlrdata->vars[0], &conshdlrdata->transvars[0]) );
+   }
+
+   /* the lazy constraints are unknown, so every variable may appear with either sign */
+   for (size_t i = 0; i < conshdlrdata->transvars.size(); ++i)
+   {
+      SCIP_CALL( SCIPaddVarLocksType(scip, conshdlrdata->transvars[i], locktype, nlockspos + nlocksneg, nlockspos + nlocksneg) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** sets a parameter if it exists in this SCIP version */
+static
+SCIP_RETCODE setParamIfExists(
+   SCIP*                 scip,               /**< SCIP instance */
+   const char*           name,               /**< parameter name */
+   int                   value               /**< value (bool parameters: 0/1) */
+   )
+{
+   SCIP_PARAM* param = SCIPgetParam(scip, name);
+
+   if ( param == NULL )
+      return SCIP_OKAY;
+
+   if ( SCIPparamGetType(param) == SCIP_PARAMTYPE_BOOL )
+   {
+      SCIP_CALL( SCIPsetBoolParam(scip, name, value != 0) );
+   }
+   else
+   {
+      SCIP_CALL( SCIPsetIntParam(scip, name, value) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** add constraint handler for lazy constraints given by a MATLAB function */
+SCIP_RETCODE SCIPincludeConshdlrMatlabLazy(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        callback,           /**< function handle or name (has to exist until SCIP is freed) */
+   SCIP_VAR**            vars,               /**< original variables */
+   int                   nvars               /**< number of original variables */
+   )
+{
+   SCIP_CONSHDLRDATA* conshdlrdata = new SCIP_CONSHDLRDATA;
+   SCIP_CONSHDLR* conshdlr = NULL;
+
+   conshdlrdata->callback = callback;
+   conshdlrdata->vars.assign(vars, vars + nvars);
+   conshdlrdata->nvars = nvars;
+   conshdlrdata->ncalls = 0;
+   conshdlrdata->nrows = 0;
+   conshdlrdata->time = 0.0;
+
+   SCIP_CALL( SCIPincludeConshdlrBasic(scip, &conshdlr, CONSHDLR_NAME, CONSHDLR_DESC, CONSHDLR_ENFOPRIORITY,
+         CONSHDLR_CHECKPRIORITY, CONSHDLR_EAGERFREQ, CONSHDLR_NEEDSCONS, consEnfolpMatlabLazy, consEnfopsMatlabLazy,
+         consCheckMatlabLazy, consLockMatlabLazy, conshdlrdata) );
+   SCIP_CALL( SCIPsetConshdlrFree(scip, conshdlr, consFreeMatlabLazy) );
+
+   /* reductions that rely on knowing all constraints are invalid with lazy constraints */
+   SCIP_CALL( setParamIfExists(scip, "misc/allowdualreds", 0) );
+   SCIP_CALL( setParamIfExists(scip, "misc/allowstrongdualreds", 0) );
+   SCIP_CALL( setParamIfExists(scip, "misc/allowweakdualreds", 0) );
+   SCIP_CALL( setParamIfExists(scip, "misc/usesymmetry", 0) );
+   SCIP_CALL( setParamIfExists(scip, "constraints/components/maxprerounds", 0) );
+   SCIP_CALL( setParamIfExists(scip, "constraints/components/propfreq", -1) );
+
+   return SCIP_OKAY;
+}
+
+/** get statistics of the lazy constraint callback */
+void SCIPgetConshdlrMatlabLazyStats(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_Longint*         ncalls,             /**< number of calls of the MATLAB function */
+   SCIP_Longint*         nrows,              /**< number of rows added as constraints */
+   SCIP_Real*            time                /**< wall clock time spent in MATLAB, including marshalling [s] */
+   )
+{
+   SCIP_CONSHDLR* conshdlr = SCIPfindConshdlr(scip, CONSHDLR_NAME);
+   SCIP_CONSHDLRDATA* conshdlrdata = conshdlr != NULL ? SCIPconshdlrGetData(conshdlr) : NULL;
+
+   *ncalls = conshdlrdata != NULL ? conshdlrdata->ncalls : 0;
+   *nrows = conshdlrdata != NULL ? conshdlrdata->nrows : 0;
+   *time = conshdlrdata != NULL ? conshdlrdata->time : 0.0;
+}
+
+
+/** returns the Euclidean efficacy of a row, i.e., its violation by x divided by the norm of its coefficients */
+static
+SCIP_Real getRowEfficacy(
+   SCIP*                 scip,               /**< SCIP instance */
+   const CallbackRow&    row,                /**< row */
+   const SCIP_Real*      x                   /**< values of the original variables */
+   )
+{
+   SCIP_Real activity = 0.0;
+   SCIP_Real norm = 0.0;
+   SCIP_Real viol = 0.0;
+
+   for (size_t k = 0; k < row.ind.size(); ++k)
+   {
+      activity += row.val[k] * x[row.ind[k]];
+      norm += row.val[k] * row.val[k];
+   }
+
+   if ( ! SCIPisInfinity(scip, -row.lhs) )
+      viol = MAX(viol, row.lhs - activity);
+   if ( ! SCIPisInfinity(scip, row.rhs) )
+      viol = MAX(viol, activity - row.rhs);
+
+   return norm > 0.0 ? viol / sqrt(norm) : 0.0;
+}
+
+/** passes a row to SCIP as cut, either to the LP or to the global cut pool */
+static
+SCIP_RETCODE addCutRow(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_SEPA*            sepa,               /**< separator */
+   const CallbackRow&    row,                /**< row */
+   SCIP_VAR**            transvars,          /**< transformed variables */
+   SCIP_Bool*            cutoff              /**< pointer to store whether the cut proves infeasibility */
+   )
+{
+   SCIP_SEPADATA* sepadata = SCIPsepaGetData(sepa);
+   char name[SCIP_MAXSTRLEN];
+   SCIP_ROW* cut;
+   vector<SCIP_VAR*> vars(row.ind.size());
+
+   for (size_t k = 0; k < row.ind.size(); ++k)
+      vars[k] = transvars[row.ind[k]];
+
+   /* cuts are globally valid and may be removed from the LP again */
+   (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "matlabcut%" SCIP_LONGINT_FORMAT, sepadata->ncuts);
+   SCIP_CALL( SCIPcreateEmptyRowSepa(scip, &cut, sepa, name, row.lhs, row.rhs, FALSE, FALSE, TRUE) );
+   SCIP_CALL( SCIPaddVarsToRow(scip, cut, (int) vars.size(), vars.empty() ? NULL : &vars[0],
+         row.val.empty() ? NULL : (SCIP_Real*) &row.val[0]) );
+
+   if ( sepadata->usepool )
+   {
+      SCIP_CALL( SCIPaddPoolCut(scip, cut) );
+   }
+   else
+   {
+      SCIP_CALL( SCIPaddRow(scip, cut, FALSE, cutoff) );
+   }
+   ++sepadata->ncuts;
+
+   SCIP_CALL( SCIPreleaseRow(scip, &cut) );
+
+   return SCIP_OKAY;
+}
+
+/** orders cut candidates by decreasing efficacy */
+static
+bool compareEfficacy(
+   const std::pair<SCIP_Real, size_t>& a,    /**< first candidate */
+   const std::pair<SCIP_Real, size_t>& b     /**< second candidate */
+   )
+{
+   return a.first > b.first;
+}
+
+
+/** destructor of separator to free separator data */
+static
+SCIP_DECL_SEPAFREE(sepaFreeMatlabCuts)
+{
+   delete SCIPsepaGetData(sepa);
+   SCIPsepaSetData(sepa, NULL);
+
+   return SCIP_OKAY;
+}
+
+/** LP solution separation method of separator */
+static
+SCIP_DECL_SEPAEXECLP(sepaExeclpMatlabCuts)
+{
+   SCIP_SEPADATA* sepadata = SCIPsepaGetData(sepa);
+   vector<CallbackRow> rows;
+   vector<std::pair<SCIP_Real, size_t> > cands;
+   vector<SCIP_VAR*> transvars;
+   SCIP_Bool cutoff = FALSE;
+   mxArray* X;
+   double* x;
+   size_t ncands;
+
+   *result = SCIP_DIDNOTRUN;
+
+   if ( sepadata->maxdepth >= 0 && SCIPgetDepth(scip) > sepadata->maxdepth )
+      return SCIP_OKAY;
+
+   *result = SCIP_DIDNOTFIND;
+
+   X = mxCreateDoubleMatrix(sepadata->nvars, 1, mxREAL);
+   x = mxGetPr(X);
+   SCIP_CALL( SCIPgetSolVals(scip, NULL, sepadata->nvars, &sepadata->vars[0], x) );
+
+   SCIP_CALL( callRowCallback(scip, sepadata->callback, X, sepadata->nvars, "cut", rows, &sepadata->ncalls, &sepadata->time) );
+   sepadata->nfound += (SCIP_Longint) rows.size();
+
+   /* only cuts that are violated enough reach SCIP, the most efficacious ones first */
+   for (size_t i = 0; i < rows.size(); ++i)
+   {
+      SCIP_Real efficacy = getRowEfficacy(scip, rows[i], x);
+
+      if ( efficacy >= sepadata->minefficacy && SCIPisFeasPositive(scip, efficacy) )
+         cands.push_back(std::make_pair(efficacy, i));
+   }
+   std::stable_sort(cands.begin(), cands.end(), compareEfficacy);
+
+   ncands = cands.size();
+   if ( sepadata->maxcuts >= 0 && ncands > (size_t) sepadata->maxcuts )
+      ncands = (size_t) sepadata->maxcuts;
+
+   if ( ncands > 0 )
+   {
+      transvars.resize(sepadata->nvars);
+      SCIP_CALL( SCIPgetTransformedVars(scip, sepadata->nvars, &sepadata->vars[0], &transvars[0]) );
+   }
+
+   for (size_t i = 0; i < ncands && ! cutoff; ++i)
+   {
+      SCIP_CALL( addCutRow(scip, sepa, rows[cands[i].second], &transvars[0], &cutoff) );
+      *result = SCIP_SEPARATED;
+   }
+
+   if ( cutoff )
+      *result = SCIP_CUTOFF;
+
+   mxDestroyArray(X);
+
+   return SCIP_OKAY;
+}
+
+/** add separator for cutting planes given by a MATLAB function */
+SCIP_RETCODE SCIPincludeSepaMatlabCuts(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        callback,           /**< function handle or name (has to exist until SCIP is freed) */
+   SCIP_VAR**            vars,               /**< original variables */
+   int                   nvars,              /**< number of original variables */
+   int                   freq,               /**< frequency of calls in the tree (0: only root, -1: never) */
+   int                   maxdepth,           /**< maximal depth at which the function is called (-1: no limit) */
+   SCIP_Real             minefficacy,        /**< minimal efficacy of a cut to be passed to SCIP */
+   int                   maxcuts,            /**< maximal number of cuts passed to SCIP per call (-1: no limit) */
+   SCIP_Bool             usepool             /**< add cuts to the global cut pool instead of the LP? */
+   )
+{
+   SCIP_SEPADATA* sepadata = new SCIP_SEPADATA;
+   SCIP_SEPA* sepa = NULL;
+
+   sepadata->callback = callback;
+   sepadata->vars.assign(vars, vars + nvars);
+   sepadata->nvars = nvars;
+   sepadata->maxdepth = maxdepth;
+   sepadata->minefficacy = minefficacy;
+   sepadata->maxcuts = maxcuts;
+   sepadata->usepool = usepool;
+   sepadata->ncalls = 0;
+   sepadata->nfound = 0;
+   sepadata->ncuts = 0;
+   sepadata->time = 0.0;
+
+   SCIP_CALL( SCIPincludeSepaBasic(scip, &sepa, SEPA_NAME, SEPA_DESC, SEPA_PRIORITY, freq, SEPA_MAXBOUNDDIST,
+         SEPA_USESSUBSCIP, SEPA_DELAY, sepaExeclpMatlabCuts, NULL, sepadata) );
+   SCIP_CALL( SCIPsetSepaFree(scip, sepa, sepaFreeMatlabCuts) );
+
+   return SCIP_OKAY;
+}
+
+/** get statistics of the cut callback */
+void SCIPgetSepaMatlabCutsStats(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_Longint*         ncalls,             /**< number of calls of the MATLAB function */
+   SCIP_Longint*         nfound,             /**< number of rows returned by the MATLAB function */
+   SCIP_Longint*         ncuts,              /**< number of cuts passed to SCIP after filtering */
+   SCIP_Real*            time                /**< wall clock time spent in MATLAB, including marshalling [s] */
+   )
+{
+   SCIP_SEPA* sepa = SCIPfindSepa(scip, SEPA_NAME);
+   SCIP_SEPADATA* sepadata = sepa != NULL ? SCIPsepaGetData(sepa) : NULL;
+
+   *ncalls = sepadata != NULL ? sepadata->ncalls : 0;
+   *nfound = sepadata != NULL ? sepadata->nfound : 0;
+   *ncuts = sepadata != NULL ? sepadata->ncuts : 0;
+   *time = sepadata != NULL ? sepadata->time : 0.0;
+}
+
+
+/** calls the pricing function with the duals of the linear constraints and adds the returned columns
+ *
+ *  In reduced cost pricing only columns with negative reduced cost are added, in Farkas pricing all returned columns.
+ */
+static
+SCIP_RETCODE priceColumns(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_PRICER*          pricer,             /**< pricer */
+   SCIP_Bool             farkas,             /**< Farkas pricing (for an infeasible LP)? */
+   SCIP_RESULT*          result              /**< result */
+   )
+{
+   SCIP_PRICERDATA* pricerdata = SCIPpricerGetData(pricer);
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   mxArray* cbrhs[3];
+   mxArray* cblhs[3] = {NULL, NULL, NULL};
+   const mxArray* A;
+   SCIP_RETCODE retcode = SCIP_OKAY;
+   double* y;
+   size_t k;
+
+   *result = SCIP_SUCCESS;
+
+   cbrhs[0] = (mxArray*) pricerdata->callback;
+   cbrhs[1] = mxCreateDoubleMatrix(pricerdata->nconss, 1, mxREAL);
+   cbrhs[2] = mxCreateLogicalScalar(farkas ? true : false);
+   y = mxGetPr(cbrhs[1]);
+   for (int i = 0; i < pricerdata->nconss; ++i)
+   {
+      y[i] = farkas ? SCIPgetDualfarkasLinear(scip, pricerdata->transconss[i])
+         : SCIPgetDualsolLinear(scip, pricerdata->transconss[i]);
+   }
+
+   retcode = callMatlabFunction(3, cblhs, 3, cbrhs, "pricing");
+   ++pricerdata->ncalls;
+
+   /* no columns */
+   A = cblhs[1];
+   k = ( A == NULL || mxIsEmpty(A) ) ? 0 : mxGetN(A);
+
+   if ( retcode != SCIP_OKAY )
+   {
+      /* the MATLAB error is raised after SCIP has been freed */
+   }
+   else if ( k > 0 && ( ! mxIsSparse(A) || ! mxIsDouble(A) || mxIsComplex(A) || mxGetM(A) != (size_t) pricerdata->nconss ) )
+   {
+      SCIPerrorMessage("The pricing callback has to return a real sparse matrix A with %d rows.\n", pricerdata->nconss);
+      retcode = SCIP_INVALIDDATA;
+   }
+   else if ( k > 0 && ( ! mxIsDouble(cblhs[0]) || mxIsSparse(cblhs[0]) || mxGetNumberOfElements(cblhs[0]) != k
+         || ( ! mxIsEmpty(cblhs[2]) && ( ! mxIsDouble(cblhs[2]) || mxIsSparse(cblhs[2]) || mxGetNumberOfElements(cblhs[2]) != k ) ) ) )
+   {
+      SCIPerrorMessage("The pricing callback has to return a dense vector f and (optionally) ub with one entry per column of A.\n");
+      retcode = SCIP_INVALIDDATA;
+   }
+   else if ( k > 0 )
+   {
+      const mwIndex* jc = mxGetJc(A);
+      const mwIndex* ir = mxGetIr(A);
+      const double* pr = mxGetPr(A);
+      const double* f = mxGetPr(cblhs[0]);
+      const double* ub = mxIsEmpty(cblhs[2]) ? NULL : mxGetPr(cblhs[2]);
+      char name[SCIP_MAXSTRLEN];
+
+      for (size_t j = 0; j < k && retcode == SCIP_OKAY; ++j)
+      {
+         SCIP_VAR* var;
+         SCIP_Real redcost = f[j];
+
+         for (mwIndex l = jc[j]; l < jc[j+1]; ++l)
+            redcost -= y[ir[l]] * pr[l];
+
+         if ( ! farkas && ! SCIPisDualfeasNegative(scip, redcost) )
+            continue;
+
+         /* priced columns are continuous, initially in the LP and may be removed from it again; errors are passed
+          * on after the MATLAB arrays are freed */
+         (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "pricedvar%d", (int) pricerdata->pricedvars.size());
+         retcode = SCIPcreateVar(scip, &var, name, 0.0, ( ub == NULL || mxIsInf(ub[j]) ) ? SCIPinfinity(scip) : ub[j],
+            f[j], SCIP_VARTYPE_CONTINUOUS, TRUE, TRUE, NULL, NULL, NULL, NULL, NULL);
+         if ( retcode != SCIP_OKAY )
+            break;
+
+         /* keep the variable to report its value after solving (and to release it) */
+         pricerdata->pricedvars.push_back(var);
+
+         retcode = SCIPaddPricedVar(scip, var, 1.0);
+         for (mwIndex l = jc[j]; l < jc[j+1] && retcode == SCIP_OKAY; ++l)
+            retcode = SCIPaddCoefLinear(scip, pricerdata->transconss[ir[l]], var, pr[l]);
+      }
+   }
+
+   for (int i = 0; i < 3; ++i)
+   {
+      if ( cblhs[i] != NULL )
+         mxDestroyArray(cblhs[i]);
+   }
+   mxDestroyArray(cbrhs[1]);
+   mxDestroyArray(cbrhs[2]);
+
+   pricerdata->time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+   return retcode;
+}
+
+
+/** destructor of pricer to free pricer data */
+static
+SCIP_DECL_PRICERFREE(pricerFreeMatlabColumns)
+{
+   delete SCIPpricerGetData(pricer);
+   SCIPpricerSetData(pricer, NULL);
+
+   return SCIP_OKAY;
+}
+
+/** initialization method of pricer (called after problem was transformed) */
+static
+SCIP_DECL_PRICERINIT(pricerInitMatlabColumns)
+{
+   SCIP_PRICERDATA* pricerdata = SCIPpricerGetData(pricer);
+
+   pricerdata->transconss.resize(pricerdata->nconss);
+   if ( pricerdata->nconss > 0 )
+   {
+      SCIP_CALL( SCIPgetTransformedConss(scip, pricerdata->nconss, &pricerdata->conss[0], &pricerdata->transconss[0]) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** deinitialization method of pricer (called before transformed problem is freed) */
+static
+SCIP_DECL_PRICEREXIT(pricerExitMatlabColumns)
+{
+   SCIP_PRICERDATA* pricerdata = SCIPpricerGetData(pricer);
+
+   for (size_t j = 0; j < pricerdata->pricedvars.size(); ++j)
+   {
+      SCIP_CALL( SCIPreleaseVar(scip, &pricerdata->pricedvars[j]) );
+   }
+   pricerdata->pricedvars.clear();
+   pricerdata->transconss.clear();
+
+   return SCIP_OKAY;
+}
+
+/** reduced cost pricing method of pricer for feasible LPs */
+static
+SCIP_DECL_PRICERREDCOST(pricerRedcostMatlabColumns)
+{
+   SCIP_CALL( priceColumns(scip, pricer, FALSE, result) );
+
+   return SCIP_OKAY;
+}
+
+/** Farkas pricing method of pricer for infeasible LPs */
+static
+SCIP_DECL_PRICERFARKAS(pricerFarkasMatlabColumns)
+{
+   SCIP_CALL( priceColumns(scip, pricer, TRUE, result) );
+
+   return SCIP_OKAY;
+}
+
+/** add and activate pricer for columns given by a MATLAB function */
+SCIP_RETCODE SCIPincludePricerMatlabColumns(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        callback,           /**< function handle or name (has to exist until SCIP is freed) */
+   SCIP_CONS**           conss,              /**< original linear constraints the columns have coefficients in */
+   int                   nconss              /**< number of linear constraints */
+   )
+{
+   SCIP_PRICERDATA* pricerdata = new SCIP_PRICERDATA;
+   SCIP_PRICER* pricer = NULL;
+
+   pricerdata->callback = callback;
+   pricerdata->conss.assign(conss, conss + nconss);
+   pricerdata->nconss = nconss;
+   pricerdata->ncalls = 0;
+   pricerdata->time = 0.0;
+
+   /* new columns need coefficients in the constraints */
+   for (int i = 0; i < nconss; ++i)
+   {
+      SCIP_CALL( SCIPsetConsModifiable(scip, conss[i], TRUE) );
+   }
+
+   SCIP_CALL( SCIPincludePricerBasic(scip, &pricer, PRICER_NAME, PRICER_DESC, PRICER_PRIORITY, PRICER_DELAY,
+         pricerRedcostMatlabColumns, pricerFarkasMatlabColumns, pricerdata) );
+   SCIP_CALL( SCIPsetPricerFree(scip, pricer, pricerFreeMatlabColumns) );
+   SCIP_CALL( SCIPsetPricerInit(scip, pricer, pricerInitMatlabColumns) );
+   SCIP_CALL( SCIPsetPricerExit(scip, pricer, pricerExitMatlabColumns) );
+   SCIP_CALL( SCIPactivatePricer(scip, pricer) );
+
+   /* reductions that rely on knowing all columns are invalid with pricing */
+   SCIP_CALL( setParamIfExists(scip, "misc/allowdualreds", 0) );
+   SCIP_CALL( setParamIfExists(scip, "misc/allowstrongdualreds", 0) );
+   SCIP_CALL( setParamIfExists(scip, "misc/allowweakdualreds", 0) );
+   SCIP_CALL( setParamIfExists(scip, "misc/usesymmetry", 0) );
+   SCIP_CALL( setParamIfExists(scip, "presolving/maxrestarts", 0) );
+
+   return SCIP_OKAY;
+}
+
+/** get statistics of the pricing callback */
+void SCIPgetPricerMatlabColumnsStats(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_Longint*         ncalls,             /**< number of calls of the MATLAB function */
+   int*                  ncols,              /**< number of columns added */
+   SCIP_Real*            time                /**< wall clock time spent in MATLAB, including marshalling [s] */
+   )
+{
+   SCIP_PRICER* pricer = SCIPfindPricer(scip, PRICER_NAME);
+   SCIP_PRICERDATA* pricerdata = pricer != NULL ? SCIPpricerGetData(pricer) : NULL;
+
+   *ncalls = pricerdata != NULL ? pricerdata->ncalls : 0;
+   *ncols = pricerdata != NULL ? (int) pricerdata->pricedvars.size() : 0;
+   *time = pricerdata != NULL ? pricerdata->time : 0.0;
+}
+
+/** get the values of the columns added by the pricer in a solution, in the order they were added */
+SCIP_RETCODE SCIPgetPricerMatlabColumnsVals(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_SOL*             sol,                /**< solution */
+   SCIP_Real*            vals                /**< array to store the values (length: ncols of the statistics) */
+   )
+{
+   SCIP_PRICER* pricer = SCIPfindPricer(scip, PRICER_NAME);
+   SCIP_PRICERDATA* pricerdata = pricer != NULL ? SCIPpricerGetData(pricer) : NULL;
+
+   if ( pricerdata == NULL || pricerdata->pricedvars.empty() )
+      return SCIP_OKAY;
+
+   SCIP_CALL( SCIPgetSolVals(scip, sol, (int) pricerdata->pricedvars.size(), &pricerdata->pricedvars[0], vals) );
+
+   return SCIP_OKAY;
+}
+
+/** copies the MATLAB error raised in the last failed callback to msg and clears it, returns FALSE if there was none */
+SCIP_Bool SCIPgetMatlabCallbackError(
+   char*                 msg,                /**< buffer to store the message */
+   size_t                msgsize             /**< size of buffer */
+   )
+{
+   if ( callbackerror.empty() )
+      return FALSE;
+
+   (void) SCIPsnprintf(msg, (int) msgsize, "%s", callbackerror.c_str());
+   callbackerror.clear();
+
+   return TRUE;
+}
@@ -74,3 +74,106 @@ SCIP_RETCODE SCIPincludeCtrlCEventHdlr(
 
    return SCIP_OKAY;
 }
+
+/** data of the stall time event handler */
+struct SCIP_EventhdlrData
+{
+   SCIP_Real             stalltime;          /**< maximal solving time without improvement of the best solution [s] */
+   SCIP_Real             lastimprovement;    /**< solving time at the last improvement [s] */
+   SCIP_Bool             reached;            /**< was the solve interrupted because of the stall time? */
+};
+
+/** frees the event handler data */
+static
+SCIP_DECL_EVENTFREE(eventFreeStallTime)
+{
+   delete SCIPeventhdlrGetData(eventhdlr);
+
+   return SCIP_OKAY;
+}
+
+/** catches the events at the beginning of each solve */
+static
+SCIP_DECL_EVENTINITSOL(eventInitsolStallTime)
+{
+   SCIP_EVENTHDLRDATA* eventhdlrdata = SCIPeventhdlrGetData(eventhdlr);
+
+   eventhdlrdata->lastimprovement = SCIPgetSolvingTime(scip);
+   eventhdlrdata->reached = FALSE;
+
+   SCIP_CALL( SCIPcatchEvent(scip, SCIP_EVENTTYPE_NODESOLVED | SCIP_EVENTTYPE_BESTSOLFOUND, eventhdlr, NULL, NULL) );
+   return SCIP_OKAY;
+}
+
+/** drops the events at the end of each solve */
+static
+SCIP_DECL_EVENTEXITSOL(eventExitsolStallTime)
+{
+   SCIP_CALL( SCIPdropEvent(scip, SCIP_EVENTTYPE_NODESOLVED | SCIP_EVENTTYPE_BESTSOLFOUND, eventhdlr, NULL, -1) );
+   return SCIP_OKAY;
+}
+
+/** remembers the time of a new best solution and interrupts the solve if there was none for too long */
+static
+SCIP_DECL_EVENTEXEC(eventExecStallTime)
+{
+   SCIP_EVENTHDLRDATA* eventhdlrdata = SCIPeventhdlrGetData(eventhdlr);
+   SCIP_Real time = SCIPgetSolvingTime(scip);
+
+   if ( SCIPeventGetType(event) & SCIP_EVENTTYPE_BESTSOLFOUND )
+      eventhdlrdata->lastimprovement = time;
+   else if ( ! eventhdlrdata->reached && time - eventhdlrdata->lastimprovement > eventhdlrdata->stalltime )
+   {
+      eventhdlrdata->reached = TRUE;
+      SCIP_CALL( SCIPinterruptSolve(scip) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** add event handler that interrupts the solve if the best solution did not improve for some time */
+SCIP_RETCODE SCIPincludeStallTimeEventHdlr(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_Real             stalltime           /**< maximal solving time without improvement [s] */
+   )
+{
+   SCIP_EVENTHDLRDATA* eventhdlrdata = new SCIP_EVENTHDLRDATA;
+   SCIP_EVENTHDLR* eventhdlr = NULL;
+
+   eventhdlrdata->stalltime = stalltime;
+   eventhdlrdata->lastimprovement = 0.0;
+   eventhdlrdata->reached = FALSE;
+
+   SCIP_CALL( SCIPincludeEventhdlrBasic(scip, &eventhdlr, "StallTimeMatlab", "Stall time limit from Matlab",
+         eventExecStallTime, eventhdlrdata) );
+   SCIP_CALL( SCIPsetEventhdlrFree(scip, eventhdlr, eventFreeStallTime) );
+   SCIP_CALL( SCIPsetEventhdlrInitsol(scip, eventhdlr, eventInitsolStallTime) );
+   SCIP_CALL( SCIPsetEventhdlrExitsol(scip, eventhdlr, eventExitsolStallTime) );
+
+   return SCIP_OKAY;
+}
+
+/** returns whether the last solve was interrupted by the stall time event handler */
+SCIP_Bool SCIPisStallTimeReached(
+   SCIP*                 scip                /**< SCIP instance */
+   )
+{
+   SCIP_EVENTHDLR* eventhdlr = SCIPfindEventhdlr(scip, "StallTimeMatlab");
+
+   return eventhdlr != NULL && SCIPeventhdlrGetData(eventhdlr)->reached;
+}
+
+/** returns whether Ctrl-C was pressed in MATLAB and resets it, for waiting loops outside of a SCIP solve */
+SCIP_Bool SCIPisCtrlCPending(
+   void
+   )
+{
+#ifndef HAVE_OCTAVE
+   if ( utIsInterruptPending() )
+   {
+      utSetInterruptPending(false);
+      return TRUE;
+   }
+#endif
+   return FALSE;
+}
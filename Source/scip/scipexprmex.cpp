@@ -0,0 +1,903 @@
+/* SCIPEXPRMEX - Native expression graph for scipvar
+ * Released Under the BSD 3-Clause License.
+ *
+ * scipvar objects only hold handles to nodes of an expression graph (DAG) stored in this MEX file. All vectorized
+ * operations (elementwise operations, matrix products, sums and products) are performed here in one call each, and
+ * the instruction lists for addNonlinearCon() are emitted from the graph at the end.
+ *
+ * Usage:
+ *   scipexprmex('reset')                 - clear graph
+ *   ids = scipexprmex('var', idx)        - variable nodes with (0-based) indices idx
+ *   ids = scipexprmex('num', vals)       - constant nodes
+ *   ids = scipexprmex('unary', op, a)    - elementwise function op(a)
+ *   ids = scipexprmex('binary', op, a, b) - elementwise a (op) b (with scalar expansion)
+ *   ids = scipexprmex('linmap', M, a)    - M*a for a numeric (dense or sparse) matrix M
+ *   ids = scipexprmex('matmul', a, b)    - a*b
+ *   ids = scipexprmex('reduce', op, a, dim) - sum (op = ADD) or prod (op = MUL) along dimension dim
+ *   ins = scipexprmex('emit', ids)       - cell array of instruction lists
+ *   [CT,c,isaff,rest] = scipexprmex('affine', ids, nvar) - split ids into affine parts CT(:,k)'*x + c(k) and
+ *                                          nonlinear remainders rest(k) (-1 if ids(k) is affine)
+ *   n = scipexprmex('nnodes')            - number of nodes in the graph
+ */
+
+#include "mex.h"
+#include <string.h>
+#include <stdio.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/** instructions (same codes as in scipvar and scipnlmex) */
+enum
+{
+   NUM   = 0,
+   VAR   = 1,
+   MUL   = 3,
+   DIV   = 4,
+   ADD   = 5,
+   SUB   = 6,
+   SQU   = 7,
+   SQR   = 8,
+   POW   = 9,
+   EXPNT = 10,
+   LOG   = 11,
+   MIN   = 15,
+   MAX   = 16,
+   ABS   = 17,
+   SUMW  = -1,           /**< weighted sum of children (internal only) */
+   PRODN = -2            /**< product of children (internal only) */
+};
+
+/* message buffer size */
+#define BUFSIZE 2048
+
+#ifndef MAX
+#define MAX(x,y) ((x) > (y) ? (x) : (y))
+#endif
+
+/* global message buffer */
+static char msgbuf[BUFSIZE];
+
+/** node of the expression graph */
+struct ExprNode
+{
+   int                   op;                 /**< operation */
+   double                val;                /**< value for NUM, index for VAR */
+   size_t                first;              /**< position of first child in children */
+   size_t                nchildren;          /**< number of children */
+};
+
+/** item of the emitting stack: either a node to expand or an instruction pair */
+struct EmitItem
+{
+   bool                  literal;            /**< is this an instruction pair? */
+   size_t                node;               /**< node to expand */
+   double                code;               /**< instruction code */
+   double                arg;                /**< instruction argument */
+};
+
+/* the expression graph */
+static vector<ExprNode> nodes;
+static vector<size_t> children;
+static vector<double> coefs;                 /* coefficients of children (only used by SUMW) */
+
+
+/** add a node to the graph and return its index */
+static
+size_t addNode(
+   int                   op,                 /**< operation */
+   double                val,                /**< value */
+   const size_t*         childs,             /**< children (or NULL) */
+   const double*         childcoefs,         /**< coefficients of children (or NULL) */
+   size_t                nchilds             /**< number of children */
+   )
+{
+   ExprNode node;
+
+   node.op = op;
+   node.val = val;
+   node.first = children.size();
+   node.nchildren = nchilds;
+
+   for (size_t k = 0; k < nchilds; ++k)
+   {
+      children.push_back(childs[k]);
+      coefs.push_back(childcoefs != NULL ? childcoefs[k] : 1.0);
+   }
+   nodes.push_back(node);
+
+   return nodes.size() - 1;
+}
+
+/** get node indices from a MATLAB array */
+static
+void getNodeIds(
+   const mxArray*        arr,                /**< array of node indices */
+   vector<size_t>&       ids                 /**< node indices */
+   )
+{
+   if ( ! mxIsDouble(arr) || mxIsSparse(arr) )
+      mexErrMsgTxt("Expression nodes must be given as a dense double array.");
+
+   size_t n = mxGetNumberOfElements(arr);
+   const double* vals = mxGetPr(arr);
+
+   ids.resize(n);
+   for (size_t k = 0; k < n; ++k)
+   {
+      if ( vals[k] < 0.0 || vals[k] >= (double) nodes.size() || vals[k] != floor(vals[k]) )
+         mexErrMsgTxt("Invalid expression node, the expression graph may have been reset.");
+      ids[k] = (size_t) vals[k];
+   }
+}
+
+/** create a MATLAB array of node indices */
+static
+mxArray* createNodeArray(
+   const vector<size_t>& ids,                /**< node indices */
+   size_t                m,                  /**< number of rows */
+   size_t                n                   /**< number of columns */
+   )
+{
+   mxArray* arr = mxCreateDoubleMatrix(m, n, mxREAL);
+   double* vals = mxGetPr(arr);
+
+   for (size_t k = 0; k < m * n; ++k)
+      vals[k] = (double) ids[k];
+
+   return arr;
+}
+
+/** create node for a (op) b, folding constants */
+static
+size_t addBinary(
+   int                   op,                 /**< operation */
+   size_t                a,                  /**< first operand */
+   size_t                b                   /**< second operand */
+   )
+{
+   size_t childs[2] = {a, b};
+
+   if ( nodes[a].op == NUM && nodes[b].op == NUM )
+   {
+      double va = nodes[a].val;
+      double vb = nodes[b].val;
+
+      switch ( op )
+      {
+      case ADD: return addNode(NUM, va + vb, NULL, NULL, 0);
+      case SUB: return addNode(NUM, va - vb, NULL, NULL, 0);
+      case MUL: return addNode(NUM, va * vb, NULL, NULL, 0);
+      case DIV: return addNode(NUM, va / vb, NULL, NULL, 0);
+      case POW: return addNode(NUM, pow(va, vb), NULL, NULL, 0);
+      default: break;
+      }
+   }
+
+   return addNode(op, 0.0, childs, NULL, 2);
+}
+
+/** append instruction pair */
+static
+void pushLiteral(
+   vector<EmitItem>&     items,              /**< items */
+   double                code,               /**< instruction */
+   double                arg                 /**< argument */
+   )
+{
+   EmitItem item;
+
+   item.literal = true;
+   item.node = 0;
+   item.code = code;
+   item.arg = arg;
+   items.push_back(item);
+}
+
+/** append node to expand; variables and constants are directly written as instruction pairs */
+static
+void pushNode(
+   vector<EmitItem>&     items,              /**< items */
+   size_t                node                /**< node */
+   )
+{
+   EmitItem item;
+
+   if ( nodes[node].op == NUM || nodes[node].op == VAR )
+   {
+      pushLiteral(items, nodes[node].op, nodes[node].val);
+      return;
+   }
+
+   item.literal = false;
+   item.node = node;
+   item.code = 0.0;
+   item.arg = 0.0;
+   items.push_back(item);
+}
+
+/** append items for a (op) b
+ *
+ *  This uses the same instruction patterns as the original scipvar implementation, since addNonlinearCon() only
+ *  accepts these: a constant as left operand is only allowed directly before a variable, otherwise it is placed after
+ *  the other operand and the operation is flagged as flipped (argument 1).
+ */
+static
+void pushBinary(
+   vector<EmitItem>&     items,              /**< items */
+   int                   op,                 /**< operation */
+   size_t                a,                  /**< first operand */
+   size_t                b                   /**< second operand */
+   )
+{
+   if ( nodes[a].op == NUM && nodes[b].op != VAR && nodes[b].op != NUM )
+   {
+      pushNode(items, b);
+      pushLiteral(items, NUM, nodes[a].val);
+      pushLiteral(items, op, 1.0);
+   }
+   else
+   {
+      pushNode(items, a);
+      pushNode(items, b);
+      pushLiteral(items, op, mxGetNaN());
+   }
+}
+
+/** expand a node into the items of its instruction list */
+static
+void expandNode(
+   size_t                node,               /**< node */
+   vector<EmitItem>&     items               /**< items */
+   )
+{
+   const ExprNode& n = nodes[node];
+   const size_t* childs = &children[n.first];
+   const double* childcoefs = &coefs[n.first];
+
+   switch ( n.op )
+   {
+   case NUM:
+   case VAR:
+      pushLiteral(items, n.op, n.val);
+      break;
+
+   case SUMW:
+   {
+      double constant = 0.0;
+      bool first = true;
+
+      for (size_t k = 0; k < n.nchildren; ++k)
+      {
+         size_t c = childs[k];
+
+         /* collect constants, these have to be added at the end */
+         if ( nodes[c].op == NUM )
+         {
+            constant += childcoefs[k] * nodes[c].val;
+            continue;
+         }
+
+         if ( childcoefs[k] == 1.0 )
+            pushNode(items, c);
+         else if ( nodes[c].op == VAR )
+         {
+            pushLiteral(items, NUM, childcoefs[k]);
+            pushLiteral(items, VAR, nodes[c].val);
+            pushLiteral(items, MUL, mxGetNaN());
+         }
+         else
+         {
+            pushNode(items, c);
+            pushLiteral(items, NUM, childcoefs[k]);
+            pushLiteral(items, MUL, 1.0);
+         }
+
+         if ( ! first )
+            pushLiteral(items, ADD, mxGetNaN());
+         first = false;
+      }
+
+      if ( first )
+         pushLiteral(items, NUM, constant);
+      else if ( constant != 0.0 )
+      {
+         pushLiteral(items, NUM, constant);
+         pushLiteral(items, ADD, mxGetNaN());
+      }
+      break;
+   }
+
+   case PRODN:
+      pushBinary(items, MUL, childs[0], childs[1]);
+      for (size_t k = 2; k < n.nchildren; ++k)
+      {
+         pushNode(items, childs[k]);
+         pushLiteral(items, MUL, mxGetNaN());
+      }
+      break;
+
+   default:
+      if ( n.nchildren == 1 )
+      {
+         pushNode(items, childs[0]);
+         pushLiteral(items, n.op, mxGetNaN());
+      }
+      else
+         pushBinary(items, n.op, childs[0], childs[1]);
+      break;
+   }
+}
+
+/** emit the instruction list of a node (without recursion, chains can be very long) */
+static
+mxArray* emitInstructions(
+   size_t                root                /**< node */
+   )
+{
+   vector<EmitItem> stack;
+   vector<EmitItem> items;
+   vector<double> ins;
+   mxArray* arr;
+
+   pushNode(stack, root);
+   while ( ! stack.empty() )
+   {
+      EmitItem item = stack.back();
+      stack.pop_back();
+
+      if ( item.literal )
+      {
+         ins.push_back(item.code);
+         ins.push_back(item.arg);
+         continue;
+      }
+
+      items.clear();
+      expandNode(item.node, items);
+      for (size_t k = items.size(); k > 0; --k)
+         stack.push_back(items[k-1]);
+   }
+
+   arr = mxCreateDoubleMatrix(ins.size(), 1, mxREAL);
+   if ( ! ins.empty() )
+      memcpy(mxGetPr(arr), &ins[0], ins.size() * sizeof(double));
+
+   return arr;
+}
+
+/** get operation code from input */
+static
+int getOp(
+   const mxArray*        arr                 /**< operation argument */
+   )
+{
+   if ( ! mxIsNumeric(arr) || mxGetNumberOfElements(arr) != 1 )
+      mexErrMsgTxt("The operation must be a numeric scalar.");
+   return (int) mxGetScalar(arr);
+}
+
+/** y = M*a for a numeric matrix M (only nonzeros of M create terms) */
+static
+void linearMap(
+   const mxArray*        M,                  /**< numeric matrix (m x k) */
+   const vector<size_t>& a,                  /**< nodes (k x n) */
+   size_t                k,                  /**< rows of a */
+   size_t                n,                  /**< columns of a */
+   vector<size_t>&       y                   /**< resulting nodes (m x n) */
+   )
+{
+   size_t m = mxGetM(M);
+   const double* vals = mxGetPr(M);
+   vector<size_t> rowbeg(m + 1, 0);
+   vector<size_t> rowcols;
+   vector<double> rowvals;
+   vector<size_t> childs;
+   vector<double> childcoefs;
+
+   /* store M row-wise, skipping zeros */
+   if ( mxIsSparse(M) )
+   {
+      const mwIndex* ir = mxGetIr(M);
+      const mwIndex* jc = mxGetJc(M);
+      size_t nnz = jc[k];
+      vector<size_t> pos;
+
+      for (size_t p = 0; p < nnz; ++p)
+         ++rowbeg[ir[p] + 1];
+      for (size_t i = 0; i < m; ++i)
+         rowbeg[i + 1] += rowbeg[i];
+
+      pos.assign(rowbeg.begin(), rowbeg.end() - 1);
+      rowcols.resize(nnz);
+      rowvals.resize(nnz);
+      for (size_t j = 0; j < k; ++j)
+      {
+         for (mwIndex p = jc[j]; p < jc[j + 1]; ++p)
+         {
+            rowcols[pos[ir[p]]] = j;
+            rowvals[pos[ir[p]]++] = vals[p];
+         }
+      }
+   }
+   else
+   {
+      for (size_t i = 0; i < m; ++i)
+      {
+         for (size_t j = 0; j < k; ++j)
+         {
+            if ( vals[i + j * m] != 0.0 )
+            {
+               rowcols.push_back(j);
+               rowvals.push_back(vals[i + j * m]);
+            }
+         }
+         rowbeg[i + 1] = rowcols.size();
+      }
+   }
+
+   y.resize(m * n);
+   for (size_t j = 0; j < n; ++j)
+   {
+      for (size_t i = 0; i < m; ++i)
+      {
+         childs.clear();
+         childcoefs.clear();
+         for (size_t p = rowbeg[i]; p < rowbeg[i + 1]; ++p)
+         {
+            childs.push_back(a[rowcols[p] + j * k]);
+            childcoefs.push_back(rowvals[p]);
+         }
+
+         /* keep zero rows as 0*a(1,j), so that the result remains an expression of the variables */
+         if ( childs.empty() )
+         {
+            if ( k > 0 )
+            {
+               childs.push_back(a[j * k]);
+               childcoefs.push_back(0.0);
+            }
+            else
+            {
+               y[i + j * m] = addNode(NUM, 0.0, NULL, NULL, 0);
+               continue;
+            }
+         }
+
+         y[i + j * m] = addNode(SUMW, 0.0, &childs[0], &childcoefs[0], childs.size());
+      }
+   }
+}
+
+/** determine for all nodes up to maxnode whether they are affine in the variables
+ *
+ *  Children always have smaller indices than their parents, so a single pass in order of the indices suffices.
+ */
+static
+void computeAffineFlags(
+   size_t                maxnode,            /**< largest node of interest */
+   vector<char>&         isaffine            /**< affine flag for each node */
+   )
+{
+   isaffine.assign(maxnode + 1, 0);
+
+   for (size_t v = 0; v <= maxnode; ++v)
+   {
+      const ExprNode& n = nodes[v];
+      const size_t* childs = n.nchildren > 0 ? &children[n.first] : NULL;
+      size_t nconst = 0;
+      bool affine = true;
+
+      for (size_t k = 0; k < n.nchildren; ++k)
+      {
+         affine = affine && isaffine[childs[k]];
+         if ( nodes[childs[k]].op == NUM )
+            ++nconst;
+      }
+
+      switch ( n.op )
+      {
+      case NUM:
+      case VAR:
+         isaffine[v] = 1;
+         break;
+      case SUMW:
+      case ADD:
+      case SUB:
+         isaffine[v] = affine;
+         break;
+      case MUL:
+      case PRODN:
+         /* products are affine if all but one factor are constants */
+         isaffine[v] = affine && nconst + 1 >= n.nchildren;
+         break;
+      case DIV:
+         isaffine[v] = affine && nodes[childs[1]].op == NUM;
+         break;
+      default:
+         isaffine[v] = 0;
+         break;
+      }
+   }
+}
+
+/** split expression into affine part coefs'*x + constant and remaining (nonlinear) terms
+ *
+ *  The additive structure (sums, differences, scaling by constants) is traversed from the root; affine subexpressions
+ *  are expanded into the coefficient accumulator, the remaining subexpressions are collected as terms with their
+ *  coefficients.
+ */
+static
+void splitAffine(
+   size_t                root,               /**< root node */
+   const vector<char>&   isaffine,           /**< affine flags of nodes */
+   vector<double>&       acc,                /**< dense coefficient accumulator (all zero on entry) */
+   vector<size_t>&       touched,            /**< indices of touched entries of acc */
+   double&               constant,           /**< constant part */
+   vector<size_t>&       restnodes,          /**< remaining nonlinear terms */
+   vector<double>&       restcoefs           /**< coefficients of remaining nonlinear terms */
+   )
+{
+   vector< pair<size_t, double> > stack;
+
+   constant = 0.0;
+   stack.push_back(make_pair(root, 1.0));
+   while ( ! stack.empty() )
+   {
+      size_t v = stack.back().first;
+      double coef = stack.back().second;
+      stack.pop_back();
+
+      const ExprNode& n = nodes[v];
+      const size_t* childs = n.nchildren > 0 ? &children[n.first] : NULL;
+      const double* childcoefs = n.nchildren > 0 ? &coefs[n.first] : NULL;
+
+      if ( coef == 0.0 )
+         continue;
+
+      switch ( n.op )
+      {
+      case NUM:
+         constant += coef * n.val;
+         continue;
+
+      case VAR:
+      {
+         size_t idx = (size_t) n.val;
+         if ( idx >= acc.size() )
+            mexErrMsgTxt("Variable index exceeds the number of variables.");
+         if ( acc[idx] == 0.0 )
+            touched.push_back(idx);
+         acc[idx] += coef;
+         continue;
+      }
+
+      case SUMW:
+         for (size_t k = 0; k < n.nchildren; ++k)
+            stack.push_back(make_pair(childs[k], coef * childcoefs[k]));
+         continue;
+
+      case ADD:
+         stack.push_back(make_pair(childs[0], coef));
+         stack.push_back(make_pair(childs[1], coef));
+         continue;
+
+      case SUB:
+         stack.push_back(make_pair(childs[0], coef));
+         stack.push_back(make_pair(childs[1], -coef));
+         continue;
+
+      case MUL:
+         if ( nodes[childs[0]].op == NUM )
+         {
+            stack.push_back(make_pair(childs[1], coef * nodes[childs[0]].val));
+            continue;
+         }
+         if ( nodes[childs[1]].op == NUM )
+         {
+            stack.push_back(make_pair(childs[0], coef * nodes[childs[1]].val));
+            continue;
+         }
+         break;
+
+      case DIV:
+         if ( nodes[childs[1]].op == NUM )
+         {
+            stack.push_back(make_pair(childs[0], coef / nodes[childs[1]].val));
+            continue;
+         }
+         break;
+
+      case PRODN:
+         if ( isaffine[v] )
+         {
+            size_t factor = childs[0];
+            double scale = coef;
+
+            for (size_t k = 0; k < n.nchildren; ++k)
+            {
+               if ( nodes[childs[k]].op == NUM )
+                  scale *= nodes[childs[k]].val;
+               else
+                  factor = childs[k];
+            }
+
+            if ( nodes[factor].op == NUM )
+               constant += scale;
+            else
+               stack.push_back(make_pair(factor, scale));
+            continue;
+         }
+         break;
+
+      default:
+         break;
+      }
+
+      /* not additive or affine: keep as nonlinear term */
+      restnodes.push_back(v);
+      restcoefs.push_back(coef);
+   }
+}
+
+/** main function */
+void mexFunction(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   char cmd[BUFSIZE];
+   vector<size_t> a;
+   vector<size_t> b;
+   vector<size_t> y;
+
+   (void) nlhs;
+
+   if ( nrhs < 1 || ! mxIsChar(prhs[0]) )
+      mexErrMsgTxt("Usage: scipexprmex(command, ...).");
+   mxGetString(prhs[0], cmd, BUFSIZE);
+
+   if ( strcmp(cmd, "reset") == 0 )
+   {
+      vector<ExprNode>().swap(nodes);
+      vector<size_t>().swap(children);
+      vector<double>().swap(coefs);
+   }
+   else if ( strcmp(cmd, "nnodes") == 0 )
+   {
+      plhs[0] = mxCreateDoubleScalar((double) nodes.size());
+   }
+   else if ( strcmp(cmd, "var") == 0 || strcmp(cmd, "num") == 0 )
+   {
+      if ( nrhs < 2 || ! mxIsDouble(prhs[1]) || mxIsSparse(prhs[1]) )
+         mexErrMsgTxt("Values must be given as a dense double array.");
+
+      int op = strcmp(cmd, "var") == 0 ? VAR : NUM;
+      size_t n = mxGetNumberOfElements(prhs[1]);
+      const double* vals = mxGetPr(prhs[1]);
+
+      y.resize(n);
+      for (size_t k = 0; k < n; ++k)
+         y[k] = addNode(op, vals[k], NULL, NULL, 0);
+      plhs[0] = createNodeArray(y, mxGetM(prhs[1]), mxGetN(prhs[1]));
+   }
+   else if ( strcmp(cmd, "unary") == 0 )
+   {
+      if ( nrhs < 3 )
+         mexErrMsgTxt("Usage: scipexprmex('unary', op, a).");
+
+      int op = getOp(prhs[1]);
+      getNodeIds(prhs[2], a);
+
+      y.resize(a.size());
+      for (size_t k = 0; k < a.size(); ++k)
+         y[k] = addNode(op, 0.0, &a[k], NULL, 1);
+      plhs[0] = createNodeArray(y, mxGetM(prhs[2]), mxGetN(prhs[2]));
+   }
+   else if ( strcmp(cmd, "binary") == 0 )
+   {
+      if ( nrhs < 4 )
+         mexErrMsgTxt("Usage: scipexprmex('binary', op, a, b).");
+
+      int op = getOp(prhs[1]);
+      getNodeIds(prhs[2], a);
+      getNodeIds(prhs[3], b);
+
+      size_t m = mxGetM(prhs[2]);
+      size_t n = mxGetN(prhs[2]);
+      if ( a.size() == 1 )
+      {
+         m = mxGetM(prhs[3]);
+         n = mxGetN(prhs[3]);
+      }
+      else if ( b.size() != 1 )
+      {
+         if ( mxGetM(prhs[2]) != mxGetM(prhs[3]) )
+         {
+            snprintf(msgbuf, BUFSIZE, "Vector/Matrix row dimensions must agree [r1 = %d, r2 = %d].", (int) mxGetM(prhs[2]), (int) mxGetM(prhs[3]));
+            mexErrMsgTxt(msgbuf);
+         }
+         if ( mxGetN(prhs[2]) != mxGetN(prhs[3]) )
+         {
+            snprintf(msgbuf, BUFSIZE, "Vector/Matrix column dimensions must agree [c1 = %d, c2 = %d].", (int) mxGetN(prhs[2]), (int) mxGetN(prhs[3]));
+            mexErrMsgTxt(msgbuf);
+         }
+      }
+
+      y.resize(m * n);
+      for (size_t k = 0; k < m * n; ++k)
+         y[k] = addBinary(op, a[a.size() == 1 ? 0 : k], b[b.size() == 1 ? 0 : k]);
+      plhs[0] = createNodeArray(y, m, n);
+   }
+   else if ( strcmp(cmd, "linmap") == 0 )
+   {
+      if ( nrhs < 3 || ! mxIsDouble(prhs[1]) || mxIsComplex(prhs[1]) )
+         mexErrMsgTxt("Usage: scipexprmex('linmap', M, a) with a real double matrix M.");
+
+      getNodeIds(prhs[2], a);
+      if ( mxGetN(prhs[1]) != mxGetM(prhs[2]) )
+      {
+         snprintf(msgbuf, BUFSIZE, "Matrix / vector sizes do not match - trying to multiply %d x %d by %d x %d.",
+            (int) mxGetM(prhs[1]), (int) mxGetN(prhs[1]), (int) mxGetM(prhs[2]), (int) mxGetN(prhs[2]));
+         mexErrMsgTxt(msgbuf);
+      }
+
+      linearMap(prhs[1], a, mxGetM(prhs[2]), mxGetN(prhs[2]), y);
+      plhs[0] = createNodeArray(y, mxGetM(prhs[1]), mxGetN(prhs[2]));
+   }
+   else if ( strcmp(cmd, "matmul") == 0 )
+   {
+      if ( nrhs < 3 )
+         mexErrMsgTxt("Usage: scipexprmex('matmul', a, b).");
+
+      getNodeIds(prhs[1], a);
+      getNodeIds(prhs[2], b);
+
+      size_t m = mxGetM(prhs[1]);
+      size_t k = mxGetN(prhs[1]);
+      size_t n = mxGetN(prhs[2]);
+      if ( k != mxGetM(prhs[2]) )
+      {
+         snprintf(msgbuf, BUFSIZE, "Matrix / vector sizes do not match - trying to multiply %d x %d by %d x %d.",
+            (int) m, (int) k, (int) mxGetM(prhs[2]), (int) n);
+         mexErrMsgTxt(msgbuf);
+      }
+
+      vector<size_t> prods(k);
+      y.resize(m * n);
+      for (size_t j = 0; j < n; ++j)
+      {
+         for (size_t i = 0; i < m; ++i)
+         {
+            for (size_t l = 0; l < k; ++l)
+               prods[l] = addBinary(MUL, a[i + l * m], b[l + j * k]);
+            if ( k == 0 )
+               y[i + j * m] = addNode(NUM, 0.0, NULL, NULL, 0);
+            else
+               y[i + j * m] = k == 1 ? prods[0] : addNode(SUMW, 0.0, &prods[0], NULL, k);
+         }
+      }
+      plhs[0] = createNodeArray(y, m, n);
+   }
+   else if ( strcmp(cmd, "reduce") == 0 )
+   {
+      if ( nrhs < 4 )
+         mexErrMsgTxt("Usage: scipexprmex('reduce', op, a, dim).");
+
+      int op = getOp(prhs[1]);
+      int dim = (int) mxGetScalar(prhs[3]);
+      if ( op != ADD && op != MUL )
+         mexErrMsgTxt("Only sums and products can be reduced.");
+      if ( dim != 1 && dim != 2 )
+         mexErrMsgTxt("Only 2D operations are implemented.");
+      getNodeIds(prhs[2], a);
+
+      size_t m = mxGetM(prhs[2]);
+      size_t n = mxGetN(prhs[2]);
+      size_t nout = dim == 1 ? n : m;
+      size_t nred = dim == 1 ? m : n;
+      vector<size_t> childs(nred);
+
+      y.resize(nout);
+      for (size_t j = 0; j < nout; ++j)
+      {
+         for (size_t l = 0; l < nred; ++l)
+            childs[l] = dim == 1 ? a[l + j * m] : a[j + l * m];
+
+         if ( nred == 0 )
+            y[j] = addNode(NUM, op == ADD ? 0.0 : 1.0, NULL, NULL, 0);
+         else if ( nred == 1 )
+            y[j] = childs[0];
+         else
+            y[j] = addNode(op == ADD ? SUMW : PRODN, 0.0, &childs[0], NULL, nred);
+      }
+      plhs[0] = dim == 1 ? createNodeArray(y, 1, nout) : createNodeArray(y, nout, 1);
+   }
+   else if ( strcmp(cmd, "emit") == 0 )
+   {
+      if ( nrhs < 2 )
+         mexErrMsgTxt("Usage: scipexprmex('emit', ids).");
+
+      getNodeIds(prhs[1], a);
+      plhs[0] = mxCreateCellMatrix(mxGetM(prhs[1]), mxGetN(prhs[1]));
+      for (size_t k = 0; k < a.size(); ++k)
+         mxSetCell(plhs[0], k, emitInstructions(a[k]));
+   }
+   else if ( strcmp(cmd, "affine") == 0 )
+   {
+      if ( nrhs < 3 )
+         mexErrMsgTxt("Usage: scipexprmex('affine', ids, nvar).");
+
+      getNodeIds(prhs[1], a);
+      size_t nvar = (size_t) mxGetScalar(prhs[2]);
+      size_t nroots = a.size();
+      size_t maxnode = 0;
+      vector<char> isaffine;
+      vector<double> acc(nvar, 0.0);
+      vector<size_t> touched;
+      vector<size_t> restnodes;
+      vector<double> restcoefs;
+      vector<mwIndex> colbeg(1, 0);
+      vector<mwIndex> rowind;
+      vector<double> vals;
+
+      for (size_t k = 0; k < nroots; ++k)
+         maxnode = a[k] > maxnode ? a[k] : maxnode;
+      if ( nroots > 0 )
+         computeAffineFlags(maxnode, isaffine);
+
+      plhs[1] = mxCreateDoubleMatrix(nroots, 1, mxREAL);
+      plhs[2] = mxCreateDoubleMatrix(nroots, 1, mxREAL);
+      plhs[3] = mxCreateDoubleMatrix(nroots, 1, mxREAL);
+
+      for (size_t k = 0; k < nroots; ++k)
+      {
+         double constant;
+
+         touched.clear();
+         restnodes.clear();
+         restcoefs.clear();
+         splitAffine(a[k], isaffine, acc, touched, constant, restnodes, restcoefs);
+
+         /* store coefficients as column k (sorted, without zeros) */
+         sort(touched.begin(), touched.end());
+         for (size_t p = 0; p < touched.size(); ++p)
+         {
+            if ( acc[touched[p]] != 0.0 )
+            {
+               rowind.push_back(touched[p]);
+               vals.push_back(acc[touched[p]]);
+            }
+            acc[touched[p]] = 0.0;
+         }
+         colbeg.push_back(rowind.size());
+
+         mxGetPr(plhs[1])[k] = constant;
+         mxGetPr(plhs[2])[k] = restnodes.empty() ? 1.0 : 0.0;
+         if ( restnodes.empty() )
+            mxGetPr(plhs[3])[k] = -1.0;
+         else if ( restnodes.size() == 1 && restcoefs[0] == 1.0 )
+            mxGetPr(plhs[3])[k] = (double) restnodes[0];
+         else
+            mxGetPr(plhs[3])[k] = (double) addNode(SUMW, 0.0, &restnodes[0], &restcoefs[0], restnodes.size());
+      }
+
+      plhs[0] = mxCreateSparse(nvar, nroots, MAX(rowind.size(), 1), mxREAL);
+      for (size_t k = 0; k <= nroots; ++k)
+         mxGetJc(plhs[0])[k] = colbeg[k];
+      for (size_t p = 0; p < rowind.size(); ++p)
+      {
+         mxGetIr(plhs[0])[p] = rowind[p];
+         mxGetPr(plhs[0])[p] = vals[p];
+      }
+   }
+   else
+   {
+      snprintf(msgbuf, BUFSIZE, "Unknown command \"%.*s\".", 64, cmd);
+      mexErrMsgTxt(msgbuf);
+   }
+}
@@ -11,13 +11,27 @@
 #include "mex.h"
 #include <ctype.h>
 #include <stdio.h>
+#include <string.h>
+#include <stdint.h>
 #include <cmath>
 #include <limits>
+#include <chrono>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <scip/scip.h>
 #include <scip/scipdefplugins.h>
 #include <scip/pub_paramset.h>
+#include <scip/pub_misc_linear.h>
+#include <lpi/lpi.h>
 #include "scipeventmex.h"
+#include "scipcallbackmex.h"
 #include "opti_build_utils.h"
 #include "scipnlmex.h"
 
@@ -49,6 +63,7 @@ static char msgbuf[BUFSIZE];
 
 /* error catching macro */
 #define SCIP_ERR(rc,msg) if ( rc != SCIP_OKAY ) { snprintf(msgbuf, BUFSIZE, "%s, Error Code: %d", msg, rc); mexErrMsgTxt(msgbuf);}
+#define LPI_ERR(rc,msg) if ( rc != SCIP_OKAY ) { (void) SCIPlpiFree(&lpi); SCIP_ERR(rc, msg); }
 
 
 /* supporting functions */
@@ -96,6 +111,255 @@ void msginfo(
     mexEvalString("drawnow;");  /* flush draw buffer */
 }
 
+/** checks whether an array holds real double, single, integer or logical data */
+static
+bool isRealData(
+   const mxArray*        arr                 /**< array */
+   )
+{
+   return ( mxIsNumeric(arr) || mxIsLogical(arr) ) && ! mxIsComplex(arr);
+}
+
+/** converts entries of typed data to double */
+template <typename T>
+static
+void convertEntries(
+   const void*           data,               /**< data of array */
+   size_t                offset,             /**< position of first entry */
+   size_t                n,                  /**< number of entries */
+   double*               vals                /**< array to store the n values */
+   )
+{
+   const T* d = (const T*) data + offset;
+
+   for (size_t k = 0; k < n; ++k)
+      vals[k] = (double) d[k];
+}
+
+/** converts entries of a dense or the nonzeros of a sparse double, single, integer or logical array to double */
+static
+void convertToDouble(
+   const mxArray*        arr,                /**< array */
+   size_t                offset,             /**< position of first entry */
+   size_t                n,                  /**< number of entries */
+   double*               vals                /**< array to store the n values */
+   )
+{
+   const void* data = mxGetData(arr);
+
+   switch ( mxGetClassID(arr) )
+   {
+   case mxDOUBLE_CLASS:  memcpy(vals, (const double*) data + offset, n * sizeof(double)); break;
+   case mxSINGLE_CLASS:  convertEntries<float>(data, offset, n, vals); break;
+   case mxINT8_CLASS:    convertEntries<int8_t>(data, offset, n, vals); break;
+   case mxUINT8_CLASS:   convertEntries<uint8_t>(data, offset, n, vals); break;
+   case mxINT16_CLASS:   convertEntries<int16_t>(data, offset, n, vals); break;
+   case mxUINT16_CLASS:  convertEntries<uint16_t>(data, offset, n, vals); break;
+   case mxINT32_CLASS:   convertEntries<int32_t>(data, offset, n, vals); break;
+   case mxUINT32_CLASS:  convertEntries<uint32_t>(data, offset, n, vals); break;
+   case mxINT64_CLASS:   convertEntries<int64_t>(data, offset, n, vals); break;
+   case mxUINT64_CLASS:  convertEntries<uint64_t>(data, offset, n, vals); break;
+   case mxLOGICAL_CLASS: convertEntries<mxLogical>(data, offset, n, vals); break;
+   default:
+      mexErrMsgTxt("Input data must be of class double, single, integer or logical.");
+   }
+}
+
+/** gets the entries of a dense double, single, integer or logical array as doubles
+ *
+ *  Double arrays are returned directly. Other arrays are converted into new memory, which has to be freed with
+ *  mxFree() if converted is set to 1.
+ */
+static
+double* getDoubleData(
+   const mxArray*        arr,                /**< array */
+   int*                  converted           /**< returns whether the data was converted */
+   )
+{
+   double* vals;
+   size_t n;
+
+   if ( mxIsDouble(arr) )
+   {
+      *converted = 0;
+      return mxGetPr(arr);
+   }
+
+   n = mxGetNumberOfElements(arr);
+   vals = (double*) mxCalloc(n > 0 ? n : 1, sizeof(double));
+   convertToDouble(arr, 0, n, vals);
+   *converted = 1;
+
+   return vals;
+}
+
+/** gets 1-based variable indices from a double, single or integer array, or the positions of the true entries of a
+ *  logical array
+ *
+ *  Returns newly allocated memory, which has to be freed with mxFree(), if converted is set to 1.
+ */
+static
+double* getIndexData(
+   const mxArray*        arr,                /**< array */
+   size_t                ndec,               /**< number of variables */
+   size_t*               nidx,               /**< returns number of indices */
+   int*                  converted           /**< returns whether the data was converted */
+   )
+{
+   double* idx;
+
+   if ( mxIsLogical(arr) )
+   {
+      const mxLogical* mask = mxGetLogicals(arr);
+      size_t n = mxGetNumberOfElements(arr);
+
+      idx = (double*) mxCalloc(n > 0 ? n : 1, sizeof(double));
+      *nidx = 0;
+      for (size_t k = 0; k < n; ++k)
+      {
+         if ( mask[k] )
+            idx[(*nidx)++] = (double) (k + 1);
+      }
+      *converted = 1;
+   }
+   else
+   {
+      idx = getDoubleData(arr, converted);
+      *nidx = mxGetNumberOfElements(arr);
+   }
+
+   for (size_t k = 0; k < *nidx; ++k)
+   {
+      if ( idx[k] < 1.0 || idx[k] > (double) ndec || idx[k] != floor(idx[k]) )
+      {
+         snprintf(msgbuf, BUFSIZE, "Invalid variable index %g (must be an integer between 1 and %zu).", idx[k], ndec);
+         mexErrMsgTxt(msgbuf);
+      }
+   }
+
+   return idx;
+}
+
+/** column-wise access to the nonzeros of a sparse or dense, double, single, integer or logical matrix
+ *
+ *  The nonzeros of sparse double matrices are returned in place, all other columns are converted (dense columns are
+ *  scanned for nonzeros) into buffers that are reused for each column.
+ */
+struct MatrixColumns
+{
+   const mxArray*        arr;                /**< matrix */
+   size_t                nrows;              /**< number of rows */
+   mwIndex*              rowbuf;             /**< buffer for row indices of converted columns (or NULL) */
+   double*               valbuf;             /**< buffer for values of converted columns (or NULL) */
+};
+
+/** initializes column-wise access to a matrix */
+static
+void initMatrixColumns(
+   MatrixColumns*        mat,                /**< column access data */
+   const mxArray*        arr                 /**< matrix */
+   )
+{
+   mat->arr = arr;
+   mat->nrows = mxGetM(arr);
+   mat->rowbuf = NULL;
+   mat->valbuf = NULL;
+
+   if ( ! mxIsSparse(arr) || ! mxIsDouble(arr) )
+   {
+      mat->rowbuf = (mwIndex*) mxCalloc(mat->nrows > 0 ? mat->nrows : 1, sizeof(mwIndex));
+      mat->valbuf = (double*) mxCalloc(mat->nrows > 0 ? mat->nrows : 1, sizeof(double));
+   }
+}
+
+/** gets the nonzeros of a column; the returned arrays are valid until the next call */
+static
+size_t getMatrixColumn(
+   MatrixColumns*        mat,                /**< column access data */
+   size_t                col,                /**< column */
+   const mwIndex**       rows,               /**< returns row indices of nonzeros */
+   const double**        vals                /**< returns values of nonzeros */
+   )
+{
+   size_t nnz = 0;
+
+   if ( mxIsSparse(mat->arr) )
+   {
+      const mwIndex* jc = mxGetJc(mat->arr);
+
+      nnz = jc[col + 1] - jc[col];
+      *rows = mxGetIr(mat->arr) + jc[col];
+      if ( mxIsDouble(mat->arr) )
+         *vals = mxGetPr(mat->arr) + jc[col];
+      else
+      {
+         convertToDouble(mat->arr, jc[col], nnz, mat->valbuf);
+         *vals = mat->valbuf;
+      }
+      return nnz;
+   }
+
+   /* dense column: convert, then compress to nonzeros in place */
+   convertToDouble(mat->arr, col * mat->nrows, mat->nrows, mat->valbuf);
+   for (size_t r = 0; r < mat->nrows; ++r)
+   {
+      if ( mat->valbuf[r] != 0.0 )
+      {
+         mat->rowbuf[nnz] = r;
+         mat->valbuf[nnz++] = mat->valbuf[r];
+      }
+   }
+   *rows = mat->rowbuf;
+   *vals = mat->valbuf;
+
+   return nnz;
+}
+
+/** frees buffers of column-wise access to a matrix */
+static
+void freeMatrixColumns(
+   MatrixColumns*        mat                 /**< column access data */
+   )
+{
+   if ( mat->rowbuf != NULL )
+      mxFree(mat->rowbuf);
+   if ( mat->valbuf != NULL )
+      mxFree(mat->valbuf);
+   mat->rowbuf = NULL;
+   mat->valbuf = NULL;
+}
+
+/** checks that an optional argument is a dense real (double, single, integer or logical) array */
+static
+void checkRealData(
+   const mxArray*        arr,                /**< array (may be NULL) */
+   const char*           name                /**< name of argument */
+   )
+{
+   if ( arr == NULL || mxIsEmpty(arr) )
+      return;
+
+   if ( ! isRealData(arr) || mxIsSparse(arr) )
+   {
+      snprintf(msgbuf, BUFSIZE, "%s must be a dense real double, single, integer or logical array.", name);
+      mexErrMsgTxt(msgbuf);
+   }
+}
+
+/** checks that a matrix is a sparse or dense real (double, single, integer or logical) matrix */
+static
+void checkRealMatrix(
+   const mxArray*        arr,                /**< array */
+   const char*           name                /**< name of argument */
+   )
+{
+   if ( ! isRealData(arr) )
+   {
+      snprintf(msgbuf, BUFSIZE, "%s must be a real double, single, integer or logical matrix (sparse or dense).", name);
+      mexErrMsgTxt(msgbuf);
+   }
+}
+
 /** check all inputs for size and type errors */
 static
 void checkInputs(
@@ -105,6 +369,7 @@ void checkInputs(
 {
    size_t ndec;
    size_t ncon;
+   size_t nconss;
 
    /* Correct number of inputs */
    if ( nrhs <= eUB )
@@ -121,6 +386,11 @@ void checkInputs(
    /* get sizes */
    ndec = mxGetNumberOfElements(prhs[eF]);
    ncon = mxGetM(prhs[eA]);
+   nconss = ncon;
+
+   /* SCIP indexes variables with int, so reject sizes that cannot be represented before touching any data */
+   CheckIntSize(ndec, "variables");
+   CheckIntSize(ncon, "linear constraints");
 
    /* check quadratic objective */
    if ( ! mxIsEmpty(prhs[eH]) )
@@ -128,18 +398,19 @@ void checkInputs(
       if ( mxGetM(prhs[eH]) != ndec || mxGetN(prhs[eH]) != ndec )
          mexErrMsgTxt("H has incompatible dimensions.");
 
-      if ( ! mxIsSparse(prhs[eH]) )
-         mexErrMsgTxt("H must be a sparse matrix.");
+      checkRealMatrix(prhs[eH], "H");
    }
 
-   /* check sparsity (only supported in A) */
+   /* A and H may be sparse or dense, all vectors have to be dense */
    if ( ! mxIsEmpty(prhs[eA]) )
-   {
-      if ( mxIsSparse(prhs[eF]) || mxIsSparse(prhs[eLHS]) || mxIsSparse(prhs[eLB]) )
-         mexErrMsgTxt("Only A is a sparse matrix.");
-      if ( ! mxIsSparse(prhs[eA]) )
-         mexErrMsgTxt("A must be a sparse matrix");
-   }
+      checkRealMatrix(prhs[eA], "A");
+   checkRealData(prhs[eF], "f");
+   checkRealData(prhs[eLHS], "lhs");
+   checkRealData(prhs[eRHS], "rhs");
+   checkRealData(prhs[eLB], "lb");
+   checkRealData(prhs[eUB], "ub");
+   if ( nrhs > eX0 )
+      checkRealData(prhs[eX0], "x0");
 
    /* check xtype data type */
    if ( nrhs > eXTYPE && ! mxIsEmpty(prhs[eXTYPE]) && mxGetClassID(prhs[eXTYPE]) != mxCHAR_CLASS )
@@ -160,7 +431,8 @@ void checkInputs(
       if ( mxGetFieldNumber(prhs[eSOS], "weight") < 0 )
          mexErrMsgTxt("The SOS structure should contain the field 'weight'.");
 
-      int no_sets = (int)mxGetNumberOfElements(mxGetField(prhs[eSOS],0,"type"));
+      size_t no_sets = mxGetNumberOfElements(mxGetField(prhs[eSOS],0,"type"));
+      nconss += no_sets;
 
       if ( no_sets > 1 )
       {
@@ -176,6 +448,16 @@ void checkInputs(
          if ( mxGetNumberOfElements(mxGetField(prhs[eSOS], 0, "weight")) != no_sets )
             mexErrMsgTxt("sos.weight cell array is not the same length as sos.type!");
       }
+
+      /* indices and weights may be double, single, integer (or logical for indices) */
+      for (size_t s = 0; s < no_sets; s++)
+      {
+         const mxArray* sosidx = mxGetField(prhs[eSOS], 0, "index");
+         const mxArray* soswgt = mxGetField(prhs[eSOS], 0, "weight");
+
+         checkRealData(mxIsCell(sosidx) ? mxGetCell(sosidx, s) : sosidx, "sos.index");
+         checkRealData(mxIsCell(soswgt) ? mxGetCell(soswgt, s) : soswgt, "sos.weight");
+      }
    }
 
    /* check QC structure */
@@ -199,7 +481,8 @@ void checkInputs(
       if ( mxGetNumberOfElements(mxGetField(prhs[eQC], 0, "qrl")) != mxGetNumberOfElements(mxGetField(prhs[eQC], 0, "qru")) )
          mexErrMsgTxt("qrl and qru should have the the same number of elements.");
 
-      int no_qc = (int)mxGetNumberOfElements(mxGetField(prhs[eQC], 0, "qrl"));
+      size_t no_qc = mxGetNumberOfElements(mxGetField(prhs[eQC], 0, "qrl"));
+      nconss += no_qc;
       if ( no_qc > 1 )
       {
          if ( ! mxIsCell(mxGetField(prhs[eQC], 0, "Q")) || mxIsEmpty(mxGetField(prhs[eQC], 0, "Q")))
@@ -211,11 +494,10 @@ void checkInputs(
          /* check each Q */
          mxArray* Q;
 
-         for(int i = 0; i < no_qc; i++)
+         for(size_t i = 0; i < no_qc; i++)
          {
             Q = mxGetCell(mxGetField(prhs[eQC], 0, "Q"), i);
-            if ( ! mxIsSparse(Q) )
-               mexErrMsgTxt("Q must be sparse!");
+            checkRealMatrix(Q, "Q");
 
             if ( mxGetM(Q) != ndec || mxGetN(Q) != ndec )
                mexErrMsgTxt("Q must be an n x n square matrix.");
@@ -226,8 +508,7 @@ void checkInputs(
          if ( mxIsEmpty(mxGetField(prhs[eQC], 0, "Q")))
             mexErrMsgTxt("Q must not be empty!");
 
-         if ( ! mxIsSparse(mxGetField(prhs[eQC], 0, "Q")) )
-            mexErrMsgTxt("Q must be sparse!");
+         checkRealMatrix(mxGetField(prhs[eQC], 0, "Q"), "Q");
 
          if ( mxGetM(mxGetField(prhs[eQC], 0, "Q")) != ndec || mxGetN(mxGetField(prhs[eQC], 0, "Q")) != ndec )
             mexErrMsgTxt("Q must be an n x n square matrix.");
@@ -237,8 +518,9 @@ void checkInputs(
       if ( mxIsEmpty(mxGetField(prhs[eQC], 0, "l")) )
          mexErrMsgTxt("l must not be empty!");
 
-      if ( mxIsSparse(mxGetField(prhs[eQC], 0, "l")) )
-         mexErrMsgTxt("l matrix must be dense!");
+      checkRealMatrix(mxGetField(prhs[eQC], 0, "l"), "l");
+      checkRealData(mxGetField(prhs[eQC], 0, "qrl"), "qrl");
+      checkRealData(mxGetField(prhs[eQC], 0, "qru"), "qru");
 
       if ( mxGetN(mxGetField(prhs[eQC], 0, "l")) != no_qc )
          mexErrMsgTxt("l matrix/vector does not have the same number of columns as there are elements in qrl/qru.");
@@ -278,9 +560,14 @@ void checkInputs(
             if ( mxGetNumberOfElements(mxGetField(prhs[eNLCON], 0, "cl")) != 1 )
                mexErrMsgTxt("When nl.instr is not a cell (single constraint), cl and cu are expected to be scalars.");
          }
+
+         nconss += mxGetNumberOfElements(mxGetField(prhs[eNLCON], 0, "cl"));
       }
    }
 
+   /* SCIP counts the constraints of a problem with int */
+   CheckIntSize(nconss, "constraints");
+
    /* check sizes */
    if ( ncon )
    {
@@ -303,7 +590,8 @@ void checkInputs(
    if ( nrhs > eXTYPE && ! mxIsEmpty(prhs[eXTYPE]) && (mxGetNumberOfElements(prhs[eXTYPE]) != ndec) )
       mexErrMsgTxt("xtype has incompatible dimensions");
 
-   if ( nrhs > eX0 && ! mxIsEmpty(prhs[eX0]) && (mxGetNumberOfElements(prhs[eX0]) != ndec) )
+   /* a vector or one starting point per column */
+   if ( nrhs > eX0 && ! mxIsEmpty(prhs[eX0]) && mxGetNumberOfElements(prhs[eX0]) != ndec && mxGetM(prhs[eX0]) != ndec )
       mexErrMsgTxt("x0 has incompatible dimensions");
 }
 
@@ -365,21 +653,34 @@ int getStrOption(
    }
 }
 
-/** process options specified by user
+/** a SCIP parameter with its value, resolved from solverOpts or a parameter file */
+struct UserParam
+{
+   std::string           name;               /**< parameter name */
+   SCIP_PARAMTYPE        type;               /**< parameter type */
+   SCIP_Longint          intval;             /**< value of bool, int and longint parameters */
+   SCIP_Real             realval;            /**< value of real parameters */
+   std::string           strval;             /**< value of char and string parameters */
+   size_t                row;                /**< row in solverOpts (0 for parameter files) */
+};
+
+/** named parameter profiles, defined by scip('defineProfile', name, solverOpts) and kept until the MEX file is cleared */
+static std::map<std::string, std::vector<UserParam> > profiles;
+
+/** resolve options specified by user to typed parameters
  *
  *  Options in the format {'name1', val1; 'name2', val2}
  */
 static
-void processUserOpts(
+void resolveUserOpts(
    SCIP*                 scip,               /**< SCIP instance */
-   mxArray*              opts                /**< options array */
+   const mxArray*        opts,               /**< options array */
+   std::vector<UserParam>& params            /**< array to append the parameters to */
    )
 {
-   SCIP_RETCODE retcode;
    size_t no;
    char* name;
    char* str_val;
-   SCIP_Bool boolval;
    mxArray* opt_name;
    mxArray* opt_val;
    SCIP_PARAM* p = NULL;
@@ -394,6 +695,8 @@ void processUserOpts(
 
       for (size_t i = 0; i < no; i++)
       {
+         UserParam param;
+
          p = NULL; /* ensures we know if we got a valid parameter or not! */
 
          opt_name = mxGetCell(opts, i);
@@ -401,7 +704,7 @@ void processUserOpts(
 
          if ( mxIsEmpty(opt_name) )
          {
-            sprintf(msgbuf, "SCIP option name in cell row %zd is empty!", i + 1);
+            sprintf(msgbuf, "SCIP option name in cell row %zu is empty!", i + 1);
             mexErrMsgTxt(msgbuf);
          }
 
@@ -410,7 +713,7 @@ void processUserOpts(
 
          if ( ! mxIsChar(opt_name) )
          {
-            sprintf(msgbuf, "SCIP option name in cell row %zd is not a string!", i + 1);
+            sprintf(msgbuf, "SCIP option name in cell row %zu is not a string!", i + 1);
             mexErrMsgTxt(msgbuf);
          }
 
@@ -423,13 +726,19 @@ void processUserOpts(
          if ( p == NULL )
          {
             /* clean up SCIP here */
-            sprintf(msgbuf, "SCIP option \"%s\" (row %zd) is not recognized!", name, i + 1);
+            sprintf(msgbuf, "SCIP option \"%s\" (row %zu) is not recognized!", name, i + 1);
             mxFree(name);
             mexErrMsgTxt(msgbuf);
          }
 
-         /* based on parameter type, get from MATLAB and set via correct SCIP method */
-         switch ( SCIPparamGetType(p) )
+         param.name = name;
+         param.type = SCIPparamGetType(p);
+         param.intval = 0;
+         param.realval = 0.0;
+         param.row = i + 1;
+
+         /* based on parameter type, get from MATLAB */
+         switch ( param.type )
          {
          case SCIP_PARAMTYPE_BOOL:
             if ( ! mxIsDouble(opt_val) && ! mxIsLogical(opt_val) )
@@ -441,25 +750,12 @@ void processUserOpts(
             if ( mxIsLogical(opt_val) )
             {
                bool* tval = (bool*)mxGetData(opt_val);
-               if ( *tval )
-                  boolval = TRUE;
-               else
-                  boolval = FALSE;
+               param.intval = *tval ? TRUE : FALSE;
             }
             else
             {
                double* tval = (double*)mxGetPr(opt_val);
-               if ( *tval != 0 )
-                  boolval = TRUE;
-               else
-                  boolval = FALSE;
-            }
-
-            retcode = SCIPsetBoolParam(scip, name, boolval);
-            if ( retcode != SCIP_OKAY )
-            {
-               sprintf(msgbuf, "Error setting SCIP bool option \"%s\" (Row %zd)! Please check the value is within range.", name, i + 1);
-               mexErrMsgTxt(msgbuf);
+               param.intval = *tval != 0 ? TRUE : FALSE;
             }
             break;
 
@@ -469,13 +765,7 @@ void processUserOpts(
                sprintf(msgbuf, "Error setting parameter \"%s\" - Expected the value to be a double.", name);
                mexErrMsgTxt(msgbuf);
             }
-
-            retcode = SCIPsetIntParam(scip, name, (int) *mxGetPr(opt_val));
-            if ( retcode != SCIP_OKAY )
-            {
-               sprintf(msgbuf, "Error setting SCIP integer option \"%s\" (row %zd)! Please check the value is within range.", name, i + 1);
-               mexErrMsgTxt(msgbuf);
-            }
+            param.intval = (int) *mxGetPr(opt_val);
             break;
 
          case SCIP_PARAMTYPE_LONGINT:
@@ -484,13 +774,7 @@ void processUserOpts(
                sprintf(msgbuf, "Error setting parameter \"%s\" - Expected the value to be a double.", name);
                mexErrMsgTxt(msgbuf);
             }
-
-            retcode = SCIPsetLongintParam(scip, name, *mxGetPr(opt_val));
-            if ( retcode != SCIP_OKAY )
-            {
-               sprintf(msgbuf, "Error setting SCIP longint option \"%s\" (Row %zd)! Please check the value is within range.", name, i + 1);
-               mexErrMsgTxt(msgbuf);
-            }
+            param.intval = (SCIP_Longint) *mxGetPr(opt_val);
             break;
 
          case SCIP_PARAMTYPE_REAL:
@@ -499,13 +783,7 @@ void processUserOpts(
                sprintf(msgbuf, "Error setting parameter \"%s\" - Expected the value to be a double.", name);
                mexErrMsgTxt(msgbuf);
             }
-
-            retcode = SCIPsetRealParam(scip, name, *mxGetPr(opt_val));
-            if ( retcode != SCIP_OKAY )
-            {
-               sprintf(msgbuf, "Error setting SCIP real option \"%s\" (Row %zd)! Please check the value is within range.", name, i + 1);
-               mexErrMsgTxt(msgbuf);
-            }
+            param.realval = *mxGetPr(opt_val);
             break;
 
          case SCIP_PARAMTYPE_CHAR:
@@ -515,14 +793,7 @@ void processUserOpts(
                mexErrMsgTxt(msgbuf);
             }
             str_val = mxArrayToString(opt_val);
-
-            retcode = SCIPsetCharParam(scip, name, str_val[0]);
-            if ( retcode != SCIP_OKAY )
-            {
-               sprintf(msgbuf, "Error setting SCIP char option \"%s\" (Row %zd)! Please check the value is a valid character.", name, i + 1);
-               mxFree(str_val);
-               mexErrMsgTxt(msgbuf);
-            }
+            param.strval = std::string(1, str_val[0]);
             mxFree(str_val);
             break;
 
@@ -533,106 +804,2801 @@ void processUserOpts(
                mexErrMsgTxt(msgbuf);
             }
             str_val = mxArrayToString(opt_val);
-
-            retcode = SCIPsetStringParam(scip, name, str_val);
-            if ( retcode != SCIP_OKAY )
-            {
-               sprintf(msgbuf,"Error setting SCIP string option \"%s\" (Row %zd)! Please check the value is a valid string.", name, i + 1);
-               mxFree(str_val);
-               mexErrMsgTxt(msgbuf);
-            }
+            param.strval = str_val;
             mxFree(str_val);
             break;
          }
          /* free string memory */
          mxFree(name);
+
+         params.push_back(param);
       }
    }
 }
 
-/*
-SCIP_PARAMSETTING getEmphasisSetting(char* optsStr)
+/** set a resolved parameter via the SCIP method of its type
+ *
+ *  Does not use the MATLAB API, so it can also be called while worker threads are running.
+ */
+static
+SCIP_RETCODE setUserParam(
+   SCIP*                 scip,               /**< SCIP instance */
+   const UserParam&      param               /**< parameter */
+   )
 {
-    if ( strcmp(optsStr, "default") == 0 )
-        return SCIP_PARAMSETTING_DEFAULT;
-    else if ( strcmp(optsStr, "aggressive") == 0 )
-        return SCIP_PARAMSETTING_AGGRESSIVE;
-    else if ( strcmp(optsStr, "fast") == 0 )
-        return SCIP_PARAMSETTING_FAST;
-    else if ( strcmp(optsStr, "off") == 0 )
-        return SCIP_PARAMSETTING_OFF;
-    else
-    {
-        sprintf(msgbuf,"Error Setting Emphasis Option - Unknown Emphasis Type \"%s\".", optsStr);
-        mexErrMsgTxt(msgbuf);
-    }
+   const char* name = param.name.c_str();
+
+   switch ( param.type )
+   {
+   case SCIP_PARAMTYPE_BOOL:
+      return SCIPsetBoolParam(scip, name, (SCIP_Bool) param.intval);
+   case SCIP_PARAMTYPE_INT:
+      return SCIPsetIntParam(scip, name, (int) param.intval);
+   case SCIP_PARAMTYPE_LONGINT:
+      return SCIPsetLongintParam(scip, name, param.intval);
+   case SCIP_PARAMTYPE_REAL:
+      return SCIPsetRealParam(scip, name, param.realval);
+   case SCIP_PARAMTYPE_CHAR:
+      return SCIPsetCharParam(scip, name, param.strval[0]);
+   case SCIP_PARAMTYPE_STRING:
+      return SCIPsetStringParam(scip, name, param.strval.c_str());
+   }
+   return SCIP_PARAMETERUNKNOWN;
 }
-*/
 
-/* // Process Emphasis Settings
-void processEmphasisOptions(SCIP *scip, mxArray *opts)
-{
-    char optsStr[BUFSIZE]; optsStr[0]   = NULL;
-    SCIP_SET* set;//                       = scip->set;
-    SCIP_PARAMSET* paramset             = set->paramset;
-    SCIP_MESSAGEHDLR* messagehdlr;//       = scip->messagehdlr;
+/** set resolved parameters via the SCIP method of their type */
+static
+void applyUserParams(
+   SCIP*                 scip,               /**< SCIP instance */
+   const std::vector<UserParam>& params      /**< parameters */
+   )
+{
+   /* indexed by SCIP_PARAMTYPE */
+   const char* typenames[6] = {"bool", "integer", "longint", "real", "char", "string"};
+
+   for (size_t i = 0; i < params.size(); ++i)
+   {
+      const UserParam& param = params[i];
+
+      if ( setUserParam(scip, param) != SCIP_OKAY )
+      {
+         snprintf(msgbuf, BUFSIZE, "Error setting SCIP %s option \"%s\" (row %zu)! Please check the value is %s.",
+            typenames[param.type], param.name.c_str(), param.row, param.type == SCIP_PARAMTYPE_CHAR ? "a valid character" :
+            ( param.type == SCIP_PARAMTYPE_STRING ? "a valid string" : "within range" ));
+         mexErrMsgTxt(msgbuf);
+      }
+   }
+}
+
+/** process options specified by user
+ *
+ *  Options in the format {'name1', val1; 'name2', val2}
+ */
+static
+void processUserOpts(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        opts                /**< options array */
+   )
+{
+   std::vector<UserParam> params;
+
+   resolveUserOpts(scip, opts, params);
+   applyUserParams(scip, params);
+}
+
+/** read a SCIP parameter file (.set), reporting errors with its name */
+static
+void readParamFile(
+   SCIP*                 scip,               /**< SCIP instance */
+   const char*           filename            /**< name of parameter file */
+   )
+{
+   SCIP_RETCODE rc = SCIPreadParams(scip, filename);
+
+   if ( rc != SCIP_OKAY )
+   {
+      snprintf(msgbuf, BUFSIZE, "Error reading parameter file \"%s\", Error: %s (Code: %d)", filename, scipErrCode(rc), rc);
+      mexErrMsgTxt(msgbuf);
+   }
+}
+
+/** collect all parameters that differ from their defaults, e.g., after reading a parameter file */
+static
+void collectChangedParams(
+   SCIP*                 scip,               /**< SCIP instance */
+   std::vector<UserParam>& params            /**< array to append the parameters to */
+   )
+{
+   SCIP_PARAM** allparams = SCIPgetParams(scip);
+
+   for (int k = 0; k < SCIPgetNParams(scip); ++k)
+   {
+      SCIP_PARAM* p = allparams[k];
+      UserParam param;
+
+      if ( SCIPparamIsDefault(p) )
+         continue;
+
+      param.name = SCIPparamGetName(p);
+      param.type = SCIPparamGetType(p);
+      param.intval = 0;
+      param.realval = 0.0;
+      param.row = 0;
+
+      switch ( param.type )
+      {
+      case SCIP_PARAMTYPE_BOOL:
+         param.intval = SCIPparamGetBool(p);
+         break;
+      case SCIP_PARAMTYPE_INT:
+         param.intval = SCIPparamGetInt(p);
+         break;
+      case SCIP_PARAMTYPE_LONGINT:
+         param.intval = SCIPparamGetLongint(p);
+         break;
+      case SCIP_PARAMTYPE_REAL:
+         param.realval = SCIPparamGetReal(p);
+         break;
+      case SCIP_PARAMTYPE_CHAR:
+         param.strval = std::string(1, SCIPparamGetChar(p));
+         break;
+      case SCIP_PARAMTYPE_STRING:
+         param.strval = SCIPparamGetString(p);
+         break;
+      }
+      params.push_back(param);
+   }
+}
+
+/** apply the parameter file, the parameter profile and the solverOpts of the options, in this order */
+static
+void applySolverOpts(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        opts                /**< options structure (or NULL) */
+   )
+{
+   char paramfile[BUFSIZE];
+   char profile[BUFSIZE];
+
+   if ( opts == NULL )
+      return;
+
+   if ( getStrOption(opts, "paramfile", paramfile) == 0 )
+      readParamFile(scip, paramfile);
+
+   if ( getStrOption(opts, "profile", profile) == 0 )
+   {
+      std::map<std::string, std::vector<UserParam> >::const_iterator it = profiles.find(profile);
+
+      if ( it == profiles.end() )
+      {
+         snprintf(msgbuf, BUFSIZE, "Unknown parameter profile \"%s\", define it with scip('defineProfile', name, solverOpts).", profile);
+         mexErrMsgTxt(msgbuf);
+      }
+      applyUserParams(scip, it->second);
+   }
+
+   if ( mxGetField(opts, 0, "solverOpts") )
+      processUserOpts(scip, mxGetField(opts, 0, "solverOpts"));
+}
+
+/** define a named parameter profile
+ *
+ *  scip('defineProfile', name, solverOpts)
+ *
+ *  solverOpts is a cell array {'name1', val1; ...} or the name of a parameter file. The parameters are resolved and
+ *  checked once with a SCIP instance including the default plugins and stored, so that later solves with
+ *  opts.profile = name set them directly. An empty solverOpts removes the profile. Returns the number of parameters.
+ */
+static
+void defineProfile(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   std::vector<UserParam> params;
+   char name[BUFSIZE];
+   SCIP* scip;
+
+   if ( nrhs < 3 || ! mxIsChar(prhs[1]) || mxIsEmpty(prhs[1]) )
+      mexErrMsgTxt("Usage: scip('defineProfile', name, solverOpts).");
+   mxGetString(prhs[1], name, BUFSIZE);
+
+   if ( mxIsEmpty(prhs[2]) )
+   {
+      profiles.erase(name);
+      if ( nlhs >= 1 )
+         plhs[0] = mxCreateDoubleScalar(0.0);
+      return;
+   }
+
+   SCIP_ERR( SCIPcreate(&scip), "Error creating SCIP object.");
+   SCIP_ERR( SCIPincludeDefaultPlugins(scip), "Error including SCIP default plugins.");
+
+   if ( mxIsChar(prhs[2]) )
+   {
+      char* filename = mxArrayToString(prhs[2]);
+      SCIP_RETCODE rc = SCIPreadParams(scip, filename);
+
+      if ( rc != SCIP_OKAY )
+      {
+         SCIPfree(&scip);
+         snprintf(msgbuf, BUFSIZE, "Error reading parameter file \"%s\", Error: %s (Code: %d)", filename, scipErrCode(rc), rc);
+         mxFree(filename);
+         mexErrMsgTxt(msgbuf);
+      }
+      mxFree(filename);
+      collectChangedParams(scip, params);
+   }
+   else
+   {
+      /* setting the values also checks their ranges */
+      resolveUserOpts(scip, prhs[2], params);
+      applyUserParams(scip, params);
+   }
+
+   SCIP_ERR( SCIPfree(&scip), "Error releasing SCIP.");
+
+   profiles[name] = params;
+   if ( nlhs >= 1 )
+      plhs[0] = mxCreateDoubleScalar((double) params.size());
+}
+
+/** set common options, message handler and verbosity level
+ *
+ *  Returns the print level.
+ */
+static
+int setCommonOpts(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        opts                /**< options structure (or NULL) */
+   )
+{
+   SCIP_Longint maxlpiter = -1LL;
+   SCIP_Longint maxnodes = -1LL;
+   SCIP_Longint stallnodes = -1LL;
+   double maxtime = 1e20;
+   double primtol = SCIP_DEFAULT_FEASTOL;
+   double relgap = -1.0;
+   double absgap = -1.0;
+   double stalltime = 1e20;
+   int maxsols = -1;
+   int presolvethreads = 0;
+   int printLevel = 0;
+
+   if ( opts != NULL )
+   {
+      getLongIntOption(opts, "maxiter", maxlpiter);
+      getLongIntOption(opts, "maxnodes", maxnodes);
+      getLongIntOption(opts, "stallnodes", stallnodes);
+      getDblOption(opts, "maxtime", maxtime);
+      getDblOption(opts, "tolrfun", primtol);
+      getDblOption(opts, "relgap", relgap);
+      getDblOption(opts, "absgap", absgap);
+      getDblOption(opts, "stalltime", stalltime);
+      getIntOption(opts, "maxsols", maxsols);
+      getIntOption(opts, "presolvethreads", presolvethreads);
+      getIntOption(opts, "display", printLevel);
+      /* make sure level is ok */
+      if ( printLevel < 0 )
+         printLevel = 0;
+      if ( printLevel > 5 )
+         printLevel = 5;
+
+      /* set common options */
+      if ( ! SCIPisInfinity(scip, maxtime) )
+      {
+         SCIP_ERR( SCIPsetRealParam(scip, "limits/time", maxtime), "Error setting maxtime.");
+      }
+      if ( maxlpiter >= 0LL )
+      {
+         SCIP_ERR( SCIPsetLongintParam(scip, "lp/iterlim", maxlpiter), "Error setting LP iterlim.");
+      }
+      if ( maxnodes >= 0 )
+      {
+         SCIP_ERR( SCIPsetLongintParam(scip, "limits/nodes", maxnodes), "Error setting nodes.");
+      }
+      if ( primtol != SCIP_DEFAULT_FEASTOL )
+      {
+         SCIP_ERR( SCIPsetRealParam(scip, "numerics/feastol", primtol), "Error setting lpfeastol.");
+      }
+
+      /* early termination */
+      if ( relgap >= 0.0 )
+      {
+         SCIP_ERR( SCIPsetRealParam(scip, "limits/gap", relgap), "Error setting relgap.");
+      }
+      if ( absgap >= 0.0 )
+      {
+         SCIP_ERR( SCIPsetRealParam(scip, "limits/absgap", absgap), "Error setting absgap.");
+      }
+      if ( stallnodes >= 0LL )
+      {
+         SCIP_ERR( SCIPsetLongintParam(scip, "limits/stallnodes", stallnodes), "Error setting stallnodes.");
+      }
+      if ( maxsols >= 0 )
+      {
+         SCIP_ERR( SCIPsetIntParam(scip, "limits/solutions", maxsols), "Error setting maxsols.");
+      }
+      if ( ! SCIPisInfinity(scip, stalltime) )
+      {
+         if ( stalltime < 0.0 )
+            mexErrMsgTxt("opts.stalltime must be nonnegative.");
+         SCIP_ERR( SCIPincludeStallTimeEventHdlr(scip, stalltime), "Error adding stall time event handler.");
+      }
+
+      /* parallel presolving with PaPILO (presolver milp, only if SCIP was built with PaPILO) */
+      if ( presolvethreads > 0 )
+      {
+         if ( SCIPgetParam(scip, "presolving/milp/threads") != NULL )
+         {
+            SCIP_ERR( SCIPsetIntParam(scip, "presolving/milp/threads", presolvethreads), "Error setting presolve threads.");
+         }
+         else
+            mexWarnMsgTxt("This SCIP version was built without PaPILO, opts.presolvethreads is ignored.");
+      }
+   }
+
+   /* if user has requested print out */
+   if ( printLevel )
+   {
+      /* create message handler */
+      SCIP_MESSAGEHDLR* mexprinter;
+
+      SCIPmessagehdlrCreate(&mexprinter, TRUE, NULL, FALSE, &msginfo, &msginfo, &msginfo, NULL, NULL);
+      SCIP_ERR( SCIPsetMessagehdlr(scip, mexprinter), "Error adding message handler.");
+   }
+
+   /* set verbosity level */
+   SCIP_ERR( SCIPsetIntParam(scip, "display/verblevel", printLevel), "Error setting verblevel.");
+
+   if ( printLevel )
+   {
+      SCIPprintVersion(scip, NULL);
+      SCIPinfoMessage(scip, NULL, "\n");
+
+      SCIPprintExternalCodes(scip, NULL);
+      SCIPinfoMessage(scip, NULL, "\n");
+   }
+
+   return printLevel;
+}
+
+/** set the limits that have to be applied right before each solve
+ *
+ *  The objective limit needs the problem (it can only be set before solving, i.e., also after presolving), and the
+ *  remaining time to the deadline (absolute POSIX time [s]) is computed from the current clock. Returns whether the time limit was reduced
+ *  to meet the deadline.
+ */
+static
+SCIP_Bool setSolveLimits(
+   SCIP*                 scip,               /**< SCIP instance with problem */
+   const mxArray*        opts                /**< options structure (or NULL) */
+   )
+{
+   double objlimit = std::numeric_limits<double>::quiet_NaN();
+   double deadline = std::numeric_limits<double>::quiet_NaN();
+   double timelimit;
+   double remaining;
+
+   if ( opts == NULL )
+      return FALSE;
+
+   getDblOption(opts, "objlimit", objlimit);
+   getDblOption(opts, "deadline", deadline);
+
+   if ( ! mxIsNaN(objlimit) && SCIPgetStage(scip) <= SCIP_STAGE_PRESOLVED )
+   {
+      SCIP_ERR( SCIPsetObjlimit(scip, objlimit), "Error setting objlimit.");
+   }
+
+   if ( mxIsNaN(deadline) )
+      return FALSE;
+
+   /* limits/time refers to the solving time of the SCIP instance, which includes previous solves */
+   remaining = deadline - std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+   remaining = SCIPgetSolvingTime(scip) + MAX(remaining, 0.0);
+   SCIP_ERR( SCIPgetRealParam(scip, "limits/time", &timelimit), "Error getting time limit.");
+   if ( remaining >= timelimit )
+      return FALSE;
+
+   SCIP_ERR( SCIPsetRealParam(scip, "limits/time", remaining), "Error setting deadline.");
+   return TRUE;
+}
+
+/** returns the name of the reason why the last solve stopped */
+static
+const char* getStopReason(
+   SCIP*                 scip,               /**< SCIP instance after solving */
+   const mxArray*        opts,               /**< options structure (or NULL) */
+   SCIP_Bool             deadline            /**< was the time limit reduced to meet the deadline? */
+   )
+{
+   double objlimit = std::numeric_limits<double>::quiet_NaN();
+   double absgap = -1.0;
+
+   if ( opts != NULL )
+   {
+      getDblOption(opts, "objlimit", objlimit);
+      getDblOption(opts, "absgap", absgap);
+   }
+
+   switch ( SCIPgetStatus(scip) )
+   {
+   case SCIP_STATUS_OPTIMAL:
+      return "optimal";
+   case SCIP_STATUS_INFEASIBLE:
+      /* SCIP reports no solution better than the objective limit as infeasible, so both cannot be told apart */
+      return mxIsNaN(objlimit) ? "infeasible" : "infeasible_or_objlimit";
+   case SCIP_STATUS_UNBOUNDED:
+      return "unbounded";
+   case SCIP_STATUS_INFORUNBD:
+      return "inforunbd";
+   case SCIP_STATUS_TIMELIMIT:
+      return deadline ? "deadline" : "timelimit";
+   case SCIP_STATUS_GAPLIMIT:
+      /* SCIP uses the same status for the relative and the absolute gap */
+      if ( absgap >= 0.0 && SCIPgetNSols(scip) > 0 && REALABS(SCIPgetPrimalbound(scip) - SCIPgetDualbound(scip)) <= absgap )
+         return "absgaplimit";
+      return "gaplimit";
+   case SCIP_STATUS_SOLLIMIT:
+      return "sollimit";
+   case SCIP_STATUS_BESTSOLLIMIT:
+      return "bestsollimit";
+   case SCIP_STATUS_STALLNODELIMIT:
+      return "stallnodes";
+   case SCIP_STATUS_USERINTERRUPT:
+      return SCIPisStallTimeReached(scip) ? "stalltime" : "userinterrupt";
+   case SCIP_STATUS_NODELIMIT:
+      return "nodelimit";
+   case SCIP_STATUS_TOTALNODELIMIT:
+      return "totalnodelimit";
+   case SCIP_STATUS_MEMLIMIT:
+      return "memlimit";
+   case SCIP_STATUS_RESTARTLIMIT:
+      return "restartlimit";
+   default:
+      return "unknown";
+   }
+}
+
+/** orders matrix entries (column, (row, value)) by column */
+static
+bool compareColumn(
+   const std::pair<int, std::pair<int, double> >& a, /**< first entry */
+   const std::pair<int, std::pair<int, double> >& b  /**< second entry */
+   )
+{
+   return a.first < b.first;
+}
+
+/** add the matrices of the presolved problem to the presolve statistics
+ *
+ *  Only constraints of the linear constraint types (linear, setppc, logicor, knapsack, varbound) are returned as rows
+ *  of A; the others are counted in NOtherConss. Columns are the active variables of the presolved problem.
+ */
+static
+void setPresolveMatrices(
+   SCIP*                 scip,               /**< SCIP instance after presolving */
+   mxArray*              pstats              /**< presolve statistics structure */
+   )
+{
+   const char* lineartypes[5] = {"linear", "setppc", "logicor", "knapsack", "varbound"};
+   SCIP_VAR** vars = SCIPgetVars(scip);
+   SCIP_CONS** conss = SCIPgetConss(scip);
+   int nvars = SCIPgetNVars(scip);
+   int nconss = SCIPgetNConss(scip);
+   std::vector<int> rowcons;
+   std::vector<std::pair<int, std::pair<int, double> > > entries;    /* (column, (row, value)) */
+   std::vector<SCIP_VAR*> consvars;
+   std::vector<SCIP_Real> consvals;
+   mxArray* f = mxCreateDoubleMatrix(nvars, 1, mxREAL);
+   mxArray* lb = mxCreateDoubleMatrix(nvars, 1, mxREAL);
+   mxArray* ub = mxCreateDoubleMatrix(nvars, 1, mxREAL);
+   mxArray* names = mxCreateCellMatrix(nvars, 1);
+   mxArray* xtype;
+   mxArray* lhs;
+   mxArray* rhs;
+   mxArray* A;
+   char* types = (char*) mxCalloc((size_t) nvars + 1, sizeof(char));
+   int nother = 0;
+
+   for (int j = 0; j < nvars; ++j)
+   {
+      mxGetPr(f)[j] = SCIPvarGetObj(vars[j]);
+      mxGetPr(lb)[j] = SCIPisInfinity(scip, -SCIPvarGetLbGlobal(vars[j])) ? -mxGetInf() : SCIPvarGetLbGlobal(vars[j]);
+      mxGetPr(ub)[j] = SCIPisInfinity(scip, SCIPvarGetUbGlobal(vars[j])) ? mxGetInf() : SCIPvarGetUbGlobal(vars[j]);
+      types[j] = SCIPvarGetType(vars[j]) == SCIP_VARTYPE_BINARY ? 'B' : SCIPvarGetType(vars[j]) == SCIP_VARTYPE_INTEGER ? 'I' : 'C';
+      mxSetCell(names, j, mxCreateString(SCIPvarGetName(vars[j])));
+   }
+   xtype = mxCreateString(types);
+   mxFree(types);
+
+   /* collect the rows of the linear-type constraints */
+   for (int c = 0; c < nconss; ++c)
+   {
+      const char* hdlrname = SCIPconshdlrGetName(SCIPconsGetHdlr(conss[c]));
+      SCIP_Bool success = FALSE;
+      int nconsvars = 0;
+      int row = (int) rowcons.size();
+
+      for (int t = 0; t < 5 && ! success; ++t)
+         success = strcmp(hdlrname, lineartypes[t]) == 0;
+      if ( success )
+      {
+         SCIP_ERR( SCIPgetConsNVars(scip, conss[c], &nconsvars, &success), "Error getting constraint size.");
+      }
+      if ( success )
+      {
+         consvars.resize((size_t) MAX(nconsvars, 1));
+         consvals.resize((size_t) MAX(nconsvars, 1));
+         SCIP_ERR( SCIPgetConsVars(scip, conss[c], &consvars[0], nconsvars, &success), "Error getting constraint variables.");
+      }
+      if ( success )
+      {
+         SCIP_ERR( SCIPgetConsVals(scip, conss[c], &consvals[0], nconsvars, &success), "Error getting constraint coefficients.");
+      }
+      for (int k = 0; k < nconsvars && success; ++k)
+         success = SCIPvarGetProbindex(consvars[k]) >= 0;
+      if ( ! success )
+      {
+         ++nother;
+         continue;
+      }
+
+      rowcons.push_back(c);
+      for (int k = 0; k < nconsvars; ++k)
+         entries.push_back(std::make_pair(SCIPvarGetProbindex(consvars[k]), std::make_pair(row, consvals[k])));
+   }
+
+   /* sides */
+   lhs = mxCreateDoubleMatrix(rowcons.size(), 1, mxREAL);
+   rhs = mxCreateDoubleMatrix(rowcons.size(), 1, mxREAL);
+   for (size_t r = 0; r < rowcons.size(); ++r)
+   {
+      SCIP_Bool success;
+      SCIP_Real side;
+
+      side = SCIPconsGetLhs(scip, conss[rowcons[r]], &success);
+      mxGetPr(lhs)[r] = SCIPisInfinity(scip, -side) ? -mxGetInf() : side;
+      side = SCIPconsGetRhs(scip, conss[rowcons[r]], &success);
+      mxGetPr(rhs)[r] = SCIPisInfinity(scip, side) ? mxGetInf() : side;
+   }
+
+   /* A in compressed column format: sort by column, rows are increasing within a column */
+   std::stable_sort(entries.begin(), entries.end(), compareColumn);
+   A = mxCreateSparse(rowcons.size(), (size_t) nvars, MAX(entries.size(), (size_t) 1), mxREAL);
+   for (size_t k = 0; k < entries.size(); ++k)
+   {
+      mxGetIr(A)[k] = (mwIndex) entries[k].second.first;
+      mxGetPr(A)[k] = entries[k].second.second;
+      ++mxGetJc(A)[entries[k].first + 1];
+   }
+   for (int j = 0; j < nvars; ++j)
+      mxGetJc(A)[j + 1] += mxGetJc(A)[j];
+
+   mxAddField(pstats, "f");
+   mxSetField(pstats, 0, "f", f);
+   mxAddField(pstats, "ObjOffset");
+   mxSetField(pstats, 0, "ObjOffset", mxCreateDoubleScalar(SCIPgetTransObjoffset(scip)));
+   mxAddField(pstats, "A");
+   mxSetField(pstats, 0, "A", A);
+   mxAddField(pstats, "rl");
+   mxSetField(pstats, 0, "rl", lhs);
+   mxAddField(pstats, "ru");
+   mxSetField(pstats, 0, "ru", rhs);
+   mxAddField(pstats, "lb");
+   mxSetField(pstats, 0, "lb", lb);
+   mxAddField(pstats, "ub");
+   mxSetField(pstats, 0, "ub", ub);
+   mxAddField(pstats, "xtype");
+   mxSetField(pstats, 0, "xtype", xtype);
+   mxAddField(pstats, "VarNames");
+   mxSetField(pstats, 0, "VarNames", names);
+   mxAddField(pstats, "NOtherConss");
+   mxSetField(pstats, 0, "NOtherConss", mxCreateDoubleScalar((double) nother));
+}
+
+/** add field Presolve with the sizes and reductions of the presolved problem (and possibly its matrices) */
+static
+void setPresolveStats(
+   SCIP*                 scip,               /**< SCIP instance after presolving */
+   mxArray*              stats,              /**< statistics structure */
+   SCIP_Bool             matrices            /**< also return the matrices of the presolved problem? */
+   )
+{
+   const char* fnames[19] = {"OrigVars", "OrigConss", "Vars", "BinVars", "IntVars", "ImplVars", "ContVars", "Conss",
+      "NNonzeros", "FixedVars", "AggrVars", "ChgVarTypes", "ChgBds", "DelConss", "AddConss", "UpgrConss", "ChgCoefs",
+      "ChgSides", "Rounds"};
+   double vals[19];
+   SCIP_CONS** conss = SCIPgetConss(scip);
+   SCIP_Longint nnonzeros = 0;
+   mxArray* pstats = mxCreateStructMatrix(1, 1, 19, fnames);
+   int threads = 0;
+
+   /* nonzeros of all constraints that report their variables */
+   for (int c = 0; c < SCIPgetNConss(scip); ++c)
+   {
+      SCIP_Bool success;
+      int nconsvars;
+
+      SCIP_ERR( SCIPgetConsNVars(scip, conss[c], &nconsvars, &success), "Error getting constraint size.");
+      if ( success )
+         nnonzeros += nconsvars;
+   }
+
+   vals[0] = SCIPgetNOrigVars(scip);
+   vals[1] = SCIPgetNOrigConss(scip);
+   vals[2] = SCIPgetNVars(scip);
+   vals[3] = SCIPgetNBinVars(scip);
+   vals[4] = SCIPgetNIntVars(scip);
+   vals[5] = SCIPgetNImplVars(scip);
+   vals[6] = SCIPgetNContVars(scip);
+   vals[7] = SCIPgetNConss(scip);
+   vals[8] = (double) nnonzeros;
+   vals[9] = SCIPgetNFixedVars(scip);
+   vals[10] = SCIPgetNAggrVars(scip);
+   vals[11] = SCIPgetNChgVarTypes(scip);
+   vals[12] = SCIPgetNChgBds(scip);
+   vals[13] = SCIPgetNDelConss(scip);
+   vals[14] = SCIPgetNAddConss(scip);
+   vals[15] = SCIPgetNUpgrConss(scip);
+   vals[16] = SCIPgetNChgCoefs(scip);
+   vals[17] = SCIPgetNChgSides(scip);
+   vals[18] = SCIPgetNPresolRounds(scip);
+   for (int k = 0; k < 19; ++k)
+      mxSetField(pstats, 0, fnames[k], mxCreateDoubleScalar(vals[k]));
+
+   mxAddField(pstats, "Time");
+   mxSetField(pstats, 0, "Time", mxCreateDoubleScalar(SCIPgetPresolvingTime(scip)));
+
+   /* threads of PaPILO, 0 if SCIP was built without it */
+   if ( SCIPgetParam(scip, "presolving/milp/threads") != NULL )
+   {
+      SCIP_ERR( SCIPgetIntParam(scip, "presolving/milp/threads", &threads), "Error getting presolve threads.");
+   }
+   mxAddField(pstats, "Threads");
+   mxSetField(pstats, 0, "Threads", mxCreateDoubleScalar((double) threads));
+
+   if ( matrices )
+      setPresolveMatrices(scip, pstats);
+
+   mxAddField(stats, "Presolve");
+   mxSetField(stats, 0, "Presolve", pstats);
+}
+
+/** update a 64-bit FNV-1a hash with a block of bytes */
+static
+uint64_t hashBytes(
+   uint64_t              hash,               /**< current hash value */
+   const void*           data,               /**< data to hash */
+   size_t                nbytes              /**< number of bytes */
+   )
+{
+   const unsigned char* bytes = (const unsigned char*) data;
+
+   for (size_t k = 0; k < nbytes; ++k)
+   {
+      hash ^= (uint64_t) bytes[k];
+      hash *= 1099511628211ULL;
+   }
+   return hash;
+}
+
+/** update hash with the type, size and contents of a MATLAB array (numeric, logical, char, sparse, struct or cell) */
+static
+uint64_t hashMxArray(
+   uint64_t              hash,               /**< current hash value */
+   const mxArray*        arr                 /**< array to hash (or NULL) */
+   )
+{
+   mxClassID classid;
+   size_t nelem;
+
+   if ( arr == NULL )
+      return hashBytes(hash, "", 1);
+
+   classid = mxGetClassID(arr);
+   nelem = mxGetNumberOfElements(arr);
+   hash = hashBytes(hash, &classid, sizeof(classid));
+   hash = hashBytes(hash, mxGetDimensions(arr), mxGetNumberOfDimensions(arr) * sizeof(mwSize));
+
+   if ( mxIsStruct(arr) )
+   {
+      int nfields = mxGetNumberOfFields(arr);
+
+      for (size_t e = 0; e < nelem; ++e)
+      {
+         for (int fi = 0; fi < nfields; ++fi)
+         {
+            const char* fname = mxGetFieldNameByNumber(arr, fi);
+            hash = hashBytes(hash, fname, strlen(fname) + 1);
+            hash = hashMxArray(hash, mxGetFieldByNumber(arr, e, fi));
+         }
+      }
+   }
+   else if ( mxIsCell(arr) )
+   {
+      for (size_t e = 0; e < nelem; ++e)
+         hash = hashMxArray(hash, mxGetCell(arr, e));
+   }
+   else if ( mxIsSparse(arr) )
+   {
+      size_t n = mxGetN(arr);
+      mwIndex* jc = mxGetJc(arr);
+
+      /* sparsity pattern and values */
+      hash = hashBytes(hash, jc, (n + 1) * sizeof(mwIndex));
+      hash = hashBytes(hash, mxGetIr(arr), jc[n] * sizeof(mwIndex));
+      hash = hashBytes(hash, mxGetData(arr), jc[n] * mxGetElementSize(arr));
+   }
+   else if ( mxGetData(arr) != NULL )
+      hash = hashBytes(hash, mxGetData(arr), nelem * mxGetElementSize(arr));
+
+   return hash;
+}
+
+/** update hash with the parameters that differ from their defaults, except for limits and display settings */
+static
+uint64_t hashChangedParams(
+   uint64_t              hash,               /**< current hash value */
+   SCIP*                 scip                /**< SCIP instance with all options applied */
+   )
+{
+   std::vector<UserParam> params;
+
+   collectChangedParams(scip, params);
+   for (size_t k = 0; k < params.size(); ++k)
+   {
+      if ( params[k].name.compare(0, 7, "limits/") == 0 || params[k].name.compare(0, 8, "display/") == 0 )
+         continue;
+
+      hash = hashBytes(hash, params[k].name.c_str(), params[k].name.size() + 1);
+      hash = hashBytes(hash, &params[k].intval, sizeof(params[k].intval));
+      hash = hashBytes(hash, &params[k].realval, sizeof(params[k].realval));
+      hash = hashBytes(hash, params[k].strval.c_str(), params[k].strval.size() + 1);
+   }
+
+   return hash;
+}
+
+/** store the presolved (transformed) problem in the presolve cache
+ *
+ *  The problem is written in CIP format to a temporary file which is then renamed, so that concurrent runs never read a
+ *  partially written file. The presolving time is stored next to it to report the time saved on later hits.
+ */
+static
+void writePresolveCache(
+   SCIP*                 scip,               /**< SCIP instance (presolved) */
+   const char*           cachefile           /**< name of cache file */
+   )
+{
+   char tmpfile[BUFSIZE];
+   FILE* file;
+
+   snprintf(tmpfile, BUFSIZE, "%s.tmp", cachefile);
+   if ( SCIPwriteTransProblem(scip, tmpfile, "cip", FALSE) != SCIP_OKAY || rename(tmpfile, cachefile) != 0 )
+   {
+      remove(tmpfile);
+      snprintf(msgbuf, BUFSIZE, "Could not write presolve cache file \"%s\".", cachefile);
+      mexWarnMsgTxt(msgbuf);
+      return;
+   }
+
+   snprintf(tmpfile, BUFSIZE, "%s.time", cachefile);
+   file = fopen(tmpfile, "w");
+   if ( file != NULL )
+   {
+      fprintf(file, "%.6f\n", SCIPgetPresolvingTime(scip));
+      fclose(file);
+   }
+}
+
+/** solve the cached presolved problem and map the solution back to the original variables
+ *
+ *  In the cached transformed problem, original variable "<name>" appears as "t_<name>" (possibly fixed or aggregated),
+ *  where the names are generated from xtype in the same way as when building the problem. If a variable cannot be
+ *  found, the cache entry does not belong to this problem: it is dropped and FALSE is returned. Otherwise, the cached
+ *  problem is solved without presolving rounds and restarts, and the time saved compared to the presolving time
+ *  recorded when the cache entry was written is stored in timesaved.
+ */
+static
+SCIP_Bool solveFromPresolveCache(
+   SCIP*                 scip,               /**< SCIP instance (without problem) */
+   const char*           cachefile,          /**< name of cache file */
+   const mxArray*        opts,               /**< options structure (or NULL) */
+   const char*           xtype,              /**< variable types (or NULL for continuous) */
+   size_t                ndec,               /**< number of original variables */
+   mxArray*              plhs[],             /**< output arguments (already created) */
+   double*               timesaved           /**< pointer to store the presolving time saved [s] */
+   )
+{
+   std::vector<SCIP_VAR*> vars(ndec);
+   double* x = mxGetPr(plhs[0]);
+   double cachedtime = 0.0;
+   size_t nint = 0;
+   size_t nbin = 0;
+   size_t ncnt = 0;
+   FILE* file;
+
+   SCIP_ERR( SCIPreadProb(scip, cachefile, "cip"), "Error reading presolve cache file.");
+
+   /* find the variable of each original variable before solving */
+   for (size_t i = 0; i < ndec; i++)
+   {
+      switch( xtype != NULL ? tolower(xtype[i]) : 'c' )
+      {
+      case 'i':
+         sprintf(msgbuf, "t_ivar%zu", nint++);
+         break;
+      case 'b':
+         sprintf(msgbuf, "t_bvar%zu", nbin++);
+         break;
+      default:
+         sprintf(msgbuf, "t_xvar%zu", ncnt++);
+         break;
+      }
+
+      vars[i] = SCIPfindVar(scip, msgbuf);
+      if ( vars[i] == NULL )
+      {
+         SCIP_ERR( SCIPfreeProb(scip), "Error freeing presolve cache problem.");
+         remove(cachefile);
+         snprintf(msgbuf, BUFSIZE, "Presolve cache file \"%s\" does not match the problem and is rebuilt.", cachefile);
+         mexWarnMsgTxt(msgbuf);
+         return FALSE;
+      }
+   }
+
+   /* process advanced user options (if they exist) */
+   applySolverOpts(scip, opts);
+
+   /* the cached problem is already presolved */
+   SCIP_ERR( SCIPsetIntParam(scip, "presolving/maxrounds", 0), "Error disabling presolving.");
+   SCIP_ERR( SCIPsetIntParam(scip, "presolving/maxrestarts", 0), "Error disabling restarts.");
+
+   SCIP_Bool deadline = setSolveLimits(scip, opts);
+   SCIP_RETCODE rc = SCIPsolve(scip);
+   if ( rc != SCIP_OKAY )
+   {
+      SCIPfree(&scip);
+      sprintf(msgbuf, "Error Solving SCIP Problem, Error: %s (Code: %d)", scipErrCode(rc), rc);
+      mexErrMsgTxt(msgbuf);
+   }
+
+   *mxGetPr(mxGetField(plhs[3], 0, "LPiter")) = (double)SCIPgetNLPIterations(scip);
+   *mxGetPr(mxGetField(plhs[3], 0, "BBnodes")) = (double)SCIPgetNTotalNodes(scip);
+   *mxGetPr(mxGetField(plhs[3], 0, "DualBound")) = SCIPgetDualbound(scip);
+   *mxGetPr(plhs[2]) = (double)SCIPgetStatus(scip);
+   mxAddField(plhs[3], "StopReason");
+   mxSetField(plhs[3], 0, "StopReason", mxCreateString(getStopReason(scip, opts, deadline)));
+
+   if ( SCIPgetNSols(scip) > 0 )
+   {
+      SCIP_SOL* scipbestsol = SCIPgetBestSol(scip);
+
+      for (size_t i = 0; i < ndec; i++)
+         x[i] = SCIPgetSolVal(scip, scipbestsol, vars[i]);
+
+      *mxGetPr(plhs[1]) = SCIPgetSolOrigObj(scip, scipbestsol);
+      *mxGetPr(mxGetField(plhs[3], 0, "BBgap")) = SCIPgetGap(scip);
+      *mxGetPr(mxGetField(plhs[3], 0, "PrimalBound")) = SCIPgetPrimalbound(scip);
+   }
+   else
+   {
+      *mxGetPr(plhs[1]) = std::numeric_limits<double>::quiet_NaN();
+      *mxGetPr(mxGetField(plhs[3], 0, "BBgap")) = std::numeric_limits<double>::infinity();
+      *mxGetPr(mxGetField(plhs[3], 0, "PrimalBound")) = std::numeric_limits<double>::quiet_NaN();
+   }
+
+   /* compare with the presolving time recorded when writing the cache */
+   snprintf(msgbuf, BUFSIZE, "%s.time", cachefile);
+   file = fopen(msgbuf, "r");
+   if ( file != NULL )
+   {
+      if ( fscanf(file, "%lf", &cachedtime) != 1 )
+         cachedtime = 0.0;
+      fclose(file);
+   }
+   *timesaved = MAX(cachedtime - SCIPgetPresolvingTime(scip), 0.0);
+
+   return TRUE;
+}
+
+/** change the objective of the original problem for the next reoptimization solve
+ *
+ *  SCIPchgReoptObjective() resets all objective coefficients, so the coefficients of the auxiliary variables
+ *  (quadratic/nonlinear objective, objective bias) are passed with their current values.
+ */
+static
+void changeReoptObjective(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_VAR**            vars,               /**< original problem variables */
+   const double*         f,                  /**< new linear objective for vars */
+   size_t                ndec                /**< number of variables in vars */
+   )
+{
+   SCIP_VAR** origvars = SCIPgetOrigVars(scip);
+   int norigvars = SCIPgetNOrigVars(scip);
+   SCIP_Real* coefs;
+
+   SCIP_ERR( SCIPallocMemoryArray(scip, &coefs, norigvars), "Error allocating objective memory.");
+
+   for (int j = 0; j < norigvars; j++)
+      coefs[j] = SCIPvarGetObj(origvars[j]);
+
+   for (size_t i = 0; i < ndec; i++)
+      coefs[SCIPvarGetProbindex(vars[i])] = f[i];
+
+   SCIP_ERR( SCIPchgReoptObjective(scip, SCIP_OBJSENSE_MINIMIZE, origvars, coefs, norigvars), "Error changing reoptimization objective.");
+
+   SCIPfreeMemoryArray(scip, &coefs);
+}
+
+/** returns whether branching priorities, directions or factors are given in the options */
+static
+bool hasBranchingHints(
+   const mxArray*        opts                /**< options structure (or NULL) */
+   )
+{
+   const char* names[3] = {"branchpriority", "branchdir", "branchfactor"};
+
+   if ( opts == NULL )
+      return false;
+
+   for (int k = 0; k < 3; ++k)
+   {
+      const mxArray* field = mxGetField(opts, 0, names[k]);
+      if ( field != NULL && ! mxIsEmpty(field) )
+         return true;
+   }
+
+   return false;
+}
+
+/** checks the branching priorities, directions and factors given in the options, before SCIP instances are created */
+static
+void checkBranchingHints(
+   const mxArray*        opts,               /**< options structure (or NULL) */
+   size_t                nvars               /**< number of variables */
+   )
+{
+   const char* names[3] = {"branchpriority", "branchdir", "branchfactor"};
+
+   if ( opts == NULL )
+      return;
+
+   for (int k = 0; k < 3; ++k)
+   {
+      const mxArray* field = mxGetField(opts, 0, names[k]);
+      double* vals;
+      int avals;
+
+      if ( field == NULL || mxIsEmpty(field) )
+         continue;
+
+      snprintf(msgbuf, BUFSIZE, "opts.%s", names[k]);
+      checkRealData(field, msgbuf);
+      if ( mxGetNumberOfElements(field) != nvars )
+      {
+         snprintf(msgbuf, BUFSIZE, "opts.%s must have one entry per variable (%zu).", names[k], nvars);
+         mexErrMsgTxt(msgbuf);
+      }
+
+      vals = getDoubleData(field, &avals);
+      for (size_t j = 0; j < nvars; ++j)
+      {
+         switch ( k )
+         {
+         case 0:
+            /* higher priorities are branched on first */
+            if ( vals[j] != floor(vals[j]) || fabs(vals[j]) > (double) INT_MAX )
+            {
+               snprintf(msgbuf, BUFSIZE, "Invalid branching priority %g (must be an integer).", vals[j]);
+               mexErrMsgTxt(msgbuf);
+            }
+            break;
+         case 1:
+            /* preferred child: -1 down, 0 automatic, 1 up */
+            if ( vals[j] != -1.0 && vals[j] != 0.0 && vals[j] != 1.0 )
+            {
+               snprintf(msgbuf, BUFSIZE, "Invalid branching direction %g (must be -1, 0 or 1).", vals[j]);
+               mexErrMsgTxt(msgbuf);
+            }
+            break;
+         default:
+            /* weight of the branching score */
+            if ( ! ( vals[j] >= 0.0 ) || mxIsInf(vals[j]) )
+            {
+               snprintf(msgbuf, BUFSIZE, "Invalid branching factor %g (must be finite and nonnegative).", vals[j]);
+               mexErrMsgTxt(msgbuf);
+            }
+            break;
+         }
+      }
+      if ( avals )
+         mxFree(vals);
+   }
+}
+
+/** applies the branching priorities, directions and factors given in the options to the variables */
+static
+void setBranchingHints(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        opts,               /**< options structure (or NULL) */
+   SCIP_VAR**            vars,               /**< variables */
+   size_t                nvars               /**< number of variables */
+   )
+{
+   const char* names[3] = {"branchpriority", "branchdir", "branchfactor"};
+
+   if ( opts == NULL )
+      return;
+
+   checkBranchingHints(opts, nvars);
+
+   for (int k = 0; k < 3; ++k)
+   {
+      const mxArray* field = mxGetField(opts, 0, names[k]);
+      double* vals;
+      int avals;
+
+      if ( field == NULL || mxIsEmpty(field) )
+         continue;
+
+      vals = getDoubleData(field, &avals);
+      for (size_t j = 0; j < nvars; ++j)
+      {
+         switch ( k )
+         {
+         case 0:
+            SCIP_ERR( SCIPchgVarBranchPriority(scip, vars[j], (int) vals[j]), "Error setting branching priority.");
+            break;
+         case 1:
+            SCIP_ERR( SCIPchgVarBranchDirection(scip, vars[j], vals[j] < 0.0 ? SCIP_BRANCHDIR_DOWNWARDS
+                  : ( vals[j] > 0.0 ? SCIP_BRANCHDIR_UPWARDS : SCIP_BRANCHDIR_AUTO )), "Error setting branching direction.");
+            break;
+         default:
+            SCIP_ERR( SCIPchgVarBranchFactor(scip, vars[j], vals[j]), "Error setting branching factor.");
+            break;
+         }
+      }
+      if ( avals )
+         mxFree(vals);
+   }
+}
+
+/** read a problem file (MPS, LP, CIP, ..., possibly compressed) directly into SCIP and solve it
+ *
+ *  [x,fval,exitflag,stats] = scip('readsolve', filename, opts)
+ *
+ *  The solution is returned in the order of the variables in the file.
+ */
+static
+void readSolve(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   const char* fnames[5] = {"LPiter", "BBnodes", "BBgap", "PrimalBound", "DualBound"};
+   const mxArray* opts = NULL;
+   SCIP* scip;
+   SCIP_VAR** vars;
+   SCIP_Bool deadline;
+   char* filename;
+   int presolveonly = 0;
+   int presolvematrices = 0;
+   int nvars;
+
+   if ( nrhs < 2 || ! mxIsChar(prhs[1]) || mxIsEmpty(prhs[1]) )
+      mexErrMsgTxt("Usage: scip('readsolve', filename, opts).");
+
+   if ( nrhs > 2 && ! mxIsEmpty(prhs[2]) )
+   {
+      if ( ! mxIsStruct(prhs[2]) )
+         mexErrMsgTxt("The options argument must be a structure!");
+      opts = prhs[2];
+      CheckOptiVersion(opts);
+   }
+
+   /* create SCIP object */
+   SCIP_ERR( SCIPcreate(&scip), "Error creating SCIP object.");
+   SCIP_ERR( SCIPincludeDefaultPlugins(scip), "Error including SCIP default plugins.");
+
+   /* add Ctrl-C event handler */
+   SCIP_ERR( SCIPincludeCtrlCEventHdlr(scip), "Error adding Ctrl-C Event Handler.");
+
+   (void) setCommonOpts(scip, opts);
+
+   /* let the SCIP readers parse the file */
+   filename = mxArrayToString(prhs[1]);
+   SCIP_RETCODE rc = SCIPreadProb(scip, filename, NULL);
+   if ( rc != SCIP_OKAY )
+   {
+      SCIPfree(&scip);
+      snprintf(msgbuf, BUFSIZE, "Error reading problem file \"%s\", Error: %s (Code: %d)", filename, scipErrCode(rc), rc);
+      mxFree(filename);
+      mexErrMsgTxt(msgbuf);
+   }
+   mxFree(filename);
+
+   /* branching hints refer to the variables in the order of the file */
+   setBranchingHints(scip, opts, SCIPgetOrigVars(scip), (size_t) SCIPgetNOrigVars(scip));
+
+   /* process advanced user options (if they exist) */
+   applySolverOpts(scip, opts);
+
+   /* possibly only presolve, e.g., to benchmark presolving separately */
+   if ( opts != NULL )
+   {
+      getIntOption(opts, "presolveonly", presolveonly);
+      getIntOption(opts, "presolvematrices", presolvematrices);
+   }
+   deadline = presolveonly ? FALSE : setSolveLimits(scip, opts);
+   rc = presolveonly ? SCIPpresolve(scip) : SCIPsolve(scip);
+   if ( rc != SCIP_OKAY )
+   {
+      SCIPfree(&scip);
+      sprintf(msgbuf, "Error Solving SCIP Problem, Error: %s (Code: %d)", scipErrCode(rc), rc);
+      mexErrMsgTxt(msgbuf);
+   }
+
+   /* create outputs */
+   nvars = SCIPgetNOrigVars(scip);
+   vars = SCIPgetOrigVars(scip);
+
+   plhs[0] = mxCreateDoubleMatrix(nvars, 1, mxREAL);
+   plhs[1] = mxCreateDoubleScalar(std::numeric_limits<double>::quiet_NaN());
+   plhs[2] = mxCreateDoubleScalar((double)SCIPgetStatus(scip));
+   plhs[3] = mxCreateStructMatrix(1, 1, 5, fnames);
+   mxSetField(plhs[3], 0, fnames[0], mxCreateDoubleScalar((double)SCIPgetNLPIterations(scip)));
+   mxSetField(plhs[3], 0, fnames[1], mxCreateDoubleScalar((double)SCIPgetNTotalNodes(scip)));
+   mxSetField(plhs[3], 0, fnames[2], mxCreateDoubleScalar(std::numeric_limits<double>::infinity()));
+   mxSetField(plhs[3], 0, fnames[3], mxCreateDoubleScalar(std::numeric_limits<double>::quiet_NaN()));
+   mxSetField(plhs[3], 0, fnames[4], mxCreateDoubleScalar(SCIPgetDualbound(scip)));
+   if ( presolveonly )
+      setPresolveStats(scip, plhs[3], presolvematrices != 0);
+   else
+   {
+      mxAddField(plhs[3], "StopReason");
+      mxSetField(plhs[3], 0, "StopReason", mxCreateString(getStopReason(scip, opts, deadline)));
+   }
+
+   /* assign return arguments */
+   if ( SCIPgetNSols(scip) > 0 )
+   {
+      SCIP_SOL* scipbestsol = SCIPgetBestSol(scip);
+
+      SCIP_ERR( SCIPgetSolVals(scip, scipbestsol, nvars, vars, mxGetPr(plhs[0])), "Error getting solution values.");
+      *mxGetPr(plhs[1]) = SCIPgetSolOrigObj(scip, scipbestsol);
+      *mxGetPr(mxGetField(plhs[3], 0, fnames[2])) = SCIPgetGap(scip);
+      *mxGetPr(mxGetField(plhs[3], 0, fnames[3])) = SCIPgetPrimalbound(scip);
+   }
+
+   /* clean up general SCIP memory */
+   SCIP_ERR( SCIPfree(&scip), "Error releasing SCIP problem.");
+}
+
+/** returns a field of a problem structure, or NULL if it does not exist or is empty */
+static
+const mxArray* getProbField(
+   const mxArray*        prob,               /**< problem structure */
+   const char*           name                /**< field name */
+   )
+{
+   const mxArray* field = mxGetField(prob, 0, name);
+
+   return ( field == NULL || mxIsEmpty(field) ) ? NULL : field;
+}
+
+/** checks a linear problem structure with fields f, A, rl, ru, lb, ub, xtype (and link for subproblems) */
+static
+void checkLinearProb(
+   const mxArray*        prob,               /**< problem structure */
+   const char*           what,               /**< name of problem for error messages */
+   size_t                nmaster             /**< number of master variables for checking link, 0 for the master */
+   )
+{
+   const mxArray* field;
+   size_t ndec;
+   size_t ncon = 0;
+
+   if ( ! mxIsStruct(prob) || mxGetNumberOfElements(prob) != 1 )
+   {
+      snprintf(msgbuf, BUFSIZE, "The %s must be a structure with fields f, A, rl, ru, lb, ub and xtype.", what);
+      mexErrMsgTxt(msgbuf);
+   }
+
+   if ( getProbField(prob, "f") == NULL )
+   {
+      snprintf(msgbuf, BUFSIZE, "The %s must have a linear objective f (all zeros if not required).", what);
+      mexErrMsgTxt(msgbuf);
+   }
+   checkRealData(getProbField(prob, "f"), "f");
+   ndec = mxGetNumberOfElements(getProbField(prob, "f"));
+   CheckIntSize(ndec, "variables");
+
+   if ( (field = getProbField(prob, "A")) != NULL )
+   {
+      checkRealMatrix(field, "A");
+      ncon = mxGetM(field);
+      CheckIntSize(ncon, "linear constraints");
+      if ( mxGetN(field) != ndec )
+      {
+         snprintf(msgbuf, BUFSIZE, "A of the %s has %zu columns, but f has %zu entries.", what, mxGetN(field), ndec);
+         mexErrMsgTxt(msgbuf);
+      }
+   }
+
+   const char* vecs[4] = {"rl", "ru", "lb", "ub"};
+   for (int k = 0; k < 4; ++k)
+   {
+      field = getProbField(prob, vecs[k]);
+      checkRealData(field, vecs[k]);
+      if ( field != NULL && mxGetNumberOfElements(field) != ( k < 2 ? ncon : ndec ) )
+      {
+         snprintf(msgbuf, BUFSIZE, "%s of the %s has %zu entries, expected %zu.", vecs[k], what, mxGetNumberOfElements(field), k < 2 ? ncon : ndec);
+         mexErrMsgTxt(msgbuf);
+      }
+   }
+
+   field = getProbField(prob, "xtype");
+   if ( field != NULL && ( ! mxIsChar(field) || mxGetNumberOfElements(field) != ndec ) )
+   {
+      snprintf(msgbuf, BUFSIZE, "xtype of the %s must be a char array with one entry per variable.", what);
+      mexErrMsgTxt(msgbuf);
+   }
+   if ( field != NULL )
+   {
+      const mxChar* chars = mxGetChars(field);
+
+      for (size_t j = 0; j < ndec; ++j)
+      {
+         if ( chars[j] == 0 || chars[j] > 127 || strchr("cibCIB", (int) chars[j]) == NULL )
+         {
+            snprintf(msgbuf, BUFSIZE, "Unknown variable type '%c' in xtype of the %s.", chars[j] < 128 ? (char) chars[j] : '?', what);
+            mexErrMsgTxt(msgbuf);
+         }
+      }
+   }
+
+   /* the master variable (1-based, 0 for none) that each subproblem variable is a copy of */
+   if ( nmaster > 0 )
+   {
+      const double* link;
+      int alink;
+
+      field = getProbField(prob, "link");
+      if ( field == NULL || ! isRealData(field) || mxIsSparse(field) || mxGetNumberOfElements(field) != ndec )
+      {
+         snprintf(msgbuf, BUFSIZE, "The %s must have a dense vector link with one entry per variable (master variable index or 0).", what);
+         mexErrMsgTxt(msgbuf);
+      }
+
+      link = getDoubleData(field, &alink);
+      for (size_t j = 0; j < ndec; ++j)
+      {
+         if ( link[j] < 0.0 || link[j] > (double) nmaster || link[j] != floor(link[j]) )
+         {
+            snprintf(msgbuf, BUFSIZE, "Invalid link %g of the %s (must be 0 or a master variable index between 1 and %zu).", link[j], what, nmaster);
+            mexErrMsgTxt(msgbuf);
+         }
+      }
+      if ( alink )
+         mxFree((void*) link);
+   }
+}
+
+/** builds a linear problem given as structure (checked by checkLinearProb()) in a SCIP instance
+ *
+ *  Variables are named prefix + "x<j>". In subproblems, copies of master variables (nonzero link) get the name of the
+ *  master variable instead, which is how SCIP's default Benders' decomposition identifies the linking variables; they
+ *  are continuous and have no objective, since their cost is accounted for in the master.
+ */
+static
+void buildLinearProb(
+   SCIP*                 scip,               /**< SCIP instance (with problem created) */
+   const mxArray*        prob,               /**< problem structure */
+   const char*           prefix,             /**< prefix of variable and constraint names */
+   SCIP_VAR**            mastervars,         /**< variables of the master (NULL when building the master) */
+   SCIP_VAR**            vars                /**< array to store the variables (one per entry of f, captured) */
+   )
+{
+   const mxArray* field;
+   const double* f;
+   const double* rl = NULL;
+   const double* ru = NULL;
+   const double* lb = NULL;
+   const double* ub = NULL;
+   double* link = NULL;
+   char* xtype = NULL;
+   int af;
+   int arl = 0;
+   int aru = 0;
+   int alb = 0;
+   int aub = 0;
+   int alink = 0;
+   size_t ndec;
+   size_t ncon;
+
+   f = getDoubleData(getProbField(prob, "f"), &af);
+   ndec = mxGetNumberOfElements(getProbField(prob, "f"));
+   ncon = getProbField(prob, "A") != NULL ? mxGetM(getProbField(prob, "A")) : 0;
+   if ( (field = getProbField(prob, "rl")) != NULL )
+      rl = getDoubleData(field, &arl);
+   if ( (field = getProbField(prob, "ru")) != NULL )
+      ru = getDoubleData(field, &aru);
+   if ( (field = getProbField(prob, "lb")) != NULL )
+      lb = getDoubleData(field, &alb);
+   if ( (field = getProbField(prob, "ub")) != NULL )
+      ub = getDoubleData(field, &aub);
+   if ( (field = getProbField(prob, "xtype")) != NULL )
+      xtype = mxArrayToString(field);
+   if ( mastervars != NULL )
+      link = getDoubleData(getProbField(prob, "link"), &alink);
+
+   /* variables */
+   for (size_t j = 0; j < ndec; ++j)
+   {
+      SCIP_VARTYPE vartype = SCIP_VARTYPE_CONTINUOUS;
+      double vlb = lb != NULL ? lb[j] : -SCIPinfinity(scip);
+      double vub = ub != NULL ? ub[j] : SCIPinfinity(scip);
+      double obj = f[j];
+
+      switch( xtype != NULL ? tolower(xtype[j]) : 'c' )
+      {
+      case 'i':
+         vartype = SCIP_VARTYPE_INTEGER;
+         break;
+      case 'b':
+         vartype = SCIP_VARTYPE_BINARY;
+         vlb = SCIPisInfinity(scip, -vlb) ? 0.0 : vlb;
+         vub = SCIPisInfinity(scip, vub) ? 1.0 : vub;
+         break;
+      case 'c':
+         break;
+      default:
+         snprintf(msgbuf, BUFSIZE, "Unknown variable type '%c' in xtype.", xtype[j]);
+         mexErrMsgTxt(msgbuf);
+      }
+
+      if ( link != NULL && link[j] > 0.0 )
+      {
+         (void) SCIPsnprintf(msgbuf, BUFSIZE, "%s", SCIPvarGetName(mastervars[(size_t) link[j] - 1]));
+         vartype = SCIP_VARTYPE_CONTINUOUS;
+         obj = 0.0;
+      }
+      else
+         (void) SCIPsnprintf(msgbuf, BUFSIZE, "%sx%zu", prefix, j);
+
+      SCIP_ERR( SCIPcreateVarBasic(scip, &vars[j], msgbuf, mxIsInf(vlb) ? -SCIPinfinity(scip) : vlb,
+            mxIsInf(vub) ? SCIPinfinity(scip) : vub, obj, vartype), "Error creating variable.");
+      SCIP_ERR( SCIPaddVar(scip, vars[j]), "Error adding variable.");
+   }
+
+   /* linear constraints, built row-wise from the columns of A */
+   if ( ncon > 0 )
+   {
+      SCIP_CONS** cons;
+      MatrixColumns matcols;
+      const mwIndex* rows;
+      const double* vals;
+
+      SCIP_ERR( SCIPallocMemoryArray(scip, &cons, ncon), "Error allocating constraint memory.");
+      for (size_t i = 0; i < ncon; ++i)
+      {
+         (void) SCIPsnprintf(msgbuf, BUFSIZE, "%slincon%zu", prefix, i);
+         SCIP_ERR( SCIPcreateConsBasicLinear(scip, &cons[i], msgbuf, 0, NULL, NULL,
+               ( rl == NULL || mxIsInf(rl[i]) ) ? -SCIPinfinity(scip) : rl[i],
+               ( ru == NULL || mxIsInf(ru[i]) ) ? SCIPinfinity(scip) : ru[i]), "Error creating linear constraint.");
+      }
+
+      initMatrixColumns(&matcols, getProbField(prob, "A"));
+      for (size_t j = 0; j < ndec; ++j)
+      {
+         size_t nnz = getMatrixColumn(&matcols, j, &rows, &vals);
+
+         for (size_t k = 0; k < nnz; ++k)
+            SCIP_ERR( SCIPaddCoefLinear(scip, cons[rows[k]], vars[j], vals[k]), "Error adding constraint linear coefficient.");
+      }
+      freeMatrixColumns(&matcols);
+
+      for (size_t i = 0; i < ncon; ++i)
+      {
+         SCIP_ERR( SCIPaddCons(scip, cons[i]), "Error adding linear constraint.");
+         SCIP_ERR( SCIPreleaseCons(scip, &cons[i]), "Error releasing linear constraint.");
+      }
+      SCIPfreeMemoryArray(scip, &cons);
+   }
+
+   if ( af )
+      mxFree((void*) f);
+   if ( arl )
+      mxFree((void*) rl);
+   if ( aru )
+      mxFree((void*) ru);
+   if ( alb )
+      mxFree((void*) lb);
+   if ( aub )
+      mxFree((void*) ub);
+   if ( alink )
+      mxFree(link);
+   if ( xtype != NULL )
+      mxFree(xtype);
+}
+
+/** solve a two-stage problem with SCIP's default Benders' decomposition
+ *
+ *  [x,fval,exitflag,stats] = scip('benders', master, subprobs, opts)
+ *
+ *  master is a structure with fields f, A, rl, ru, lb, ub and xtype; subprobs is a cell array of such structures with an
+ *  additional field link that maps their variables to master variables. Each subproblem is built in its own SCIP
+ *  instance and registered with SCIPcreateBendersDefault(). x contains the values of the master variables.
+ */
+static
+void bendersSolve(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   const char* fnames[5] = {"LPiter", "BBnodes", "BBgap", "PrimalBound", "DualBound"};
+   const mxArray* opts = NULL;
+   SCIP* scip;
+   SCIP** subscips;
+   SCIP_VAR** mastervars;
+   SCIP_VAR** subvars;
+   SCIP_BENDERS* benders;
+   size_t nmaster;
+   size_t nsubs;
+   int nthreads = 1;
+
+   if ( nrhs < 3 || ! mxIsStruct(prhs[1]) || ! mxIsCell(prhs[2]) || mxIsEmpty(prhs[2]) )
+      mexErrMsgTxt("Usage: scip('benders', master, subprobs, opts) with a master structure and a cell array of subproblem structures.");
+
+   if ( nrhs > 3 && ! mxIsEmpty(prhs[3]) )
+   {
+      if ( ! mxIsStruct(prhs[3]) )
+         mexErrMsgTxt("The options argument must be a structure!");
+      opts = prhs[3];
+      CheckOptiVersion(opts);
+      getIntOption(opts, "bendersthreads", nthreads);
+   }
+
+   /* check all inputs before creating anything */
+   checkLinearProb(prhs[1], "master problem", 0);
+   nmaster = mxGetNumberOfElements(getProbField(prhs[1], "f"));
+   nsubs = mxGetNumberOfElements(prhs[2]);
+   CheckIntSize(nsubs, "subproblems");
+   for (size_t s = 0; s < nsubs; ++s)
+   {
+      snprintf(msgbuf, BUFSIZE, "subproblem %zu", s + 1);
+      checkLinearProb(mxGetCell(prhs[2], s), msgbuf, nmaster);
+   }
+   checkBranchingHints(opts, nmaster);
+
+   /* create SCIP object for the master */
+   SCIP_ERR( SCIPcreate(&scip), "Error creating SCIP object.");
+   SCIP_ERR( SCIPincludeDefaultPlugins(scip), "Error including SCIP default plugins.");
+   SCIP_ERR( SCIPincludeCtrlCEventHdlr(scip), "Error adding Ctrl-C Event Handler.");
+   (void) setCommonOpts(scip, opts);
+
+   SCIP_ERR( SCIPcreateProbBasic(scip, "scipmex_benders_master"), "Error creating master problem.");
+   SCIP_ERR( SCIPallocMemoryArray(scip, &mastervars, nmaster), "Error allocating variable memory.");
+   buildLinearProb(scip, prhs[1], "", NULL, mastervars);
+   setBranchingHints(scip, opts, mastervars, nmaster);
+
+   /* one SCIP instance per subproblem, freed after the master */
+   subscips = (SCIP**) mxCalloc(nsubs, sizeof(SCIP*));
+   for (size_t s = 0; s < nsubs; ++s)
+   {
+      const mxArray* sub = mxGetCell(prhs[2], s);
+      size_t nsubvars = mxGetNumberOfElements(getProbField(sub, "f"));
+      char prefix[BUFSIZE];
+
+      SCIP_ERR( SCIPcreate(&subscips[s]), "Error creating SCIP object for subproblem.");
+      SCIP_ERR( SCIPincludeDefaultPlugins(subscips[s]), "Error including SCIP default plugins.");
+      SCIP_ERR( SCIPsetIntParam(subscips[s], "display/verblevel", 0), "Error setting verblevel.");
+
+      snprintf(prefix, BUFSIZE, "s%zu_", s + 1);
+      (void) SCIPsnprintf(msgbuf, BUFSIZE, "scipmex_benders_sub%zu", s + 1);
+      SCIP_ERR( SCIPcreateProbBasic(subscips[s], msgbuf), "Error creating subproblem.");
+      SCIP_ERR( SCIPallocMemoryArray(subscips[s], &subvars, nsubvars), "Error allocating variable memory.");
+      buildLinearProb(subscips[s], sub, prefix, mastervars, subvars);
+
+      for (size_t j = 0; j < nsubvars; ++j)
+         SCIP_ERR( SCIPreleaseVar(subscips[s], &subvars[j]), "Error releasing variable.");
+      SCIPfreeMemoryArray(subscips[s], &subvars);
+   }
+
+   SCIP_ERR( SCIPcreateBendersDefault(scip, subscips, (int) nsubs), "Error creating Benders' decomposition.");
+
+   /* subproblems are solved in parallel if SCIP was built with a parallel task interface */
+   if ( nthreads > 1 )
+   {
+      if ( SCIPgetParam(scip, "benders/default/numthreads") != NULL )
+      {
+         SCIP_ERR( SCIPsetIntParam(scip, "benders/default/numthreads", nthreads), "Error setting Benders threads.");
+      }
+      else
+         mexWarnMsgTxt("This SCIP version cannot solve Benders' subproblems in parallel, opts.bendersthreads is ignored.");
+   }
+
+   /* process advanced user options (if they exist) */
+   applySolverOpts(scip, opts);
+
+   SCIP_Bool deadline = setSolveLimits(scip, opts);
+   SCIP_RETCODE rc = SCIPsolve(scip);
+   if ( rc != SCIP_OKAY )
+   {
+      SCIPfree(&scip);
+      for (size_t s = 0; s < nsubs; ++s)
+         SCIPfree(&subscips[s]);
+      sprintf(msgbuf, "Error Solving SCIP Problem, Error: %s (Code: %d)", scipErrCode(rc), rc);
+      mexErrMsgTxt(msgbuf);
+   }
+
+   /* create outputs */
+   plhs[0] = mxCreateDoubleMatrix(nmaster, 1, mxREAL);
+   plhs[1] = mxCreateDoubleScalar(std::numeric_limits<double>::quiet_NaN());
+   plhs[2] = mxCreateDoubleScalar((double)SCIPgetStatus(scip));
+   plhs[3] = mxCreateStructMatrix(1, 1, 5, fnames);
+   mxSetField(plhs[3], 0, fnames[0], mxCreateDoubleScalar((double)SCIPgetNLPIterations(scip)));
+   mxSetField(plhs[3], 0, fnames[1], mxCreateDoubleScalar((double)SCIPgetNTotalNodes(scip)));
+   mxSetField(plhs[3], 0, fnames[2], mxCreateDoubleScalar(std::numeric_limits<double>::infinity()));
+   mxSetField(plhs[3], 0, fnames[3], mxCreateDoubleScalar(std::numeric_limits<double>::quiet_NaN()));
+   mxSetField(plhs[3], 0, fnames[4], mxCreateDoubleScalar(SCIPgetDualbound(scip)));
+   mxAddField(plhs[3], "StopReason");
+   mxSetField(plhs[3], 0, "StopReason", mxCreateString(getStopReason(scip, opts, deadline)));
+
+   if ( SCIPgetNSols(scip) > 0 )
+   {
+      SCIP_SOL* scipbestsol = SCIPgetBestSol(scip);
+
+      SCIP_ERR( SCIPgetSolVals(scip, scipbestsol, (int) nmaster, mastervars, mxGetPr(plhs[0])), "Error getting solution values.");
+      *mxGetPr(plhs[1]) = SCIPgetSolOrigObj(scip, scipbestsol);
+      *mxGetPr(mxGetField(plhs[3], 0, fnames[2])) = SCIPgetGap(scip);
+      *mxGetPr(mxGetField(plhs[3], 0, fnames[3])) = SCIPgetPrimalbound(scip);
+   }
+
+   /* Benders' statistics */
+   benders = SCIPfindBenders(scip, "default");
+   mxAddField(plhs[3], "BendersSubproblems");
+   mxSetField(plhs[3], 0, "BendersSubproblems", mxCreateDoubleScalar((double) nsubs));
+   mxAddField(plhs[3], "BendersCalls");
+   mxSetField(plhs[3], 0, "BendersCalls", mxCreateDoubleScalar(benders != NULL ? (double) SCIPbendersGetNCalls(benders) : 0.0));
+   mxAddField(plhs[3], "BendersCuts");
+   mxSetField(plhs[3], 0, "BendersCuts", mxCreateDoubleScalar(benders != NULL ? (double) SCIPbendersGetNCutsFound(benders) : 0.0));
+
+   /* clean up: the master refers to the subproblems until it is freed */
+   for (size_t j = 0; j < nmaster; ++j)
+      SCIP_ERR( SCIPreleaseVar(scip, &mastervars[j]), "Error releasing variable.");
+   SCIPfreeMemoryArray(scip, &mastervars);
+   SCIP_ERR( SCIPfree(&scip), "Error releasing SCIP problem.");
+   for (size_t s = 0; s < nsubs; ++s)
+      SCIP_ERR( SCIPfree(&subscips[s]), "Error releasing Benders' subproblem.");
+   mxFree(subscips);
+}
+
+/** one run of the tuning harness: a configuration on a problem with a random seed shift */
+struct TuneRun
+{
+   size_t                config;             /**< index of configuration */
+   size_t                prob;               /**< index of problem */
+   int                   seed;               /**< random seed shift */
+   SCIP*                 scip;               /**< copy of the problem, solved by a worker thread */
+   SCIP_RETCODE          retcode;            /**< return code of setting up and solving the copy */
+   bool                  done;               /**< whether the run was solved (or failed) */
+   std::thread           worker;             /**< worker thread */
+   double                stats[7];           /**< Status, Time, Nodes, Gap, PrimalBound, DualBound and Integral */
+};
+
+/** runs finished by the worker threads, waiting to be collected by the main thread */
+struct TuneQueue
+{
+   std::mutex            mutex;              /**< protects finished */
+   std::condition_variable cv;               /**< signaled when a run is finished */
+   std::deque<size_t>    finished;           /**< indices of finished runs */
+};
+
+/** solve a tuning run in a worker thread
+ *
+ *  Only SCIP is called here: the MATLAB API must not be used outside of the main thread.
+ */
+static
+void solveTuneRun(
+   TuneRun*              run,                /**< run to solve */
+   TuneQueue*            queue,              /**< queue to report the finished run to */
+   size_t                idx                 /**< index of run */
+   )
+{
+   run->retcode = SCIPsolve(run->scip);
+   {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      queue->finished.push_back(idx);
+   }
+   queue->cv.notify_one();
+}
+
+/** set up a tuning run: copy the problem with its base settings and set the parameters of the configuration
+ *
+ *  Does not use the MATLAB API, since worker threads may be running; the parameters have been checked before.
+ */
+static
+SCIP_RETCODE setupTuneRun(
+   SCIP*                 source,             /**< SCIP instance with the problem and the base settings */
+   const std::vector<UserParam>& params,     /**< parameters of the configuration */
+   int                   seed,               /**< random seed shift */
+   double                maxtime,            /**< time limit of the run [s] */
+   SCIP**                scip                /**< pointer to store the copy (to be freed by the caller) */
+   )
+{
+   SCIP_Bool valid;
+
+   SCIP_CALL( SCIPcreate(scip) );
+   SCIP_CALL( SCIPcopyOrig(source, *scip, NULL, NULL, "", FALSE, TRUE, FALSE, &valid) );
+   if ( ! valid )
+      return SCIP_INVALIDDATA;
+   SCIPsetMessagehdlrQuiet(*scip, TRUE);
+
+   /* Ctrl-C is checked by the main thread, which interrupts the running copies */
+   SCIP_CALL( SCIPsetBoolParam(*scip, "misc/catchctrlc", FALSE) );
+
+   for (size_t i = 0; i < params.size(); ++i)
+      SCIP_CALL( setUserParam(*scip, params[i]) );
+   SCIP_CALL( SCIPsetIntParam(*scip, "randomization/randomseedshift", seed) );
+   SCIP_CALL( SCIPsetRealParam(*scip, "limits/time", maxtime) );
+
+   return SCIP_OKAY;
+}
+
+/** store the statistics of a finished tuning run and free its SCIP instance */
+static
+void collectTuneRun(
+   TuneRun*              run                 /**< finished run */
+   )
+{
+   run->done = true;
+   if ( run->retcode == SCIP_OKAY )
+   {
+      run->stats[0] = (double) SCIPgetStatus(run->scip);
+      run->stats[1] = SCIPgetSolvingTime(run->scip);
+      run->stats[2] = (double) SCIPgetNTotalNodes(run->scip);
+      run->stats[3] = SCIPgetGap(run->scip);
+      run->stats[4] = SCIPgetPrimalbound(run->scip);
+      run->stats[5] = SCIPgetDualbound(run->scip);
+      run->stats[6] = SCIPgetPrimalDualIntegral(run->scip);
+   }
+   if ( run->scip != NULL )
+      (void) SCIPfree(&run->scip);
+}
+
+/** creates the solverOpts cell array of a configuration in the grid spanned by a search space {'name1', values1; ...}
+ *
+ *  The configurations are numbered with the values of the first parameter changing fastest.
+ */
+static
+mxArray* createTuneConfig(
+   const mxArray*        space,              /**< search space (checked) */
+   size_t                config              /**< index of configuration */
+   )
+{
+   size_t nparams = mxIsEmpty(space) ? 0 : mxGetM(space);
+   mxArray* cfg = mxCreateCellMatrix(nparams, 2);
+
+   for (size_t i = 0; i < nparams; ++i)
+   {
+      const mxArray* values = mxGetCell(space, i + nparams);
+      size_t nvalues = mxGetNumberOfElements(values);
+      size_t k = config % nvalues;
+      mxArray* value;
+
+      config /= nvalues;
+      if ( mxIsCell(values) )
+         value = mxDuplicateArray(mxGetCell(values, k));
+      else if ( mxIsLogical(values) )
+         value = mxCreateLogicalScalar(mxGetLogicals(values)[k]);
+      else if ( mxIsChar(values) )
+      {
+         char str[2] = {(char) mxGetChars(values)[k], '\0'};
+         value = mxCreateString(str);
+      }
+      else
+         value = mxCreateDoubleScalar(mxGetPr(values)[k]);
+
+      mxSetCell(cfg, i, mxDuplicateArray(mxGetCell(space, i)));
+      mxSetCell(cfg, i + nparams, value);
+   }
+   return cfg;
+}
+
+/** returns the number of configurations in the grid spanned by a search space {'name1', values1; ...} */
+static
+size_t checkTuneSpace(
+   const mxArray*        space               /**< search space */
+   )
+{
+   size_t nconfigs = 1;
+
+   if ( mxIsEmpty(space) )
+      return 1;
+
+   if ( ! mxIsCell(space) || mxGetN(space) != 2 )
+      mexErrMsgTxt("The search space should be a cell array of the form {'name1', values1; 'name2', values2}.");
+
+   for (size_t i = 0; i < mxGetM(space); ++i)
+   {
+      const mxArray* values = mxGetCell(space, i + mxGetM(space));
+
+      if ( values == NULL || mxIsEmpty(values) || ! ( mxIsCell(values) || mxIsLogical(values) || mxIsChar(values) || mxIsDouble(values) ) )
+      {
+         snprintf(msgbuf, BUFSIZE, "The values in row %zu of the search space must be a non-empty double, logical, char or cell array.", i + 1);
+         mexErrMsgTxt(msgbuf);
+      }
+
+      nconfigs *= mxGetNumberOfElements(values);
+      if ( nconfigs > 1000000 )
+         mexErrMsgTxt("The search space has more than 1e6 configurations.");
+   }
+   return nconfigs;
+}
+
+/** shifted geometric mean exp(mean(log(v + shift))) - shift */
+static
+double shiftedGeomMean(
+   const std::vector<double>& vals,          /**< values */
+   double                shift               /**< shift */
+   )
+{
+   double sum = 0.0;
+
+   if ( vals.empty() )
+      return std::numeric_limits<double>::quiet_NaN();
+
+   for (size_t i = 0; i < vals.size(); ++i)
+      sum += log(std::max(vals[i] + shift, 1e-9));
+
+   return exp(sum / (double) vals.size()) - shift;
+}
+
+/** tune SCIP parameters over a set of problems
+ *
+ *  [best, results] = scip('tune', problems, space, opts)
+ *
+ *  problems is a cell array of problem file names and problem structures (fields f, A, rl, ru, lb, ub and xtype),
+ *  space a cell array {'name1', values1; ...} whose grid of configurations is evaluated. Every configuration is solved
+ *  on every problem with opts.seeds random seed shifts, in opts.threads worker threads. Each problem is read or built
+ *  once with the base settings of opts (paramfile, profile, solverOpts) and copied for each run, so that the worker
+ *  threads only call SCIP. Configurations are scored by the shifted geometric mean of the solving time or the
+ *  primal-dual integral; best is the solverOpts of the configuration with the smallest score.
+ */
+static
+void tuneSolve(
+   int                   nlhs,               /* number of expected outputs */
+   mxArray*              plhs[],             /* array of pointers to output arguments */
+   int                   nrhs,               /* number of inputs */
+   const mxArray*        prhs[]              /* array of pointers to input arguments */
+   )
+{
+   const char* fnames[4] = {"Configs", "Score", "Solved", "Runs"};
+   const char* rnames[10] = {"Config", "Problem", "Seed", "Status", "Time", "Nodes", "Gap", "PrimalBound", "DualBound", "Integral"};
+   const mxArray* opts = NULL;
+   const mxArray* space;
+   std::vector< std::vector<UserParam> > configparams;
+   std::vector<SCIP*> templates;
+   TuneQueue queue;
+   mxArray* configs;
+   mxArray* runstats;
+   char score[BUFSIZE] = "time";
+   double maxtime = 60.0;
+   double shift = 10.0;
+   int nseeds = 1;
+   int nthreads = (int) std::thread::hardware_concurrency();
+   int display = 0;
+   bool interrupted = false;
+   size_t nprobs;
+   size_t nconfigs;
+   size_t nruns;
+   size_t next = 0;
+   size_t nrunning = 0;
+   SCIP* scip;
+
+   if ( nrhs < 3 || ! mxIsCell(prhs[1]) || mxIsEmpty(prhs[1]) )
+      mexErrMsgTxt("Usage: scip('tune', problems, space, opts) with a cell array of problem files or structures.");
+
+   if ( nrhs > 3 && ! mxIsEmpty(prhs[3]) )
+   {
+      if ( ! mxIsStruct(prhs[3]) )
+         mexErrMsgTxt("The options argument must be a structure!");
+      opts = prhs[3];
+      CheckOptiVersion(opts);
+      getDblOption(opts, "maxtime", maxtime);
+      getDblOption(opts, "shift", shift);
+      getIntOption(opts, "seeds", nseeds);
+      getIntOption(opts, "threads", nthreads);
+      getIntOption(opts, "display", display);
+      (void) getStrOption(opts, "score", score);
+   }
+   if ( strcmp(score, "time") != 0 && strcmp(score, "integral") != 0 )
+      mexErrMsgTxt("The tuning score (opts.score) must be 'time' or 'integral'.");
+   if ( ! ( maxtime > 0.0 ) || nseeds < 1 )
+      mexErrMsgTxt("The time limit (opts.maxtime) and the number of seeds (opts.seeds) of the tuning must be positive.");
+   nthreads = std::max(nthreads, 1);
+
+   /* check all inputs before creating anything */
+   space = prhs[2];
+   nconfigs = checkTuneSpace(space);
+   nprobs = mxGetNumberOfElements(prhs[1]);
+   for (size_t p = 0; p < nprobs; ++p)
+   {
+      const mxArray* prob = mxGetCell(prhs[1], p);
+
+      if ( prob == NULL || ! ( mxIsStruct(prob) || ( mxIsChar(prob) && ! mxIsEmpty(prob) ) ) )
+      {
+         snprintf(msgbuf, BUFSIZE, "Problem %zu of the tuning must be a file name or a problem structure.", p + 1);
+         mexErrMsgTxt(msgbuf);
+      }
+      if ( mxIsStruct(prob) )
+      {
+         snprintf(msgbuf, BUFSIZE, "tuning problem %zu", p + 1);
+         checkLinearProb(prob, msgbuf, 0);
+      }
+   }
+
+   /* the checks below raise MATLAB errors while SCIP instances exist, which are freed before the error is passed on */
+   configs = mxCreateCellMatrix(nconfigs, 1);
+   configparams.resize(nconfigs);
+   templates.resize(nprobs, NULL);
+   scip = NULL;
+   try
+   {
+      /* resolve the configurations and check their values once */
+      SCIP_ERR( SCIPcreate(&scip), "Error creating SCIP object.");
+      SCIP_ERR( SCIPincludeDefaultPlugins(scip), "Error including SCIP default plugins.");
+      for (size_t c = 0; c < nconfigs; ++c)
+      {
+         mxSetCell(configs, c, createTuneConfig(space, c));
+         resolveUserOpts(scip, mxGetCell(configs, c), configparams[c]);
+         applyUserParams(scip, configparams[c]);
+      }
+      SCIP_ERR( SCIPfree(&scip), "Error releasing SCIP.");
+
+      /* read or build each problem once with the base settings */
+      for (size_t p = 0; p < nprobs; ++p)
+      {
+         const mxArray* prob = mxGetCell(prhs[1], p);
+
+         SCIP_ERR( SCIPcreate(&templates[p]), "Error creating SCIP object.");
+         SCIP_ERR( SCIPincludeDefaultPlugins(templates[p]), "Error including SCIP default plugins.");
+         SCIP_ERR( SCIPsetIntParam(templates[p], "display/verblevel", 0), "Error setting verblevel.");
+         SCIPsetMessagehdlrQuiet(templates[p], TRUE);
+
+         if ( mxIsChar(prob) )
+         {
+            char* filename = mxArrayToString(prob);
+            SCIP_RETCODE rc = SCIPreadProb(templates[p], filename, NULL);
+
+            if ( rc != SCIP_OKAY )
+            {
+               snprintf(msgbuf, BUFSIZE, "Error reading problem file \"%s\", Error: %s (Code: %d)", filename, scipErrCode(rc), rc);
+               mxFree(filename);
+               mexErrMsgTxt(msgbuf);
+            }
+            mxFree(filename);
+         }
+         else
+         {
+            size_t ndec = mxGetNumberOfElements(getProbField(prob, "f"));
+            SCIP_VAR** vars;
+
+            (void) SCIPsnprintf(msgbuf, BUFSIZE, "scipmex_tune_prob%zu", p + 1);
+            SCIP_ERR( SCIPcreateProbBasic(templates[p], msgbuf), "Error creating problem.");
+            SCIP_ERR( SCIPallocMemoryArray(templates[p], &vars, ndec), "Error allocating variable memory.");
+            buildLinearProb(templates[p], prob, "", NULL, vars);
+            for (size_t j = 0; j < ndec; ++j)
+               SCIP_ERR( SCIPreleaseVar(templates[p], &vars[j]), "Error releasing variable.");
+            SCIPfreeMemoryArray(templates[p], &vars);
+         }
+
+         applySolverOpts(templates[p], opts);
+      }
+   }
+   catch (...)
+   {
+      if ( scip != NULL )
+         (void) SCIPfree(&scip);
+      for (size_t p = 0; p < nprobs; ++p)
+      {
+         if ( templates[p] != NULL )
+            (void) SCIPfree(&templates[p]);
+      }
+      mxDestroyArray(configs);
+      throw;
+   }
+
+   /* all runs; from here on, no MATLAB error may be raised until the worker threads are joined */
+   nruns = nconfigs * nprobs * (size_t) nseeds;
+   std::vector<TuneRun> runs(nruns);
+   for (size_t r = 0; r < nruns; ++r)
+   {
+      runs[r].seed = (int) (r % (size_t) nseeds);
+      runs[r].prob = (r / (size_t) nseeds) % nprobs;
+      runs[r].config = r / ((size_t) nseeds * nprobs);
+      runs[r].scip = NULL;
+      runs[r].retcode = SCIP_OKAY;
+      runs[r].done = false;
+   }
+
+   while ( nrunning > 0 || ( next < nruns && ! interrupted ) )
+   {
+      size_t idx;
+
+      /* start runs while workers are free; the copies are made in the main thread */
+      while ( nrunning < (size_t) nthreads && next < nruns && ! interrupted )
+      {
+         TuneRun& run = runs[next];
+
+         run.retcode = setupTuneRun(templates[run.prob], configparams[run.config], run.seed, maxtime, &run.scip);
+         if ( run.retcode == SCIP_OKAY )
+         {
+            run.worker = std::thread(solveTuneRun, &run, &queue, next);
+            ++nrunning;
+         }
+         else
+            collectTuneRun(&run);
+         ++next;
+      }
+
+      if ( nrunning == 0 )
+         continue;
+
+      /* wait for a finished run, checking for Ctrl-C in between */
+      {
+         std::unique_lock<std::mutex> lock(queue.mutex);
+
+         while ( queue.finished.empty() )
+         {
+            queue.cv.wait_for(lock, std::chrono::milliseconds(100));
+            if ( ! interrupted && SCIPisCtrlCPending() )
+            {
+               interrupted = true;
+               for (size_t r = 0; r < next; ++r)
+               {
+                  if ( runs[r].worker.joinable() )
+                     (void) SCIPinterruptSolve(runs[r].scip);
+               }
+            }
+         }
+         idx = queue.finished.front();
+         queue.finished.pop_front();
+      }
+      runs[idx].worker.join();
+      collectTuneRun(&runs[idx]);
+      --nrunning;
+
+      if ( display > 0 && runs[idx].retcode == SCIP_OKAY )
+      {
+         mexPrintf("tune: config %zu, problem %zu, seed %d: status %g, time %.2f, nodes %g\n", runs[idx].config + 1,
+            runs[idx].prob + 1, runs[idx].seed, runs[idx].stats[0], runs[idx].stats[1], runs[idx].stats[2]);
+      }
+   }
+
+   /* results table, one row per run */
+   runstats = mxCreateStructMatrix(1, 1, 10, rnames);
+   for (int k = 0; k < 10; ++k)
+      mxSetField(runstats, 0, rnames[k], mxCreateDoubleMatrix(nruns, 1, mxREAL));
+
+   std::vector< std::vector<double> > values(nconfigs);
+   std::vector<bool> failed(nconfigs, false);
+   std::vector<double> nsolved(nconfigs, 0.0);
+   double* cols[10];
+   for (int k = 0; k < 10; ++k)
+      cols[k] = mxGetPr(mxGetField(runstats, 0, rnames[k]));
+
+   for (size_t r = 0; r < nruns; ++r)
+   {
+      TuneRun& run = runs[r];
+
+      cols[0][r] = (double) run.config + 1;
+      cols[1][r] = (double) run.prob + 1;
+      cols[2][r] = (double) run.seed;
+      for (int k = 3; k < 10; ++k)
+         cols[k][r] = std::numeric_limits<double>::quiet_NaN();
+
+      if ( run.done && run.retcode == SCIP_OKAY )
+      {
+         SCIP_STATUS status = (SCIP_STATUS) (int) run.stats[0];
+
+         for (int k = 3; k < 10; ++k)
+            cols[k][r] = run.stats[k - 3];
+
+         values[run.config].push_back(strcmp(score, "time") == 0 ? cols[4][r] : cols[9][r]);
+         if ( status == SCIP_STATUS_OPTIMAL || status == SCIP_STATUS_INFEASIBLE || status == SCIP_STATUS_UNBOUNDED || status == SCIP_STATUS_INFORUNBD )
+            nsolved[run.config] += 1.0;
+      }
+      else
+         failed[run.config] = true;
+   }
+   for (size_t p = 0; p < nprobs; ++p)
+      (void) SCIPfree(&templates[p]);
+
+   /* scores: configurations with failed or skipped runs cannot be compared */
+   mxArray* scores = mxCreateDoubleMatrix(nconfigs, 1, mxREAL);
+   size_t best = 0;
+   size_t nfailed = 0;
+   for (size_t c = 0; c < nconfigs; ++c)
+   {
+      mxGetPr(scores)[c] = failed[c] ? std::numeric_limits<double>::infinity() : shiftedGeomMean(values[c], shift);
+      if ( mxGetPr(scores)[c] < mxGetPr(scores)[best] )
+         best = c;
+      if ( failed[c] )
+         ++nfailed;
+   }
+   if ( interrupted )
+      mexWarnMsgTxt("Tuning interrupted by Ctrl-C, configurations with runs that were not solved have score Inf.");
+   else if ( nfailed > 0 )
+   {
+      snprintf(msgbuf, BUFSIZE, "%zu configurations have runs that failed and have score Inf.", nfailed);
+      mexWarnMsgTxt(msgbuf);
+   }
+
+   plhs[0] = mxDuplicateArray(mxGetCell(configs, best));
+   if ( nlhs > 1 )
+   {
+      plhs[1] = mxCreateStructMatrix(1, 1, 4, fnames);
+      mxSetField(plhs[1], 0, fnames[0], configs);
+      mxSetField(plhs[1], 0, fnames[1], scores);
+      mxSetField(plhs[1], 0, fnames[2], mxCreateDoubleMatrix(nconfigs, 1, mxREAL));
+      std::copy(nsolved.begin(), nsolved.end(), mxGetPr(mxGetField(plhs[1], 0, fnames[2])));
+      mxSetField(plhs[1], 0, fnames[3], runstats);
+   }
+   else
+   {
+      mxDestroyArray(configs);
+      mxDestroyArray(scores);
+      mxDestroyArray(runstats);
+   }
+}
+
+/*
+SCIP_PARAMSETTING getEmphasisSetting(char* optsStr)
+{
+    if ( strcmp(optsStr, "default") == 0 )
+        return SCIP_PARAMSETTING_DEFAULT;
+    else if ( strcmp(optsStr, "aggressive") == 0 )
+        return SCIP_PARAMSETTING_AGGRESSIVE;
+    else if ( strcmp(optsStr, "fast") == 0 )
+        return SCIP_PARAMSETTING_FAST;
+    else if ( strcmp(optsStr, "off") == 0 )
+        return SCIP_PARAMSETTING_OFF;
+    else
+    {
+        sprintf(msgbuf,"Error Setting Emphasis Option - Unknown Emphasis Type \"%s\".", optsStr);
+        mexErrMsgTxt(msgbuf);
+    }
+}
+*/
+
+/* // Process Emphasis Settings
+void processEmphasisOptions(SCIP *scip, mxArray *opts)
+{
+    char optsStr[BUFSIZE]; optsStr[0]   = NULL;
+    SCIP_SET* set;//                       = scip->set;
+    SCIP_PARAMSET* paramset             = set->paramset;
+    SCIP_MESSAGEHDLR* messagehdlr;//       = scip->messagehdlr;
+
+    // Check for global emphasis (set this first)
+    if (getStrOption(opts, "globalEmphasis", optsStr) == 0)
+    {
+        if ( strcmp(optsStr, "default") == 0 )
+        {
+            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_DEFAULT, TRUE), "Error Setting Global Emphasis to default");
+        }
+        else if ( strcmp(optsStr, "counter") == 0 )
+        {
+            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_COUNTER, TRUE), "Error Setting Global Emphasis to counter" );
+        }
+        else if ( strcmp(optsStr, "cpsolver") == 0 )
+        {
+            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_CPSOLVER, TRUE), "Error Setting Global Emphasis to cpsolver" );
+        }
+        else if ( strcmp(optsStr, "easycip") == 0 )
+        {
+            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_EASYCIP, TRUE), "Error Setting Global Emphasis to easycip" );
+        }
+        else if ( strcmp(optsStr, "feasibility") == 0 )
+        {
+            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_FEASIBILITY, TRUE), "Error Setting Global Emphasis to feasibility" );
+        }
+        else if ( strcmp(optsStr, "hardlp") == 0 )
+        {
+            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_HARDLP, TRUE), "Error Setting Global Emphasis to hardlp" );
+        }
+        else if ( strcmp(optsStr, "optimality") == 0 )
+        {
+            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_OPTIMALITY, TRUE), "Error Setting Global Emphasis to optimality" );
+        }
+        else
+        {
+            sprintf(msgbuf,"Error setting SCIP globalEmphasis Option - Unknown Emphasis Type \"%s\".",optsStr);
+            mexErrMsgTxt(msgbuf);
+        }
+    }
+
+    // Remainder of emphasis options
+    if (getStrOption(opts, "heuristicsEmphasis", optsStr) == 0)
+    {
+        SCIP_PARAMSETTING paramsetting = getEmphasisSetting(optsStr);
+        SCIP_ERR( SCIPparamsetSetHeuristics(paramset, set, messagehdlr, paramsetting, TRUE), "Error Setting Heuristics Emphasis" );
+    }
+    if (getStrOption(opts, "presolvingEmphasis", optsStr) == 0)
+    {
+        SCIP_PARAMSETTING paramsetting = getEmphasisSetting(optsStr);
+        SCIP_ERR( SCIPparamsetSetPresolving(paramset, set, messagehdlr, paramsetting, TRUE), "Error Setting Presolving Emphasis" );
+    }
+    if (getStrOption(opts, "separatingEmphasis", optsStr) == 0)
+    {
+        SCIP_PARAMSETTING paramsetting = getEmphasisSetting(optsStr);
+        SCIP_ERR( SCIPparamsetSetSeparating(paramset, set, messagehdlr, paramsetting, TRUE), "Error Setting Separating Emphasis" );
+    }
+}
+*/
+
+/** phases of building the SCIP problem, reported with opts.buildtime */
+enum
+{
+   eBuildValidation = 0,        /**< input checks, options and SCIP setup */
+   eBuildVariables  = 1,        /**< variables, objective and bounds */
+   eBuildLinear     = 2,        /**< linear constraints */
+   eBuildQuadratic  = 3,        /**< quadratic objective and quadratic constraints */
+   eBuildSOS        = 4,        /**< SOS constraints */
+   eBuildNonlinear  = 5,        /**< nonlinear constraints and objective */
+   eBuildNPhases    = 6
+};
+
+/** wall clock time in seconds */
+static
+double wallClock(void)
+{
+   return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** report the statistics of the lazy constraint callback in the statistics structure */
+static
+void setLazyStats(
+   SCIP*                 scip,               /**< SCIP instance */
+   mxArray*              stats               /**< statistics structure */
+   )
+{
+   SCIP_Longint ncalls;
+   SCIP_Longint nrows;
+   SCIP_Real time;
+
+   SCIPgetConshdlrMatlabLazyStats(scip, &ncalls, &nrows, &time);
+
+   mxAddField(stats, "LazyCalls");
+   mxSetField(stats, 0, "LazyCalls", mxCreateDoubleScalar((double) ncalls));
+   mxAddField(stats, "LazyRows");
+   mxSetField(stats, 0, "LazyRows", mxCreateDoubleScalar((double) nrows));
+   mxAddField(stats, "LazyTime");
+   mxSetField(stats, 0, "LazyTime", mxCreateDoubleScalar(time));
+}
+
+/** report the statistics of the cut callback in the statistics structure */
+static
+void setCutStats(
+   SCIP*                 scip,               /**< SCIP instance */
+   mxArray*              stats               /**< statistics structure */
+   )
+{
+   SCIP_Longint ncalls;
+   SCIP_Longint nfound;
+   SCIP_Longint ncuts;
+   SCIP_Real time;
+
+   SCIPgetSepaMatlabCutsStats(scip, &ncalls, &nfound, &ncuts, &time);
+
+   mxAddField(stats, "CutCalls");
+   mxSetField(stats, 0, "CutCalls", mxCreateDoubleScalar((double) ncalls));
+   mxAddField(stats, "CutRows");
+   mxSetField(stats, 0, "CutRows", mxCreateDoubleScalar((double) nfound));
+   mxAddField(stats, "CutsAdded");
+   mxSetField(stats, 0, "CutsAdded", mxCreateDoubleScalar((double) ncuts));
+   mxAddField(stats, "CutTime");
+   mxSetField(stats, 0, "CutTime", mxCreateDoubleScalar(time));
+}
+
+/** report the statistics of the pricing callback and the values of the priced columns in the statistics structure */
+static
+void setPriceStats(
+   SCIP*                 scip,               /**< SCIP instance */
+   mxArray*              stats               /**< statistics structure */
+   )
+{
+   SCIP_SOL* bestsol = SCIPgetBestSol(scip);
+   SCIP_Longint ncalls;
+   int ncols;
+   SCIP_Real time;
+   mxArray* pricedx;
+
+   SCIPgetPricerMatlabColumnsStats(scip, &ncalls, &ncols, &time);
+
+   mxAddField(stats, "PriceCalls");
+   mxSetField(stats, 0, "PriceCalls", mxCreateDoubleScalar((double) ncalls));
+   mxAddField(stats, "PriceColumns");
+   mxSetField(stats, 0, "PriceColumns", mxCreateDoubleScalar((double) ncols));
+   mxAddField(stats, "PriceTime");
+   mxSetField(stats, 0, "PriceTime", mxCreateDoubleScalar(time));
+
+   /* values of the priced columns in the best solution, in the order they were returned */
+   pricedx = mxCreateDoubleMatrix(bestsol != NULL ? ncols : 0, 1, mxREAL);
+   if ( bestsol != NULL )
+   {
+      SCIP_ERR( SCIPgetPricerMatlabColumnsVals(scip, bestsol, mxGetPr(pricedx)), "Error getting values of priced columns.");
+   }
+   mxAddField(stats, "PricedX");
+   mxSetField(stats, 0, "PricedX", pricedx);
+}
+
+/** converts block labels (nonnegative integers, -1 for linking) to SCIP labels and returns the number of blocks */
+static
+int getDecompLabels(
+   const mxArray*        arr,                /**< labels */
+   const char*           name,               /**< name of option for error messages */
+   int                   linklabel,          /**< SCIP label for linking variables or constraints */
+   int*                  labels              /**< array to store the labels (one per element of arr) */
+   )
+{
+   size_t n = mxGetNumberOfElements(arr);
+   double* vals;
+   int avals;
+   int nblocks = 0;
+
+   vals = getDoubleData(arr, &avals);
+   for (size_t k = 0; k < n; ++k)
+   {
+      if ( vals[k] < -1.0 || vals[k] > (double) INT_MAX - 1 || vals[k] != floor(vals[k]) )
+      {
+         snprintf(msgbuf, BUFSIZE, "Invalid label %g in opts.%s (must be a block number >= 0 or -1 for linking).", vals[k], name);
+         mexErrMsgTxt(msgbuf);
+      }
+      labels[k] = vals[k] < 0.0 ? linklabel : (int) vals[k];
+   }
+   if ( avals )
+      mxFree(vals);
+
+   /* count distinct block labels */
+   std::vector<int> blocks;
+   for (size_t k = 0; k < n; ++k)
+   {
+      if ( labels[k] >= 0 )
+         blocks.push_back(labels[k]);
+   }
+   std::sort(blocks.begin(), blocks.end());
+   nblocks = (int) (std::unique(blocks.begin(), blocks.end()) - blocks.begin());
+
+   return nblocks;
+}
+
+/** adds the block structure given by labels of the linear constraints and/or variables as decomposition to SCIP
+ *
+ *  Missing labels are computed by SCIP: constraints get the block of their variables, variables the block of their
+ *  constraints (or are linking). If both are given, the linear constraints keep the labels of rowlabels and only the
+ *  other constraints get computed labels. The decomposition statistics are returned in stats.Decomp.
+ */
+static
+void addDecomposition(
+   SCIP*                 scip,               /**< SCIP instance */
+   const mxArray*        rowlabels,          /**< labels of linear constraints (or NULL) */
+   const mxArray*        varlabels,          /**< labels of variables (or NULL) */
+   SCIP_CONS**           lincons,            /**< linear constraints (captured if rowlabels is given) */
+   size_t                ncon,               /**< number of linear constraints */
+   SCIP_VAR**            vars,               /**< variables */
+   size_t                ndec,               /**< number of variables */
+   mxArray*              stats               /**< statistics structure */
+   )
+{
+   const char* fnames[7] = {"NBlocks", "NLinkVars", "NLinkConss", "AreaScore", "Modularity", "NBlockGraphEdges", "NBlockGraphComponents"};
+   SCIP_DECOMP* decomp;
+   mxArray* dstats;
+   int* varlab = NULL;
+   int* rowlab = NULL;
+   int nblocks = 0;
+
+   /* the number of blocks is only a hint, SCIP recomputes it with the statistics */
+   if ( varlabels != NULL )
+   {
+      varlab = (int*) mxCalloc(ndec > 0 ? ndec : 1, sizeof(int));
+      nblocks = getDecompLabels(varlabels, "varlabels", SCIP_DECOMP_LINKVAR, varlab);
+   }
+   if ( rowlabels != NULL )
+   {
+      rowlab = (int*) mxCalloc(ncon > 0 ? ncon : 1, sizeof(int));
+      nblocks = MAX(nblocks, getDecompLabels(rowlabels, "rowlabels", SCIP_DECOMP_LINKCONS, rowlab));
+   }
+
+   SCIP_ERR( SCIPcreateDecomp(scip, &decomp, nblocks, TRUE, FALSE), "Error creating decomposition.");
+
+   if ( rowlab != NULL )
+   {
+      SCIP_ERR( SCIPdecompSetConsLabels(decomp, lincons, rowlab, (int) ncon), "Error setting constraint labels.");
+      mxFree(rowlab);
+   }
+
+   if ( varlab != NULL )
+   {
+      SCIP_ERR( SCIPdecompSetVarsLabels(decomp, vars, varlab, (int) ndec), "Error setting variable labels.");
+      mxFree(varlab);
+
+      if ( rowlabels == NULL )
+      {
+         SCIP_ERR( SCIPcomputeDecompConsLabels(scip, decomp, SCIPgetConss(scip), SCIPgetNConss(scip)), "Error computing constraint labels.");
+      }
+      else
+      {
+         /* only the constraints without labels of their own */
+         std::vector<SCIP_CONS*> others;
+         std::vector<SCIP_CONS*> labeled(lincons, lincons + ncon);
+         SCIP_CONS** conss = SCIPgetConss(scip);
+
+         std::sort(labeled.begin(), labeled.end());
+         for (int c = 0; c < SCIPgetNConss(scip); ++c)
+         {
+            if ( ! std::binary_search(labeled.begin(), labeled.end(), conss[c]) )
+               others.push_back(conss[c]);
+         }
+         if ( ! others.empty() )
+         {
+            SCIP_ERR( SCIPcomputeDecompConsLabels(scip, decomp, others.data(), (int) others.size()), "Error computing constraint labels.");
+         }
+      }
+   }
+   else
+   {
+      SCIP_ERR( SCIPcomputeDecompVarsLabels(scip, decomp, SCIPgetConss(scip), SCIPgetNConss(scip)), "Error computing variable labels.");
+   }
+
+   SCIP_ERR( SCIPcomputeDecompStats(scip, decomp, TRUE), "Error computing decomposition statistics.");
+
+   dstats = mxCreateStructMatrix(1, 1, 7, fnames);
+   mxSetField(dstats, 0, fnames[0], mxCreateDoubleScalar((double) SCIPdecompGetNBlocks(decomp)));
+   mxSetField(dstats, 0, fnames[1], mxCreateDoubleScalar((double) SCIPdecompGetNBorderVars(decomp)));
+   mxSetField(dstats, 0, fnames[2], mxCreateDoubleScalar((double) SCIPdecompGetNBorderConss(decomp)));
+   mxSetField(dstats, 0, fnames[3], mxCreateDoubleScalar(SCIPdecompGetAreaScore(decomp)));
+   mxSetField(dstats, 0, fnames[4], mxCreateDoubleScalar(SCIPdecompGetModularity(decomp)));
+   mxSetField(dstats, 0, fnames[5], mxCreateDoubleScalar((double) SCIPdecompGetNBlockGraphEdges(decomp)));
+   mxSetField(dstats, 0, fnames[6], mxCreateDoubleScalar((double) SCIPdecompGetNBlockGraphComponents(decomp)));
+   mxAddField(stats, "Decomp");
+   mxSetField(stats, 0, "Decomp", dstats);
+
+   /* the decomposition store of SCIP takes over the decomposition */
+   SCIP_ERR( SCIPaddDecomp(scip, decomp), "Error adding decomposition.");
+}
+
+/** add time since *tstart to the given build phase and restart the clock */
+static
+void addBuildTime(
+   double*               buildtime,          /**< times of build phases */
+   int                   phase,              /**< phase that just ended */
+   double*               tstart              /**< start time of phase (updated) */
+   )
+{
+   double t = wallClock();
+
+   buildtime[phase] += t - *tstart;
+   *tstart = t;
+}
+
+/** add field BuildTime with the times of the build phases to the statistics */
+static
+void setBuildTimeStats(
+   mxArray*              stats,              /**< statistics structure */
+   const double*         buildtime           /**< times of build phases */
+   )
+{
+   const char* phasenames[eBuildNPhases] = {"validation", "variables", "linear", "quadratic", "sos", "nonlinear"};
+   mxArray* bt = mxCreateStructMatrix(1, 1, eBuildNPhases, phasenames);
+   double total = 0.0;
+
+   for (int p = 0; p < eBuildNPhases; p++)
+   {
+      mxSetField(bt, 0, phasenames[p], mxCreateDoubleScalar(buildtime[p]));
+      total += buildtime[p];
+   }
+   mxAddField(bt, "total");
+   mxSetField(bt, 0, "total", mxCreateDoubleScalar(total));
+
+   mxAddField(stats, "BuildTime");
+   mxSetField(stats, 0, "BuildTime", bt);
+}
+
+/** returns whether the problem is a pure LP that can be solved directly with the LP interface
+ *
+ *  All variables have to be continuous, there must be no quadratic, SOS or nonlinear parts, and no option may need the
+ *  SCIP problem (callbacks, files, presolving, reoptimization, decomposition, SCIP parameters, or limits that
+ *  only exist in SCIP). The fast path can be switched off with opts.lpfastpath = 0.
+ */
+static
+bool isLPFastPath(
+   const mxArray*        prhs[],             /**< array of pointers to input arguments */
+   int                   nrhs                /**< number of inputs */
+   )
+{
+   const char* scipopts[] = {"solverOpts", "paramfile", "profile", "probfile", "presolvedfile", "presolvecache",
+      "reoptobj", "lazycb", "cutcb", "pricecb", "rowlabels", "varlabels", "buildtime", "objlimit", "stalltime", "deadline"};
+   const mxArray* opts = nrhs > eOPTS && ! mxIsEmpty(prhs[eOPTS]) ? prhs[eOPTS] : NULL;
+   int lpfastpath = 1;
+   int testmode = 0;
+   int presolveonly = 0;
+
+   if ( ! mxIsEmpty(prhs[eH]) )
+      return false;
+   for (int k = eSOS; k <= eNLCON && k < nrhs; ++k)
+   {
+      if ( ! mxIsEmpty(prhs[k]) )
+         return false;
+   }
+
+   if ( nrhs > eXTYPE && ! mxIsEmpty(prhs[eXTYPE]) )
+   {
+      char* xtype = mxArrayToString(prhs[eXTYPE]);
+      bool continuous = true;
+
+      for (size_t j = 0; xtype[j] != '\0' && continuous; ++j)
+         continuous = tolower(xtype[j]) == 'c';
+      mxFree(xtype);
+      if ( ! continuous )
+         return false;
+   }
+
+   if ( opts != NULL )
+   {
+      getIntOption(opts, "lpfastpath", lpfastpath);
+      getIntOption(opts, "testmode", testmode);
+      getIntOption(opts, "presolveonly", presolveonly);
+      if ( lpfastpath == 0 || testmode != 0 || presolveonly != 0 )
+         return false;
+
+      for (size_t k = 0; k < sizeof(scipopts) / sizeof(scipopts[0]); ++k)
+      {
+         const mxArray* field = mxGetField(opts, 0, scipopts[k]);
+
+         if ( field != NULL && ! mxIsEmpty(field) )
+            return false;
+      }
+   }
+
+   return true;
+}
+
+/** gets a basis status vector of opts.basis, checking its length and values */
+static
+int* getBasisStatus(
+   const mxArray*        basis,              /**< basis structure */
+   const char*           name,               /**< field name (cstat or rstat) */
+   size_t                n                   /**< required length */
+   )
+{
+   const mxArray* field = mxGetField(basis, 0, name);
+   int* stat;
+   double* vals;
+   int converted;
+
+   if ( field == NULL || mxIsSparse(field) || ! isRealData(field) || mxGetNumberOfElements(field) != n )
+   {
+      snprintf(msgbuf, BUFSIZE, "opts.basis.%s must be a real vector with %zu entries.", name, n);
+      mexErrMsgTxt(msgbuf);
+   }
+
+   vals = getDoubleData(field, &converted);
+   stat = (int*) mxCalloc(n > 0 ? n : 1, sizeof(int));
+   for (size_t k = 0; k < n; ++k)
+   {
+      if ( vals[k] != SCIP_BASESTAT_LOWER && vals[k] != SCIP_BASESTAT_BASIC && vals[k] != SCIP_BASESTAT_UPPER
+         && vals[k] != SCIP_BASESTAT_ZERO )
+      {
+         snprintf(msgbuf, BUFSIZE, "Invalid basis status %g in opts.basis.%s (must be 0, 1, 2 or 3).", vals[k], name);
+         mexErrMsgTxt(msgbuf);
+      }
+      stat[k] = (int) vals[k];
+   }
+   if ( converted )
+      mxFree(vals);
+
+   return stat;
+}
+
+/** returns an int vector as MATLAB column vector */
+static
+mxArray* createIntVector(
+   const int*            vals,               /**< values */
+   size_t                n                   /**< length */
+   )
+{
+   mxArray* arr = mxCreateDoubleMatrix(n, 1, mxREAL);
+   double* pr = mxGetPr(arr);
+
+   for (size_t k = 0; k < n; ++k)
+      pr[k] = (double) vals[k];
+
+   return arr;
+}
+
+/** solve a pure LP with the LP interface of SCIP, without building a SCIP problem
+ *
+ *  The dual simplex is used, warm started from opts.basis if given. Besides the usual outputs, stats contains the
+ *  duals Lambda of the rows of A, the reduced costs RedCost of the variables and the final Basis (cstat, rstat with
+ *  the values of SCIP_BASESTAT), which can be passed as opts.basis to the next solve. The LP solver is not interrupted
+ *  by Ctrl-C, only by the time and iteration limits.
+ */
+static
+void lpSolve(
+   mxArray*              plhs[],             /**< array of pointers to output arguments */
+   int                   nrhs,               /**< number of inputs */
+   const mxArray*        prhs[]              /**< array of pointers to input arguments */
+   )
+{
+   const char* fnames[5] = {"LPiter", "BBnodes", "BBgap", "PrimalBound", "DualBound"};
+   const char* basisnames[2] = {"cstat", "rstat"};
+   const mxArray* opts = nrhs > eOPTS && ! mxIsEmpty(prhs[eOPTS]) ? prhs[eOPTS] : NULL;
+   const mxArray* basis = NULL;
+   size_t ndec = mxGetNumberOfElements(prhs[eF]);
+   size_t ncon = mxGetM(prhs[eA]);
+   SCIP_LPI* lpi = NULL;
+   SCIP_Real inf;
+   double* f;
+   double* lb;
+   double* ub;
+   double* lhs;
+   double* rhs;
+   int* beg;
+   int* ind;
+   double* val;
+   int* cstat;
+   int* rstat;
+   int* bcstat = NULL;
+   int* brstat = NULL;
+   int af;
+   int niter = 0;
+   size_t nnz = 0;
+   size_t maxnnz = 0;
+   double maxtime = 1e20;
+   double primtol = SCIP_DEFAULT_FEASTOL;
+   double objbias = 0.0;
+   SCIP_Longint maxlpiter = -1LL;
+   int printLevel = 0;
+   const char* reason;
+   double status;
+
+   if ( opts != NULL )
+   {
+      getDblOption(opts, "maxtime", maxtime);
+      getLongIntOption(opts, "maxiter", maxlpiter);
+      getDblOption(opts, "tolrfun", primtol);
+      getDblOption(opts, "objbias", objbias);
+      getIntOption(opts, "display", printLevel);
+      basis = mxGetField(opts, 0, "basis");
+      if ( basis != NULL && mxIsEmpty(basis) )
+         basis = NULL;
+      if ( basis != NULL && ! mxIsStruct(basis) )
+         mexErrMsgTxt("opts.basis must be a structure with fields cstat and rstat.");
+   }
+
+   /* convert and validate the inputs before the LP interface is created, later errors free it */
+   if ( basis != NULL )
+   {
+      bcstat = getBasisStatus(basis, "cstat", ndec);
+      brstat = getBasisStatus(basis, "rstat", ncon);
+   }
+   if ( ncon > 0 )
+   {
+      maxnnz = mxIsSparse(prhs[eA]) ? mxGetJc(prhs[eA])[ndec] : ncon * ndec;
+      CheckIntSize(maxnnz, "nonzeros of A");
+   }
+
+   /* bounds and sides */
+   f = getDoubleData(prhs[eF], &af);
+   lb = (double*) mxCalloc(ndec > 0 ? ndec : 1, sizeof(double));
+   ub = (double*) mxCalloc(ndec > 0 ? ndec : 1, sizeof(double));
+   lhs = (double*) mxCalloc(ncon > 0 ? ncon : 1, sizeof(double));
+   rhs = (double*) mxCalloc(ncon > 0 ? ncon : 1, sizeof(double));
+   if ( ! mxIsEmpty(prhs[eLB]) )
+      convertToDouble(prhs[eLB], 0, ndec, lb);
+   if ( ! mxIsEmpty(prhs[eUB]) )
+      convertToDouble(prhs[eUB], 0, ndec, ub);
+   if ( ! mxIsEmpty(prhs[eLHS]) )
+      convertToDouble(prhs[eLHS], 0, ncon, lhs);
+   if ( ! mxIsEmpty(prhs[eRHS]) )
+      convertToDouble(prhs[eRHS], 0, ncon, rhs);
+
+   /* A in compressed column format with int indices */
+   beg = (int*) mxCalloc(ndec > 0 ? ndec : 1, sizeof(int));
+   if ( ncon > 0 )
+   {
+      MatrixColumns matcols;
+      const mwIndex* rows;
+      const double* vals;
+
+      ind = (int*) mxCalloc(maxnnz > 0 ? maxnnz : 1, sizeof(int));
+      val = (double*) mxCalloc(maxnnz > 0 ? maxnnz : 1, sizeof(double));
+
+      initMatrixColumns(&matcols, prhs[eA]);
+      for (size_t j = 0; j < ndec; ++j)
+      {
+         size_t colnnz = getMatrixColumn(&matcols, j, &rows, &vals);
+
+         beg[j] = (int) nnz;
+         for (size_t k = 0; k < colnnz; ++k)
+         {
+            ind[nnz] = (int) rows[k];
+            val[nnz++] = vals[k];
+         }
+      }
+      freeMatrixColumns(&matcols);
+   }
+   else
+   {
+      ind = (int*) mxCalloc(1, sizeof(int));
+      val = (double*) mxCalloc(1, sizeof(double));
+   }
+
+   SCIP_ERR( SCIPlpiCreate(&lpi, NULL, "scipmex_lp", SCIP_OBJSEN_MINIMIZE), "Error creating LP interface.");
+   inf = SCIPlpiInfinity(lpi);
+
+   /* infinite values (or >= 1e20) are mapped to the infinity of the LP solver */
+   for (size_t j = 0; j < ndec; ++j)
+   {
+      lb[j] = ( mxIsEmpty(prhs[eLB]) || lb[j] <= -1e20 ) ? -inf : lb[j];
+      ub[j] = ( mxIsEmpty(prhs[eUB]) || ub[j] >= 1e20 ) ? inf : ub[j];
+   }
+   for (size_t i = 0; i < ncon; ++i)
+   {
+      lhs[i] = ( mxIsEmpty(prhs[eLHS]) || lhs[i] <= -1e20 ) ? -inf : lhs[i];
+      rhs[i] = ( mxIsEmpty(prhs[eRHS]) || rhs[i] >= 1e20 ) ? inf : rhs[i];
+   }
+
+   LPI_ERR( SCIPlpiLoadColLP(lpi, SCIP_OBJSEN_MINIMIZE, (int) ndec, f, lb, ub, NULL, (int) ncon, lhs, rhs, NULL, (int) nnz,
+         beg, ind, val), "Error loading LP.");
+
+   if ( af )
+      mxFree(f);
+   mxFree(lb);
+   mxFree(ub);
+   mxFree(lhs);
+   mxFree(rhs);
+   mxFree(beg);
+   mxFree(ind);
+   mxFree(val);
+
+   /* common options */
+   if ( maxtime < 1e20 )
+   {
+      LPI_ERR( SCIPlpiSetRealpar(lpi, SCIP_LPPAR_LPTILIM, maxtime), "Error setting maxtime.");
+   }
+   if ( maxlpiter >= 0LL )
+   {
+      LPI_ERR( SCIPlpiSetIntpar(lpi, SCIP_LPPAR_LPITLIM, (int) MIN(maxlpiter, (SCIP_Longint) INT_MAX)), "Error setting LP iterlim.");
+   }
+   if ( primtol != SCIP_DEFAULT_FEASTOL )
+   {
+      LPI_ERR( SCIPlpiSetRealpar(lpi, SCIP_LPPAR_FEASTOL, primtol), "Error setting lpfeastol.");
+   }
+   /* the log of the LP solver goes to stdout and would not be shown in MATLAB, so a summary is printed instead */
+   if ( printLevel > 0 )
+      mexPrintf("Solving LP with %s.\n", SCIPlpiGetSolverName());
+
+   cstat = (int*) mxCalloc(ndec > 0 ? ndec : 1, sizeof(int));
+   rstat = (int*) mxCalloc(ncon > 0 ? ncon : 1, sizeof(int));
+
+   /* warm start from a previous basis */
+   if ( basis != NULL )
+   {
+      LPI_ERR( SCIPlpiSetBase(lpi, bcstat, brstat), "Error setting LP basis.");
+      mxFree(bcstat);
+      mxFree(brstat);
+   }
+
+   LPI_ERR( SCIPlpiSolveDual(lpi), "Error solving LP.");
+   LPI_ERR( SCIPlpiGetIterations(lpi, &niter), "Error getting LP iterations.");
+
+   /* map the LP status to the SCIP status */
+   if ( SCIPlpiIsOptimal(lpi) )
+   {
+      status = SCIP_STATUS_OPTIMAL;
+      reason = "optimal";
+   }
+   else if ( SCIPlpiIsPrimalInfeasible(lpi) )
+   {
+      status = SCIP_STATUS_INFEASIBLE;
+      reason = "infeasible";
+   }
+   else if ( SCIPlpiIsPrimalUnbounded(lpi) )
+   {
+      status = SCIP_STATUS_UNBOUNDED;
+      reason = "unbounded";
+   }
+   else if ( SCIPlpiIsDualInfeasible(lpi) )
+   {
+      status = SCIP_STATUS_INFORUNBD;
+      reason = "inforunbd";
+   }
+   else if ( SCIPlpiIsTimelimExc(lpi) )
+   {
+      status = SCIP_STATUS_TIMELIMIT;
+      reason = "timelimit";
+   }
+   else if ( SCIPlpiIsIterlimExc(lpi) )
+   {
+      status = SCIP_STATUS_UNKNOWN;
+      reason = "iterlimit";
+   }
+   else
+   {
+      status = SCIP_STATUS_UNKNOWN;
+      reason = "unknown";
+   }
+   if ( printLevel > 0 )
+      mexPrintf("LP %s after %d iterations.\n", reason, niter);
+
+   /* create outputs */
+   plhs[0] = mxCreateDoubleMatrix(ndec, 1, mxREAL);
+   plhs[1] = mxCreateDoubleScalar(std::numeric_limits<double>::quiet_NaN());
+   plhs[2] = mxCreateDoubleScalar(status);
+   plhs[3] = mxCreateStructMatrix(1, 1, 5, fnames);
+   mxSetField(plhs[3], 0, fnames[0], mxCreateDoubleScalar((double) niter));
+   mxSetField(plhs[3], 0, fnames[1], mxCreateDoubleScalar(0.0));
+   mxSetField(plhs[3], 0, fnames[2], mxCreateDoubleScalar(std::numeric_limits<double>::infinity()));
+   mxSetField(plhs[3], 0, fnames[3], mxCreateDoubleScalar(std::numeric_limits<double>::quiet_NaN()));
+   mxSetField(plhs[3], 0, fnames[4], mxCreateDoubleScalar(std::numeric_limits<double>::quiet_NaN()));
+   mxAddField(plhs[3], "StopReason");
+   mxSetField(plhs[3], 0, "StopReason", mxCreateString(reason));
+   mxAddField(plhs[3], "Lambda");
+   mxAddField(plhs[3], "RedCost");
+   mxAddField(plhs[3], "Basis");
+
+   if ( SCIPlpiIsOptimal(lpi) )
+   {
+      mxArray* lambda = mxCreateDoubleMatrix(ncon, 1, mxREAL);
+      mxArray* redcost = mxCreateDoubleMatrix(ndec, 1, mxREAL);
+      double objval;
+
+      LPI_ERR( SCIPlpiGetSol(lpi, &objval, mxGetPr(plhs[0]), mxGetPr(lambda), NULL, mxGetPr(redcost)),
+         "Error getting LP solution.");
+      objval += objbias;
+      *mxGetPr(plhs[1]) = objval;
+      *mxGetPr(mxGetField(plhs[3], 0, fnames[2])) = 0.0;
+      *mxGetPr(mxGetField(plhs[3], 0, fnames[3])) = objval;
+      *mxGetPr(mxGetField(plhs[3], 0, fnames[4])) = objval;
+      mxSetField(plhs[3], 0, "Lambda", lambda);
+      mxSetField(plhs[3], 0, "RedCost", redcost);
+   }
+   else
+   {
+      mxSetField(plhs[3], 0, "Lambda", mxCreateDoubleMatrix(0, 0, mxREAL));
+      mxSetField(plhs[3], 0, "RedCost", mxCreateDoubleMatrix(0, 0, mxREAL));
+   }
 
-    // Check for global emphasis (set this first)
-    if (getStrOption(opts, "globalEmphasis", optsStr) == 0)
-    {
-        if ( strcmp(optsStr, "default") == 0 )
-        {
-            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_DEFAULT, TRUE), "Error Setting Global Emphasis to default");
-        }
-        else if ( strcmp(optsStr, "counter") == 0 )
-        {
-            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_COUNTER, TRUE), "Error Setting Global Emphasis to counter" );
-        }
-        else if ( strcmp(optsStr, "cpsolver") == 0 )
-        {
-            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_CPSOLVER, TRUE), "Error Setting Global Emphasis to cpsolver" );
-        }
-        else if ( strcmp(optsStr, "easycip") == 0 )
-        {
-            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_EASYCIP, TRUE), "Error Setting Global Emphasis to easycip" );
-        }
-        else if ( strcmp(optsStr, "feasibility") == 0 )
-        {
-            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_FEASIBILITY, TRUE), "Error Setting Global Emphasis to feasibility" );
-        }
-        else if ( strcmp(optsStr, "hardlp") == 0 )
-        {
-            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_HARDLP, TRUE), "Error Setting Global Emphasis to hardlp" );
-        }
-        else if ( strcmp(optsStr, "optimality") == 0 )
-        {
-            SCIP_ERR( SCIPparamsetSetEmphasis(paramset, set, messagehdlr, SCIP_PARAMEMPHASIS_OPTIMALITY, TRUE), "Error Setting Global Emphasis to optimality" );
-        }
-        else
-        {
-            sprintf(msgbuf,"Error setting SCIP globalEmphasis Option - Unknown Emphasis Type \"%s\".",optsStr);
-            mexErrMsgTxt(msgbuf);
-        }
-    }
+   /* the final basis is also returned after a limit was reached, to continue from it */
+   if ( SCIPlpiGetBase(lpi, cstat, rstat) == SCIP_OKAY )
+   {
+      mxArray* bstruct = mxCreateStructMatrix(1, 1, 2, basisnames);
 
-    // Remainder of emphasis options
-    if (getStrOption(opts, "heuristicsEmphasis", optsStr) == 0)
-    {
-        SCIP_PARAMSETTING paramsetting = getEmphasisSetting(optsStr);
-        SCIP_ERR( SCIPparamsetSetHeuristics(paramset, set, messagehdlr, paramsetting, TRUE), "Error Setting Heuristics Emphasis" );
-    }
-    if (getStrOption(opts, "presolvingEmphasis", optsStr) == 0)
-    {
-        SCIP_PARAMSETTING paramsetting = getEmphasisSetting(optsStr);
-        SCIP_ERR( SCIPparamsetSetPresolving(paramset, set, messagehdlr, paramsetting, TRUE), "Error Setting Presolving Emphasis" );
-    }
-    if (getStrOption(opts, "separatingEmphasis", optsStr) == 0)
-    {
-        SCIP_PARAMSETTING paramsetting = getEmphasisSetting(optsStr);
-        SCIP_ERR( SCIPparamsetSetSeparating(paramset, set, messagehdlr, paramsetting, TRUE), "Error Setting Separating Emphasis" );
-    }
+      mxSetField(bstruct, 0, "cstat", createIntVector(cstat, ndec));
+      mxSetField(bstruct, 0, "rstat", createIntVector(rstat, ncon));
+      mxSetField(plhs[3], 0, "Basis", bstruct);
+   }
+   else
+      mxSetField(plhs[3], 0, "Basis", mxCreateDoubleMatrix(0, 0, mxREAL));
+
+   mxFree(cstat);
+   mxFree(rstat);
+   SCIP_ERR( SCIPlpiFree(&lpi), "Error freeing LP interface.");
 }
-*/
 
 /** main function */
 void mexFunction(
@@ -643,21 +3609,17 @@ void mexFunction(
    )
 {
    /* input arguments */
-   double* H;
    double* f;
-   double* A;
-   double* lhs;
-   double* rhs;
-   double* lb;
-   double* ub;
+   double* lhs = NULL;
+   double* rhs = NULL;
+   double* lb = NULL;
+   double* ub = NULL;
    double* sosind;
    double* soswt;
-   double* Q;
-   double* l;
    double* qrl;
    double* qru;
    double* x0 = NULL;
-   char* xtype;
+   char* xtype = NULL;
    char* sostype = NULL;
    char fpath[BUFSIZE];
 
@@ -673,16 +3635,31 @@ void mexFunction(
    const char* fnames[5] = {"LPiter", "BBnodes", "BBgap", "PrimalBound", "DualBound"};
 
    /* common options */
-   SCIP_Longint maxlpiter = -1LL;
-   SCIP_Longint maxnodes = -1LL;
-   double maxtime = 1e20;
-   double primtol = SCIP_DEFAULT_FEASTOL;
    double objbias = 0.0;
    int printLevel = 0;
    int optsEntry = 0;
    char probfile[BUFSIZE]; probfile[0] = '\0';
    char presolvedfile[BUFSIZE]; presolvedfile[0] = '\0';
+   char cachedir[BUFSIZE]; cachedir[0] = '\0';
+   char cachefile[BUFSIZE]; cachefile[0] = '\0';
    mxArray* OPTS;
+   mxArray* reoptobj = NULL;
+   mxArray* lazycb = NULL;
+   mxArray* cutcb = NULL;
+   mxArray* pricecb = NULL;
+   const mxArray* rowlabels = NULL;
+   const mxArray* varlabels = NULL;
+   int cutfreq = 1;
+   int cutmaxdepth = -1;
+   double cutminefficacy = 1e-4;
+   int cutmaxround = -1;
+   int cutpool = 0;
+   size_t nsolves = 1;
+   int presolveonly = 0;
+   int presolvematrices = 0;
+   int buildtimes = 0;
+   double buildtime[eBuildNPhases] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+   double tphase = wallClock();
 
    /* internal vars */
    size_t ncon = 0;
@@ -693,23 +3670,20 @@ void mexFunction(
    size_t i;
    size_t j;
    size_t k;
+   int af = 0;
    int alhs = 0;
    int arhs = 0;
    int alb = 0;
    int aub = 0;
-   int no = 0;
    int tm = 0;
    int ts = 1;
 
-   /* sparse indexing */
-   mwIndex* H_ir;
-   mwIndex* H_jc;
-   mwIndex* A_ir;
-   mwIndex* A_jc;
-   mwIndex* Q_ir;
-   mwIndex* Q_jc;
-   mwIndex startRow;
-   mwIndex stopRow;
+   /* column access to sparse or dense matrices */
+   MatrixColumns matcols;
+   const mwIndex* rows;
+   const double* vals;
+   size_t nnz;
+   size_t nterms;
 
    /* SCIP objects */
    SCIP* scip;
@@ -730,9 +3704,40 @@ void mexFunction(
       return;
    }
 
+   /* commands given as a string in the first argument */
+   if ( mxIsChar(prhs[0]) )
+   {
+      char cmd[BUFSIZE];
+      mxGetString(prhs[0], cmd, BUFSIZE);
+
+      if ( strcmp(cmd, "readsolve") == 0 )
+         readSolve(nlhs, plhs, nrhs, prhs);
+      else if ( strcmp(cmd, "benders") == 0 )
+         bendersSolve(nlhs, plhs, nrhs, prhs);
+      else if ( strcmp(cmd, "defineProfile") == 0 )
+         defineProfile(nlhs, plhs, nrhs, prhs);
+      else if ( strcmp(cmd, "tune") == 0 )
+         tuneSolve(nlhs, plhs, nrhs, prhs);
+      else
+      {
+         snprintf(msgbuf, BUFSIZE, "Unknown command \"%s\".", cmd);
+         mexErrMsgTxt(msgbuf);
+      }
+      return;
+   }
+
    /* check inputs */
    checkInputs(prhs, nrhs);
 
+   /* pure LPs are solved directly with the LP interface */
+   if ( isLPFastPath(prhs, nrhs) )
+   {
+      if ( nrhs > eOPTS && ! mxIsEmpty(prhs[eOPTS]) )
+         CheckOptiVersion(prhs[eOPTS]);
+      lpSolve(plhs, nrhs, prhs);
+      return;
+   }
+
    /* create SCIP object */
    SCIP_ERR( SCIPcreate(&scip), "Error creating SCIP object.");
    SCIP_ERR( SCIPincludeDefaultPlugins(scip), "Error including SCIP default plugins.");
@@ -747,103 +3752,131 @@ void mexFunction(
    /* get common options if specified */
    if ( nrhs > optsEntry )
    {
-      getLongIntOption(OPTS, "maxiter", maxlpiter);
-      getLongIntOption(OPTS, "maxnodes", maxnodes);
-      getDblOption(OPTS, "maxtime", maxtime);
-      getDblOption(OPTS, "tolrfun", primtol);
       getDblOption(OPTS, "objbias", objbias);
-      getIntOption(OPTS, "display", printLevel);
-      /* make sure level is ok */
-      if ( printLevel < 0 )
-         printLevel = 0;
-      if ( printLevel > 5 )
-         printLevel = 5;
 
       /* Check for nonlinear testing mode */
       getIntOption(OPTS, "testmode", tm);
 
+      /* Check for reporting the time of the build phases */
+      getIntOption(OPTS, "buildtime", buildtimes);
+
       /* Check for writing problem */
       getStrOption(OPTS, "probfile", probfile);
 
       /* Check for writing presolved problem */
       getStrOption(OPTS, "presolvedfile", presolvedfile);
 
-      CheckOptiVersion(OPTS);
+      /* Check for presolve cache directory */
+      getStrOption(OPTS, "presolvecache", cachedir);
+
+      /* Check for presolving only (possibly returning the presolved matrices) */
+      getIntOption(OPTS, "presolveonly", presolveonly);
+      getIntOption(OPTS, "presolvematrices", presolvematrices);
+
+      /* Check for sequence of objectives to solve with reoptimization */
+      reoptobj = mxGetField(OPTS, 0, "reoptobj");
+      if ( reoptobj != NULL && mxIsEmpty(reoptobj) )
+         reoptobj = NULL;
+
+      /* Check for lazy constraint callback */
+      lazycb = mxGetField(OPTS, 0, "lazycb");
+      if ( lazycb != NULL && mxIsEmpty(lazycb) )
+         lazycb = NULL;
+      if ( lazycb != NULL && ! mxIsClass(lazycb, "function_handle") && ! mxIsChar(lazycb) )
+         mexErrMsgTxt("opts.lazycb must be a function handle or the name of a function.");
+
+      /* Check for cut callback */
+      cutcb = mxGetField(OPTS, 0, "cutcb");
+      if ( cutcb != NULL && mxIsEmpty(cutcb) )
+         cutcb = NULL;
+      if ( cutcb != NULL && ! mxIsClass(cutcb, "function_handle") && ! mxIsChar(cutcb) )
+         mexErrMsgTxt("opts.cutcb must be a function handle or the name of a function.");
+      getIntOption(OPTS, "cutfreq", cutfreq);
+      getIntOption(OPTS, "cutmaxdepth", cutmaxdepth);
+      getDblOption(OPTS, "cutminefficacy", cutminefficacy);
+      getIntOption(OPTS, "cutmaxround", cutmaxround);
+      getIntOption(OPTS, "cutpool", cutpool);
+      if ( cutfreq < -1 )
+         mexErrMsgTxt("opts.cutfreq must be -1 (never), 0 (only root) or positive.");
+      if ( cutminefficacy < 0.0 )
+         mexErrMsgTxt("opts.cutminefficacy must not be negative.");
+
+      /* Check for block labels of a decomposition */
+      rowlabels = mxGetField(OPTS, 0, "rowlabels");
+      if ( rowlabels != NULL && mxIsEmpty(rowlabels) )
+         rowlabels = NULL;
+      varlabels = mxGetField(OPTS, 0, "varlabels");
+      if ( varlabels != NULL && mxIsEmpty(varlabels) )
+         varlabels = NULL;
+      checkRealData(rowlabels, "opts.rowlabels");
+      checkRealData(varlabels, "opts.varlabels");
+
+      /* Check for pricing callback */
+      pricecb = mxGetField(OPTS, 0, "pricecb");
+      if ( pricecb != NULL && mxIsEmpty(pricecb) )
+         pricecb = NULL;
+      if ( pricecb != NULL && ! mxIsClass(pricecb, "function_handle") && ! mxIsChar(pricecb) )
+         mexErrMsgTxt("opts.pricecb must be a function handle or the name of a function.");
 
-      /* set common options */
-      if ( ! SCIPisInfinity(scip, maxtime) )
-      {
-         SCIP_ERR( SCIPsetRealParam(scip, "limits/time", maxtime), "Error setting maxtime.");
-      }
-      if ( maxlpiter >= 0LL )
-      {
-         SCIP_ERR( SCIPsetLongintParam(scip, "lp/iterlim", maxlpiter), "Error setting LP iterlim.");
-      }
-      if ( maxnodes >= 0 )
-      {
-         SCIP_ERR( SCIPsetLongintParam(scip, "limits/nodes", maxnodes), "Error setting nodes.");
-      }
-      if ( primtol != SCIP_DEFAULT_FEASTOL )
-      {
-         SCIP_ERR( SCIPsetRealParam(scip, "numerics/feastol", primtol), "Error setting lpfeastol.");
-      }
+      CheckOptiVersion(OPTS);
    }
 
-   /* if user has requested print out */
-   if ( printLevel )
-   {
-      /* create message handler */
-      SCIP_MESSAGEHDLR* mexprinter;
+   /* set common options, message handler and verbosity */
+   printLevel = setCommonOpts(scip, nrhs > optsEntry ? OPTS : NULL);
 
-      SCIPmessagehdlrCreate(&mexprinter, TRUE, NULL, FALSE, &msginfo, &msginfo, &msginfo, NULL, NULL);
-      SCIP_ERR( SCIPsetMessagehdlr(scip, mexprinter), "Error adding message handler.");
-   }
+   /* get pointers to input vectors (converted to double if necessary; H, A and Q are read column-wise below) */
+   f = getDoubleData(prhs[eF], &af);
+   if ( ! mxIsEmpty(prhs[eLHS]) )
+      lhs = getDoubleData(prhs[eLHS], &alhs);
+   if ( ! mxIsEmpty(prhs[eRHS]) )
+      rhs = getDoubleData(prhs[eRHS], &arhs);
+   if ( ! mxIsEmpty(prhs[eLB]) )
+      lb = getDoubleData(prhs[eLB], &alb);
+   if ( ! mxIsEmpty(prhs[eUB]) )
+      ub = getDoubleData(prhs[eUB], &aub);
 
-   /* set verbosity level */
-   SCIP_ERR( SCIPsetIntParam(scip, "display/verblevel", printLevel), "Error setting verblevel.");
+   if ( nrhs > eXTYPE )
+      xtype = mxArrayToString(prhs[eXTYPE]);
 
-   if ( printLevel )
-   {
-      SCIPprintVersion(scip, NULL);
-      SCIPinfoMessage(scip, NULL, "\n");
+   /* get sizes from input args */
+   ndec = mxGetNumberOfElements(prhs[eF]);
+   ncon = mxGetM(prhs[eA]);
 
-      SCIPprintExternalCodes(scip, NULL);
-      SCIPinfoMessage(scip, NULL, "\n");
+   /* one solve per column of reoptobj */
+   if ( reoptobj != NULL )
+   {
+      if ( ! mxIsDouble(reoptobj) || mxIsSparse(reoptobj) || mxIsComplex(reoptobj) || mxGetM(reoptobj) != ndec )
+      {
+         sprintf(msgbuf, "opts.reoptobj must be a dense real matrix with %zu rows (one objective per column).", ndec);
+         mexErrMsgTxt(msgbuf);
+      }
+      nsolves = mxGetN(reoptobj);
    }
 
-   /* get pointers to input vars */
-   if ( ! mxIsEmpty(prhs[eH]) )
+   /* priced columns need linear constraints and cannot be reused across objectives */
+   if ( pricecb != NULL && ncon == 0 )
+      mexErrMsgTxt("opts.pricecb requires linear constraints (A) for the coefficients of the priced columns.");
+   if ( pricecb != NULL && reoptobj != NULL )
+      mexErrMsgTxt("opts.pricecb cannot be combined with opts.reoptobj.");
+   if ( presolveonly && reoptobj != NULL )
+      mexErrMsgTxt("opts.presolveonly cannot be combined with opts.reoptobj.");
+
+   /* one block label per linear constraint and variable */
+   if ( rowlabels != NULL && mxGetNumberOfElements(rowlabels) != ncon )
    {
-      H = mxGetPr(prhs[eH]);
-      H_ir = mxGetIr(prhs[eH]);
-      H_jc = mxGetJc(prhs[eH]);
+      sprintf(msgbuf, "opts.rowlabels must have one entry per linear constraint (%zu).", ncon);
+      mexErrMsgTxt(msgbuf);
    }
-   else
+   if ( varlabels != NULL && mxGetNumberOfElements(varlabels) != ndec )
    {
-      H = NULL;
-      H_ir = NULL;
-      H_jc = NULL;
+      sprintf(msgbuf, "opts.varlabels must have one entry per variable (%zu).", ndec);
+      mexErrMsgTxt(msgbuf);
    }
-   f = mxGetPr(prhs[eF]);
-   A = mxGetPr(prhs[eA]);
-   A_ir = mxGetIr(prhs[eA]);
-   A_jc = mxGetJc(prhs[eA]);
-   lhs = mxGetPr(prhs[eLHS]);
-   rhs = mxGetPr(prhs[eRHS]);
-   lb = mxGetPr(prhs[eLB]);
-   ub = mxGetPr(prhs[eUB]);
-
-   if ( nrhs > eXTYPE )
-      xtype = mxArrayToString(prhs[eXTYPE]);
-
-   /* get sizes from input args */
-   ndec = mxGetNumberOfElements(prhs[eF]);
-   ncon = mxGetM(prhs[eA]);
 
    /* create outputs */
-   plhs[0] = mxCreateDoubleMatrix(ndec, 1, mxREAL);
-   plhs[1] = mxCreateDoubleMatrix(1, 1, mxREAL);
-   plhs[2] = mxCreateDoubleMatrix(1, 1, mxREAL);
+   plhs[0] = mxCreateDoubleMatrix(ndec, nsolves, mxREAL);
+   plhs[1] = mxCreateDoubleMatrix(1, nsolves, mxREAL);
+   plhs[2] = mxCreateDoubleMatrix(1, nsolves, mxREAL);
    plhs[3] = mxCreateDoubleMatrix(1, 1, mxREAL);
 
    x = mxGetPr(plhs[0]);         /* solution */
@@ -852,17 +3885,69 @@ void mexFunction(
 
    /* statistic structure output */
    plhs[3] = mxCreateStructMatrix(1, 1, 5, fnames);
-   mxSetField(plhs[3], 0, fnames[0], mxCreateDoubleMatrix(1, 1, mxREAL));
-   mxSetField(plhs[3], 0, fnames[1], mxCreateDoubleMatrix(1, 1, mxREAL));
-   mxSetField(plhs[3], 0, fnames[2], mxCreateDoubleMatrix(1, 1, mxREAL));
-   mxSetField(plhs[3], 0, fnames[3], mxCreateDoubleMatrix(1, 1, mxREAL));
-   mxSetField(plhs[3], 0, fnames[4], mxCreateDoubleMatrix(1, 1, mxREAL));
+   mxSetField(plhs[3], 0, fnames[0], mxCreateDoubleMatrix(1, nsolves, mxREAL));
+   mxSetField(plhs[3], 0, fnames[1], mxCreateDoubleMatrix(1, nsolves, mxREAL));
+   mxSetField(plhs[3], 0, fnames[2], mxCreateDoubleMatrix(1, nsolves, mxREAL));
+   mxSetField(plhs[3], 0, fnames[3], mxCreateDoubleMatrix(1, nsolves, mxREAL));
+   mxSetField(plhs[3], 0, fnames[4], mxCreateDoubleMatrix(1, nsolves, mxREAL));
    iter  = mxGetPr(mxGetField(plhs[3], 0, fnames[0]));
    nodes = mxGetPr(mxGetField(plhs[3], 0, fnames[1]));
    gap   = mxGetPr(mxGetField(plhs[3], 0, fnames[2]));
    pbound = mxGetPr(mxGetField(plhs[3], 0, fnames[3]));
    dbound = mxGetPr(mxGetField(plhs[3], 0, fnames[4]));
 
+   /* presolve cache: key is a hash of all problem data (not x0) and of the parameters that influence presolving */
+   if ( strlen(cachedir) > 0 && tm == 0 && ! presolveonly && reoptobj == NULL && lazycb == NULL && cutcb == NULL && pricecb == NULL
+      && rowlabels == NULL && varlabels == NULL && ! hasBranchingHints(OPTS) )
+   {
+      uint64_t hash = 14695981039346656037ULL;
+      FILE* file;
+
+      for (k = eH; k < eX0 && k < (size_t) nrhs; k++)
+         hash = hashMxArray(hash, prhs[k]);
+      hash = hashBytes(hash, &objbias, sizeof(objbias));
+      /* cache files of other SCIP versions may be written or presolved differently */
+      int version[3] = {SCIPmajorVersion(), SCIPminorVersion(), SCIPtechVersion()};
+      hash = hashBytes(hash, version, sizeof(version));
+      /* all parameters that may change presolving, e.g., tolrfun, paramfile, profile and solverOpts */
+      if ( nrhs > optsEntry )
+         applySolverOpts(scip, OPTS);
+      hash = hashChangedParams(hash, scip);
+      /* the objective limit is used in presolving */
+      if ( nrhs > optsEntry && mxGetField(OPTS, 0, "objlimit") != NULL )
+         hash = hashMxArray(hash, mxGetField(OPTS, 0, "objlimit"));
+
+      snprintf(cachefile, BUFSIZE, "%s/scip_presolve_%016llx.cip", cachedir, (unsigned long long) hash);
+
+      mxAddField(plhs[3], "PresolveCache");
+      mxAddField(plhs[3], "PresolveTimeSaved");
+
+      /* on a hit, skip building and presolving the problem */
+      file = fopen(cachefile, "r");
+      if ( file != NULL )
+      {
+         double timesaved;
+
+         fclose(file);
+         if ( printLevel )
+            mexPrintf("Using presolve cache file <%s>.\n", cachefile);
+
+         if ( solveFromPresolveCache(scip, cachefile, nrhs > optsEntry ? OPTS : NULL,
+               nrhs > eXTYPE && ! mxIsEmpty(prhs[eXTYPE]) ? xtype : NULL, ndec, plhs, &timesaved) )
+         {
+            mxSetField(plhs[3], 0, "PresolveCache", mxCreateString("hit"));
+            mxSetField(plhs[3], 0, "PresolveTimeSaved", mxCreateDoubleScalar(timesaved));
+
+            mxFree(xtype);
+            SCIP_ERR( SCIPfree(&scip), "Error releasing SCIP problem.");
+            return;
+         }
+      }
+
+      mxSetField(plhs[3], 0, "PresolveCache", mxCreateString("miss"));
+      mxSetField(plhs[3], 0, "PresolveTimeSaved", mxCreateDoubleScalar(0.0));
+   }
+
    /* create empty problem */
    SCIP_ERR( SCIPcreateProbBasic(scip, "OPTI Problem"), "Error creating basic SCIP problem");
 
@@ -908,8 +3993,10 @@ void mexFunction(
          rhs[i] = SCIPinfinity(scip);
    }
 
+   addBuildTime(buildtime, eBuildValidation, &tphase);
+
    /* create SCIP variables (also loads linear objective + bounds) */
-   SCIP_ERR( SCIPallocMemoryArray(scip, &vars, (int)ndec), "Error allocating variable memory");
+   SCIP_ERR( SCIPallocMemoryArray(scip, &vars, ndec), "Error allocating variable memory");
    double llb;
    double lub;
 
@@ -924,22 +4011,22 @@ void mexFunction(
          vartype = SCIP_VARTYPE_INTEGER;
          llb = lb[i];
          lub = ub[i];
-         sprintf(msgbuf, "ivar%zd", nint++);
+         sprintf(msgbuf, "ivar%zu", nint++);
          break;
       case 'b':
          vartype = SCIP_VARTYPE_BINARY;
          llb = SCIPisInfinity(scip, -lb[i]) ? 0 : lb[i]; /* if we don't do this, SCIP fails during presolve */
          lub = SCIPisInfinity(scip, ub[i])  ? 1 : ub[i];
-         sprintf(msgbuf, "bvar%zd", nbin++);
+         sprintf(msgbuf, "bvar%zu", nbin++);
          break;
       case 'c':
          vartype = SCIP_VARTYPE_CONTINUOUS;
          llb = lb[i];
          lub = ub[i];
-         sprintf(msgbuf, "xvar%zd", ncnt++);
+         sprintf(msgbuf, "xvar%zu", ncnt++);
          break;
       default:
-         sprintf(msgbuf, "Unknown variable type for variable %zd.", i);
+         sprintf(msgbuf, "Unknown variable type for variable %zu.", i);
          mexErrMsgTxt(msgbuf);
       }
 
@@ -957,6 +4044,11 @@ void mexFunction(
       SCIP_ERR( SCIPaddVar(scip, objb), "Error adding objective bias variable.");
    }
 
+   /* branching priorities, directions and factors (kept for all solves of reoptobj) */
+   if ( nrhs > optsEntry )
+      setBranchingHints(scip, OPTS, vars, ndec);
+   addBuildTime(buildtime, eBuildVariables, &tphase);
+
    /* add quadratic objective (as quadratic constraint 0.5x'Hx - qobj = 0, and min(x) f'x + qobj, if exists) */
    if ( ! mxIsEmpty(prhs[eH]) )
    {
@@ -980,21 +4072,25 @@ void mexFunction(
 #endif
 
       /* Begin processing Hessian (note we expect the full H, not lower/upper triangular - to allow for non-convex and other not-nice problems) */
+      initMatrixColumns(&matcols, prhs[eH]);
+      nterms = 0;
       for (i = 0; i < ndec; i++)
       {
-         /* Determine number of nz in this column */
-         startRow = H_jc[i];
-         stopRow = H_jc[i+1];
-         no = (int)(stopRow - startRow);
+         /* get nz in this column */
+         nnz = getMatrixColumn(&matcols, i, &rows, &vals);
 
          /* if we have nz in this column */
-         if ( no > 0 )
+         if ( nnz > 0 )
          {
+            /* each coefficient becomes a term of the quadratic objective constraint */
+            nterms += nnz;
+            CheckIntSize(nterms, "quadratic objective terms");
+
             /* add each coefficient */
-            for (j = startRow; j < stopRow; j++)
+            for (j = 0; j < nnz; j++)
             {
                /* check for squared term, or bilinear */
-               if ( i == H_ir[j] )
+               if ( i == rows[j] )
                {
                   /* diagonal */
 #if ( SCIP_VERSION >= 800 || ( SCIP_VERSION < 800 && SCIP_APIVERSION >= 100 ) )
@@ -1004,12 +4100,12 @@ void mexFunction(
                   SCIP_ERR( SCIPcreateExprVar(scip, &varexpr, vars[i], NULL, NULL) , "Error creating expression.");
                   SCIP_ERR( SCIPcreateExprPow(scip, &sqrexpr, varexpr, 2.0, NULL, NULL), "Error creating expression." );
 
-                  SCIP_ERR( SCIPaddExprNonlinear(scip, qobjc, sqrexpr, 0.5 * H[j]), "Error creating expression." );
+                  SCIP_ERR( SCIPaddExprNonlinear(scip, qobjc, sqrexpr, 0.5 * vals[j]), "Error creating expression." );
 
                   SCIP_ERR( SCIPreleaseExpr(scip, &sqrexpr), "Error releasing expression.");
                   SCIP_ERR( SCIPreleaseExpr(scip, &varexpr), "Error releasing expression.");
 #else
-                  SCIP_ERR( SCIPaddSquareCoefQuadratic(scip, qobjc, vars[i], 0.5 * H[j]), "Error adding quadratic squared term.");
+                  SCIP_ERR( SCIPaddSquareCoefQuadratic(scip, qobjc, vars[i], 0.5 * vals[j]), "Error adding quadratic squared term.");
 #endif
                }
                else
@@ -1018,71 +4114,78 @@ void mexFunction(
                   SCIP_EXPR* varexprs[2];
                   SCIP_EXPR* prodexpr;
 
-                  SCIP_ERR( SCIPcreateExprVar(scip, &varexprs[0], vars[H_ir[j]], NULL, NULL), "Error creating expression.");
+                  SCIP_ERR( SCIPcreateExprVar(scip, &varexprs[0], vars[rows[j]], NULL, NULL), "Error creating expression.");
                   SCIP_ERR( SCIPcreateExprVar(scip, &varexprs[1], vars[i], NULL, NULL), "Error creating expression.");
                   SCIP_ERR( SCIPcreateExprProduct(scip, &prodexpr, 2, varexprs, 1.0, NULL, NULL), "Error creating expression.");
 
-                  SCIP_ERR( SCIPaddExprNonlinear(scip, qobjc, prodexpr, 0.5 * H[j]), "Error creating expression.");
+                  SCIP_ERR( SCIPaddExprNonlinear(scip, qobjc, prodexpr, 0.5 * vals[j]), "Error creating expression.");
 
                   SCIP_ERR( SCIPreleaseExpr(scip, &prodexpr), "Error releasing expression.");
                   SCIP_ERR( SCIPreleaseExpr(scip, &varexprs[1]), "Error releasing expression.");
                   SCIP_ERR( SCIPreleaseExpr(scip, &varexprs[0]), "Error releasing expression.");
 #else
-                  SCIP_ERR( SCIPaddBilinTermQuadratic(scip, qobjc, vars[H_ir[j]], vars[i], 0.5 * H[j]), "Error adding quadratic bilinear term.");
+                  SCIP_ERR( SCIPaddBilinTermQuadratic(scip, qobjc, vars[rows[j]], vars[i], 0.5 * vals[j]), "Error adding quadratic bilinear term.");
 #endif
                }
             }
          }
       }
 
+      freeMatrixColumns(&matcols);
+
       /* add the quadratic constraint, then release it */
       SCIP_ERR( SCIPaddCons(scip, qobjc), "Error adding quadratic objective constraint.");
       SCIP_ERR( SCIPreleaseCons(scip, &qobjc), "Error releaseing quadratic objective constraint.");
    }
+   addBuildTime(buildtime, eBuildQuadratic, &tphase);
 
    /* add linear constraints (if they exist) */
    if ( ncon )
    {
       /* allocate memory for all constraints (we create them all now, as we have to add coefficients in column order) */
-      SCIP_ERR( SCIPallocMemoryArray(scip, &cons, (int)ncon), "Error allocating constraint memory.");
+      SCIP_ERR( SCIPallocMemoryArray(scip, &cons, ncon), "Error allocating constraint memory.");
 
       /* create each constraint and add row bounds, but leave coefficients empty */
       for (i = 0; i < ncon; i++)
       {
-         (void) SCIPsnprintf(msgbuf, BUFSIZE, "lincon%d", i);
+         (void) SCIPsnprintf(msgbuf, BUFSIZE, "lincon%zu", i);
          SCIP_ERR( SCIPcreateConsBasicLinear(scip, &cons[i], msgbuf, 0, NULL, NULL, lhs[i], rhs[i]), "Error creating basic SCIP linear constraint.");
       }
 
       /* now for each column (variable), add coefficients */
+      initMatrixColumns(&matcols, prhs[eA]);
       for (i = 0; i < ndec; i++)
       {
-         /* determine number of nz in this column */
-         startRow = A_jc[i];
-         stopRow = A_jc[i+1];
-         no = (int)(stopRow - startRow);
+         /* get nz in this column */
+         nnz = getMatrixColumn(&matcols, i, &rows, &vals);
 
-         /* if we have nz in this column */
-         if ( no > 0 )
-         {
-            /* add each coefficient */
-            for (j = startRow; j < stopRow; j++)
-               SCIP_ERR( SCIPaddCoefLinear(scip, cons[A_ir[j]], vars[i], A[j]), "Error adding constraint linear coefficient.");
-         }
+         /* add each coefficient */
+         for (j = 0; j < nnz; j++)
+            SCIP_ERR( SCIPaddCoefLinear(scip, cons[rows[j]], vars[i], vals[j]), "Error adding constraint linear coefficient.");
+      }
+      freeMatrixColumns(&matcols);
+
+      /* columns from a MATLAB function get coefficients in these constraints (made modifiable) */
+      if ( pricecb != NULL )
+      {
+         SCIP_ERR( SCIPincludePricerMatlabColumns(scip, pricecb, cons, (int) ncon), "Error adding pricer.");
       }
 
-      /* now for each constraint, add it to the problem, then release it */
+      /* now for each constraint, add it to the problem, then release it (row labels need it until the decomposition is added) */
       for (i = 0; i < ncon; i++)
       {
          SCIP_ERR( SCIPaddCons(scip, cons[i]), "Error adding linear constraint.");
-         SCIP_ERR( SCIPreleaseCons(scip, &cons[i]), "Error releasing linear constraint.");
+         if ( rowlabels == NULL )
+            SCIP_ERR( SCIPreleaseCons(scip, &cons[i]), "Error releasing linear constraint.");
       }
    }
+   addBuildTime(buildtime, eBuildLinear, &tphase);
 
    /* add SOS Constraints (if they exist) */
    if ( nrhs > eSOS && ! mxIsEmpty(prhs[eSOS]) )
    {
       /* determine the number of SOS to add */
-      size_t no_sets = (int)mxGetNumberOfElements(mxGetField(prhs[eSOS], 0, "type"));
+      size_t no_sets = mxGetNumberOfElements(mxGetField(prhs[eSOS], 0, "type"));
 
       if ( no_sets > 0 )
       {
@@ -1091,28 +4194,32 @@ void mexFunction(
 
          /* for each SOS constraint, create respective constraint, add it, then release it */
          SCIP_CONS* consos = NULL;
+         const mxArray* sosidxarr;
+         const mxArray* soswtarr;
          size_t novars;
+         int aind;
+         int awt;
 
          for (i = 0; i < no_sets; i++)
          {
             /* create constraint name */
-            (void) SCIPsnprintf(msgbuf, BUFSIZE, "soscon%d", i);
+            (void) SCIPsnprintf(msgbuf, BUFSIZE, "soscon%zu", i);
 
             /* Collect novars + ind + wt */
-            if ( mxIsCell(mxGetField(prhs[eSOS], 0, "index")) )
-            {
-               novars = (int)mxGetNumberOfElements(mxGetCell(mxGetField(prhs[eSOS], 0, "index"), i));
-               sosind = mxGetPr(mxGetCell(mxGetField(prhs[eSOS], 0, "index"), i));
-            }
-            else
+            sosidxarr = mxGetField(prhs[eSOS], 0, "index");
+            if ( mxIsCell(sosidxarr) )
+               sosidxarr = mxGetCell(sosidxarr, i);
+            soswtarr = mxGetField(prhs[eSOS], 0, "weight");
+            if ( mxIsCell(soswtarr) )
+               soswtarr = mxGetCell(soswtarr, i);
+
+            sosind = getIndexData(sosidxarr, ndec, &novars, &aind);
+            soswt = getDoubleData(soswtarr, &awt);
+            if ( mxGetNumberOfElements(soswtarr) != novars )
             {
-               novars = (int)mxGetNumberOfElements(mxGetField(prhs[eSOS], 0, "index"));
-               sosind = mxGetPr(mxGetField(prhs[eSOS], 0, "index"));
+               sprintf(msgbuf, "The number of weights of SOS %zu does not match its number of indices.", i);
+               mexErrMsgTxt(msgbuf);
             }
-            if ( mxIsCell(mxGetField(prhs[eSOS], 0, "weight")) ) /* should check here soswt is the same length */
-               soswt = mxGetPr(mxGetCell(mxGetField(prhs[eSOS], 0, "weight"), i));
-            else
-               soswt = mxGetPr(mxGetField(prhs[eSOS], 0, "weight"));
 
             /* switch based on SOS type */
             switch ( sostype[i] )
@@ -1123,7 +4230,7 @@ void mexFunction(
 
                /* for each variable, add to SOS constraint */
                for (j = 0; j < novars; j++)
-                  SCIP_ERR( SCIPaddVarSOS1(scip, consos, vars[(int)sosind[j]-1], soswt[j]), "Error adding SOS1 constraint."); /* remember -1 for Matlab indicies */
+                  SCIP_ERR( SCIPaddVarSOS1(scip, consos, vars[(size_t)sosind[j]-1], soswt[j]), "Error adding SOS1 constraint."); /* remember -1 for Matlab indicies */
                break;
 
             case '2':
@@ -1132,54 +4239,56 @@ void mexFunction(
 
                /* for each variable, add to SOS constraint */
                for (j = 0; j < novars; j++)
-                  SCIP_ERR( SCIPaddVarSOS2(scip, consos, vars[(int)sosind[j]-1], soswt[j]), "Error adding SOS2 constraint."); /* remember -1 for Matlab indicies */
+                  SCIP_ERR( SCIPaddVarSOS2(scip, consos, vars[(size_t)sosind[j]-1], soswt[j]), "Error adding SOS2 constraint."); /* remember -1 for Matlab indicies */
                break;
 
             default:
-               sprintf(msgbuf, "Uknown SOS Type for SOS %zd", i);
+               sprintf(msgbuf, "Uknown SOS Type for SOS %zu", i);
                mexErrMsgTxt(msgbuf);
             }
 
+            if ( aind )
+               mxFree(sosind);
+            if ( awt )
+               mxFree(soswt);
+
             /* add the constraint to the problem, then release it */
             SCIP_ERR( SCIPaddCons(scip,consos), "Error adding SOS constraint.");
             SCIP_ERR( SCIPreleaseCons(scip, &consos), "Error releasing SOS constraint.");
          }
       }
    }
+   addBuildTime(buildtime, eBuildSOS, &tphase);
 
    /* add Quadratic Constraints (if they exist) */
    if ( nrhs > eQC && ! mxIsEmpty(prhs[eQC]) )
    {
       /* determine the number of constraints to add */
-      size_t no_qc = (int)mxGetNumberOfElements(mxGetField(prhs[eQC], 0, "qrl"));
+      size_t no_qc = mxGetNumberOfElements(mxGetField(prhs[eQC], 0, "qrl"));
 
       if ( no_qc > 0 )
       {
-         /* Collect l and r */
-         l = mxGetPr(mxGetField(prhs[eQC], 0, "l"));
-         qrl = mxGetPr(mxGetField(prhs[eQC], 0, "qrl"));
-         qru = mxGetPr(mxGetField(prhs[eQC], 0, "qru"));
+         /* Collect l (column-wise) and r */
+         MatrixColumns lcols;
+         int aqrl;
+         int aqru;
+
+         initMatrixColumns(&lcols, mxGetField(prhs[eQC], 0, "l"));
+         qrl = getDoubleData(mxGetField(prhs[eQC], 0, "qrl"), &aqrl);
+         qru = getDoubleData(mxGetField(prhs[eQC], 0, "qru"), &aqru);
 
          /* for each QC, create respective constraint, add it, then release it */
          SCIP_CONS *conqc = NULL;
          for (i = 0; i < no_qc; i++)
          {
             /* create constraint name */
-            (void) SCIPsnprintf(msgbuf, BUFSIZE, "qccon%d", i);
+            (void) SCIPsnprintf(msgbuf, BUFSIZE, "qccon%zu", i);
 
             /* collect Q */
             if ( mxIsCell(mxGetField(prhs[eQC], 0, "Q")))
-            {
-               Q = mxGetPr(mxGetCell(mxGetField(prhs[eQC], 0, "Q"), i));
-               Q_ir = mxGetIr(mxGetCell(mxGetField(prhs[eQC], 0, "Q"), i));
-               Q_jc = mxGetJc(mxGetCell(mxGetField(prhs[eQC], 0, "Q"), i));
-            }
+               initMatrixColumns(&matcols, mxGetCell(mxGetField(prhs[eQC], 0, "Q"), i));
             else
-            {
-               Q = mxGetPr(mxGetField(prhs[eQC], 0, "Q"));
-               Q_ir = mxGetIr(mxGetField(prhs[eQC], 0, "Q"));
-               Q_jc = mxGetJc(mxGetField(prhs[eQC], 0, "Q"));
-            }
+               initMatrixColumns(&matcols, mxGetField(prhs[eQC], 0, "Q"));
 
             /* collect bounds */
             double lqrl;
@@ -1194,35 +4303,38 @@ void mexFunction(
             SCIP_ERR( SCIPcreateConsBasicQuadratic(scip, &conqc, msgbuf, 0, NULL, NULL, 0, NULL, NULL, NULL, lqrl, lqru), "Error creating quadratic constraint.");
 #endif
 
-            /* add linear terms */
-            for (j = 0; j < ndec; j++)
+            /* add linear terms (column i of l) */
+            nnz = getMatrixColumn(&lcols, i, &rows, &vals);
+            for (j = 0; j < nnz; j++)
             {
-               if ( ! SCIPisFeasZero(scip, l[j+i*ndec]) )
+               if ( ! SCIPisFeasZero(scip, vals[j]) )
                {
 #if ( SCIP_VERSION >= 800 || ( SCIP_VERSION < 800 && SCIP_APIVERSION >= 100 ) )
-                  SCIP_ERR( SCIPaddLinearVarNonlinear(scip, conqc, vars[j], l[j+i*ndec]), "Error adding quadratic objective linear term.");
+                  SCIP_ERR( SCIPaddLinearVarNonlinear(scip, conqc, vars[rows[j]], vals[j]), "Error adding quadratic objective linear term.");
 #else
-                  SCIP_ERR( SCIPaddLinearVarQuadratic(scip, conqc, vars[j], l[j+i*ndec]), "Error adding quadratic objective linear term.");
+                  SCIP_ERR( SCIPaddLinearVarQuadratic(scip, conqc, vars[rows[j]], vals[j]), "Error adding quadratic objective linear term.");
 #endif
                }
             }
 
             /* begin processing Q (note we expect the full Q, not lower/upper triangular - to allow for non-convex problems) */
+            nterms = 0;
             for (k = 0; k < ndec; k++)
             {
-               /* determine number of nz in this column */
-               startRow = Q_jc[k];
-               stopRow = Q_jc[k+1];
-               no = (int)(stopRow - startRow);
+               /* get nz in this column */
+               nnz = getMatrixColumn(&matcols, k, &rows, &vals);
 
                /* if we have nz in this column */
-               if ( no > 0 )
+               if ( nnz > 0 )
                {
+                  nterms += nnz;
+                  CheckIntSize(nterms, "quadratic constraint terms");
+
                   /* add each coefficient */
-                  for (j = startRow; j < stopRow; j++)
+                  for (j = 0; j < nnz; j++)
                   {
                      /* check for squared term, or bilinear */
-                     if ( k == Q_ir[j] )
+                     if ( k == rows[j] )
                      {
                         /* diagonal */
 #if ( SCIP_VERSION >= 800 || ( SCIP_VERSION < 800 && SCIP_APIVERSION >= 100 ) )
@@ -1232,12 +4344,12 @@ void mexFunction(
                         SCIP_ERR( SCIPcreateExprVar(scip, &varexpr, vars[k], NULL, NULL) , "Error creating expression.");
                         SCIP_ERR( SCIPcreateExprPow(scip, &sqrexpr, varexpr, 2.0, NULL, NULL), "Error creating expression." );
 
-                        SCIP_ERR( SCIPaddExprNonlinear(scip, conqc, sqrexpr, Q[j]), "Error creating expression." );
+                        SCIP_ERR( SCIPaddExprNonlinear(scip, conqc, sqrexpr, vals[j]), "Error creating expression." );
 
                         SCIP_ERR( SCIPreleaseExpr(scip, &sqrexpr), "Error releasing expression.");
                         SCIP_ERR( SCIPreleaseExpr(scip, &varexpr), "Error releasing expression.");
 #else
-                        SCIP_ERR( SCIPaddSquareCoefQuadratic(scip, conqc, vars[k], Q[j]), "Error adding quadratic constraint squared term.");
+                        SCIP_ERR( SCIPaddSquareCoefQuadratic(scip, conqc, vars[k], vals[j]), "Error adding quadratic constraint squared term.");
 #endif
                      }
                      else
@@ -1246,29 +4358,38 @@ void mexFunction(
                         SCIP_EXPR* varexprs[2];
                         SCIP_EXPR* prodexpr;
 
-                        SCIP_ERR( SCIPcreateExprVar(scip, &varexprs[0], vars[Q_ir[j]], NULL, NULL), "Error creating expression.");
+                        SCIP_ERR( SCIPcreateExprVar(scip, &varexprs[0], vars[rows[j]], NULL, NULL), "Error creating expression.");
                         SCIP_ERR( SCIPcreateExprVar(scip, &varexprs[1], vars[k], NULL, NULL), "Error creating expression.");
                         SCIP_ERR( SCIPcreateExprProduct(scip, &prodexpr, 2, varexprs, 1.0, NULL, NULL), "Error creating expression.");
 
-                        SCIP_ERR( SCIPaddExprNonlinear(scip, conqc, prodexpr, Q[j]), "Error creating expression.");
+                        SCIP_ERR( SCIPaddExprNonlinear(scip, conqc, prodexpr, vals[j]), "Error creating expression.");
 
                         SCIP_ERR( SCIPreleaseExpr(scip, &prodexpr), "Error releasing expression.");
                         SCIP_ERR( SCIPreleaseExpr(scip, &varexprs[1]), "Error releasing expression.");
                         SCIP_ERR( SCIPreleaseExpr(scip, &varexprs[0]), "Error releasing expression.");
 #else
-                        SCIP_ERR( SCIPaddBilinTermQuadratic(scip, conqc, vars[Q_ir[j]], vars[k], Q[j]), "Error adding quadratic constraint bilinear term.");
+                        SCIP_ERR( SCIPaddBilinTermQuadratic(scip, conqc, vars[rows[j]], vars[k], vals[j]), "Error adding quadratic constraint bilinear term.");
 #endif
                      }
                   }
                }
             }
 
+            freeMatrixColumns(&matcols);
+
             /* add the constraint to the problem, then release it */
             SCIP_ERR( SCIPaddCons(scip,conqc), "Error adding quadratic constraint");
             SCIP_ERR( SCIPreleaseCons(scip,&conqc), "Error releasing quadratic constraint");
          }
+
+         freeMatrixColumns(&lcols);
+         if ( aqrl )
+            mxFree(qrl);
+         if ( aqru )
+            mxFree(qru);
       }
    }
+   addBuildTime(buildtime, eBuildQuadratic, &tphase);
 
    /* add nonlinear constraints and / or objective (if they exist) */
    if ( nrhs > eNLCON && ! mxIsEmpty(prhs[eNLCON]) )
@@ -1340,13 +4461,13 @@ void mexFunction(
                   err = REALABS(cval - conval[i]);
                   if ( SCIPisFeasPositive(scip, err) )
                   {
-                     sprintf(msgbuf, "Failed validation test on nonlinear constraint #%zd, difference: %1.6g", i, err);
+                     sprintf(msgbuf, "Failed validation test on nonlinear constraint #%zu, difference: %1.6g", i, err);
                      mexWarnMsgTxt(msgbuf);
                      ts = 0;
                   }
 #ifdef DEBUG
                   else
-                     mexPrintf("-- Passed validation test on nonlinear constraint #%d --\n", i);
+                     mexPrintf("-- Passed validation test on nonlinear constraint #%zu --\n", i);
 #endif
                }
             }
@@ -1406,21 +4527,87 @@ void mexFunction(
       }
    }
 
-   /* process primal solution (if it exits) */
+   addBuildTime(buildtime, eBuildNonlinear, &tphase);
+
+   /* block structure known to the user, e.g., for the GINS and PADM heuristics */
+   if ( rowlabels != NULL || varlabels != NULL )
+      addDecomposition(scip, rowlabels, varlabels, cons, ncon, vars, ndec, plhs[3]);
+   if ( rowlabels != NULL )
+   {
+      for (i = 0; i < ncon; i++)
+         SCIP_ERR( SCIPreleaseCons(scip, &cons[i]), "Error releasing linear constraint.");
+   }
+
+   if ( buildtimes )
+      setBuildTimeStats(plhs[3], buildtime);
+
+   /* enable reoptimization and set the first objective (only possible before the problem is transformed) */
+   if ( reoptobj != NULL )
+   {
+      SCIP_ERR( SCIPenableReoptimization(scip, TRUE), "Error enabling reoptimization.");
+      changeReoptObjective(scip, vars, mxGetPr(reoptobj), ndec);
+   }
+
+   /* process primal solutions (if they exist): one per column, NaN entries are completed by SCIP */
    if ( nrhs > eX0 && ! mxIsEmpty(prhs[eX0]) )
    {
       SCIP_SOL* sol;
       SCIP_Bool stored;
+      SCIP_VAR** solvars;
+      SCIP_Real* solvals;
+      size_t nx0 = mxGetNumberOfElements(prhs[eX0]) / ndec;
+      int ax0;
 
-      x0 = mxGetPr(prhs[eX0]);
+      x0 = getDoubleData(prhs[eX0], &ax0);
       assert( x0 != NULL );
-      SCIP_ERR( SCIPcreateSol(scip, &sol, NULL), "Error creating empty solution");
+      SCIP_ERR( SCIPallocMemoryArray(scip, &solvars, ndec), "Error allocating solution memory.");
+      SCIP_ERR( SCIPallocMemoryArray(scip, &solvals, ndec), "Error allocating solution memory.");
 
-      for (i = 0; i < ndec; i++)
+      for (size_t k = 0; k < nx0; k++)
       {
-         SCIP_ERR( SCIPsetSolVal(scip, sol, vars[i], x0[i]), "Error creating setting solution value");
+         const double* x0k = x0 + k * ndec;
+         int nsolvals = 0;
+
+         /* collect the given values */
+         for (i = 0; i < ndec; i++)
+         {
+            if ( ! mxIsNaN(x0k[i]) )
+            {
+               solvars[nsolvals] = vars[i];
+               solvals[nsolvals++] = x0k[i];
+            }
+         }
+
+         /* a partial solution is completed by the completesol heuristic */
+         if ( (size_t) nsolvals < ndec )
+         {
+            SCIP_ERR( SCIPcreatePartialSol(scip, &sol, NULL), "Error creating partial solution");
+         }
+         else
+         {
+            SCIP_ERR( SCIPcreateSol(scip, &sol, NULL), "Error creating empty solution");
+         }
+         SCIP_ERR( SCIPsetSolVals(scip, sol, nsolvals, solvars, solvals), "Error setting solution values");
+         SCIP_ERR( SCIPaddSolFree(scip, &sol, &stored), "Error adding solution" );
       }
-      SCIP_ERR( SCIPaddSolFree(scip, &sol, &stored), "Error adding solution" );
+
+      SCIPfreeMemoryArray(scip, &solvals);
+      SCIPfreeMemoryArray(scip, &solvars);
+      if ( ax0 )
+         mxFree(x0);
+   }
+
+   /* lazy constraints from a MATLAB function (disables reductions that need all constraints, see solverOpts) */
+   if ( lazycb != NULL )
+   {
+      SCIP_ERR( SCIPincludeConshdlrMatlabLazy(scip, lazycb, vars, (int) ndec), "Error adding lazy constraint handler.");
+   }
+
+   /* cutting planes from a MATLAB function (SCIP's parameters separating/matlabcuts/... can be set in solverOpts) */
+   if ( cutcb != NULL )
+   {
+      SCIP_ERR( SCIPincludeSepaMatlabCuts(scip, cutcb, vars, (int) ndec, cutfreq, cutmaxdepth, cutminefficacy,
+            cutmaxround, cutpool != 0), "Error adding cut separator.");
    }
 
    /* process advanced user options (if they exist) */
@@ -1429,9 +4616,8 @@ void mexFunction(
       /* emphasis settings */
       /* processEmphasisOptions(scip, OPTS); */
 
-      /* process specific options (overriding emphasis options) */
-      if ( mxGetField(OPTS, 0, "solverOpts") )
-         processUserOpts(scip, mxGetField(OPTS, 0, "solverOpts"));
+      /* process parameter file, profile and specific options (overriding emphasis options) */
+      applySolverOpts(scip, OPTS);
    }
 
    /* possibly write file */
@@ -1440,59 +4626,100 @@ void mexFunction(
       SCIP_ERR( SCIPwriteOrigProblem(scip, probfile, NULL, FALSE), "Error writing file.");
    }
 
-   /* possibly write presolved file */
-   if ( strlen(presolvedfile) > 0 )
+   /* possibly write presolved file and/or store presolved problem in the cache */
+   if ( strlen(presolvedfile) > 0 || strlen(cachefile) > 0 )
    {
       /* presolve first */
       SCIP_ERR( SCIPpresolve(scip), "Error presolving SCIP problem!");
 
       /* now write */
-      SCIP_ERR( SCIPwriteTransProblem(scip, presolvedfile, NULL, FALSE), "Error writing presolved file.");
+      if ( strlen(presolvedfile) > 0 )
+      {
+         SCIP_ERR( SCIPwriteTransProblem(scip, presolvedfile, NULL, FALSE), "Error writing presolved file.");
+      }
+
+      /* do not cache problems that were already solved or interrupted during presolving */
+      if ( strlen(cachefile) > 0 && SCIPgetStage(scip) == SCIP_STAGE_PRESOLVED )
+         writePresolveCache(scip, cachefile);
    }
 
+   /* only presolve: return the sizes (and possibly the matrices) of the presolved problem */
+   if ( tm == 0 && presolveonly )
+   {
+      SCIP_ERR( SCIPpresolve(scip), "Error presolving SCIP problem!");
+
+      /* x is kept at 0, a solution exists only if presolving solved the problem */
+      exitflag[0] = (double)SCIPgetStatus(scip);
+      fval[0] = std::numeric_limits<double>::quiet_NaN();
+      gap[0] = std::numeric_limits<double>::infinity();
+      pbound[0] = std::numeric_limits<double>::quiet_NaN();
+      dbound[0] = std::numeric_limits<double>::quiet_NaN();
+      setPresolveStats(scip, plhs[3], presolvematrices != 0);
+   }
    /* solve problem if not in testing mode */
-   if ( tm == 0 )
+   else if ( tm == 0 )
    {
-      SCIP_RETCODE rc = SCIPsolve(scip);
+      /* one stop reason per solve */
+      mxAddField(plhs[3], "StopReason");
+      if ( nsolves > 1 )
+         mxSetField(plhs[3], 0, "StopReason", mxCreateCellMatrix(1, nsolves));
 
-      if ( rc != SCIP_OKAY )
+      /* with reoptimization, solve once per objective, reusing the search information of the previous solves */
+      for (k = 0; k < nsolves; k++)
       {
-         /* clean up general SCIP memory (if possible) */
-         SCIPfree(&scip);
+         if ( k > 0 )
+         {
+            SCIP_ERR( SCIPfreeReoptSolve(scip), "Error freeing reoptimization solve.");
+            changeReoptObjective(scip, vars, mxGetPr(reoptobj) + k * ndec, ndec);
+         }
 
-         /* display error */
-         sprintf(msgbuf, "Error Solving SCIP Problem, Error: %s (Code: %d)", scipErrCode(rc), rc);
-         mexErrMsgTxt(msgbuf);
-      }
+         SCIP_Bool deadline = setSolveLimits(scip, nrhs > optsEntry ? OPTS : NULL);
+         SCIP_RETCODE rc = SCIPsolve(scip);
 
-      /* assign return arguments */
-      if ( SCIPgetNSols(scip) > 0 )
-      {
-         SCIP_SOL* scipbestsol = SCIPgetBestSol(scip);
+         if ( rc != SCIP_OKAY )
+         {
+            /* clean up general SCIP memory (if possible) */
+            SCIPfree(&scip);
 
-         /* assign x */
-         for (i = 0; i < ndec; i++)
-            x[i] = SCIPgetSolVal(scip, scipbestsol, vars[i]);
+            /* display error, preferring the error of a MATLAB callback */
+            if ( ! SCIPgetMatlabCallbackError(msgbuf, BUFSIZE) )
+               sprintf(msgbuf, "Error Solving SCIP Problem, Error: %s (Code: %d)", scipErrCode(rc), rc);
+            mexErrMsgTxt(msgbuf);
+         }
+
+         /* assign return arguments */
+         if ( SCIPgetNSols(scip) > 0 )
+         {
+            SCIP_SOL* scipbestsol = SCIPgetBestSol(scip);
 
-         /* assign fval */
-         *fval = SCIPgetSolOrigObj(scip, scipbestsol);
+            /* assign x */
+            for (i = 0; i < ndec; i++)
+               x[k * ndec + i] = SCIPgetSolVal(scip, scipbestsol, vars[i]);
 
-         /* get solve statistics */
-         *iter = (double)SCIPgetNLPIterations(scip);
-         *nodes = (double)SCIPgetNTotalNodes(scip);
-         *gap = SCIPgetGap(scip);
-         *pbound = SCIPgetPrimalbound(scip);
-         *dbound = SCIPgetDualbound(scip);
-      }
-      else /* no solution found */
-      {
-         *fval = std::numeric_limits<double>::quiet_NaN();
-         *gap = std::numeric_limits<double>::infinity();
-         *pbound = std::numeric_limits<double>::quiet_NaN();
-      }
+            /* assign fval */
+            fval[k] = SCIPgetSolOrigObj(scip, scipbestsol);
 
-      /* get solution status */
-      *exitflag = (double)SCIPgetStatus(scip);
+            /* get solve statistics */
+            iter[k] = (double)SCIPgetNLPIterations(scip);
+            nodes[k] = (double)SCIPgetNTotalNodes(scip);
+            gap[k] = SCIPgetGap(scip);
+            pbound[k] = SCIPgetPrimalbound(scip);
+            dbound[k] = SCIPgetDualbound(scip);
+         }
+         else /* no solution found */
+         {
+            fval[k] = std::numeric_limits<double>::quiet_NaN();
+            gap[k] = std::numeric_limits<double>::infinity();
+            pbound[k] = std::numeric_limits<double>::quiet_NaN();
+         }
+
+         /* get solution status */
+         exitflag[k] = (double)SCIPgetStatus(scip);
+         if ( nsolves > 1 )
+            mxSetCell(mxGetField(plhs[3], 0, "StopReason"), k, mxCreateString(getStopReason(scip, nrhs > optsEntry ? OPTS : NULL, deadline)));
+         else
+            mxSetField(plhs[3], 0, "StopReason", mxCreateString(getStopReason(scip, nrhs > optsEntry ? OPTS : NULL, deadline)));
+      }
    }
    /* else return test status */
    else
@@ -1500,9 +4727,20 @@ void mexFunction(
       *x = ts;
    }
 
+   if ( lazycb != NULL )
+      setLazyStats(scip, plhs[3]);
+   if ( cutcb != NULL )
+      setCutStats(scip, plhs[3]);
+   if ( pricecb != NULL )
+      setPriceStats(scip, plhs[3]);
+
    /* clean up memory from MATLAB mode */
    mxFree(xtype);
 
+   if ( af )
+      mxFree(f);
+   af = 0;
+
    if ( alhs )
       mxFree(lhs);
    alhs = 0;
@@ -18,6 +18,12 @@
 #include "scip/scipdefplugins.h"
 #include "mex.h"
 #include "scipnlmex.h"
+#include "opti_build_utils.h"
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
 
 /* enable for debugging: */
 /* #define DEBUG 1 */
@@ -34,6 +40,9 @@ static char msgbuf[BUFSIZE];
 /* error catching macro */
 #define SCIP_ERR(rc,msg) if ( rc != SCIP_OKAY ) { snprintf(msgbuf, BUFSIZE, "%s, Error Code: %d", msg, rc); mexErrMsgTxt(msgbuf);}
 
+/* whether affine and quadratic instruction lists are added as linear or quadratic constraints */
+static bool quadraticdetection = true;
+
 
 /** print state for debugging */
 static
@@ -61,6 +70,343 @@ enum {EMPTY=-2,READ,NUM,VAR,EXP,MUL,DIV,ADD,SUB,SQUARE,SQRT,POW,EXPNT,LOG,SIN,CO
 const int OTHER = 98, EXIT = 99;
 
 
+/** polynomial of degree at most two: constant + sum lin_i x_i + sum quad_ij x_i x_j */
+struct QuadPoly
+{
+   double                constant;           /**< constant term */
+   std::map<int, double> lin;                /**< linear coefficients */
+   std::map<std::pair<int, int>, double> quad; /**< quadratic coefficients (i <= j) */
+
+   QuadPoly() : constant(0.0) {}
+
+   /** degree of polynomial */
+   int degree() const
+   {
+      return ! quad.empty() ? 2 : (! lin.empty() ? 1 : 0);
+   }
+};
+
+/** p = p + scale * q */
+static
+void polyAdd(
+   QuadPoly&             p,                  /**< polynomial to add to */
+   const QuadPoly&       q,                  /**< polynomial to add */
+   double                scale               /**< scaling factor of q */
+   )
+{
+   p.constant += scale * q.constant;
+   for (std::map<int, double>::const_iterator it = q.lin.begin(); it != q.lin.end(); ++it)
+      p.lin[it->first] += scale * it->second;
+   for (std::map<std::pair<int, int>, double>::const_iterator it = q.quad.begin(); it != q.quad.end(); ++it)
+      p.quad[it->first] += scale * it->second;
+}
+
+/** compute p * q, returns false if the result has degree larger than two */
+static
+bool polyMul(
+   const QuadPoly&       p,                  /**< first factor */
+   const QuadPoly&       q,                  /**< second factor */
+   QuadPoly&             r                   /**< result */
+   )
+{
+   if ( p.degree() + q.degree() > 2 )
+      return false;
+
+   r = QuadPoly();
+   polyAdd(r, q, p.constant);
+   polyAdd(r, p, q.constant);
+   r.constant -= p.constant * q.constant; /* counted twice */
+
+   for (std::map<int, double>::const_iterator it = p.lin.begin(); it != p.lin.end(); ++it)
+   {
+      for (std::map<int, double>::const_iterator jt = q.lin.begin(); jt != q.lin.end(); ++jt)
+      {
+         std::pair<int, int> key(MIN(it->first, jt->first), MAX(it->first, jt->first));
+         r.quad[key] += it->second * jt->second;
+      }
+   }
+
+   return true;
+}
+
+/** classify instruction list as polynomial of degree at most two
+ *
+ *  The instruction list is interpreted in postfix order, where a binary operation with argument 1 has its operands
+ *  flipped (e.g., "exp; NUM 2; SUB 1" is 2 - exp). Returns false if the list contains other operations, or a product
+ *  or power of degree larger than two.
+ */
+static
+bool classifyQuadratic(
+   const double*         instr,              /**< array of instructions */
+   size_t                no_instr,           /**< number of instructions */
+   int                   nvars,              /**< number of variables */
+   QuadPoly&             result              /**< resulting polynomial */
+   )
+{
+   std::vector<QuadPoly> stack;
+
+   if ( no_instr == 0 || no_instr % 2 != 0 )
+      return false;
+
+   for (size_t i = 0; i < no_instr; i += 2)
+   {
+      int op = (int) instr[i];
+      double arg = instr[i+1];
+
+      switch ( op )
+      {
+      case NUM:
+         stack.push_back(QuadPoly());
+         stack.back().constant = arg;
+         break;
+
+      case VAR:
+         if ( arg < 0 || arg >= nvars )
+            return false;
+         stack.push_back(QuadPoly());
+         stack.back().lin[(int) arg] = 1.0;
+         break;
+
+      case SQUARE:
+      {
+         QuadPoly r;
+         if ( stack.empty() || ! polyMul(stack.back(), stack.back(), r) )
+            return false;
+         stack.back() = r;
+         break;
+      }
+
+      case ADD:
+      case SUB:
+      case MUL:
+      case DIV:
+      case POW:
+      {
+         if ( stack.size() < 2 )
+            return false;
+
+         QuadPoly b = stack.back();
+         stack.pop_back();
+         QuadPoly a = stack.back();
+         stack.pop_back();
+
+         /* flipped operands */
+         if ( arg == 1.0 )
+            std::swap(a, b);
+
+         QuadPoly r;
+         switch ( op )
+         {
+         case ADD:
+            r = a;
+            polyAdd(r, b, 1.0);
+            break;
+         case SUB:
+            r = a;
+            polyAdd(r, b, -1.0);
+            break;
+         case MUL:
+            if ( ! polyMul(a, b, r) )
+               return false;
+            break;
+         case DIV:
+            if ( b.degree() > 0 || b.constant == 0.0 )
+               return false;
+            polyAdd(r, a, 1.0 / b.constant);
+            break;
+         default: /* POW */
+            if ( b.degree() > 0 )
+               return false;
+            if ( b.constant == 0.0 )
+               r.constant = 1.0;
+            else if ( b.constant == 1.0 )
+               r = a;
+            else if ( b.constant != 2.0 || ! polyMul(a, a, r) )
+               return false;
+            break;
+         }
+         stack.push_back(r);
+         break;
+      }
+
+      default:
+         return false;
+      }
+   }
+
+   if ( stack.size() != 1 )
+      return false;
+
+   result = stack.back();
+
+   /* remove cancelled terms */
+   for (std::map<std::pair<int, int>, double>::iterator it = result.quad.begin(); it != result.quad.end(); )
+   {
+      if ( it->second == 0.0 )
+         result.quad.erase(it++);
+      else
+         ++it;
+   }
+   for (std::map<int, double>::iterator it = result.lin.begin(); it != result.lin.end(); )
+   {
+      if ( it->second == 0.0 )
+         result.lin.erase(it++);
+      else
+         ++it;
+   }
+
+   return true;
+}
+
+/** add affine or quadratic instruction list directly as linear or quadratic constraint
+ *
+ *  This avoids building expression trees for which SCIP would have to rediscover the structure. For the objective,
+ *  the affine part is added to the objective coefficients and only the quadratic part is added as a constraint
+ *  quad(x) - nlobj = 0 with objective coefficient 1 for nlobj. Returns false if the instruction list is not affine or
+ *  quadratic, in which case nothing is added.
+ */
+static
+bool addQuadraticCon(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_VAR**            vars,               /**< variable array */
+   const double*         instr,              /**< array of instructions */
+   size_t                no_instr,           /**< number of instructions */
+   double                lhs,                /**< left hand side */
+   double                rhs,                /**< right hand side */
+   const double*         xval,               /**< validation point for variables (or NULL) */
+   size_t                nlno,               /**< index of nonlinear constraint */
+   bool                  isObj,              /**< is this the objective function */
+   double*               fval                /**< value at validation point */
+   )
+{
+   QuadPoly poly;
+   SCIP_VAR** linvars;
+   SCIP_Real* lincoefs;
+   SCIP_VAR** quadvars1;
+   SCIP_VAR** quadvars2;
+   SCIP_Real* quadcoefs;
+   SCIP_CONS* cons;
+   int nlin = 0;
+   int nquad = 0;
+
+   if ( ! classifyQuadratic(instr, no_instr, SCIPgetNVars(scip), poly) )
+      return false;
+
+   /* value at validation point */
+   *fval = 0.0;
+   if ( xval != NULL )
+   {
+      *fval = poly.constant;
+      for (std::map<int, double>::const_iterator it = poly.lin.begin(); it != poly.lin.end(); ++it)
+         *fval += it->second * xval[it->first];
+      for (std::map<std::pair<int, int>, double>::const_iterator it = poly.quad.begin(); it != poly.quad.end(); ++it)
+         *fval += it->second * xval[it->first.first] * xval[it->first.second];
+   }
+
+   /* the linear part may get one extra term for the objective variable */
+   CheckIntSize(poly.lin.size() + 1, "linear terms of a quadratic expression");
+   CheckIntSize(poly.quad.size(), "quadratic terms of a quadratic expression");
+
+   SCIP_ERR( SCIPallocMemoryArray(scip, &linvars, poly.lin.size() + 1), "Error allocating linear term memory.");
+   SCIP_ERR( SCIPallocMemoryArray(scip, &lincoefs, poly.lin.size() + 1), "Error allocating linear term memory.");
+   SCIP_ERR( SCIPallocMemoryArray(scip, &quadvars1, poly.quad.size() + 1), "Error allocating quadratic term memory.");
+   SCIP_ERR( SCIPallocMemoryArray(scip, &quadvars2, poly.quad.size() + 1), "Error allocating quadratic term memory.");
+   SCIP_ERR( SCIPallocMemoryArray(scip, &quadcoefs, poly.quad.size() + 1), "Error allocating quadratic term memory.");
+
+   for (std::map<int, double>::const_iterator it = poly.lin.begin(); it != poly.lin.end(); ++it)
+   {
+      linvars[nlin] = vars[it->first];
+      lincoefs[nlin++] = it->second;
+   }
+   for (std::map<std::pair<int, int>, double>::const_iterator it = poly.quad.begin(); it != poly.quad.end(); ++it)
+   {
+      quadvars1[nquad] = vars[it->first.first];
+      quadvars2[nquad] = vars[it->first.second];
+      quadcoefs[nquad++] = it->second;
+   }
+
+   if ( isObj )
+   {
+      /* affine part goes directly into the objective */
+      for (int k = 0; k < nlin; ++k)
+      {
+         SCIP_ERR( SCIPaddVarObj(scip, linvars[k], lincoefs[k]), "Error adding objective coefficient.");
+      }
+      if ( poly.constant != 0.0 )
+      {
+         SCIP_ERR( SCIPaddOrigObjoffset(scip, poly.constant), "Error adding objective offset.");
+      }
+      nlin = 0;
+
+      /* quadratic part: quad(x) - nlobj = 0 */
+      if ( nquad > 0 )
+      {
+         SCIP_VAR* nlobj;
+
+         SCIP_ERR( SCIPcreateVarBasic(scip, &nlobj, "nlobj", -SCIPinfinity(scip), SCIPinfinity(scip), 1.0, SCIP_VARTYPE_CONTINUOUS), "Error adding nonlinear objective variable.");
+         SCIP_ERR( SCIPaddVar(scip, nlobj), "Error adding nonlinear objective variable.");
+         linvars[nlin] = nlobj;
+         lincoefs[nlin++] = -1.0;
+
+         (void) SCIPsnprintf(msgbuf, BUFSIZE, "QuadraticObj%zu", nlno);
+#if ( SCIP_VERSION >= 800 || ( SCIP_VERSION < 800 && SCIP_APIVERSION >= 100 ) )
+         SCIP_ERR( SCIPcreateConsBasicQuadraticNonlinear(scip, &cons, msgbuf, nlin, linvars, lincoefs, nquad, quadvars1, quadvars2, quadcoefs, 0.0, 0.0), "Error creating quadratic objective constraint.");
+#else
+         SCIP_ERR( SCIPcreateConsBasicQuadratic(scip, &cons, msgbuf, nlin, linvars, lincoefs, nquad, quadvars1, quadvars2, quadcoefs, 0.0, 0.0), "Error creating quadratic objective constraint.");
+#endif
+         SCIP_ERR( SCIPaddCons(scip, cons), "Error adding quadratic objective constraint.");
+         SCIP_ERR( SCIPreleaseCons(scip, &cons), "Error freeing quadratic objective constraint.");
+         SCIP_ERR( SCIPreleaseVar(scip, &nlobj), "Error releasing SCIP nonlinear objective variable.");
+      }
+   }
+   else
+   {
+      /* move constant to the sides */
+      if ( ! SCIPisInfinity(scip, -lhs) )
+         lhs -= poly.constant;
+      if ( ! SCIPisInfinity(scip, rhs) )
+         rhs -= poly.constant;
+
+      if ( nquad == 0 )
+      {
+         (void) SCIPsnprintf(msgbuf, BUFSIZE, "LinearExp%zu", nlno);
+         SCIP_ERR( SCIPcreateConsBasicLinear(scip, &cons, msgbuf, nlin, linvars, lincoefs, lhs, rhs), "Error creating linear constraint.");
+      }
+      else
+      {
+         (void) SCIPsnprintf(msgbuf, BUFSIZE, "QuadraticExp%zu", nlno);
+#if ( SCIP_VERSION >= 800 || ( SCIP_VERSION < 800 && SCIP_APIVERSION >= 100 ) )
+         SCIP_ERR( SCIPcreateConsBasicQuadraticNonlinear(scip, &cons, msgbuf, nlin, linvars, lincoefs, nquad, quadvars1, quadvars2, quadcoefs, lhs, rhs), "Error creating quadratic constraint.");
+#else
+         SCIP_ERR( SCIPcreateConsBasicQuadratic(scip, &cons, msgbuf, nlin, linvars, lincoefs, nquad, quadvars1, quadvars2, quadcoefs, lhs, rhs), "Error creating quadratic constraint.");
+#endif
+      }
+      SCIP_ERR( SCIPaddCons(scip, cons), "Error adding constraint.");
+      SCIP_ERR( SCIPreleaseCons(scip, &cons), "Error freeing constraint.");
+   }
+
+   SCIPfreeMemoryArray(scip, &quadcoefs);
+   SCIPfreeMemoryArray(scip, &quadvars2);
+   SCIPfreeMemoryArray(scip, &quadvars1);
+   SCIPfreeMemoryArray(scip, &lincoefs);
+   SCIPfreeMemoryArray(scip, &linvars);
+
+   return true;
+}
+
+
+
+/** enable or disable adding affine and quadratic instruction lists as linear or quadratic constraints
+ *
+ *  Enabled by default; when disabled, all instruction lists are built as general expressions, e.g., to compare both.
+ */
+void setQuadraticDetection(
+   bool                  enable              /**< whether to detect affine and quadratic instruction lists */
+   )
+{
+   quadraticdetection = enable;
+}
+
 #if ( SCIP_VERSION >= 800 || ( SCIP_VERSION < 800 && SCIP_APIVERSION >= 100 ) )
 
 /** add nonlinear constraint to problem */
@@ -110,6 +456,10 @@ double addNonlinearCon(
 
    nvars = SCIPgetNVars(scip);
 
+   /* affine and quadratic instruction lists are directly added as linear or quadratic constraints */
+   if ( quadraticdetection && addQuadraticCon(scip, vars, instr, no_instr, lhs, rhs, xval, nlno, isObj, &fval) )
+      return fval;
+
    /* initialize lists */
    for (i = 0; i < MAX_DEPTH; i++)
    {
@@ -141,6 +491,10 @@ double addNonlinearCon(
       }
    }
 
+   /* SCIP counts the children of an expression with int */
+   CheckIntSize(no_var, "variables in a nonlinear expression");
+   CheckIntSize(no_ops, "operations in a nonlinear expression");
+
    /* create variable index vector */
    varind = (int*)mxCalloc(no_var, sizeof(int));
 
@@ -159,6 +513,11 @@ double addNonlinearCon(
          break;
 
       case VAR:
+         if ( instr[i] < 0 || instr[i] >= SCIPgetNVars(scip) )
+         {
+            snprintf(msgbuf, BUFSIZE, "Invalid variable index %g in nonlinear instruction list.", instr[i]);
+            mexErrMsgTxt(msgbuf);
+         }
          varind[j++] = (int)instr[i];
          state = READ;
          break;
@@ -171,11 +530,11 @@ double addNonlinearCon(
 
 #ifdef DEBUG
    mexPrintf("\n---------------------------------------\nProcessing Nonlinear Expression\n---------------------------------------\n");
-   mexPrintf("novar: %d, nounq: %d; no_ops: %d\n", no_var, no_unq, no_ops);
+   mexPrintf("novar: %zu, nounq: %zu; no_ops: %zu\n", no_var, no_unq, no_ops);
 
    /* print what we have found so far */
    for (i = 0; i < no_var; i++)
-      mexPrintf("varind[%d] = %d\n", i, varind[i]);
+      mexPrintf("varind[%zu] = %d\n", i, varind[i]);
    mexPrintf("\n");
 #endif
 
@@ -823,7 +1182,7 @@ double addNonlinearCon(
 #ifdef DEBUG
    debugPrintState(state, args, psavexplst, psavvarlst, psavprolst, varcnt, num);
    mexPrintf("\n---------------------------------------\nSummary at Expression Tree Create:\n");
-   mexPrintf("expno:  %3d [should equal %3d]\nvarcnt: %3d [should equal %3d]\n", expno, no_ops-1, varcnt, no_var-1);
+   mexPrintf("expno:  %3d [should equal %3zu]\nvarcnt: %3d [should equal %3zu]\n", expno, no_ops-1, varcnt, no_var-1);
    mexPrintf("---------------------------------------\n");
 #endif
 
@@ -841,9 +1200,9 @@ double addNonlinearCon(
 
    /* create the nonlinear constraint, add it, then release it */
    if ( isObj )
-      (void) SCIPsnprintf(msgbuf, BUFSIZE, "NonlinearObj%zd", nlno);
+      (void) SCIPsnprintf(msgbuf, BUFSIZE, "NonlinearObj%zu", nlno);
    else
-      (void) SCIPsnprintf(msgbuf, BUFSIZE, "NonlinearExp%zd", nlno);
+      (void) SCIPsnprintf(msgbuf, BUFSIZE, "NonlinearExp%zu", nlno);
 
    SCIP_ERR( SCIPcreateConsBasicNonlinear(scip, &nlcon, msgbuf, exp[expno], lhs, rhs), "Error creating nonlinear constraint!");
 
@@ -864,7 +1223,7 @@ double addNonlinearCon(
       SCIP_ERR( SCIPreleaseExpr(scip, &exp[k]), "Error releasing expression.");
    }
 
-   for (int k = no_var - 1; k >= 0; --k)
+   for (int k = (int) no_var - 1; k >= 0; --k)
    {
       SCIP_ERR( SCIPreleaseExpr(scip, &expvars[k]), "Error releasing variable expression.");
    }
@@ -926,6 +1285,10 @@ double addNonlinearCon(
    size_t i;
    size_t j;
 
+   /* affine and quadratic instruction lists are directly added as linear or quadratic constraints */
+   if ( quadraticdetection && addQuadraticCon(scip, vars, instr, no_instr, lhs, rhs, xval, nlno, isObj, &fval) )
+      return fval;
+
    /* initialize lists */
    for (i = 0; i < MAX_DEPTH; i++)
    {
@@ -957,6 +1320,10 @@ double addNonlinearCon(
       }
    }
 
+   /* SCIP counts the children of an expression with int */
+   CheckIntSize(no_var, "variables in a nonlinear expression");
+   CheckIntSize(no_ops, "operations in a nonlinear expression");
+
    /* create variable index vector */
    varind = (int*)mxCalloc(no_var, sizeof(int));
 
@@ -975,6 +1342,11 @@ double addNonlinearCon(
          break;
 
       case VAR:
+         if ( instr[i] < 0 || instr[i] >= SCIPgetNVars(scip) )
+         {
+            snprintf(msgbuf, BUFSIZE, "Invalid variable index %g in nonlinear instruction list.", instr[i]);
+            mexErrMsgTxt(msgbuf);
+         }
          varind[j++] = (int)instr[i];
          state = READ;
          break;
@@ -1034,11 +1406,11 @@ double addNonlinearCon(
 
 #ifdef DEBUG
    mexPrintf("\n---------------------------------------\nProcessing Nonlinear Expression\n---------------------------------------\n");
-   mexPrintf("novar: %d, nounq: %d; no_ops: %d\n",no_var,no_unq,no_ops);
+   mexPrintf("novar: %zu, nounq: %zu; no_ops: %zu\n", no_var, no_unq, no_ops);
 
    /* print what we have found so far */
    for (i = 0; i < no_var; i++)
-      mexPrintf("varind[%d] = %d\n", i, varind[i]);
+      mexPrintf("varind[%zu] = %d\n", i, varind[i]);
    mexPrintf("\n");
 
    for (i = 0; i < no_unq; i++)
@@ -1654,7 +2026,7 @@ double addNonlinearCon(
 #ifdef DEBUG
    debugPrintState(state, args, psavexplst, psavvarlst, psavprolst, varcnt, num);
    mexPrintf("\n---------------------------------------\nSummary at Expression Tree Create:\n");
-   mexPrintf("expno:  %3d [should equal %3d]\nvarcnt: %3d [should equal %3d]\n", expno, no_ops-1, varcnt, no_var-1);
+   mexPrintf("expno:  %3d [should equal %3zu]\nvarcnt: %3d [should equal %3zu]\n", expno, no_ops-1, varcnt, no_var-1);
    mexPrintf("---------------------------------------\n");
 #endif
 
@@ -1689,9 +2061,9 @@ double addNonlinearCon(
 
    /* create the nonlinear constraint, add it, then release it */
    if ( isObj )
-      sprintf(msgbuf, "NonlinearObj%zd", nlno);
+      sprintf(msgbuf, "NonlinearObj%zu", nlno);
    else
-      sprintf(msgbuf,"NonlinearExp%zd", nlno);
+      sprintf(msgbuf,"NonlinearExp%zu", nlno);
 
    SCIP_ERR( SCIPcreateConsBasicNonlinear(scip, &nlcon, msgbuf, 0, NULL, NULL, 1, &exprtree, &one, lhs, rhs), "Error creating nonlinear constraint!");
    SCIPexprtreeFree(&exprtree);
@@ -13,6 +13,10 @@
 #include <stdio.h>
 #include <cmath>
 #include <limits>
+#include <chrono>
+#include <vector>
+#include <set>
+#include <algorithm>
 
 #include <scip/scip.h>
 #include <scipsdp/scipsdpdef.h>
@@ -125,6 +129,10 @@ void checkInputs(
    ndec = mxGetNumberOfElements(prhs[eF]);
    ncon = mxGetM(prhs[eA]);
 
+   /* SCIP indexes variables and constraints with int, so reject sizes that cannot be represented */
+   CheckIntSize(ndec, "variables");
+   CheckIntSize(ncon, "linear constraints");
+
    /* check sparsity (only supported in A) */
    if ( ! mxIsEmpty(prhs[eA]) )
    {
@@ -257,7 +265,7 @@ void processUserOpts(
 
          if ( mxIsEmpty(opt_name) )
          {
-            sprintf(msgbuf, "SCIP option name in cell row %zd is empty!", i + 1);
+            sprintf(msgbuf, "SCIP option name in cell row %zu is empty!", i + 1);
             mexErrMsgTxt(msgbuf);
          }
 
@@ -266,7 +274,7 @@ void processUserOpts(
 
          if ( ! mxIsChar(opt_name) )
          {
-            sprintf(msgbuf, "SCIP option name in cell row %zd is not a string!", i + 1);
+            sprintf(msgbuf, "SCIP option name in cell row %zu is not a string!", i + 1);
             mexErrMsgTxt(msgbuf);
          }
 
@@ -279,7 +287,7 @@ void processUserOpts(
          if ( p == NULL )
          {
             /* clean up SCIP here */
-            sprintf(msgbuf, "SCIP option \"%s\" (row %zd) is not recognized!", name, i + 1);
+            sprintf(msgbuf, "SCIP option \"%s\" (row %zu) is not recognized!", name, i + 1);
             mxFree(name);
             mexErrMsgTxt(msgbuf);
          }
@@ -314,7 +322,7 @@ void processUserOpts(
             retcode = SCIPsetBoolParam(scip, name, boolval);
             if ( retcode != SCIP_OKAY )
             {
-               sprintf(msgbuf, "Error setting SCIP bool option \"%s\" (Row %zd)! Please check the value is within range.", name, i + 1);
+               sprintf(msgbuf, "Error setting SCIP bool option \"%s\" (Row %zu)! Please check the value is within range.", name, i + 1);
                mexErrMsgTxt(msgbuf);
             }
             break;
@@ -329,7 +337,7 @@ void processUserOpts(
             retcode = SCIPsetIntParam(scip, name, (int) *mxGetPr(opt_val));
             if ( retcode != SCIP_OKAY )
             {
-               sprintf(msgbuf, "Error setting SCIP integer option \"%s\" (row %zd)! Please check the value is within range.", name, i + 1);
+               sprintf(msgbuf, "Error setting SCIP integer option \"%s\" (row %zu)! Please check the value is within range.", name, i + 1);
                mexErrMsgTxt(msgbuf);
             }
             break;
@@ -344,7 +352,7 @@ void processUserOpts(
             retcode = SCIPsetLongintParam(scip, name, *mxGetPr(opt_val));
             if ( retcode != SCIP_OKAY )
             {
-               sprintf(msgbuf, "Error setting SCIP longint option \"%s\" (Row %zd)! Please check the value is within range.", name, i + 1);
+               sprintf(msgbuf, "Error setting SCIP longint option \"%s\" (Row %zu)! Please check the value is within range.", name, i + 1);
                mexErrMsgTxt(msgbuf);
             }
             break;
@@ -359,7 +367,7 @@ void processUserOpts(
             retcode = SCIPsetRealParam(scip, name, *mxGetPr(opt_val));
             if ( retcode != SCIP_OKAY )
             {
-               sprintf(msgbuf, "Error setting SCIP real option \"%s\" (Row %zd)! Please check the value is within range.", name, i + 1);
+               sprintf(msgbuf, "Error setting SCIP real option \"%s\" (Row %zu)! Please check the value is within range.", name, i + 1);
                mexErrMsgTxt(msgbuf);
             }
             break;
@@ -375,7 +383,7 @@ void processUserOpts(
             retcode = SCIPsetCharParam(scip, name, str_val[0]);
             if ( retcode != SCIP_OKAY )
             {
-               sprintf(msgbuf, "Error setting SCIP char option \"%s\" (Row %zd)! Please check the value is a valid character.", name, i + 1);
+               sprintf(msgbuf, "Error setting SCIP char option \"%s\" (Row %zu)! Please check the value is a valid character.", name, i + 1);
                mxFree(str_val);
                mexErrMsgTxt(msgbuf);
             }
@@ -393,7 +401,7 @@ void processUserOpts(
             retcode = SCIPsetStringParam(scip, name, str_val);
             if ( retcode != SCIP_OKAY )
             {
-               sprintf(msgbuf,"Error setting SCIP string option \"%s\" (Row %zd)! Please check the value is a valid string.", name, i + 1);
+               sprintf(msgbuf,"Error setting SCIP string option \"%s\" (Row %zu)! Please check the value is a valid string.", name, i + 1);
                mxFree(str_val);
                mexErrMsgTxt(msgbuf);
             }
@@ -406,29 +414,66 @@ void processUserOpts(
    }
 }
 
+/** returns the dimension of a cone [C A1 A2 ...], whose columns are vectorized square matrices
+ *
+ *  Checks that the number of rows is a square number and that all sizes handed to SCIP-SDP fit into an int.
+ */
+static
+int getSDPDimension(
+   const mxArray*        cone,               /**< sparse cone data [C A1 A2 ...] */
+   size_t                block,              /**< index of cone */
+   size_t                nvars               /**< number of decision variables (without auxiliary variables) */
+   )
+{
+   size_t SDP_M = mxGetM(cone);
+   size_t SDP_N = mxGetN(cone);
+   size_t SDP_DIM = (size_t)(sqrt((double)SDP_M) + 0.5);
+
+   if ( ! mxIsSparse(cone) )
+   {
+      snprintf(msgbuf, BUFSIZE, "SDP cone %zu must be a sparse matrix.", block);
+      mexErrMsgTxt(msgbuf);
+   }
+
+   if ( SDP_DIM * SDP_DIM != SDP_M )
+   {
+      snprintf(msgbuf, BUFSIZE, "The number of rows of SDP cone %zu (%zu) is not the square of its dimension.", block, SDP_M);
+      mexErrMsgTxt(msgbuf);
+   }
+
+   if ( SDP_N < 1 || SDP_N > nvars + 1 )
+   {
+      snprintf(msgbuf, BUFSIZE, "SDP cone %zu must have between 1 and %zu columns ([C A1 A2 ...]).", block, nvars + 1);
+      mexErrMsgTxt(msgbuf);
+   }
+
+   CheckIntSize(SDP_DIM, "rows of an SDP block");
+   CheckIntSize(mxGetJc(cone)[SDP_N], "nonzeros of an SDP cone");
+
+   return (int)SDP_DIM;
+}
+
 /* add SDP constraint */
 static
 void addSDPConstraint(
    SCIP*                 scip,
    SCIP_VAR**            scipvars,
+   size_t                nvars,
    const mxArray*        cone,
-   int                   block
+   size_t                block
    )
 {
    double* SDP_pr  = mxGetPr(cone);
    mwIndex* SDP_ir = mxGetIr(cone);
    mwIndex* SDP_jc = mxGetJc(cone);
-   int SDP_M       = (int)mxGetM(cone);
-   int SDP_N       = (int)mxGetN(cone); /* remember [C A0 A1 A2...] so non-square */
-   int SDP_C_nnz   = 0; /* nnz in C */
-   int SDP_A_nnz   = 0; /* nnz in current A */
-   int SDP_DIM     = (int)(sqrt((double)SDP_M)); /* calculate dimension */
+   size_t SDP_N    = mxGetN(cone); /* remember [C A0 A1 A2...] so non-square */
+   size_t SDP_C_nnz = 0; /* nnz in C */
+   int SDP_DIM     = getSDPDimension(cone, block, nvars); /* calculate dimension */
    int rind;
    int cind;
    size_t i;
    size_t j;
    size_t idx;
-   size_t midx;
 
    /* data for SDP constraint */
    SCIP_VAR** vars = NULL;
@@ -444,15 +489,14 @@ void addSDPConstraint(
    int nzerocoef = 0;
 
    /* determine nnz */
-   SDP_C_nnz = (int)(SDP_jc[1] - SDP_jc[0]);
-   SDP_A_nnz = (int)(SDP_jc[SDP_N] - SDP_C_nnz);
+   SDP_C_nnz = SDP_jc[1] - SDP_jc[0];
 
 #ifdef DEBUG
-   mexPrintf("SDP_DIM [block %d]: %d, M: %d, N: %d\n", block, SDP_DIM, SDP_M, SDP_N);
-   mexPrintf("C nnz: %d, all A nnz: %d\n", SDP_C_nnz, SDP_A_nnz);
+   mexPrintf("SDP_DIM [block %zu]: %d, M: %zu, N: %zu\n", block, SDP_DIM, mxGetM(cone), SDP_N);
+   mexPrintf("C nnz: %zu, all A nnz: %zu\n", SDP_C_nnz, (size_t)(SDP_jc[SDP_N] - SDP_jc[1]));
 #endif
 
-   /* allocate constraint memory (we allocate too much here ...) */
+   /* allocate constraint memory (each matrix gets the number of nonzeros of its column) */
    SCIP_ERR( SCIPallocBlockMemoryArray(scip, &vars, SDP_N - 1), "Error Allocating SCIP-SDP Variable Memory.");
    SCIP_ERR( SCIPallocBlockMemoryArray(scip, &nvarnonz, SDP_N - 1), "Error Allocating SCIP-SDP Variable Memory.");
    SCIP_ERR( SCIPallocBlockMemoryArray(scip, &col, SDP_N - 1), "Error Allocating SCIP-SDP Column Memory.");
@@ -460,9 +504,9 @@ void addSDPConstraint(
    SCIP_ERR( SCIPallocBlockMemoryArray(scip, &val, SDP_N - 1), "Error Allocating SCIP-SDP Values Memory.");
    for (i = 1; i < SDP_N; ++i)
    {
-      SCIP_ERR( SCIPallocBlockMemoryArray(scip, &col[i-1], SDP_A_nnz), "Error Allocating SCIP-SDP Column Memory.");
-      SCIP_ERR( SCIPallocBlockMemoryArray(scip, &row[i-1], SDP_A_nnz), "Error Allocating SCIP-SDP Row Memory.");
-      SCIP_ERR( SCIPallocBlockMemoryArray(scip, &val[i-1], SDP_A_nnz), "Error Allocating SCIP-SDP Values Memory.");
+      SCIP_ERR( SCIPallocBlockMemoryArray(scip, &col[i-1], SDP_jc[i+1] - SDP_jc[i]), "Error Allocating SCIP-SDP Column Memory.");
+      SCIP_ERR( SCIPallocBlockMemoryArray(scip, &row[i-1], SDP_jc[i+1] - SDP_jc[i]), "Error Allocating SCIP-SDP Row Memory.");
+      SCIP_ERR( SCIPallocBlockMemoryArray(scip, &val[i-1], SDP_jc[i+1] - SDP_jc[i]), "Error Allocating SCIP-SDP Values Memory.");
    }
    SCIP_ERR( SCIPallocBlockMemoryArray(scip, &const_col, SDP_C_nnz), "Error Allocating SCIP-SDP Constant Column Memory.");
    SCIP_ERR( SCIPallocBlockMemoryArray(scip, &const_row, SDP_C_nnz), "Error Allocating SCIP-SDP Constant Row Memory.");
@@ -470,12 +514,12 @@ void addSDPConstraint(
 
    /* copy in C */
    idx = 0;
-   for (i = 0; i < SDP_C_nnz; i++)
+   for (i = SDP_jc[0]; i < SDP_jc[1]; i++)
    {
-      rind = SDP_ir[i] % SDP_DIM;
-      cind = (int)((SDP_ir[i] - rind)/SDP_DIM);
-      assert( 0 <= rind < SDP_DIM );
-      assert( 0 <= cind < SDP_DIM );
+      rind = (int)(SDP_ir[i] % SDP_DIM);
+      cind = (int)(SDP_ir[i] / SDP_DIM);
+      assert( 0 <= rind && rind < SDP_DIM );
+      assert( 0 <= cind && cind < SDP_DIM );
 
       if ( rind >= cind )
       {
@@ -488,7 +532,7 @@ void addSDPConstraint(
             const_val[idx] = SDP_pr[i];
             nnzc++;
 #ifdef DEBUG
-            mexPrintf("(%zd) - C[%d,%d] = %f\n", idx, const_row[idx], const_col[idx], const_val[idx]);
+            mexPrintf("(%zu) - C[%d,%d] = %f\n", idx, const_row[idx], const_col[idx], const_val[idx]);
 #endif
             idx++;
          }
@@ -496,60 +540,56 @@ void addSDPConstraint(
    }
 
    /* copy in all A_i */
-   idx = 0;
-   midx = SDP_C_nnz;
    for (i = 1; i < SDP_N; i++)
    {
       vars[i-1] = scipvars[i-1];
       idx = 0;
       for (j = SDP_jc[i]; j < SDP_jc[i+1]; j++)
       {
-         rind = SDP_ir[midx] % SDP_DIM;
-         cind = (int)((SDP_ir[midx] - rind)/SDP_DIM);
-         assert( 0 <= rind < SDP_DIM );
-         assert( 0 <= cind < SDP_DIM );
+         rind = (int)(SDP_ir[j] % SDP_DIM);
+         cind = (int)(SDP_ir[j] / SDP_DIM);
+         assert( 0 <= rind && rind < SDP_DIM );
+         assert( 0 <= cind && cind < SDP_DIM );
 
          if ( rind >= cind )
          {
-            if ( SCIPisZero(scip, SDP_pr[midx]) )
+            if ( SCIPisZero(scip, SDP_pr[j]) )
                ++nzerocoef;
             else
             {
                row[i-1][idx] = rind;
                col[i-1][idx] = cind;
-               val[i-1][idx] = SDP_pr[midx];
+               val[i-1][idx] = SDP_pr[j];
                nnza++;
 #ifdef DEBUG
-               mexPrintf("(%zd) - A[%zd][%d,%d] = %f.\n", idx, i - 1, row[i-1][idx], col[i-1][idx], val[i-1][idx]);
+               mexPrintf("(%zu) - A[%zu][%d,%d] = %f.\n", idx, i - 1, row[i-1][idx], col[i-1][idx], val[i-1][idx]);
 #endif
                idx++;
             }
          }
-         midx++;
       }
-      nvarnonz[i-1] = idx;
-      assert( idx <= SDP_A_nnz );
-      assert( midx <= SDP_A_nnz + SDP_C_nnz );
+      nvarnonz[i-1] = (int)idx;
+      assert( idx <= SDP_jc[i+1] - SDP_jc[i] );
    }
-   assert( nnza <= SDP_A_nnz );
+   assert( (size_t)nnza <= SDP_jc[SDP_N] - SDP_jc[1] );
 
    /* Create SCIP Constraint */
    SCIP_CONS* sdpcon;
-   SCIPsnprintf(msgbuf, BUFSIZE, "SDP-%d", block);
-   SCIP_ERR( SCIPcreateConsSdp(scip, &sdpcon, msgbuf, SDP_N - 1, nnza, SDP_DIM, nvarnonz, col, row, val, vars, nnzc, const_col, const_row, const_val, TRUE), "Error Creating SDP Constraint." );
+   SCIPsnprintf(msgbuf, BUFSIZE, "SDP-%zu", block);
+   SCIP_ERR( SCIPcreateConsSdp(scip, &sdpcon, msgbuf, (int)(SDP_N - 1), nnza, SDP_DIM, nvarnonz, col, row, val, vars, nnzc, const_col, const_row, const_val, TRUE), "Error Creating SDP Constraint." );
    SCIP_ERR( SCIPaddCons(scip, sdpcon), "Error Adding SDP Constraint." );
    SCIP_ERR( SCIPreleaseCons(scip, &sdpcon), "Error Releasing SDP Constraint." );
 #ifdef DEBUG
-   mexPrintf("Added SDP constraint %d.\n",block);
+   mexPrintf("Added SDP constraint %zu.\n", block);
 #endif
    if ( nzerocoef > 0 )
       mexPrintf("Found %d coefficients with absolute value less than epsilon = %g.\n", nzerocoef, SCIPepsilon(scip));
 
    for (i = SDP_N - 1; i > 0; --i)
    {
-      SCIPfreeBlockMemoryArray(scip, &col[i-1], SDP_A_nnz);
-      SCIPfreeBlockMemoryArray(scip, &row[i-1], SDP_A_nnz);
-      SCIPfreeBlockMemoryArray(scip, &val[i-1], SDP_A_nnz);
+      SCIPfreeBlockMemoryArray(scip, &col[i-1], SDP_jc[i+1] - SDP_jc[i]);
+      SCIPfreeBlockMemoryArray(scip, &row[i-1], SDP_jc[i+1] - SDP_jc[i]);
+      SCIPfreeBlockMemoryArray(scip, &val[i-1], SDP_jc[i+1] - SDP_jc[i]);
    }
    SCIPfreeBlockMemoryArray(scip, &col, SDP_N-1);
    SCIPfreeBlockMemoryArray(scip, &row, SDP_N-1);
@@ -562,6 +602,370 @@ void addSDPConstraint(
    SCIPfreeBlockMemoryArray(scip, &nvarnonz, SDP_N - 1);
 }
 
+/** computes the maximal cliques of a chordal extension of a sparsity pattern
+ *
+ *  The extension is the filled graph of a minimum degree elimination ordering. A vertex v together with its neighbors
+ *  that are eliminated after v forms a clique; this clique is maximal unless it is contained in the clique of a vertex
+ *  whose first later neighbor is v.
+ */
+static
+void computeChordalCliques(
+   int                   dim,                /**< dimension of the matrix */
+   vector< set<int> >&   adj,                /**< off-diagonal adjacency of the pattern (destroyed) */
+   vector< vector<int> >& cliques            /**< maximal cliques with sorted vertices (output) */
+   )
+{
+   vector< vector<int> > higher(dim);
+   vector<int> position(dim, -1);
+   vector<int> parent(dim, -1);
+   vector<bool> ismaximal(dim, true);
+   int pos;
+   int u;
+   int v;
+
+   for (pos = 0; pos < dim; ++pos)
+   {
+      /* pick a remaining vertex of minimum degree */
+      v = -1;
+      for (u = 0; u < dim; ++u)
+      {
+         if ( position[u] < 0 && ( v < 0 || adj[u].size() < adj[v].size() ) )
+            v = u;
+      }
+      assert( v >= 0 );
+
+      /* the remaining neighbors of v become a clique (fill-in) */
+      higher[v].assign(adj[v].begin(), adj[v].end());
+      for (vector<int>::iterator a = higher[v].begin(); a != higher[v].end(); ++a)
+      {
+         adj[*a].erase(v);
+         for (vector<int>::iterator b = higher[v].begin(); b != higher[v].end(); ++b)
+         {
+            if ( *a != *b )
+               adj[*a].insert(*b);
+         }
+      }
+      adj[v].clear();
+      position[v] = pos;
+   }
+
+   /* the parent of v is its first neighbor that is eliminated later */
+   for (v = 0; v < dim; ++v)
+   {
+      for (vector<int>::iterator a = higher[v].begin(); a != higher[v].end(); ++a)
+      {
+         if ( parent[v] < 0 || position[*a] < position[parent[v]] )
+            parent[v] = *a;
+      }
+      if ( parent[v] >= 0 && higher[v].size() == higher[parent[v]].size() + 1 )
+         ismaximal[parent[v]] = false;
+   }
+
+   for (v = 0; v < dim; ++v)
+   {
+      if ( ismaximal[v] )
+      {
+         vector<int> clique(higher[v]);
+         clique.push_back(v);
+         sort(clique.begin(), clique.end());
+         cliques.push_back(clique);
+      }
+   }
+}
+
+/** data of one SDP block created by the chordal decomposition */
+struct SdpCliqueBlock
+{
+   vector<int>           constrow;           /**< row indices of constant matrix */
+   vector<int>           constcol;           /**< column indices of constant matrix */
+   vector<SCIP_Real>     constval;           /**< values of constant matrix */
+   vector<SCIP_VAR*>     vars;               /**< variables appearing in the block */
+   vector< vector<int> > row;                /**< row indices of each variable's matrix */
+   vector< vector<int> > col;                /**< column indices of each variable's matrix */
+   vector< vector<SCIP_Real> > val;          /**< values of each variable's matrix */
+   int                   lastvar;            /**< index of the last original variable added */
+};
+
+/** returns the local index of a vertex within a (sorted) clique */
+static
+int cliqueIndex(
+   const vector<int>&    clique,             /**< sorted clique */
+   int                   vertex              /**< vertex in clique */
+   )
+{
+   vector<int>::const_iterator it = lower_bound(clique.begin(), clique.end(), vertex);
+   assert( it != clique.end() && *it == vertex );
+   return (int)(it - clique.begin());
+}
+
+/** adds an SDP constraint split along the maximal cliques of a chordal extension of its aggregate sparsity pattern
+ *
+ *  If S(x) = sum A_i x_i - C has a chordal sparsity pattern with maximal cliques C_1, ..., C_p, then S(x) is positive
+ *  semidefinite if and only if S(x) = sum_k P_k^T Z_k P_k with each Z_k positive semidefinite (Agler's theorem). Every
+ *  entry of S(x) is assigned to the first clique containing it; for entries that lie in several cliques, coupling
+ *  variables move part of the entry to the other cliques. Each Z_k becomes a separate (smaller) SDP constraint.
+ *
+ *  Returns false (and adds nothing) if the extension consists of a single clique.
+ */
+static
+bool addChordalSDPConstraints(
+   SCIP*                 scip,               /**< SCIP instance */
+   SCIP_VAR**            scipvars,           /**< problem variables */
+   size_t                nvars,              /**< number of problem variables in scipvars */
+   const mxArray*        cone,               /**< sparse cone data [C A1 A2 ...] */
+   size_t                block,              /**< index of cone */
+   mxArray**             cliquesizes,        /**< row vector of clique sizes (output) */
+   int*                  ncoupling           /**< number of coupling variables added (output) */
+   )
+{
+   double* SDP_pr  = mxGetPr(cone);
+   mwIndex* SDP_ir = mxGetIr(cone);
+   mwIndex* SDP_jc = mxGetJc(cone);
+   size_t SDP_N    = mxGetN(cone); /* remember [C A0 A1 A2...] so non-square */
+   int SDP_DIM     = getSDPDimension(cone, block, nvars); /* calculate dimension */
+   int nzerocoef = 0;
+   int rind;
+   int cind;
+   int k;
+   size_t i;
+   size_t j;
+
+   vector< set<int> > adj(SDP_DIM);
+   vector< vector<int> > cliques;
+
+   *ncoupling = 0;
+
+   /* aggregate sparsity pattern of C and all A_i */
+   for (j = 0; j < SDP_N; ++j)
+   {
+      for (i = SDP_jc[j]; i < SDP_jc[j+1]; ++i)
+      {
+         rind = (int)(SDP_ir[i] % SDP_DIM);
+         cind = (int)(SDP_ir[i] / SDP_DIM);
+         if ( rind > cind && ! SCIPisZero(scip, SDP_pr[i]) )
+         {
+            adj[rind].insert(cind);
+            adj[cind].insert(rind);
+         }
+      }
+   }
+
+   computeChordalCliques(SDP_DIM, adj, cliques);
+
+   *cliquesizes = mxCreateDoubleMatrix(1, cliques.size(), mxREAL);
+   for (i = 0; i < cliques.size(); ++i)
+      mxGetPr(*cliquesizes)[i] = (double)cliques[i].size();
+
+   if ( cliques.size() <= 1 )
+      return false;
+
+   /* collect the (lower triangular) entries of each clique, sorted by entry and clique */
+   vector< pair<SCIP_Longint, int> > entries;
+   for (k = 0; k < (int)cliques.size(); ++k)
+   {
+      for (i = 0; i < cliques[k].size(); ++i)
+      {
+         for (j = 0; j <= i; ++j)
+            entries.push_back(make_pair((SCIP_Longint)cliques[k][i] * SDP_DIM + cliques[k][j], k));
+      }
+   }
+   sort(entries.begin(), entries.end());
+
+   /* each entry belongs to the first clique containing it */
+   vector<SCIP_Longint> keys;
+   vector<int> owner;
+   for (i = 0; i < entries.size(); ++i)
+   {
+      if ( i == 0 || entries[i].first != entries[i-1].first )
+      {
+         keys.push_back(entries[i].first);
+         owner.push_back(entries[i].second);
+      }
+   }
+
+   vector<SdpCliqueBlock> blocks(cliques.size());
+   for (k = 0; k < (int)cliques.size(); ++k)
+      blocks[k].lastvar = -1;
+
+   /* copy in C */
+   for (i = SDP_jc[0]; i < SDP_jc[1]; ++i)
+   {
+      rind = (int)(SDP_ir[i] % SDP_DIM);
+      cind = (int)(SDP_ir[i] / SDP_DIM);
+
+      if ( rind >= cind )
+      {
+         if ( SCIPisZero(scip, SDP_pr[i]) )
+            ++nzerocoef;
+         else
+         {
+            k = owner[lower_bound(keys.begin(), keys.end(), (SCIP_Longint)rind * SDP_DIM + cind) - keys.begin()];
+            blocks[k].constrow.push_back(cliqueIndex(cliques[k], rind));
+            blocks[k].constcol.push_back(cliqueIndex(cliques[k], cind));
+            blocks[k].constval.push_back(SDP_pr[i]);
+         }
+      }
+   }
+
+   /* copy in all A_i */
+   for (j = 1; j < SDP_N; ++j)
+   {
+      for (i = SDP_jc[j]; i < SDP_jc[j+1]; ++i)
+      {
+         rind = (int)(SDP_ir[i] % SDP_DIM);
+         cind = (int)(SDP_ir[i] / SDP_DIM);
+
+         if ( rind >= cind )
+         {
+            if ( SCIPisZero(scip, SDP_pr[i]) )
+               ++nzerocoef;
+            else
+            {
+               k = owner[lower_bound(keys.begin(), keys.end(), (SCIP_Longint)rind * SDP_DIM + cind) - keys.begin()];
+               SdpCliqueBlock& blk = blocks[k];
+               if ( blk.lastvar != (int)j )
+               {
+                  blk.vars.push_back(scipvars[j-1]);
+                  blk.row.push_back(vector<int>());
+                  blk.col.push_back(vector<int>());
+                  blk.val.push_back(vector<SCIP_Real>());
+                  blk.lastvar = (int)j;
+               }
+               blk.row.back().push_back(cliqueIndex(cliques[k], rind));
+               blk.col.back().push_back(cliqueIndex(cliques[k], cind));
+               blk.val.back().push_back(SDP_pr[i]);
+            }
+         }
+      }
+   }
+
+   /* for entries in several cliques, move a free share from the owner to each other clique */
+   vector<SCIP_VAR*> couplingvars;
+   for (i = 0; i < entries.size(); ++i)
+   {
+      if ( i == 0 || entries[i].first != entries[i-1].first )
+         continue;
+
+      int from = owner[lower_bound(keys.begin(), keys.end(), entries[i].first) - keys.begin()];
+      int to = entries[i].second;
+      rind = (int)(entries[i].first / SDP_DIM);
+      cind = (int)(entries[i].first % SDP_DIM);
+
+      SCIP_VAR* couplingvar;
+      SCIPsnprintf(msgbuf, BUFSIZE, "sdpcoupling%zu_%d", block, *ncoupling);
+      SCIP_ERR( SCIPcreateVarBasic(scip, &couplingvar, msgbuf, -SCIPinfinity(scip), SCIPinfinity(scip), 0.0, SCIP_VARTYPE_CONTINUOUS), "Error creating SDP coupling variable.");
+      SCIP_ERR( SCIPaddVar(scip, couplingvar), "Error adding SDP coupling variable.");
+      couplingvars.push_back(couplingvar);
+      ++(*ncoupling);
+
+      blocks[from].vars.push_back(couplingvar);
+      blocks[from].row.push_back(vector<int>(1, cliqueIndex(cliques[from], rind)));
+      blocks[from].col.push_back(vector<int>(1, cliqueIndex(cliques[from], cind)));
+      blocks[from].val.push_back(vector<SCIP_Real>(1, -1.0));
+
+      blocks[to].vars.push_back(couplingvar);
+      blocks[to].row.push_back(vector<int>(1, cliqueIndex(cliques[to], rind)));
+      blocks[to].col.push_back(vector<int>(1, cliqueIndex(cliques[to], cind)));
+      blocks[to].val.push_back(vector<SCIP_Real>(1, 1.0));
+   }
+
+   /* create one SDP constraint per clique */
+   for (k = 0; k < (int)cliques.size(); ++k)
+   {
+      SdpCliqueBlock& blk = blocks[k];
+      int nvars = (int)blk.vars.size();
+      int nnza = 0;
+
+      if ( nvars == 0 && blk.constval.empty() )
+         continue;
+
+      vector<int> nvarnonz(nvars);
+      vector<int*> col(nvars);
+      vector<int*> row(nvars);
+      vector<SCIP_Real*> val(nvars);
+      for (i = 0; i < (size_t)nvars; ++i)
+      {
+         nvarnonz[i] = (int)blk.val[i].size();
+         col[i] = &blk.col[i][0];
+         row[i] = &blk.row[i][0];
+         val[i] = &blk.val[i][0];
+         nnza += nvarnonz[i];
+      }
+
+      SCIP_CONS* sdpcon;
+      SCIPsnprintf(msgbuf, BUFSIZE, "SDP-%zu-%d", block, k);
+      SCIP_ERR( SCIPcreateConsSdp(scip, &sdpcon, msgbuf, nvars, nnza, (int)cliques[k].size(), nvars > 0 ? &nvarnonz[0] : NULL,
+            nvars > 0 ? &col[0] : NULL, nvars > 0 ? &row[0] : NULL, nvars > 0 ? &val[0] : NULL, nvars > 0 ? &blk.vars[0] : NULL,
+            (int)blk.constval.size(), blk.constval.empty() ? NULL : &blk.constcol[0], blk.constval.empty() ? NULL : &blk.constrow[0],
+            blk.constval.empty() ? NULL : &blk.constval[0], TRUE), "Error Creating SDP Constraint." );
+      SCIP_ERR( SCIPaddCons(scip, sdpcon), "Error Adding SDP Constraint." );
+      SCIP_ERR( SCIPreleaseCons(scip, &sdpcon), "Error Releasing SDP Constraint." );
+   }
+
+   /* the constraints hold the coupling variables now */
+   for (i = 0; i < couplingvars.size(); ++i)
+      SCIP_ERR( SCIPreleaseVar(scip, &couplingvars[i]), "Error releasing SDP coupling variable.");
+
+   if ( nzerocoef > 0 )
+      mexPrintf("Found %d coefficients with absolute value less than epsilon = %g.\n", nzerocoef, SCIPepsilon(scip));
+
+   return true;
+}
+
+/** phases of building the SCIP-SDP problem, reported with opts.buildtime */
+enum
+{
+   eBuildValidation = 0,        /**< input checks, options and SCIP setup */
+   eBuildVariables  = 1,        /**< variables, objective and bounds */
+   eBuildLinear     = 2,        /**< linear constraints */
+   eBuildSDP        = 3,        /**< SDP cones */
+   eBuildNPhases    = 4
+};
+
+/** wall clock time in seconds */
+static
+double wallClock(void)
+{
+   return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** add time since *tstart to the given build phase and restart the clock */
+static
+void addBuildTime(
+   double*               buildtime,          /**< times of build phases */
+   int                   phase,              /**< phase that just ended */
+   double*               tstart              /**< start time of phase (updated) */
+   )
+{
+   double t = wallClock();
+
+   buildtime[phase] += t - *tstart;
+   *tstart = t;
+}
+
+/** add field BuildTime with the times of the build phases to the statistics */
+static
+void setBuildTimeStats(
+   mxArray*              stats,              /**< statistics structure */
+   const double*         buildtime           /**< times of build phases */
+   )
+{
+   const char* phasenames[eBuildNPhases] = {"validation", "variables", "linear", "sdp"};
+   mxArray* bt = mxCreateStructMatrix(1, 1, eBuildNPhases, phasenames);
+   double total = 0.0;
+
+   for (int p = 0; p < eBuildNPhases; p++)
+   {
+      mxSetField(bt, 0, phasenames[p], mxCreateDoubleScalar(buildtime[p]));
+      total += buildtime[p];
+   }
+   mxAddField(bt, "total");
+   mxSetField(bt, 0, "total", mxCreateDoubleScalar(total));
+
+   mxAddField(stats, "BuildTime");
+   mxSetField(stats, 0, "BuildTime", bt);
+}
+
 /** main function */
 void mexFunction(
    int                   nlhs,               /* number of expected outputs */
@@ -596,6 +1000,11 @@ void mexFunction(
    double primtol = SCIP_DEFAULT_FEASTOL;
    double objbias = 0.0;
    int maxpresolve = -1;
+   int sdpwarmstart = 0;
+   int sdpchordal = 0;
+   int buildtimes = 0;
+   double buildtime[eBuildNPhases] = {0.0, 0.0, 0.0, 0.0};
+   double tphase = wallClock();
    char printlevelstr[BUFSIZE]; printlevelstr[0] = '\0';
    int printLevel = 0;
    int optsEntry = 0;
@@ -616,13 +1025,10 @@ void mexFunction(
    int arhs = 0;
    int alb = 0;
    int aub = 0;
-   int no = 0;
 
    /* sparse indexing */
    mwIndex* A_ir;
    mwIndex* A_jc;
-   mwIndex startRow;
-   mwIndex stopRow;
 
    /* SCIPSDP objects */
    SCIP* scip;
@@ -667,6 +1073,9 @@ void mexFunction(
       getDblOption(OPTS, "maxtime", maxtime);
       getDblOption(OPTS, "tolrfun", primtol);
       getDblOption(OPTS, "objbias", objbias);
+      getIntOption(OPTS, "sdpwarmstart", sdpwarmstart);
+      getIntOption(OPTS, "sdpchordal", sdpchordal);
+      getIntOption(OPTS, "buildtime", buildtimes);
       getStrOption(OPTS, "display", printlevelstr);
       /* determine print level */
       if ( strcmp(printlevelstr, "iter") == 0 )
@@ -695,6 +1104,17 @@ void mexFunction(
       {
          SCIP_ERR( SCIPsetRealParam(scip, "numerics/feastol", primtol), "Error setting lpfeastol.");
       }
+
+      /* warm start the SDP relaxations from the primal/dual solution of the previous relaxation (not all SDP solvers support this) */
+      if ( sdpwarmstart )
+      {
+         if ( SCIPgetParam(scip, "relaxing/SDP/warmstart") != NULL )
+         {
+            SCIP_ERR( SCIPsetBoolParam(scip, "relaxing/SDP/warmstart", TRUE), "Error setting SDP warm start.");
+         }
+         else
+            mexWarnMsgTxt("This version of SCIP-SDP does not support warm starting the SDP relaxations, ignoring option sdpwarmstart.");
+      }
    }
 
    /* if user has requested print out */
@@ -811,8 +1231,10 @@ void mexFunction(
          rhs[i] = SCIPinfinity(scip);
    }
 
+   addBuildTime(buildtime, eBuildValidation, &tphase);
+
    /* create SCIP variables (also loads linear objective + bounds) */
-   SCIP_ERR( SCIPallocMemoryArray(scip, &vars, (int)ndec), "Error allocating variable memory");
+   SCIP_ERR( SCIPallocMemoryArray(scip, &vars, ndec), "Error allocating variable memory");
    double llb;
    double lub;
 
@@ -827,22 +1249,22 @@ void mexFunction(
          vartype = SCIP_VARTYPE_INTEGER;
          llb = lb[i];
          lub = ub[i];
-         sprintf(msgbuf, "ivar%zd", nint++);
+         sprintf(msgbuf, "ivar%zu", nint++);
          break;
       case 'b':
          vartype = SCIP_VARTYPE_BINARY;
          llb = SCIPisInfinity(scip, -lb[i]) ? 0 : lb[i]; /* if we don't do this, SCIP fails during presolve */
          lub = SCIPisInfinity(scip, ub[i])  ? 1 : ub[i];
-         sprintf(msgbuf, "bvar%zd", nbin++);
+         sprintf(msgbuf, "bvar%zu", nbin++);
          break;
       case 'c':
          vartype = SCIP_VARTYPE_CONTINUOUS;
          llb = lb[i];
          lub = ub[i];
-         sprintf(msgbuf, "xvar%zd", ncnt++);
+         sprintf(msgbuf, "xvar%zu", ncnt++);
          break;
       default:
-         sprintf(msgbuf, "Unknown variable type for variable %zd.", i);
+         sprintf(msgbuf, "Unknown variable type for variable %zu.", i);
          mexErrMsgTxt(msgbuf);
       }
 
@@ -859,35 +1281,27 @@ void mexFunction(
       SCIP_ERR( SCIPcreateVarBasic(scip, &objb, "objbiasterm", objbias, objbias, 1.0, SCIP_VARTYPE_CONTINUOUS), "Error adding objective bias variable.");
       SCIP_ERR( SCIPaddVar(scip, objb), "Error adding objective bias variable.");
    }
+   addBuildTime(buildtime, eBuildVariables, &tphase);
 
    /* add linear constraints (if they exist) */
    if ( ncon )
    {
       /* allocate memory for all constraints (we create them all now, as we have to add coefficients in column order) */
-      SCIP_ERR( SCIPallocMemoryArray(scip, &cons, (int)ncon), "Error allocating constraint memory.");
+      SCIP_ERR( SCIPallocMemoryArray(scip, &cons, ncon), "Error allocating constraint memory.");
 
       /* create each constraint and add row bounds, but leave coefficients empty */
       for (i = 0; i < ncon; i++)
       {
-         SCIPsnprintf(msgbuf, BUFSIZE, "lincon%d", i); /* appears constraints require a name */
+         SCIPsnprintf(msgbuf, BUFSIZE, "lincon%zu", i); /* appears constraints require a name */
          SCIP_ERR( SCIPcreateConsBasicLinear(scip, &cons[i], msgbuf, 0, NULL, NULL, lhs[i], rhs[i]), "Error creating basic SCIP linear constraint.");
       }
 
       /* now for each column (variable), add coefficients */
       for (i = 0; i < ndec; i++)
       {
-         /* determine number of nz in this column */
-         startRow = A_jc[i];
-         stopRow = A_jc[i+1];
-         no = (int)(stopRow - startRow);
-
-         /* if we have nz in this column */
-         if ( no > 0 )
-         {
-            /* add each coefficient */
-            for (j = startRow; j < stopRow; j++)
-               SCIP_ERR( SCIPaddCoefLinear(scip, cons[A_ir[j]], vars[i], A[j]), "Error adding constraint linear coefficient.");
-         }
+         /* add each coefficient of this column */
+         for (j = A_jc[i]; j < A_jc[i+1]; j++)
+            SCIP_ERR( SCIPaddCoefLinear(scip, cons[A_ir[j]], vars[i], A[j]), "Error adding constraint linear coefficient.");
       }
 
       /* now for each constraint, add it to the problem, then release it */
@@ -897,15 +1311,52 @@ void mexFunction(
          SCIP_ERR( SCIPreleaseCons(scip, &cons[i]), "Error releasing linear constraint.");
       }
    }
+   addBuildTime(buildtime, eBuildLinear, &tphase);
 
    /* add semidefinite constraints */
-   for (i = 0; i < ncones; i++)
+   if ( sdpchordal )
    {
-      if ( ncones == 1 && ! mxIsCell(prhs[eSDP]) )
-         addSDPConstraint(scip,vars,prhs[eSDP],(int)i);
-      else
-         addSDPConstraint(scip,vars,mxGetCell(prhs[eSDP],i),(int)i);
+      mxArray* cliques = mxCreateCellMatrix(1, ncones);
+      mxArray* cliquesizes;
+      int ncoupling;
+
+      for (i = 0; i < ncones; i++)
+      {
+         const mxArray* cone = ( ncones == 1 && ! mxIsCell(prhs[eSDP]) ) ? prhs[eSDP] : mxGetCell(prhs[eSDP], i);
+
+         /* split the cone along the maximal cliques of a chordal extension, if there is more than one */
+         if ( ! addChordalSDPConstraints(scip, vars, ndec, cone, i, &cliquesizes, &ncoupling) )
+            addSDPConstraint(scip, vars, ndec, cone, i);
+
+         if ( printLevel )
+         {
+            mexPrintf("SDP cone %zu: decomposed into %zu clique(s), %d coupling variable(s), clique sizes:", i, mxGetNumberOfElements(cliquesizes), ncoupling);
+            for (j = 0; j < mxGetNumberOfElements(cliquesizes); j++)
+               mexPrintf(" %g", mxGetPr(cliquesizes)[j]);
+            mexPrintf("\n");
+         }
+         mxSetCell(cliques, i, cliquesizes);
+      }
+
+      /* report clique sizes of each cone */
+      mxAddField(plhs[3], "SDPcliques");
+      mxSetField(plhs[3], 0, "SDPcliques", cliques);
    }
+   else
+   {
+      for (i = 0; i < ncones; i++)
+      {
+         if ( ncones == 1 && ! mxIsCell(prhs[eSDP]) )
+            addSDPConstraint(scip, vars, ndec, prhs[eSDP], i);
+         else
+            addSDPConstraint(scip, vars, ndec, mxGetCell(prhs[eSDP], i), i);
+      }
+   }
+
+   addBuildTime(buildtime, eBuildSDP, &tphase);
+
+   if ( buildtimes )
+      setBuildTimeStats(plhs[3], buildtime);
 
    /* SCIP_ERR( SCIPwriteOrigProblem(scip, NULL, "cip", FALSE), "error"); */
 
@@ -5,6 +5,11 @@ classdef scipvar
 %   deterministic MATLAB function into an SCIP MEX Interface compatible
 %   instruction list. Use 'methods(scipvar)' to see available functions.
 %
+%   Each element only holds a handle to a node of an expression graph
+%   stored in the MEX file scipexprmex, all (vectorized) operations are
+%   performed there. Use scipvar.instructions to obtain the instruction
+%   lists and scipvar.reset to clear the graph.
+%
 %   Copyright (C) 2012/2013 Jonathan Currie (IPL)
     
     %#ok<*STOUT,*MANU,*INUSD>
@@ -28,8 +33,12 @@ classdef scipvar
     end
 
     properties
-        ins         % Instruction List
-        indx        % Variable index
+        node        % Expression graph node
+        indx        % Variable index (only for variables)
+    end
+    
+    properties (Dependent)
+        ins         % Instruction List (empty for variables)
     end
 
     methods
@@ -47,32 +56,28 @@ classdef scipvar
                     
                 case 2
                     if(isnumeric(rows) && isnumeric(cols))
-                        s(rows,cols) = scipvar; % preallocate
-                        % Fill in indicies
-                        k = 0;
-                        for i = 1:cols
-                            for j = 1:rows                            
-                                s(j,i).indx = k; k = k + 1;
-                            end
-                        end
+                        % Variable indicies (column major)
+                        idx = reshape(0:rows*cols-1,rows,cols);
+                        s = scipvar.fromNodes(scipexprmex('var',idx));
+                        idx = num2cell(idx);
+                        [s.indx] = idx{:};
                     else
-                        if(iscell(rows) && iscell(cols))
-                            [r,c] = size(rows);
-                            s(r,c) = scipvar; % preallocate
-                            % Fill in indicies and existing instructions
-                            for i = 1:r
-                                for j = 1:c                 
-                                    s(i,j).ins = rows{i,j};
-                                    s(i,j).indx = cols{i,j};
-                                end
-                            end
-                        else
-                            error('Unknown constructor format.');
-                        end
+                        error('Unknown constructor format.');
                     end
             end
         end
         
+        % INS
+        function ins = get.ins(s)
+        % Instruction list of a scalar scipvar
+            if(~isempty(s.indx))
+                ins = [];
+            else
+                ins = scipexprmex('emit',s.node);
+                ins = ins{1};
+            end
+        end
+        
         %-- SIMPLE OPERATORS --%
         % PLUS 
         function c = plus(a,b)
@@ -259,13 +264,52 @@ classdef scipvar
         
     end
     
+    methods (Static)
+        % INSTRUCTIONS
+        function ins = instructions(a)
+        % Returns a cell array (same size as a) of instruction lists
+            ins = scipexprmex('emit',scipvar.nodes(a));
+        end
+        
+        % LINEARPARTS
+        function [A,c,isaff,ins] = linearParts(a,nvar)
+        % Splits each element of a into A(k,:)*x + c(k) + (nonlinear terms),
+        % A is sparse. isaff(k) is true if there are no nonlinear terms,
+        % otherwise ins{k} is the instruction list of the nonlinear terms.
+            [AT,c,isaff,rest] = scipexprmex('affine',scipvar.nodes(a),nvar);
+            A = AT.';
+            isaff = logical(isaff);
+            if(nargout > 3)
+                ins = cell(numel(a),1);
+                ins(~isaff) = scipexprmex('emit',rest(~isaff));
+            end
+        end
+        
+        % RESET
+        function reset()
+        % Clears the expression graph (invalidates all existing scipvars)
+            scipexprmex('reset');
+        end
+    end
+    
+    methods (Static, Access = private)
+        % Create scipvar array from expression graph nodes
+        function s = fromNodes(ids)
+            s = repmat(scipvar,size(ids));
+            ids = num2cell(ids);
+            [s.node] = ids{:};
+        end
+        
+        % Expression graph nodes of a scipvar array
+        function ids = nodes(a)
+            ids = reshape([a.node],size(a));
+        end
+    end
+    
     methods (Access = private)                
         
         % Basic Scalar and Vector Operations (+-*/^)
         function c = vectorOp(a,b,op)
-            % Constants
-            SCIP_NUM = 0;
-            SCIP_VAR = 1;            
             % Ensure we have doubles (otherwise cast)
             if(isnumeric(a))
                 if(~isa(a,'double'))
@@ -286,234 +330,18 @@ classdef scipvar
             % Now perform operation based on variable types presented
             switch [class(a),class(b)] 
                 case 'scipvardouble'
-
-                    % x1+2
-                    if(isscalar(a) && isscalar(b))
-                        c = a; % copy 
-                        if(isempty(c.ins))
-                            c.ins = [SCIP_VAR; c.indx];
-                        end
-                        c.ins = [c.ins;
-                                 SCIP_NUM; b;
-                                 op; NaN];
-
-                    % [x1..xn]+2
-                    elseif(isscalar(b))
-                        c = a; % copy  
-                        [r1,c1] = size(c);
-                        for i = 1:r1
-                            for j = 1:c1
-                                if(isempty(c(i,j).ins))
-                                    c(i,j).ins = [SCIP_VAR; c(i,j).indx];
-                                end
-                                c(i,j).ins = [c(i,j).ins;
-                                              SCIP_NUM; b;
-                                              op; NaN];
-                            end
-                        end
-                    
-                    % x1+[1..n]
-                    elseif(isscalar(a))
-                        % Create copies of current contents
-                        [nrow,ncol] = size(b);
-                        vins = cell(nrow,ncol);
-                        vidx = cell(nrow,ncol);
-                        if(isempty(a.ins))
-                            a.ins = [SCIP_VAR; a.indx];
-                        end
-                        for i = 1:nrow
-                            for j = 1:ncol
-                                vins{i,j} = [a.ins; SCIP_NUM; b(i,j); op; NaN];
-                                vidx{i,j} = a.indx;
-                            end
-                        end
-                        % Create new object
-                        c = scipvar(vins,vidx);
-
-                    % [x1..xn]+[1..n]
-                    else
-                        % Check dimensions
-                        [r1,c1] = size(a);
-                        [r2,c2] = size(b);
-                        if(r1 ~= r2)
-                            error('Vector/Matrix row dimensions must agree.');
-                        elseif(c1 ~= c2)
-                            error('Vector/Matrix column dimensions must agree.');
-                        end
-                        c = a; % copy
-                        for i = 1:r1
-                            for j = 1:c1
-                                if(isempty(c(i,j).ins))
-                                    c(i,j).ins = [SCIP_VAR; c(i,j).indx];
-                                end
-                                c(i,j).ins = [c(i,j).ins;
-                                              SCIP_NUM; b(i,j);
-                                              op; NaN];
-                            end
-                        end                       
-                    end
+                    c = scipvar.fromNodes(scipexprmex('binary',op,scipvar.nodes(a),scipexprmex('num',b)));
                     
                 case 'doublescipvar'
-                    % 2+x1
-                    if(isscalar(a) && isscalar(b))
-                        c = b; % copy
-                        if(isempty(c.ins))
-                            c.ins = [SCIP_NUM; a
-                                     SCIP_VAR; c.indx;
-                                     op; NaN];                            
-                        else
-                            c.ins = [c.ins; 
-                                     SCIP_NUM; a;
-                                     op; 1]; % always flip (e.g. 2-2*x)
-                        end
-                        
-                        
-                    % 2+[x1..xn]
-                    elseif(isscalar(a))
-                        c = b; % copy   
-                        [r1,c1] = size(c);
-                        for i = 1:r1
-                            for j = 1:c1
-                                if(isempty(c(i,j).ins))
-                                    c(i,j).ins = [SCIP_NUM; a;
-                                                  SCIP_VAR; c(i,j).indx;
-                                                  op; NaN];
-                                else
-                                    c(i,j).ins = [c(i,j).ins;
-                                                  SCIP_NUM; a;
-                                                  op; 1]; % always flip
-                                end
-                            end
-                        end
-                        
-                    % [1..n]+x1
-                    elseif(isscalar(b))
-                        % Create copies of current contents
-                        [nrow,ncol] = size(a);
-                        vins = cell(nrow,ncol);
-                        vidx = cell(nrow,ncol);
-                        if(isempty(b.ins))
-                            b.ins = [SCIP_VAR; b.indx];
-                        end
-                        for i = 1:nrow
-                            for j = 1:ncol
-                                vins{i,j} = [b.ins; SCIP_NUM; a(i,j); op; 1];
-                                vidx{i,j} = b.indx;
-                            end
-                        end
-                        % Create new object
-                        c = scipvar(vins,vidx);
-
-                    % [1..n]+[x1..xn]
-                    else
-                        % Check dimensions
-                        [r1,c1] = size(a);
-                        [r2,c2] = size(b);
-                        if(r1 ~= r2)
-                            error('Vector/Matrix row dimensions must agree [r1 = %d, r2 = %d].',r1,r2);
-                        elseif(c1 ~= c2)
-                            error('Vector/Matrix column dimensions must agree [c1 = %d, c2 = %d].',c1,c2);
-                        end
-                        c = b; % copy
-                        for i = 1:r1
-                            for j = 1:c1
-                                if(isempty(c(i,j).ins))
-                                    c(i,j).ins = [SCIP_NUM; a(i,j);
-                                                  SCIP_VAR; c(i,j).indx;
-                                                  op; NaN];
-                                else
-                                    c(i,j).ins = [c(i,j).ins;
-                                                  SCIP_NUM; a(i,j);
-                                                  op; 1]; % always flip
-                                end
-                            end
-                        end
-                    end
+                    c = scipvar.fromNodes(scipexprmex('binary',op,scipexprmex('num',a),scipvar.nodes(b)));
                     
                 case 'scipvarscipvar'
                     switch(op)
                         case scipvar.POW
                             % SCIP uses x^y = exp(y*log(x))
                             c = exp(b.*log(a));                            
-                        otherwise   
-                            % x1 + x2
-                            if(isscalar(a) && isscalar(b))
-                                c = a;
-                                if(isempty(c.ins))
-                                    c.ins = [SCIP_VAR; a.indx];
-                                end
-                                if(isempty(b.ins))
-                                    b.ins = [SCIP_VAR; b.indx];
-                                end
-                                c.ins = [c.ins;
-                                         b.ins;
-                                         op; NaN];
-                                     
-                            % x1+[x2..xn]
-                            elseif(isscalar(a))
-                                c = b;
-                                [r1,c1] = size(c);
-                                if(isempty(a.ins))
-                                    a.ins = [SCIP_VAR; a.indx];
-                                end
-                                for i = 1:r1
-                                    for j = 1:c1
-                                        if(isempty(c(i,j).ins))
-                                            c(i,j).ins = [a.ins;
-                                                          SCIP_VAR; c(i,j).indx;
-                                                          op; NaN];
-                                        else
-                                            c(i,j).ins = [a.ins;
-                                                          c(i,j).ins;                                                          
-                                                          op; NaN]; 
-                                        end
-                                    end
-                                end
-                                
-                            % [x1..n]+xk
-                            elseif(isscalar(b))
-                                c = a;
-                                [r1,c1] = size(c);
-                                if(isempty(b.ins))
-                                    b.ins = [SCIP_VAR; b.indx];
-                                end
-                                for i = 1:r1
-                                    for j = 1:c1
-                                        if(isempty(c(i,j).ins))
-                                            c(i,j).ins = [SCIP_VAR; c(i,j).indx;
-                                                          b.ins;
-                                                          op; NaN];
-                                        else
-                                            c(i,j).ins = [c(i,j).ins;
-                                                          b.ins;
-                                                          op; NaN]; 
-                                        end
-                                    end
-                                end
-                            else
-                                % Check dimensions
-                                [r1,c1] = size(a);
-                                [r2,c2] = size(b);
-                                if(r1 ~= r2)
-                                    error('Vector/Matrix row dimensions must agree.');
-                                elseif(c1 ~= c2)
-                                    error('Vector/Matrix column dimensions must agree.');
-                                end
-                                c = a; % copy
-                                for i = 1:r1
-                                    for j = 1:c1
-                                        if(isempty(c(i,j).ins))
-                                            c(i,j).ins = [SCIP_VAR; c(i,j).indx];
-                                        end
-                                        if(isempty(b(i,j).ins))
-                                            b(i,j).ins = [SCIP_VAR; b(i,j).indx];
-                                        end
-                                        c(i,j).ins = [c(i,j).ins;
-                                                      b(i,j).ins;
-                                                      op; NaN];                                        
-                                    end
-                                end
-                            end
+                        otherwise
+                            c = scipvar.fromNodes(scipexprmex('binary',op,scipvar.nodes(a),scipvar.nodes(b)));
                     end
                     
                 otherwise
@@ -536,75 +364,15 @@ classdef scipvar
         
         % Basic Vectorized Functions (log,log10,exp,abs)
         function c = vectorFcn(a,op)
-           SCIP_VAR = 1;
-           c = a;           
-           if(isscalar(a))
-                if(isempty(c.ins))
-                    c.ins = [SCIP_VAR; a.indx];
-                end
-                c.ins = [c.ins; op; NaN];
-           else
-               [row,col] = size(c);
-               for i = 1:row
-                   for j = 1:col
-                       if(isempty(c(i,j).ins))
-                           c(i,j).ins = [SCIP_VAR; c(i,j).indx;
-                                         op; NaN];
-                       else
-                           c(i,j).ins = [c(i,j).ins;
-                                         op; NaN];
-                       end
-                   end
-               end
-           end            
+            c = scipvar.fromNodes(scipexprmex('unary',op,scipvar.nodes(a)));
         end 
         
         % Dimension Wise Operations (sum, prod)
         function b = dimensionOp(a,n,op)            
-            [r,c] = size(a);
-            if(n == 1) % column products / sums
-                b = a(1,1);
-                if(c == 1) % result is a scalar
-                    for i = 2:r
-                        switch(op)
-                            case scipvar.ADD, b = b + a(i,1);
-                            case scipvar.MUL, b = b * a(i,1);
-                        end
-                    end
-                else % result is a row vector
-                    b = a(1,:);
-                    for i = 2:r
-                        for j = 1:c
-                            switch(op)
-                                case scipvar.ADD, b(j) = b(j) + a(i,j);
-                                case scipvar.MUL, b(j) = b(j) * a(i,j);
-                            end
-                        end
-                    end
-                end               
-            elseif(n==2) % row products / sums
-                b = a(1,1);
-                if(r == 1) % result is a scalar
-                    for i = 2:c
-                        switch(op)
-                            case scipvar.ADD, b = b + a(1,i);
-                            case scipvar.MUL, b = b * a(1,i);
-                        end
-                    end
-                else % result is a column vector
-                    b = a(:,1);
-                    for i = 1:r
-                        for j = 2:c
-                            switch(op)
-                                case scipvar.ADD, b(i) = b(i) + a(i,j);
-                                case scipvar.MUL, b(i) = b(i) * a(i,j);
-                            end
-                        end
-                    end
-                end
-            else
+            if(n ~= 1 && n ~= 2)
                 error('Only 2D operations are implemented.');
-            end           
+            end
+            b = scipvar.fromNodes(scipexprmex('reduce',op,scipvar.nodes(a),n));
         end
         
         % Matrix Operations
@@ -614,13 +382,15 @@ classdef scipvar
             [r2,c2] = size(b);               
             if(c1 ~= r2)
                 error('Matrix / vector sizes do not match - trying to multiply %d x %d by %d x %d.',r1,c1,r2,c2);
-            end            
-            % Create new output object, then fill it
-            c = scipvar(r1,c2);
-            for i = 1:r1
-                for j = 1:c2
-                    c(i,j) = dot(a(i,:),b(:,j)');
-                end
+            end
+            if(isnumeric(a))
+                % A*x (coefficients may be sparse)
+                c = scipvar.fromNodes(scipexprmex('linmap',double(a),scipvar.nodes(b)));
+            elseif(isnumeric(b))
+                % x*B = (B'*x')'
+                c = scipvar.fromNodes(scipexprmex('linmap',double(b).',scipvar.nodes(a).').');
+            else
+                c = scipvar.fromNodes(scipexprmex('matmul',scipvar.nodes(a),scipvar.nodes(b)));
             end
         end
     end    
@@ -0,0 +1,364 @@
+function [ok,res] = optiBenchRun(varargin)
+%OPTIBENCHRUN  Headless benchmark of the OPTI test sets with regression check
+%
+%   ok = optiBenchRun() runs all problems of the LP, MILP, QP, NLP and SDP
+%   test sets in Utilities/Install/*_test_results.mat with their default
+%   solvers (see optiSolver) and prints a summary. No figures or waitbars
+%   are opened, so it can be used from the command line, e.g.,
+%
+%       matlab -batch "ok = optiBenchRun('json','bench.json'); exit(~ok)"
+%
+%   ok = optiBenchRun('param1',value1,...) sets the following options:
+%       sets      - cell array of test sets {'lp','milp','qp','nlp','sdp'}
+%       workers   - number of parallel worker processes, 0 runs in the
+%                   current process {0}. Uses parfor, i.e., an open (or
+%                   auto-started) parallel pool of the Parallel Computing
+%                   Toolbox; runs sequentially if it is not available.
+%       reps      - number of runs of each problem, the fastest is used {1}
+%       seed      - random seed of MATLAB and SCIP ('randomization/
+%                   randomseedshift'), fixed per problem {0}
+%       maxtime   - time limit per problem in seconds {60}
+%       json      - write all results to this JSON file {[]}
+%       csv       - write all results to this CSV file {[]}
+%       baseline  - compare against the results of a previous run, given
+%                   by its CSV or JSON file {[]}
+%       tol       - a set (or problem) regresses if its shifted geometric
+%                   mean time exceeds the baseline by more than this
+%                   fraction {0.1}
+%       mintime   - problems faster than this (in seconds) in both runs
+%                   are not flagged individually {0.05}
+%       timeshift - shift of the geometric mean of times {1}
+%       nodeshift - shift of the geometric mean of nodes {10}
+%
+%   [ok,res] = optiBenchRun(...) also returns the results structure with
+%   fields runs (one entry per problem: set, problem, solver, time, nodes,
+%   gap, status, fval, ok), sets (shifted geometric means and number of
+%   solved problems per set) and regressions (cell array of messages).
+%
+%   ok is false if a problem returned a wrong objective value or, if a
+%   baseline is given, a regression against the baseline was found:
+%   a set or problem that became slower (see tol), a problem that is not
+%   solved correctly anymore, or a set with a larger geometric mean of
+%   nodes.
+%
+%   The CSV file of a run can directly be used as baseline of later runs.
+
+% options
+names = {'sets','workers','reps','seed','maxtime','json','csv','baseline','tol','mintime','timeshift','nodeshift'};
+defaults = {{'lp','milp','qp','nlp','sdp'},0,1,0,60,[],[],[],0.1,0.05,1,10};
+if(mod(nargin,2) ~= 0)
+    error('Options must be given as ''name'', value pairs.');
+end
+bopts = cell2struct(defaults,names,2);
+for i = 1:2:nargin
+    ind = strcmpi(varargin{i},names);
+    if(~any(ind))
+        error('Unknown option ''%s''.',varargin{i});
+    end
+    bopts.(names{ind}) = varargin{i+1};
+end
+if(ischar(bopts.sets)), bopts.sets = {bopts.sets}; end
+
+% collect jobs (problem + solver), loading the presolved results
+jobs = struct('set',{},'problem',{},'solver',{},'prob',{},'sval',{});
+here = fileparts(mfilename('fullpath'));
+for t = 1:length(bopts.sets)
+    tset = lower(bopts.sets{t});
+    file = fullfile(here,'..','Install',[tset '_test_results.mat']);
+    if(~exist(file,'file'))
+        error('Unknown test set ''%s'' (%s not found).',tset,file);
+    end
+    data = load(file);
+    probs = data.([tset '_tprob']);
+    sols = data.([tset '_sval']);
+    msolvers = optiSolver(tset);
+    ind = strcmpi(msolvers,'MATLAB') | strcmpi(msolvers,'GMATLAB'); msolvers(ind) = [];
+    for i = 1:length(msolvers)
+        for j = 1:length(probs)
+            jobs(end+1) = struct('set',tset,'problem',j,'solver',msolvers{i},'prob',probs(j),'sval',sols(j)); %#ok<AGROW>
+        end
+    end
+end
+njobs = length(jobs);
+
+% run jobs, in parallel worker processes if requested and available
+fprintf('OPTI benchmark: %d problems, %d worker(s), %d rep(s), seed %d\n',njobs,bopts.workers,bopts.reps,bopts.seed);
+runs = cell(njobs,1);
+if(bopts.workers > 0 && canRunParallel())
+    nworkers = bopts.workers;
+    parfor (k = 1:njobs, nworkers)
+        runs{k} = runJob(jobs(k),bopts);
+    end
+else
+    for k = 1:njobs
+        runs{k} = runJob(jobs(k),bopts);
+        fprintf('  %-5s %3d %-8s %-30s %9.4fs\n',runs{k}.set,runs{k}.problem,runs{k}.solver,runs{k}.status,runs{k}.time);
+    end
+end
+res.runs = [runs{:}]';
+res.sets = summarizeSets(res.runs,bopts);
+res.regressions = {};
+
+% wrong results are always failures
+bad = find(~[res.runs.ok]);
+for k = bad(:)'
+    r = res.runs(k);
+    res.regressions{end+1} = sprintf('%s problem %d (%s): wrong result %g (expected %g), status %s',r.set,r.problem,r.solver,r.fval,r.sval,r.status);
+end
+
+% compare against baseline
+if(~isempty(bopts.baseline))
+    base = readResults(bopts.baseline);
+    res.regressions = [res.regressions compareBaseline(res.runs,base,bopts)];
+end
+
+% write results
+if(~isempty(bopts.csv))
+    writeCSV(bopts.csv,res.runs);
+end
+if(~isempty(bopts.json))
+    writeJSON(bopts.json,res,bopts);
+end
+
+% print summary
+fprintf('\n%-6s %8s %8s %12s %12s\n','Set','Solved','Total','SGM time','SGM nodes');
+for t = 1:length(res.sets)
+    s = res.sets(t);
+    fprintf('%-6s %8d %8d %11.4fs %12.1f\n',upper(s.set),s.solved,s.total,s.sgmtime,s.sgmnodes);
+end
+if(isempty(res.regressions))
+    fprintf('\nNo failures or regressions.\n');
+else
+    fprintf(2,'\n%d failure(s) or regression(s):\n',length(res.regressions));
+    fprintf(2,'  %s\n',res.regressions{:});
+end
+ok = isempty(res.regressions);
+
+end
+
+
+% Solve one problem (fastest of reps runs)
+function r = runJob(job,bopts)
+if(exist('rng','file'))
+    rng(bopts.seed);
+else
+    rand('seed',bopts.seed); randn('seed',bopts.seed); %#ok<RAND>
+end
+sopts = scipset('scipopts',{'randomization/randomseedshift',bopts.seed});
+opts = optiset('solver',job.solver,'warnings','off','display','off','maxtime',bopts.maxtime,'solverOpts',sopts);
+
+r = struct('set',job.set,'problem',job.problem,'solver',job.solver,'time',Inf,'nodes',NaN,'gap',NaN, ...
+           'status','','fval',NaN,'sval',job.sval,'ok',false);
+for i = 1:max(1,bopts.reps)
+    try
+        Opt = opti(job.prob,opts);
+        [~,fval,~,stat] = solve(Opt);
+        if(stat.Time < r.time)
+            r.time = stat.Time;
+            r.nodes = getField(stat,'BBNodes');
+            r.gap = getField(stat,'BBGap');
+            r.status = stat.Status;
+            r.fval = fval;
+        end
+    catch ME
+        r.status = ['Error: ' ME.message];
+        return;
+    end
+end
+
+% same check as opti_Install_Test
+if(job.sval == 0)
+    r.ok = abs(r.fval - job.sval) <= 1e-3;
+else
+    r.ok = abs((r.fval - job.sval)/r.fval) <= 1e-3;
+end
+end
+
+
+% Return field of solver info or NaN
+function v = getField(stat,name)
+if(isfield(stat,name) && ~isempty(stat.(name)))
+    v = double(stat.(name));
+else
+    v = NaN;
+end
+end
+
+
+% Check whether parfor can use worker processes
+function can = canRunParallel()
+can = false;
+try
+    can = license('test','Distrib_Computing_Toolbox') && ~isempty(ver('parallel'));
+catch
+end
+if(~can)
+    fprintf('Parallel Computing Toolbox not available, running sequentially.\n');
+end
+end
+
+
+% Shifted geometric mean exp(mean(log(v + shift))) - shift
+function g = sgm(v,shift)
+v = v(~isnan(v) & ~isinf(v));
+if(isempty(v))
+    g = NaN;
+else
+    g = exp(mean(log(v + shift))) - shift;
+end
+end
+
+
+% Per set statistics; unsolved problems count with the time limit
+function sets = summarizeSets(runs,bopts)
+names = unique({runs.set});
+sets = struct('set',names,'solved',0,'total',0,'sgmtime',NaN,'sgmnodes',NaN);
+for t = 1:length(names)
+    r = runs(strcmp({runs.set},names{t}));
+    times = [r.time];
+    times(~[r.ok] | times > bopts.maxtime) = bopts.maxtime;
+    sets(t).solved = sum([r.ok]);
+    sets(t).total = length(r);
+    sets(t).sgmtime = sgm(times,bopts.timeshift);
+    sets(t).sgmnodes = sgm([r.nodes],bopts.nodeshift);
+end
+end
+
+
+% Regressions of runs against baseline runs
+function msgs = compareBaseline(runs,base,bopts)
+msgs = {};
+key = @(r) sprintf('%s/%d/%s',r.set,r.problem,r.solver);
+basekeys = arrayfun(key,base,'UniformOutput',false);
+
+% restrict both to the common problems, so that set means are comparable
+cur = false(size(runs)); old = zeros(size(runs));
+for k = 1:length(runs)
+    j = find(strcmp(basekeys,key(runs(k))),1);
+    if(~isempty(j))
+        cur(k) = true; old(k) = j;
+    end
+end
+if(~any(cur))
+    msgs{end+1} = 'baseline contains none of the benchmarked problems';
+    return;
+end
+runs = runs(cur); base = base(old(cur));
+
+% problems
+for k = 1:length(runs)
+    r = runs(k); b = base(k);
+    if(b.ok && ~r.ok)
+        msgs{end+1} = sprintf('%s: solved in baseline, now %s',key(r),r.status); %#ok<AGROW>
+    elseif(r.ok && b.ok && max(r.time,b.time) >= bopts.mintime && r.time > (1 + bopts.tol)*b.time)
+        msgs{end+1} = sprintf('%s: time %.4fs, baseline %.4fs (%+.0f%%)',key(r),r.time,b.time,100*(r.time/b.time - 1)); %#ok<AGROW>
+    end
+end
+
+% sets
+cs = summarizeSets(runs,bopts);
+bs = summarizeSets(base,bopts);
+for t = 1:length(cs)
+    if(cs(t).sgmtime > (1 + bopts.tol)*bs(t).sgmtime)
+        msgs{end+1} = sprintf('%s: shifted geometric mean time %.4fs, baseline %.4fs (%+.0f%%)',upper(cs(t).set), ...
+                              cs(t).sgmtime,bs(t).sgmtime,100*(cs(t).sgmtime/bs(t).sgmtime - 1)); %#ok<AGROW>
+    end
+    if(cs(t).sgmnodes > (1 + bopts.tol)*bs(t).sgmnodes)
+        msgs{end+1} = sprintf('%s: shifted geometric mean nodes %.1f, baseline %.1f',upper(cs(t).set), ...
+                              cs(t).sgmnodes,bs(t).sgmnodes); %#ok<AGROW>
+    end
+end
+end
+
+
+% Write runs as CSV
+function writeCSV(file,runs)
+fid = fopen(file,'w');
+if(fid < 0)
+    error('Cannot open %s for writing.',file);
+end
+fprintf(fid,'set,problem,solver,time,nodes,gap,status,fval,sval,ok\n');
+for k = 1:length(runs)
+    r = runs(k);
+    fprintf(fid,'%s,%d,%s,%.17g,%.17g,%.17g,"%s",%.17g,%.17g,%d\n',r.set,r.problem,r.solver,r.time,r.nodes,r.gap, ...
+            strrep(r.status,'"','""'),r.fval,r.sval,r.ok);
+end
+fclose(fid);
+end
+
+
+% Write results and options as JSON (without relying on jsonencode)
+function writeJSON(file,res,bopts)
+fid = fopen(file,'w');
+if(fid < 0)
+    error('Cannot open %s for writing.',file);
+end
+fprintf(fid,'{\n  "version": %s,\n  "seed": %d,\n  "reps": %d,\n  "workers": %d,\n',jsonValue(optiver),bopts.seed,bopts.reps,bopts.workers);
+fprintf(fid,'  "timeshift": %s,\n  "nodeshift": %s,\n',jsonValue(bopts.timeshift),jsonValue(bopts.nodeshift));
+fprintf(fid,'  "runs": [\n');
+writeStructs(fid,res.runs);
+fprintf(fid,'  ],\n  "sets": [\n');
+writeStructs(fid,res.sets);
+fprintf(fid,'  ],\n  "regressions": [');
+for k = 1:length(res.regressions)
+    if(k > 1), fprintf(fid,','); end
+    fprintf(fid,'\n    %s',jsonValue(res.regressions{k}));
+end
+fprintf(fid,'\n  ]\n}\n');
+fclose(fid);
+end
+
+function writeStructs(fid,s)
+f = fieldnames(s);
+for k = 1:length(s)
+    fprintf(fid,'    {');
+    for i = 1:length(f)
+        if(i > 1), fprintf(fid,', '); end
+        fprintf(fid,'"%s": %s',f{i},jsonValue(s(k).(f{i})));
+    end
+    if(k < length(s)), fprintf(fid,'},\n'); else, fprintf(fid,'}\n'); end
+end
+end
+
+function str = jsonValue(v)
+if(ischar(v))
+    v = strrep(strrep(v,'\','\\'),'"','\"');
+    str = ['"' regexprep(v,'[\n\r\t]',' ') '"'];
+elseif(islogical(v))
+    if(v), str = 'true'; else, str = 'false'; end
+elseif(isnan(v) || isinf(v))
+    str = 'null';
+else
+    str = sprintf('%.17g',v);
+end
+end
+
+
+% Read runs of a previous CSV or JSON file
+function runs = readResults(file)
+[~,~,ext] = fileparts(file);
+if(strcmpi(ext,'.json'))
+    if(~exist('jsondecode','builtin') && ~exist('jsondecode','file'))
+        error('Reading JSON baselines requires jsondecode, use the CSV file instead.');
+    end
+    data = jsondecode(fileread(file));
+    runs = data.runs;
+    if(iscell(runs)), runs = [runs{:}]; end
+    for k = 1:length(runs)
+        for f = {'time','nodes','gap','fval','sval'}
+            if(isempty(runs(k).(f{1}))), runs(k).(f{1}) = NaN; end
+        end
+    end
+else
+    fid = fopen(file,'r');
+    if(fid < 0)
+        error('Cannot open baseline %s.',file);
+    end
+    fgetl(fid); % header
+    c = textscan(fid,'%s %f %s %f %f %f %q %f %f %f','Delimiter',',');
+    fclose(fid);
+    runs = struct('set',c{1},'problem',num2cell(c{2}),'solver',c{3},'time',num2cell(c{4}),'nodes',num2cell(c{5}), ...
+                  'gap',num2cell(c{6}),'status',c{7},'fval',num2cell(c{8}),'sval',num2cell(c{9}),'ok',num2cell(c{10} ~= 0));
+end
+runs = runs(:);
+end
@@ -13,6 +13,31 @@ current_version = 3.00;
 % - Rename x0 to xval (a candidate solution).
 % - Revise handling of solver options for SCIP & SCIP-SDP.
 % - Allow to set parameters in SCIP-SDP.
+% - Add option sdpwarmstart to warm start the SDP relaxations in SCIP-SDP.
+% - Add option sdpchordal to decompose sparse SDP cones along chordal cliques.
+% - Add scip('readsolve', filename, opts) to solve problem files directly.
+% - Add option presolvecache to reuse presolved problems across identical scip calls.
+% - Add option reoptobj to solve a sequence of objectives with SCIP's reoptimization.
+% - Build scipvar expressions in a native expression graph (scipexprmex).
+% - Pass affine constraints and affine objective terms of scipvar expressions as linear data.
+% - Add affine and quadratic nonlinear instruction lists as linear/quadratic constraints in scipnlmex.
+% - Add native build (CMake) of the MEX sources against a mex/matrix API shim for tests and profiling.
+% - Add option buildtime to report the time of each model building phase, and a native build benchmark.
+% - Add optiBenchRun to benchmark the test sets headless and in parallel, with JSON/CSV output and baseline regression checks.
+% - Accept dense A/H/Q/l and single, integer and logical data directly in scipmex (converted once when added to SCIP).
+% - Check sizes against the int limits of SCIP when building problems, and use size_t throughout model construction.
+% - Add option lazycb to add lazy constraints from a MATLAB function during the solve (scipcallbackmex).
+% - Add option cutcb to separate cutting planes with a MATLAB function, with frequency, depth and efficacy filtering.
+% - Add option pricecb for column generation with a MATLAB pricing function, including Farkas pricing.
+% - Add scip('benders', master, subprobs, opts) to solve two-stage problems with SCIP's default Benders' decomposition.
+% - Add options rowlabels and varlabels to pass a block decomposition to SCIP, with decomposition statistics.
+% - Add options branchpriority, branchdir and branchfactor to set per-variable branching hints.
+% - Accept partial (NaN entries) and multiple (one per column) starting points in x0.
+% - Add early-termination options objlimit, relgap, absgap, stallnodes, stalltime, maxsols and deadline, and stats.StopReason.
+% - Solve pure LPs directly with the LP solver, returning duals, reduced costs and the basis, with basis warm start.
+% - Add options presolveonly and presolvematrices to return presolved sizes and matrices, and presolvethreads for PaPILO.
+% - Add option paramfile to read SCIP parameter files, and scip('defineProfile', name, solverOpts) for cached parameter profiles.
+% - Add scip('tune', problems, space, opts) to tune SCIP parameters over a set of problems in parallel worker threads.
 
 % 3.00 (09/2021)
 % - Complete revision based on previous version of OPTI toolbox.
@@ -42,7 +42,7 @@ if ~(exist('runTests', 'var')), runTests = []; end
 if ~(exist('specifyCPP', 'var')), specifyCPP = []; end
 
 % MEX interface source files
-src = {'scip/scipmex.cpp scip/scipeventmex.cpp scip/scipnlmex.cpp'};
+src = {'scip/scipmex.cpp scip/scipeventmex.cpp scip/scipnlmex.cpp scip/scipcallbackmex.cpp'};
 
 % set path to SCIP files
 scippath = setSCIPPath();
@@ -62,6 +62,11 @@ end
 
 opti_solverMex('scip',src, cxx_custom, inc, lib, opts);
 
+% expression graph for scipvar (does not depend on SCIP)
+eopts = opts;
+eopts.expre = '';
+opti_solverMex('scipexprmex', {'scip/scipexprmex.cpp'}, cxx_custom, [], '', eopts);
+
 fclose all;
 
 